@@ -0,0 +1,53 @@
+// Cookie会话基准测试：小会话的令牌长度与AES-GCM加密、解密认证吞吐，即每个请求代替一次服务器端往返的本地开销
+// 用法：bench_cookie_session [迭代次数]
+#include "session/cookie_storage.h"
+#include "session/session_id_generator.h"
+#include "log/http_logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace zhttp;
+using namespace zhttp::zsession;
+
+namespace
+{
+    template<typename F>
+    double ops_per_second(const size_t iterations, F &&fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            fn();
+        }
+        return iterations / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Log::Init(zlog::LogLevel::value::WARNING);
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    CookieSessionStorage storage({CookieSessionStorage::generate_key(1)});
+    Session session(SessionIdGenerator::generate());
+    session.set_attribute("user_id", "1024");
+    session.set_attribute("role", "member");
+    session.set_attribute("locale", "zh-CN");
+    session.set_attribute("csrf", "c9d2f0b1a4e84f6e9a7d3b2c1e0f9a8b");
+
+    const std::string token = *storage.cookie_token(session);
+    size_t sink = 0;
+    const double seal = ops_per_second(iterations, [&]
+    {
+        sink += storage.cookie_token(session)->size();
+    });
+    const double open = ops_per_second(iterations, [&]
+    {
+        sink += storage.load(token)->get_attribute("user_id").size();
+    });
+
+    std::printf("token %zu bytes  seal %9.0f/s (%.2f us)  open %9.0f/s (%.2f us)  (%zu)\n",
+                token.size(), seal, 1e6 / seal, open, 1e6 / open, sink % 10);
+    return 0;
+}
@@ -0,0 +1,150 @@
+// 空闲长连接内存基准测试：建立 N 个 keep-alive 连接，各完成一次请求后保持空闲，
+// 对比精简模式开关下每个空闲连接占用的常驻内存
+#include "http/http_server.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    long rss_kb()
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            if (line.compare(0, 6, "VmRSS:") == 0)
+            {
+                return std::strtol(line.c_str() + 6, nullptr, 10);
+            }
+        }
+        return 0;
+    }
+
+    int connect_to(const uint16_t port)
+    {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            if (fd >= 0) ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // 发送一个请求并读完响应，之后连接保持空闲
+    bool request_once(const int fd)
+    {
+        static const char request[] = "GET /ping HTTP/1.1\r\nHost: bench\r\nConnection: keep-alive\r\n\r\n";
+        if (::send(fd, request, sizeof(request) - 1, 0) != static_cast<ssize_t>(sizeof(request) - 1))
+        {
+            return false;
+        }
+        std::string response;
+        char buf[1024];
+        while (response.find("pong") == std::string::npos)
+        {
+            const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) return false;
+            response.append(buf, n);
+        }
+        return true;
+    }
+
+    void run(const bool lean_idle, const size_t count, const uint16_t port)
+    {
+        rlimit limit{};
+        getrlimit(RLIMIT_NOFILE, &limit);
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+
+        zhttp::HttpServerBuilder builder;
+        builder.build_port(port);
+        builder.build_name("IdleBench");
+        builder.build_thread_num(1);
+        builder.build_lean_idle(lean_idle);
+        zhttp::TimeoutConfig timeouts;
+        timeouts.idle_timeout_ = 3600; // 测试期间不让空闲连接超时
+        builder.build_timeouts(timeouts);
+        std::unique_ptr<zhttp::HttpServer> server = builder.build();
+        server->Get("/ping", [](const zhttp::HttpRequest &, zhttp::HttpResponse *res)
+        {
+            res->set_status_code(zhttp::HttpResponse::StatusCode::OK);
+            res->set_status_message("OK");
+            res->set_body("pong");
+        });
+        std::thread([&server] { server->start(); }).detach();
+
+        // 等待监听就绪
+        for (int i = 0; i < 100; ++i)
+        {
+            if (const int fd = connect_to(port); fd >= 0)
+            {
+                ::close(fd);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        const long before = rss_kb();
+        std::vector<int> fds;
+        fds.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const int fd = connect_to(port);
+            if (fd < 0 || !request_once(fd))
+            {
+                std::printf("connection %zu failed: %s\n", i, std::strerror(errno));
+                break;
+            }
+            fds.push_back(fd);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        const long after = rss_kb();
+
+        std::printf("lean_idle=%-5s connections=%-8zu rss_delta=%8ld KB  per_conn=%7.1f bytes\n",
+                    lean_idle ? "on" : "off", fds.size(), after - before,
+                    fds.empty() ? 0.0 : static_cast<double>(after - before) * 1024 / fds.size());
+        std::fflush(stdout);
+        for (const int fd : fds) ::close(fd);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    zhttp::Log::Init(zlog::LogLevel::value::OFF);
+
+    // 每种模式在独立子进程中运行，互不影响RSS
+    uint16_t port = 18080;
+    for (const bool lean_idle : {false, true})
+    {
+        if (const pid_t pid = fork(); pid == 0)
+        {
+            run(lean_idle, count, port);
+            _exit(0);
+        }
+        else if (pid > 0)
+        {
+            waitpid(pid, nullptr, 0);
+        }
+        ++port;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// IP黑白名单基准测试：20万条随机CIDR规则下的构建耗时，以及有无IPv4首级索引时的单次查找耗时
+#include "middleware/ipfilter/ip_trie.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace zhttp::zmiddleware;
+
+namespace
+{
+    std::string v4_text(const uint32_t addr)
+    {
+        return std::to_string(addr >> 24) + "." + std::to_string((addr >> 16) & 0xff) + "." +
+               std::to_string((addr >> 8) & 0xff) + "." + std::to_string(addr & 0xff);
+    }
+}
+
+int main()
+{
+    constexpr size_t rule_count = 200000;
+    constexpr size_t lookups = 5000000;
+    std::mt19937 rng(42);
+
+    // 长度16~32的随机IPv4前缀，另有1/8为IPv6 /32~/64
+    std::vector<std::string> cidrs;
+    cidrs.reserve(rule_count);
+    for (size_t i = 0; i < rule_count; ++i)
+    {
+        if (i % 8 == 0)
+        {
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "2001:%x:%x::/%u", static_cast<unsigned>(rng() & 0xffff),
+                          static_cast<unsigned>(rng() & 0xffff),
+                          32 + static_cast<unsigned>(rng() % 33));
+            cidrs.emplace_back(buf);
+        }
+        else
+        {
+            cidrs.push_back(v4_text(rng()) + "/" + std::to_string(16 + rng() % 17));
+        }
+    }
+
+    const auto build_start = std::chrono::steady_clock::now();
+    IpTrie trie;
+    for (size_t i = 0; i < cidrs.size(); ++i)
+    {
+        trie.insert(cidrs[i], i % 3 ? IpTrie::Action::Deny : IpTrie::Action::Allow);
+    }
+    const double insert_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - build_start).count();
+
+    const IpTrie plain = trie;
+    const auto compile_start = std::chrono::steady_clock::now();
+    trie.compile();
+    const double compile_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - compile_start).count();
+
+    std::vector<IpAddress> addresses(1 << 16);
+    for (auto &address : addresses)
+    {
+        address = IpAddress::from_v4(rng());
+    }
+
+    size_t denied = 0;
+    const auto measure = [&](const IpTrie &rules)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < lookups; ++i)
+        {
+            denied += rules.lookup(addresses[i & (addresses.size() - 1)]) == IpTrie::Action::Deny;
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / lookups;
+    };
+    const double plain_ns = measure(plain);
+    const double indexed_ns = measure(trie);
+
+    std::printf("rules=%zu nodes=%zu insert=%.1f ms compile=%.1f ms\n",
+                trie.size(), trie.node_count(), insert_ms, compile_ms);
+    std::printf("lookup without index: %6.1f ns/op   with /16 index: %6.1f ns/op   (denied %zu of %zu)\n",
+                plain_ns, indexed_ns, denied / 2, lookups);
+    return 0;
+}
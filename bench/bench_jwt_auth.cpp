@@ -0,0 +1,148 @@
+// JWT鉴权基准测试：RS256/ES256令牌在有无验证结果缓存时的吞吐，1个与4个线程
+#include "middleware/auth/jwt_middle.h"
+#include "log/http_logger.h"
+#include <openssl/core_names.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+using namespace zhttp;
+using namespace zhttp::zmiddleware;
+
+namespace
+{
+    std::string bn_param(EVP_PKEY *key, const char *name)
+    {
+        BIGNUM *bn = nullptr;
+        EVP_PKEY_get_bn_param(key, name, &bn);
+        std::string bytes(BN_num_bytes(bn), '\0');
+        BN_bn2bin(bn, reinterpret_cast<unsigned char *>(bytes.data()));
+        BN_free(bn);
+        return bytes;
+    }
+
+    nlohmann::json jwk_of(EVP_PKEY *key, const std::string &kid, const bool ec)
+    {
+        nlohmann::json jwk{{"kid", kid}};
+        if (ec)
+        {
+            unsigned char point[65];
+            size_t length = 0;
+            EVP_PKEY_get_octet_string_param(key, OSSL_PKEY_PARAM_PUB_KEY, point, sizeof(point), &length);
+            jwk["kty"] = "EC";
+            jwk["crv"] = "P-256";
+            jwk["x"] = jwt::base64url_encode(std::string_view(reinterpret_cast<char *>(point) + 1, 32));
+            jwk["y"] = jwt::base64url_encode(std::string_view(reinterpret_cast<char *>(point) + 33, 32));
+        }
+        else
+        {
+            jwk["kty"] = "RSA";
+            jwk["n"] = jwt::base64url_encode(bn_param(key, OSSL_PKEY_PARAM_RSA_N));
+            jwk["e"] = jwt::base64url_encode(bn_param(key, OSSL_PKEY_PARAM_RSA_E));
+        }
+        return jwk;
+    }
+
+    std::string sign(EVP_PKEY *key, const std::string &kid, const bool ec, const nlohmann::json &payload)
+    {
+        const nlohmann::json header{{"alg", ec ? "ES256" : "RS256"}, {"typ", "JWT"}, {"kid", kid}};
+        const std::string input = jwt::base64url_encode(header.dump()) + "." + jwt::base64url_encode(payload.dump());
+
+        EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+        size_t length = 0;
+        EVP_DigestSignInit(ctx, nullptr, EVP_sha256(), nullptr, key);
+        EVP_DigestSign(ctx, nullptr, &length, reinterpret_cast<const unsigned char *>(input.data()), input.size());
+        std::string signature(length, '\0');
+        EVP_DigestSign(ctx, reinterpret_cast<unsigned char *>(signature.data()), &length,
+                       reinterpret_cast<const unsigned char *>(input.data()), input.size());
+        EVP_MD_CTX_free(ctx);
+        signature.resize(length);
+
+        if (ec)
+        {
+            const auto *der = reinterpret_cast<const unsigned char *>(signature.data());
+            ECDSA_SIG *sig = d2i_ECDSA_SIG(nullptr, &der, static_cast<long>(signature.size()));
+            std::string raw(64, '\0');
+            BN_bn2binpad(ECDSA_SIG_get0_r(sig), reinterpret_cast<unsigned char *>(raw.data()), 32);
+            BN_bn2binpad(ECDSA_SIG_get0_s(sig), reinterpret_cast<unsigned char *>(raw.data()) + 32, 32);
+            ECDSA_SIG_free(sig);
+            signature = raw;
+        }
+        return input + "." + jwt::base64url_encode(signature);
+    }
+
+    // 多线程循环验证令牌，返回每秒验证次数
+    double run(JwtAuthMiddleware &middleware, const std::vector<std::string> &tokens, const int threads,
+               const size_t ops_per_thread)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]
+            {
+                std::shared_ptr<const JwtClaims> claims;
+                for (size_t i = 0; i < ops_per_thread; ++i)
+                {
+                    if (middleware.verify(tokens[(i + t * 7) % tokens.size()], claims) != JwtStatus::Ok)
+                    {
+                        std::abort();
+                    }
+                }
+            });
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<double>(ops_per_thread) * threads / seconds;
+    }
+}
+
+int main()
+{
+    Log::Init(zlog::LogLevel::value::WARNING);
+
+    EVP_PKEY *rsa = EVP_PKEY_Q_keygen(nullptr, nullptr, "RSA", size_t{2048});
+    EVP_PKEY *ec = EVP_PKEY_Q_keygen(nullptr, nullptr, "EC", "P-256");
+    const nlohmann::json jwks{{"keys", {jwk_of(rsa, "rsa", false), jwk_of(ec, "ec", true)}}};
+
+    // 1000个活跃用户，各持一个令牌
+    constexpr size_t users = 1000;
+    const int64_t now = std::time(nullptr);
+    for (const bool use_ec : {false, true})
+    {
+        std::vector<std::string> tokens;
+        for (size_t i = 0; i < users; ++i)
+        {
+            const nlohmann::json payload{{"sub", "user-" + std::to_string(i)}, {"iss", "zhttp"},
+                                         {"iat", now}, {"exp", now + 3600}, {"scope", "read write"}};
+            tokens.push_back(use_ec ? sign(ec, "ec", true, payload) : sign(rsa, "rsa", false, payload));
+        }
+
+        for (const int threads : {1, 4})
+        {
+            JwtConfig uncached_config;
+            uncached_config.cache_capacity_ = 0;
+            JwtAuthMiddleware uncached(uncached_config);
+            uncached.set_keys(JwkSet::parse(jwks.dump()));
+
+            JwtAuthMiddleware cached;
+            cached.set_keys(JwkSet::parse(jwks.dump()));
+
+            const double without = run(uncached, tokens, threads, use_ec ? 5000 : 20000);
+            const double with = run(cached, tokens, threads, 500000);
+            std::printf("%s threads=%d  no cache: %9.0f verifications/s   cache: %10.0f verifications/s   speedup: %6.1fx\n",
+                        use_ec ? "ES256" : "RS256", threads, without, with, with / without);
+        }
+    }
+
+    EVP_PKEY_free(rsa);
+    EVP_PKEY_free(ec);
+    return 0;
+}
@@ -0,0 +1,205 @@
+// IO线程分配策略基准测试：少量持续占用CPU的重连接与大量轮询的轻连接混合，
+// 对比轮询与最小负载分配下，各IO线程上轻请求p99延迟的差距
+#include "http/http_server.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr int kLoops = 4;
+    constexpr int kConnections = 16;         // 每kLoops个连接中有一个重连接
+    constexpr auto kHeavyWork = std::chrono::milliseconds(2);
+    constexpr auto kDuration = std::chrono::seconds(3);
+
+    int connect_to(const uint16_t port)
+    {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            if (fd >= 0) ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // 发送请求并读完响应，返回响应体
+    bool round_trip(const int fd, const std::string &path, std::string *body)
+    {
+        const std::string request = "GET " + path + " HTTP/1.1\r\nHost: bench\r\n\r\n";
+        if (::send(fd, request.data(), request.size(), 0) != static_cast<ssize_t>(request.size()))
+        {
+            return false;
+        }
+        std::string response;
+        char buf[4096];
+        size_t header_end = std::string::npos;
+        size_t length = 0;
+        while (header_end == std::string::npos || response.size() < header_end + 4 + length)
+        {
+            const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) return false;
+            response.append(buf, n);
+            if (header_end == std::string::npos && (header_end = response.find("\r\n\r\n")) != std::string::npos)
+            {
+                const size_t pos = response.find("Content-Length: ");
+                length = pos < header_end ? std::strtoul(response.c_str() + pos + 16, nullptr, 10) : 0;
+            }
+        }
+        *body = response.substr(header_end + 4, length);
+        return true;
+    }
+
+    double percentile(std::vector<double> &samples, const double p)
+    {
+        if (samples.empty()) return 0;
+        std::sort(samples.begin(), samples.end());
+        return samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))];
+    }
+
+    void run(const zhttp::LoopPolicy policy, const uint16_t port)
+    {
+        std::atomic<int> loop_ids{0};
+        zhttp::HttpServerBuilder builder;
+        builder.build_port(port);
+        builder.build_name("BalanceBench");
+        builder.build_thread_num(kLoops);
+        builder.build_loop_policy(policy);
+        std::unique_ptr<zhttp::HttpServer> server = builder.build();
+
+        // 响应体为处理该请求的IO线程编号
+        auto reply_loop = [&loop_ids](zhttp::HttpResponse *res)
+        {
+            thread_local const int loop_id = loop_ids.fetch_add(1);
+            const std::string body = std::to_string(loop_id);
+            res->set_status_code(zhttp::HttpResponse::StatusCode::OK);
+            res->set_status_message("OK");
+            res->set_content_length(body.size());
+            res->set_body(body);
+        };
+        server->Get("/heavy", [&reply_loop](const zhttp::HttpRequest &, zhttp::HttpResponse *res)
+        {
+            const auto until = std::chrono::steady_clock::now() + kHeavyWork;
+            while (std::chrono::steady_clock::now() < until)
+            {
+            }
+            reply_loop(res);
+        });
+        server->Get("/poll", [&reply_loop](const zhttp::HttpRequest &, zhttp::HttpResponse *res)
+        {
+            reply_loop(res);
+        });
+        std::thread([&server] { server->start(); }).detach();
+
+        for (int i = 0; i < 100; ++i)
+        {
+            if (const int fd = connect_to(port); fd >= 0)
+            {
+                ::close(fd);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+
+        std::mutex mutex;
+        std::map<std::string, std::vector<double>> latencies; // 按IO线程分组的轻请求延迟(us)
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> clients;
+        for (int i = 0; i < kConnections; ++i)
+        {
+            const bool heavy = i % kLoops == 0;
+            const int fd = connect_to(port);
+            if (fd < 0)
+            {
+                std::printf("connect failed\n");
+                break;
+            }
+            clients.emplace_back([&, fd, heavy]
+            {
+                std::string body;
+                std::vector<std::pair<std::string, double>> local;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    if (!round_trip(fd, heavy ? "/heavy" : "/poll", &body))
+                    {
+                        break;
+                    }
+                    if (!heavy)
+                    {
+                        local.emplace_back(body, std::chrono::duration<double, std::micro>(
+                                               std::chrono::steady_clock::now() - start).count());
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                }
+                ::close(fd);
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto &[loop, us] : local)
+                {
+                    latencies[loop].push_back(us);
+                }
+            });
+            // 重连接先跑一会儿，让负载统计反映出来
+            if (heavy)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            }
+        }
+
+        std::this_thread::sleep_for(kDuration);
+        stop = true;
+        for (auto &t : clients) t.join();
+
+        double min_p99 = 1e18, max_p99 = 0;
+        std::printf("policy=%s\n", policy == zhttp::LoopPolicy::LeastLoaded ? "least-loaded" : "round-robin");
+        for (auto &[loop, samples] : latencies)
+        {
+            const double p50 = percentile(samples, 0.50);
+            const double p99 = percentile(samples, 0.99);
+            min_p99 = std::min(min_p99, p99);
+            max_p99 = std::max(max_p99, p99);
+            std::printf("  loop %s: requests=%-7zu p50=%8.1f us  p99=%8.1f us\n", loop.c_str(), samples.size(),
+                        p50, p99);
+        }
+        std::printf("  p99 spread across loops: %.1f us\n", latencies.empty() ? 0.0 : max_p99 - min_p99);
+        std::fflush(stdout);
+    }
+}
+
+int main()
+{
+    zhttp::Log::Init(zlog::LogLevel::value::OFF);
+
+    // 每种策略在独立子进程中运行
+    uint16_t port = 18180;
+    for (const zhttp::LoopPolicy policy : {zhttp::LoopPolicy::RoundRobin, zhttp::LoopPolicy::LeastLoaded})
+    {
+        if (const pid_t pid = fork(); pid == 0)
+        {
+            run(policy, port);
+            _exit(0);
+        }
+        else if (pid > 0)
+        {
+            waitpid(pid, nullptr, 0);
+        }
+        ++port;
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// 中间件管线基准测试：运行时MiddlewareChain与编译期Pipeline对比，5/10个中间件
+#include "middleware/middleware_chain.h"
+#include "middleware/pipeline.h"
+#include "log/http_logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <utility>
+
+using namespace zhttp;
+using namespace zhttp::zmiddleware;
+
+namespace
+{
+    // 每层做一点真实工作：读请求头、累加计数，避免被整体优化掉
+    template<int N>
+    struct CountingHooks
+    {
+        uint64_t *counter_ = nullptr;
+
+        void before(HttpRequest &request) { *counter_ += request.get_path().size() + N; }
+
+        void after(HttpResponse &) { ++*counter_; }
+    };
+
+    template<int N>
+    class CountingMiddleware final : public Middleware
+    {
+    public:
+        explicit CountingMiddleware(uint64_t *counter) { hooks_.counter_ = counter; }
+
+        void before(HttpRequest &request) override { hooks_.before(request); }
+
+        void after(HttpResponse &response) override { hooks_.after(response); }
+
+    private:
+        CountingHooks<N> hooks_;
+    };
+
+    // 结果汇总到这里并在结束时打印，防止计数被优化掉
+    std::atomic<uint64_t> sink{0};
+
+    template<typename F>
+    double ns_per_op(const size_t ops, F &&fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ops; ++i)
+        {
+            fn();
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops;
+    }
+
+    template<int... Ns>
+    void run(std::integer_sequence<int, Ns...>)
+    {
+        constexpr size_t ops = 2000000;
+        uint64_t counter = 0;
+        HttpRequest request;
+        request.set_path("/api/users");
+        HttpResponse response;
+        const auto terminal = [&counter](MiddlewareContext &) { ++counter; };
+
+        MiddlewareChain chain({std::make_shared<CountingMiddleware<Ns>>(&counter)...});
+        const Next::Terminal runtime_terminal = terminal;
+        const double runtime = ns_per_op(ops, [&]
+        {
+            MiddlewareContext context(request, response);
+            chain.run(context, runtime_terminal);
+        });
+
+        Pipeline<CountingHooks<Ns>...> pipeline;
+        ((pipeline.template get<Ns>().counter_ = &counter), ...);
+        const double compiled = ns_per_op(ops, [&]
+        {
+            MiddlewareContext context(request, response);
+            pipeline.run(context, terminal);
+        });
+
+        std::printf("middlewares=%-3zu MiddlewareChain: %7.1f ns/req   Pipeline: %6.1f ns/req   speedup: %5.1fx\n",
+                    sizeof...(Ns), runtime, compiled, runtime / compiled);
+        sink.fetch_add(counter, std::memory_order_relaxed);
+    }
+}
+
+int main()
+{
+    Log::Init(zlog::LogLevel::value::WARNING);
+    run(std::make_integer_sequence<int, 5>{});
+    run(std::make_integer_sequence<int, 10>{});
+    std::printf("(checksum %llu)\n", static_cast<unsigned long long>(sink.load(std::memory_order_relaxed)));
+    return 0;
+}
@@ -0,0 +1,80 @@
+// 限流令牌桶表基准测试：1M 个不同键，多线程插入/命中/淘汰
+#include "middleware/ratelimit/token_bucket_table.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using zhttp::zmiddleware::TokenBucketTable;
+
+namespace
+{
+    constexpr size_t kKeyCount = 1000000;
+    constexpr size_t kHitOps = 8000000;
+
+    template<typename F>
+    double run_threads(unsigned threads, F &&fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back(fn, t);
+        }
+        for (auto &w : workers) w.join();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main()
+{
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> keys;
+    keys.reserve(kKeyCount);
+    for (size_t i = 0; i < kKeyCount; ++i)
+    {
+        keys.emplace_back("10." + std::to_string(i >> 16 & 0xff) + "." +
+                          std::to_string(i >> 8 & 0xff) + "." + std::to_string(i & 0xff) + "#" + std::to_string(i));
+    }
+
+    for (const uint32_t shards : {1u, 16u, 64u, 256u})
+    {
+        TokenBucketTable table(1000.0, 1000, shards);
+        const int64_t now = TokenBucketTable::now_ms();
+
+        // 1.插入：每个线程负责一段键
+        const double insert_s = run_threads(threads, [&](unsigned t)
+        {
+            for (size_t i = t; i < kKeyCount; i += threads)
+            {
+                table.try_acquire(keys[i], now);
+            }
+        });
+
+        // 2.命中：随机访问已存在的键
+        const double hit_s = run_threads(threads, [&](unsigned t)
+        {
+            std::mt19937_64 rng(t);
+            const size_t ops = kHitOps / threads;
+            for (size_t i = 0; i < ops; ++i)
+            {
+                table.try_acquire(keys[rng() % kKeyCount], now);
+            }
+        });
+
+        // 3.淘汰：全部键空闲
+        const auto evict_start = std::chrono::steady_clock::now();
+        const size_t evicted = table.evict_idle(now + 3600 * 1000, 1000);
+        const double evict_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - evict_start).count();
+
+        std::printf("shards=%-4u threads=%u insert: %.1f ns/key (%.2f Mops/s)  hit: %.1f ns/op (%.2f Mops/s)  "
+                    "evict %zu keys: %.1f ms\n",
+                    shards, threads,
+                    insert_s * 1e9 / kKeyCount * threads, kKeyCount / insert_s / 1e6,
+                    hit_s * 1e9 / kHitOps * threads, kHitOps / hit_s / 1e6,
+                    evicted, evict_s * 1e3);
+    }
+    return 0;
+}
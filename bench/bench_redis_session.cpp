@@ -0,0 +1,179 @@
+// Redis会话存储基准测试：逐条命令的旧写法与单次往返的store/load/load_and_refresh对比，
+// 报告每个操作的网络往返次数与延迟分位数；只读页面访问经SessionManager时每次访问的写入往返数；
+// 以及200件商品的购物车会话在Blob与Fields两种布局下"读user_id、改一个标记"的开销。需要一个可访问的Redis
+// 用法：bench_redis_session [host] [port] [次数]
+#include "session/db_storage.h"
+#include "session/session_codec.h"
+#include "session/session_manager.h"
+#include "db_pool/redis_pool.h"
+#include "log/http_logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace zhttp;
+using namespace zhttp::zsession;
+
+namespace
+{
+    // 对op计时iterations次，打印每次的平均往返数与p50/p99延迟
+    template<typename F>
+    void measure(const char *name, const size_t iterations, F &&op)
+    {
+        std::vector<double> latencies;
+        latencies.reserve(iterations);
+        const uint64_t round_trips = zdb::RedisConnection::round_trips();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            op(i);
+            latencies.push_back(std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - start).count());
+        }
+        const double per_op = static_cast<double>(zdb::RedisConnection::round_trips() - round_trips) / iterations;
+
+        std::sort(latencies.begin(), latencies.end());
+        const auto percentile = [&latencies](const double p)
+        {
+            return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+        };
+        std::printf("%-34s round_trips/op=%.2f  p50=%7.1f us  p99=%7.1f us\n",
+                    name, per_op, percentile(0.50), percentile(0.99));
+    }
+
+    std::string session_id(const size_t i)
+    {
+        return "bench_redis_session_" + std::to_string(i % 1000);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Log::Init(zlog::LogLevel::value::WARNING);
+    const std::string host = argc > 1 ? argv[1] : "127.0.0.1";
+    const int port = argc > 2 ? std::atoi(argv[2]) : 6379;
+    const size_t iterations = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20000;
+
+    auto &pool = zdb::RedisConnectionPool::get_instance();
+    try
+    {
+        pool.init(host, port, "", 0, 4, 2000);
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "cannot connect to Redis at %s:%d: %s\n", host.c_str(), port, e.what());
+        return 1;
+    }
+
+    DbSessionStorage storage;
+    const auto make_session = [](const size_t i)
+    {
+        auto session = std::make_shared<Session>(session_id(i));
+        session->set_attribute("user_id", std::to_string(i));
+        session->set_attribute("role", "member");
+        return session;
+    };
+
+    // 改造前的命令序列：HSET、HSET、EXPIRE三次往返写入；EXISTS、HGETALL两次往返读取，再整体写回刷新
+    measure("legacy store (hset+hset+expire)", iterations, [&](const size_t i)
+    {
+        const auto session = make_session(i);
+        const auto conn = pool.get_connection();
+        const std::string key = "session:" + session->get_session_id();
+        const auto expiry = std::chrono::duration_cast<std::chrono::seconds>(
+                session->get_expiry_time().time_since_epoch()).count();
+        conn->hset(key, "attributes", session->get_attributes_json().dump());
+        conn->hset(key, "expiry", std::to_string(expiry));
+        conn->expire(key, std::chrono::seconds(3600));
+    });
+    measure("legacy load (exists+hgetall)", iterations, [&](const size_t i)
+    {
+        const auto conn = pool.get_connection();
+        const std::string key = "session:" + session_id(i);
+        if (conn->exists(key))
+        {
+            conn->hgetall(key);
+        }
+    });
+
+    measure("store (MULTI/EXEC pipelined)", iterations, [&](const size_t i)
+    {
+        storage.store(make_session(i));
+    });
+    measure("load (hgetall)", iterations, [&](const size_t i)
+    {
+        storage.load(session_id(i));
+    });
+    measure("load + refresh + store", iterations, [&](const size_t i)
+    {
+        if (const auto session = storage.load(session_id(i)))
+        {
+            session->refresh();
+            storage.store(session);
+        }
+    });
+    storage.load_and_refresh(session_id(0)); // 预先加载脚本
+    measure("load_and_refresh (evalsha)", iterations, [&](const size_t i)
+    {
+        storage.load_and_refresh(session_id(i));
+    });
+
+    // 只读页面访问：1000个会话轮流访问，改造前每次访问都刷新并写回，现在由后台合并刷新过期时间
+    auto &manager = SessionManager::get_instance();
+    manager.set_session_storage(std::make_shared<DbSessionStorage>());
+    const uint64_t before_views = zdb::RedisConnection::round_trips();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        HttpRequest request;
+        request.set_header("Cookie", "session_id=" + session_id(i));
+        HttpResponse response;
+        manager.update_session(manager.get_session(request, &response));
+    }
+    manager.set_session_storage(std::make_shared<InMemoryStorage>()); // 写回待刷新的过期时间
+    const uint64_t view_round_trips = zdb::RedisConnection::round_trips() - before_views;
+    // 每次访问一次读取；其余为合并后的过期时间写入，每个会话每个刷新间隔至多一次
+    std::printf("read-only page views: %zu views over 1000 sessions, round_trips/view=%.3f, "
+                "expiry writes/view=%.3f (previously 1 write per view)\n",
+                iterations, static_cast<double>(view_round_trips) / iterations,
+                static_cast<double>(view_round_trips - iterations) / iterations);
+
+    // 大购物车会话：只读user_id并修改一个标记
+    for (const auto layout : {RedisSessionLayout::Blob, RedisSessionLayout::Fields})
+    {
+        DbSessionStorage cart_storage(layout, {"user_id"});
+        auto cart = std::make_shared<Session>("bench_redis_cart");
+        cart->set_attribute("user_id", "2048");
+        for (int i = 0; i < 200; ++i)
+        {
+            cart->set_attribute("cart:" + std::to_string(i),
+                                R"({"sku":"SKU-)" + std::to_string(100000 + i) + R"(","qty":1})");
+        }
+        cart_storage.store(cart);
+
+        const bool fields = layout == RedisSessionLayout::Fields;
+        measure(fields ? "cart read user_id + set flag (fields)" : "cart read user_id + set flag (blob)",
+                iterations / 10, [&](const size_t i)
+        {
+            const auto session = cart_storage.load("bench_redis_cart");
+            if (session && !session->get_attribute("user_id").empty())
+            {
+                session->set_attribute("flag", std::to_string(i));
+                cart_storage.store(session);
+            }
+        });
+        // 每次请求读写的属性数据量：Blob布局整体读写编码后的属性，Fields布局只读写两个字段
+        std::printf("    attribute bytes per request: %zu\n",
+                    fields ? std::strlen("2048") + std::to_string(iterations).size()
+                           : 2 * SessionCodec::encode(*cart).size());
+        cart_storage.remove("bench_redis_cart");
+    }
+
+    for (size_t i = 0; i < std::min<size_t>(iterations, 1000); ++i)
+    {
+        storage.remove(session_id(i));
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+// 正则路由基准测试：逐个std::regex_match与组合自动机RegexSet对比，10/100/1000条路由
+#include "router/regex_set.h"
+#include <chrono>
+#include <cstdio>
+#include <regex>
+#include <string>
+#include <vector>
+
+using zhttp::zrouter::RegexSet;
+
+namespace
+{
+    template<typename F>
+    double ns_per_op(const size_t ops, F &&fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ops; ++i)
+        {
+            fn(i);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops;
+    }
+}
+
+int main()
+{
+    for (const size_t count : {10u, 100u, 1000u})
+    {
+        std::vector<std::regex> regexes;
+        RegexSet set;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const std::string pattern = "^/v[0-9]+/svc" + std::to_string(i) + "/items/([^/]+)\\.(json|xml)$";
+            regexes.emplace_back(pattern);
+            set.add(pattern);
+        }
+
+        // 命中最后一条路由（逐个匹配的最坏情况）与完全未命中
+        const std::string hit = "/v2/svc" + std::to_string(count - 1) + "/items/12345.json";
+        const std::string miss = "/v2/unknown/items/12345.json";
+        const size_t ops = count >= 1000 ? 2000 : 20000;
+        size_t sink = 0;
+
+        for (const auto &[label, path] : {std::make_pair("hit ", &hit), std::make_pair("miss", &miss)})
+        {
+            const double linear = ns_per_op(ops, [&](size_t)
+            {
+                for (const auto &regex : regexes)
+                {
+                    if (std::smatch match; std::regex_match(*path, match, regex))
+                    {
+                        sink += match.length(1);
+                        break;
+                    }
+                }
+            });
+
+            std::vector<uint32_t> matches;
+            std::vector<RegexSet::Group> groups;
+            set.match(*path, matches); // 预热DFA缓存
+            const double combined = ns_per_op(ops * 10, [&](size_t)
+            {
+                set.match(*path, matches);
+                if (!matches.empty() && set.captures(matches.front(), *path, groups))
+                {
+                    sink += groups[0].second;
+                }
+            });
+
+            std::printf("routes=%-5zu %s  std::regex loop: %10.0f ns/op   RegexSet: %8.0f ns/op   speedup: %6.1fx\n",
+                        count, label, linear, combined, linear / combined);
+        }
+        std::printf("routes=%-5zu dfa states cached: %zu\n", count, set.dfa_states());
+        if (sink == 42) std::printf(" ");
+    }
+    return 0;
+}
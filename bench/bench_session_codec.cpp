@@ -0,0 +1,95 @@
+// 会话属性编解码基准测试：nlohmann::json与二进制编码在小会话与大购物车会话上的编码、解码吞吐与体积
+// 用法：bench_session_codec [迭代次数]
+#include "session/session_codec.h"
+#include "log/http_logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <nlohmann/json.hpp>
+
+using namespace zhttp;
+using namespace zhttp::zsession;
+
+namespace
+{
+    template<typename F>
+    double ops_per_second(const size_t iterations, F &&fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            fn();
+        }
+        return iterations / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 改造前的加载方式：解析为DOM后逐个set_attribute
+    void decode_json(const std::string &data, Session &session)
+    {
+        const nlohmann::json j = nlohmann::json::parse(data, nullptr, false);
+        for (auto it = j.begin(); it != j.end(); ++it)
+        {
+            session.set_attribute(it.key(), it.value().get<std::string>());
+        }
+    }
+
+    void run(const char *name, const Session &session, const size_t iterations)
+    {
+        const std::string json = session.get_attributes_json().dump();
+        const std::string binary = SessionCodec::encode(session);
+        size_t sink = 0;
+
+        const double json_encode = ops_per_second(iterations, [&]
+        {
+            sink += session.get_attributes_json().dump().size();
+        });
+        const double binary_encode = ops_per_second(iterations, [&]
+        {
+            sink += SessionCodec::encode(session).size();
+        });
+        const double json_decode = ops_per_second(iterations, [&]
+        {
+            Session decoded(session.get_session_id());
+            decode_json(json, decoded);
+            sink += decoded.get_attribute("user_id").size();
+        });
+        const double binary_decode = ops_per_second(iterations, [&]
+        {
+            Session decoded(session.get_session_id());
+            SessionCodec::decode(binary, decoded);
+            sink += decoded.get_attribute("user_id").size();
+        });
+
+        std::printf("%-6s json:   %6zu bytes  encode %9.0f/s  decode %9.0f/s\n",
+                    name, json.size(), json_encode, json_decode);
+        std::printf("%-6s binary: %6zu bytes  encode %9.0f/s  decode %9.0f/s  (%zu)\n",
+                    name, binary.size(), binary_encode, binary_decode, sink % 10);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Log::Init(zlog::LogLevel::value::WARNING);
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    Session small("small");
+    small.set_attribute("user_id", "1024");
+    small.set_attribute("role", "member");
+    small.set_attribute("locale", "zh-CN");
+    small.set_attribute("csrf", "c9d2f0b1a4e84f6e9a7d3b2c1e0f9a8b");
+    small.set_attribute("theme", "dark");
+    small.set_attribute("last_page", "/orders?page=3");
+    run("small", small, iterations);
+
+    // 200件商品的购物车，值中含需要JSON转义的字符
+    Session cart("cart");
+    cart.set_attribute("user_id", "2048");
+    for (int i = 0; i < 200; ++i)
+    {
+        cart.set_attribute("cart:" + std::to_string(i),
+                           R"({"sku":"SKU-)" + std::to_string(100000 + i) + R"(","qty":)" + std::to_string(i % 5 + 1) +
+                           R"(,"note":"gift\nwrap"})");
+    }
+    run("cart", cart, iterations / 50);
+    return 0;
+}
@@ -0,0 +1,120 @@
+// 会话ID过滤器基准测试：有效ID与伪造ID混合的请求下，启用过滤器前后get_session的吞吐、存储访问次数与误判率
+// 存储以内存存储加上每次load的模拟往返延迟代替Redis
+// 用法：bench_session_filter [请求数] [有效ID占比%] [模拟往返微秒]
+#include "session/session_manager.h"
+#include "log/http_logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace zhttp;
+using namespace zhttp::zsession;
+
+namespace
+{
+    // 每次load忙等一段时间，模拟远端存储的往返
+    class RemoteLikeStorage final : public SessionStorage
+    {
+    public:
+        explicit RemoteLikeStorage(const std::chrono::microseconds latency) : latency_(latency) {}
+
+        void store(const std::shared_ptr<Session> &session) override { storage_.store(session); }
+
+        std::shared_ptr<Session> load(const std::string &session_id) override
+        {
+            ++loads_;
+            const auto until = std::chrono::steady_clock::now() + latency_;
+            while (std::chrono::steady_clock::now() < until)
+            {
+            }
+            return storage_.load(session_id);
+        }
+
+        bool remove(const std::string &session_id) override { return storage_.remove(session_id); }
+
+        void clear_expired() override { storage_.clear_expired(); }
+
+        bool for_each_session_id(const std::function<void(const std::string &)> &fn) override
+        {
+            return storage_.for_each_session_id(fn);
+        }
+
+        std::atomic<size_t> loads_{0};
+
+    private:
+        std::chrono::microseconds latency_;
+        InMemoryStorage storage_;
+    };
+
+    void run(const char *name, const std::vector<HttpRequest> &requests, RemoteLikeStorage &storage)
+    {
+        auto &mgr = SessionManager::get_instance();
+        const size_t loads_before = storage.loads_;
+        size_t found = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto &request : requests)
+        {
+            HttpResponse response;
+            found += mgr.get_session(request, &response)->is_lazy() ? 0 : 1;
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-10s %9.0f req/s  storage loads %7zu  sessions found %7zu\n",
+                    name, requests.size() / seconds, storage.loads_ - loads_before, found);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Log::Init(zlog::LogLevel::value::WARNING);
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const int valid_percent = argc > 2 ? std::atoi(argv[2]) : 50;
+    const auto latency = std::chrono::microseconds(argc > 3 ? std::atoi(argv[3]) : 20);
+
+    constexpr size_t kLiveSessions = 100000;
+    auto storage = std::make_shared<RemoteLikeStorage>(latency);
+    std::vector<std::string> live;
+    for (size_t i = 0; i < kLiveSessions; ++i)
+    {
+        live.push_back(SessionIdGenerator::generate());
+        auto session = std::make_shared<Session>(live.back());
+        session->set_attribute("user_id", std::to_string(i));
+        storage->store(session);
+    }
+
+    // 按占比混合有效ID与伪造ID
+    std::mt19937_64 rng(42);
+    std::vector<HttpRequest> requests(count);
+    for (auto &request : requests)
+    {
+        const bool valid = static_cast<int>(rng() % 100) < valid_percent;
+        request.set_header("Cookie", "session_id=" + (valid ? live[rng() % live.size()] : SessionIdGenerator::generate()));
+    }
+
+    auto &mgr = SessionManager::get_instance();
+    mgr.set_session_storage(storage);
+    run("no filter", requests, *storage);
+
+    SessionFilterConfig config;
+    config.capacity_ = kLiveSessions;
+    config.rebuild_interval_ = std::chrono::seconds(0);
+    mgr.enable_session_filter(config);
+    while (mgr.session_filter_stats()->rebuilds_ == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    run("filter", requests, *storage);
+
+    const auto stats = *mgr.session_filter_stats();
+    std::printf("filter: %zu ids, rejected %llu of %llu checks, false positives %llu, "
+                "observed fp %.3f%%, estimated fp %.3f%%\n",
+                stats.entries_, static_cast<unsigned long long>(stats.rejected_),
+                static_cast<unsigned long long>(stats.checks_),
+                static_cast<unsigned long long>(stats.false_positives_),
+                stats.observed_fp_rate_ * 100, stats.estimated_fp_rate_ * 100);
+    mgr.disable_session_filter();
+    return 0;
+}
@@ -0,0 +1,107 @@
+// 内存会话存储基准测试：500万活跃会话下多线程load/store吞吐，以及少量会话过期时clear_expired的耗时
+// 用法：bench_session_storage [会话数] [线程数]
+#include "session/memory_storage.h"
+#include "log/http_logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace zhttp;
+using namespace zhttp::zsession;
+
+namespace
+{
+    std::string session_id(const size_t i)
+    {
+        char buf[40];
+        std::snprintf(buf, sizeof(buf), "%016zx%016zx", static_cast<size_t>(i * 0x9E3779B97F4A7C15ULL), i);
+        return buf;
+    }
+
+    template<typename F>
+    double seconds(F &&fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template<typename F>
+    void parallel(const unsigned threads, F &&fn)
+    {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            workers.emplace_back(fn, t);
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Log::Init(zlog::LogLevel::value::WARNING);
+    const size_t sessions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+    const unsigned threads = argc > 2 ? std::atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+    InMemoryStorage storage;
+
+    // 多线程写入全部会话
+    const double fill = seconds([&]
+    {
+        parallel(threads, [&](const unsigned t)
+        {
+            for (size_t i = t; i < sessions; i += threads)
+            {
+                auto session = std::make_shared<Session>(session_id(i));
+                session->set_attribute("user_id", std::to_string(i));
+                storage.store(session);
+            }
+        });
+    });
+    std::printf("sessions=%zu threads=%u  fill: %.2f s (%.0f stores/s)\n",
+                storage.size(), threads, fill, sessions / fill);
+
+    // 混合负载：每个请求load一次，十分之一的请求刷新后store
+    constexpr size_t ops_per_thread = 2000000;
+    const double mixed = seconds([&]
+    {
+        parallel(threads, [&](const unsigned t)
+        {
+            std::mt19937_64 rng(t);
+            for (size_t i = 0; i < ops_per_thread; ++i)
+            {
+                const auto session = storage.load(session_id(rng() % sessions));
+                if (session && i % 10 == 0)
+                {
+                    session->refresh();
+                    storage.store(session);
+                }
+            }
+        });
+    });
+    std::printf("mixed load/store: %.0f ops/s\n", ops_per_thread * threads / mixed);
+
+    // 让1%的会话过期，清理只应访问这些会话
+    const size_t expire_count = sessions / 100;
+    for (size_t i = 0; i < expire_count; ++i)
+    {
+        if (auto session = storage.load(session_id(i * 100)))
+        {
+            session->set_expiry_time(std::chrono::system_clock::now() - std::chrono::seconds(1));
+            storage.store(session);
+        }
+    }
+    const double cleanup = seconds([&] { storage.clear_expired(); });
+    std::printf("clear_expired: removed %zu of %zu in %.1f ms\n", sessions - storage.size(), sessions, cleanup * 1000);
+
+    const double idle_cleanup = seconds([&] { storage.clear_expired(); });
+    std::printf("clear_expired with nothing due: %.3f ms\n", idle_cleanup * 1000);
+    return 0;
+}
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 #include <sw/redis++/redis++.h>
@@ -9,6 +12,13 @@
 
 namespace zhttp::zdb
 {
+    // 一次脚本调用的参数
+    struct ScriptCall
+    {
+        std::vector<std::string> keys_;
+        std::vector<std::string> args_;
+    };
+
     class RedisConnection
     {
     public:
@@ -43,11 +53,38 @@ namespace zhttp::zdb
         std::unordered_map<std::string, std::string> hgetall(const std::string &key) const;
         void expire(const std::string &key, std::chrono::seconds ttl) const;
         std::vector<std::string> scan_keys(const std::string &pattern, size_t count = 100) const;
+        void publish(const std::string &channel, const std::string &message) const;
+
+        std::vector<std::optional<std::string>> hmget(const std::string &key,
+                                                      const std::vector<std::string> &fields) const;
+
+        // 在一次往返中以MULTI/EXEC写入多个字段、删除removed_fields并设置过期时间
+        void hset_expire(const std::string &key, const std::unordered_map<std::string, std::string> &fields,
+                         std::chrono::seconds ttl, const std::vector<std::string> &removed_fields = {}) const;
+
+        // 执行Lua脚本，返回扁平的字符串数组；按SHA1调用，服务器上没有该脚本时加载后重试
+        std::vector<std::string> eval(const std::string &script, const std::vector<std::string> &keys,
+                                      const std::vector<std::string> &args) const;
+
+        // 以流水线发出多次脚本调用，只等待一次回复；返回各调用的整数结果
+        std::vector<long long> eval_pipelined(const std::string &script, const std::vector<ScriptCall> &calls) const;
+
+        // 进程内全部Redis连接累计的网络往返次数，用于基准测试与监控
+        static uint64_t round_trips() { return round_trips_.load(std::memory_order_relaxed); }
+
+        // 创建订阅者，占用一条独立连接；consume()在socket超时后抛出TimeoutError，便于调用方检查退出条件
+        sw::redis::Subscriber subscriber() const;
 
     private:
         // 辅助连接并配置
         void connect_helper();
 
+        // 记一次网络往返
+        static void count_round_trip() { round_trips_.fetch_add(1, std::memory_order_relaxed); }
+
+        // 取脚本的SHA1，首次使用时加载到服务器，调用方持有mutex_
+        const std::string &script_sha(const std::string &script, bool reload) const;
+
     private:
         std::unique_ptr<sw::redis::Redis> redis_{}; // Redis连接
         std::string host_;
@@ -56,5 +93,7 @@ namespace zhttp::zdb
         int db_;
         int timeout_ms_;
         mutable std::mutex mutex_;
+        mutable std::unordered_map<std::string, std::string> script_shas_; // 脚本 -> SHA1
+        static inline std::atomic<uint64_t> round_trips_{0};
     };
 } // namespace zhttp::zdb
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <muduo/net/Channel.h>
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThreadPool.h>
+#include <muduo/net/InetAddress.h>
+#include <muduo/net/TcpConnection.h>
+#include <muduo/net/TcpServer.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace zhttp
+{
+    // 新连接分配IO线程的策略
+    enum class LoopPolicy
+    {
+        RoundRobin, // 轮询，与muduo::net::TcpServer一致
+        LeastLoaded // 选择负载分数最低的loop
+    };
+
+    /* 单个IO线程的负载统计。
+       连接数由接收线程维护，排队字节与忙碌时间由所属IO线程维护，
+       接收线程只读取，全部使用relaxed原子操作 */
+    class LoopLoad
+    {
+    public:
+        static constexpr double kQueuedBytesUnit = 64 * 1024; // 每64KB待发送数据计1分
+        static constexpr double kBusyWeight = 100;            // 满负荷忙碌相当于100个空闲连接
+
+        void add_connection(const int64_t delta) { connections_.fetch_add(delta, std::memory_order_relaxed); }
+
+        void add_queued_bytes(const int64_t delta) { queued_bytes_.fetch_add(delta, std::memory_order_relaxed); }
+
+        void add_busy(const int64_t ns) { busy_ns_.fetch_add(ns, std::memory_order_relaxed); }
+
+        // 在所属loop中定时调用：把本窗口的忙碌时间折算为忙碌比例并做指数平滑
+        void sample(int64_t window_ns);
+
+        // 负载分数，越小越空闲
+        double score() const;
+
+        int64_t connections() const { return connections_.load(std::memory_order_relaxed); }
+
+        int64_t queued_bytes() const { return queued_bytes_.load(std::memory_order_relaxed); }
+
+        double busy_ratio() const { return busy_ratio_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<int64_t> connections_{0};  // 活跃连接数
+        std::atomic<int64_t> queued_bytes_{0}; // 输出缓冲区中尚未发出的字节数
+        std::atomic<int64_t> busy_ns_{0};      // 当前采样窗口内处理消息的耗时
+        std::atomic<double> busy_ratio_{0};    // 平滑后的忙碌比例 [0, 1]
+    };
+
+    /* 替代muduo::net::TcpServer的接收服务器：接口与其一致，
+       但新连接按LoopPolicy分配到IO线程，默认选择负载最低的loop。
+       TcpServer内部固定使用getNextLoop()轮询，无法替换分配策略 */
+    class BalancedTcpServer : public muduo::noncopyable
+    {
+    public:
+        using ThreadInitCallback = std::function<void(muduo::net::EventLoop *)>;
+        using AcceptFilter = std::function<bool(const sockaddr *peer)>; // 返回false时连接在accept后立即关闭
+
+        BalancedTcpServer(muduo::net::EventLoop *loop,
+                          const muduo::net::InetAddress &listen_addr,
+                          const std::string &name,
+                          muduo::net::TcpServer::Option option = muduo::net::TcpServer::kNoReusePort);
+
+        ~BalancedTcpServer();
+
+        const std::string &name() const { return name_; }
+
+        const std::string &ip_port() const { return ip_port_; }
+
+        // 以下设置需在start前调用
+        void set_thread_num(int num) const;
+
+        void set_thread_init_callback(const ThreadInitCallback &cb) { thread_init_callback_ = cb; }
+
+        void set_connection_callback(const muduo::net::ConnectionCallback &cb) { connection_callback_ = cb; }
+
+        void set_message_callback(const muduo::net::MessageCallback &cb) { message_callback_ = cb; }
+
+        void set_policy(const LoopPolicy policy) { policy_ = policy; }
+
+        // 连接过滤，在创建TcpConnection之前于接收线程中调用
+        void set_accept_filter(AcceptFilter filter) { accept_filter_ = std::move(filter); }
+
+        // 启动IO线程并开始监听
+        void start();
+
+        // 获取loop的负载统计，start之后只读，可在任意线程调用
+        LoopLoad *get_load(const muduo::net::EventLoop *loop) const;
+
+    private:
+        // 监听套接字可读
+        void handle_accept();
+
+        // 为新连接选择IO线程
+        size_t select_loop();
+
+        void new_connection(int fd, const muduo::net::InetAddress &peer_addr);
+
+        void remove_connection(const muduo::net::TcpConnectionPtr &conn);
+
+        void remove_connection_in_loop(const muduo::net::TcpConnectionPtr &conn);
+
+    private:
+        static constexpr double kSampleInterval = 0.1; // 负载采样间隔（秒）
+
+        muduo::net::EventLoop *loop_;                                   // 接收线程loop
+        const std::string name_;                                        // 服务器名称
+        std::string ip_port_;                                           // 监听地址
+        int listen_fd_;                                                 // 监听套接字
+        int idle_fd_;                                                   // 文件描述符耗尽时用于拒绝连接的占位fd
+        std::unique_ptr<muduo::net::Channel> accept_channel_;           // 监听通道
+        std::unique_ptr<muduo::net::EventLoopThreadPool> thread_pool_;  // IO线程池
+        std::vector<muduo::net::EventLoop *> loops_;                    // 全部IO线程loop
+        std::vector<std::unique_ptr<LoopLoad>> loads_;                  // 与loops_一一对应的负载统计
+        std::map<std::string, muduo::net::TcpConnectionPtr> connections_; // 只在接收线程中访问
+        ThreadInitCallback thread_init_callback_;
+        muduo::net::ConnectionCallback connection_callback_;
+        muduo::net::MessageCallback message_callback_;
+        AcceptFilter accept_filter_;
+        LoopPolicy policy_ = LoopPolicy::LeastLoaded;
+        size_t next_ = 0;           // 轮询下标
+        int64_t next_conn_id_ = 1;  // 连接编号
+        bool started_ = false;
+    };
+} // namespace zhttp
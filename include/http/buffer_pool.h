@@ -0,0 +1,40 @@
+#pragma once
+
+#include <muduo/net/Buffer.h>
+#include <memory>
+#include <vector>
+
+namespace zhttp
+{
+    /* 线程本地的Buffer缓存池：每个IO线程只运行一个loop，因此线程本地即每个loop一个池。
+       空闲连接把缓冲区还回池中，下次可读事件时再取出，不跨线程共享，无需加锁 */
+    class BufferPool
+    {
+    public:
+        using BufferPtr = std::unique_ptr<muduo::net::Buffer>;
+
+        // 获取当前线程的缓存池
+        static BufferPool &local();
+
+        // 取出一个空缓冲区
+        BufferPtr acquire();
+
+        // 归还已读空的缓冲区，池已满时直接释放
+        void release(BufferPtr buffer);
+
+        // 池中缓存的缓冲区数量
+        size_t cached() const { return buffers_.size(); }
+
+        BufferPool(const BufferPool &) = delete;
+
+        BufferPool &operator=(const BufferPool &) = delete;
+
+    private:
+        BufferPool() = default;
+
+    private:
+        static constexpr size_t kMaxCached = 1024; // 最多缓存的缓冲区数量
+        static constexpr size_t kMaxCapacity = 64 * 1024; // 超过此容量的缓冲区收缩后再缓存
+        std::vector<BufferPtr> buffers_;
+    };
+} // namespace zhttp
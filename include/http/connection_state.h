@@ -0,0 +1,33 @@
+#pragma once
+
+#include "http_context.h"
+#include "ssl/ssl_connection.h"
+#include <cstdint>
+#include <memory>
+
+namespace zhttp
+{
+    // 单个连接的统计信息
+    struct ConnectionStats
+    {
+        uint64_t requests_ = 0;       // 已处理的请求数
+        uint64_t bytes_received_ = 0; // 收到的（解密后）字节数
+        uint64_t bytes_sent_ = 0;     // 发出的（加密前）响应字节数
+    };
+
+    class LoopLoad;
+
+    /* 每个连接独有的状态：解析上下文、TLS状态与统计信息。
+       由连接的context持有，消息回调直接捕获其指针，只在所属IO线程中访问，
+       不需要全局表，也不需要加锁 */
+    struct ConnectionState
+    {
+        HttpContext context_;                       // HTTP解析上下文
+        std::unique_ptr<zssl::SslConnection> ssl_; // TLS连接，未启用SSL时为空
+        ConnectionStats stats_;                     // 连接统计
+        LoopLoad *load_ = nullptr;                  // 所属IO线程的负载统计
+        size_t queued_bytes_ = 0;                   // 已计入load_的待发送字节数
+    };
+
+    using ConnectionStatePtr = std::shared_ptr<ConnectionState>;
+} // namespace zhttp
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "http_request.h"
+#include "timing_wheel.h"
 #include <muduo/net/TcpServer.h>
 #include <string_view>
 
@@ -30,12 +31,22 @@ namespace zhttp
         // 解析是否完成
         bool is_parse_complete() const;
 
+        // 是否处于请求之间（尚未收到新请求的数据）
+        bool is_expect_request_line() const;
+
+        // 是否正在等待请求体
+        bool is_expect_body() const;
+
         // 获取HttpRequest对象
         const HttpRequest &request() const;
         HttpRequest &request();
 
         void reset();
 
+        // 设置与获取连接超时节点
+        void set_timer_entry(std::shared_ptr<TimingWheel::Entry> entry);
+        TimingWheel::Entry *timer_entry() const;
+
     private:
         // 解析请求行
         bool parse_request_line(const std::string_view &line, const muduo::Timestamp &receive_time);
@@ -49,5 +60,6 @@ namespace zhttp
     private:
         HttpRequestParseState state_ = HttpRequestParseState::ExpectRequestLine; // 当前解析状态
         HttpRequest request_;// 当前请求
+        std::shared_ptr<TimingWheel::Entry> timer_entry_; // 连接超时节点，reset时保留
     };
 }// namespace zhttp
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <any>
 #include <map>
 #include <unordered_map>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <string_view>
+#include <vector>
 #include <muduo/base/Timestamp.h>
 
 
@@ -26,6 +29,14 @@ namespace zhttp
             OPTIONS,
         };
 
+        // 路由匹配出的路径参数：名称指向路由表中常驻的字符串，值为path_中的区间，复制请求时仍然有效
+        struct PathParameter
+        {
+            std::string_view name_;
+            uint32_t offset_;
+            uint32_t length_;
+        };
+
         HttpRequest() = default;
         ~HttpRequest() = default;
     public:
@@ -42,10 +53,18 @@ namespace zhttp
         void set_version(const std::string_view &version);
         const std::string &get_version() const ;
 
-        // 设置与获取请求路径参数
+        // 设置与获取请求路径参数，未命中名称时"paramN"按位置取第N个参数
         void set_path_parameters(const std::string_view&key, const std::string_view& value);
         std::string get_path_parameters(const std::string &key) const;
 
+        // 路由匹配时追加/撤销路径参数，不复制参数值
+        void add_path_parameter(std::string_view name, size_t offset, size_t length);
+        void pop_path_parameter();
+
+        // 获取路径参数视图，指向请求路径，请求存活期间有效
+        std::string_view get_path_parameter(std::string_view key) const;
+        const std::vector<PathParameter> &get_path_parameter_list() const;
+
         // 设置与获取请求查询参数
         void set_query_parameters(const std::string_view &str);
         std::string get_query_parameters(const std::string &key) const;
@@ -66,6 +85,39 @@ namespace zhttp
         void set_content_length(uint64_t length);
         uint64_t get_content_length() const;
 
+        // 设置与获取客户端地址
+        void set_remote_address(const std::string_view &address);
+        const std::string &get_remote_address() const;
+
+        // 设置与获取请求属性：中间件写入的本请求状态（如鉴权声明），处理器直接读取，同名覆盖
+        template<typename T>
+        void set_attribute(std::string_view key, T value)
+        {
+            for (auto &[name, slot] : attributes_)
+            {
+                if (name == key)
+                {
+                    slot = std::move(value);
+                    return;
+                }
+            }
+            attributes_.emplace_back(std::string(key), std::move(value));
+        }
+
+        // 不存在或类型不符时返回nullptr
+        template<typename T>
+        const T *get_attribute(std::string_view key) const
+        {
+            for (const auto &[name, slot] : attributes_)
+            {
+                if (name == key)
+                {
+                    return std::any_cast<T>(&slot);
+                }
+            }
+            return nullptr;
+        }
+
         void swap(HttpRequest&other) noexcept;
     private:
         // url解码
@@ -75,10 +127,13 @@ namespace zhttp
         std::string path_;// 请求路径
         std::string version_;// 协议版本
         std::unordered_map<std::string, std::string> path_parameters_;// 路径参数
+        std::vector<PathParameter> path_parameter_list_; // 路由匹配出的路径参数
         std::unordered_map<std::string, std::string> query_parameters_; // 查询参数
         muduo::Timestamp receive_time_; // 接收时间
         std::map<std::string, std::string> headers_; // 请求头
         std::string content_; // 请求体
         uint64_t content_length_ = 0; // 请求体长度
+        std::string remote_address_; // 客户端地址
+        std::vector<std::pair<std::string, std::any>> attributes_; // 请求属性，通常只有几项
     };
 }// namespace zhttp
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <muduo/net/TcpServer.h>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -28,6 +29,7 @@ namespace zhttp
             NotFound = 404,
             Conflict = 409,
             RangeNotSatisfiable = 416,
+            TooManyRequests = 429,
             InternalServerError = 500,
             NotImplemented = 501,
             BadGateway = 502,
@@ -79,6 +81,10 @@ namespace zhttp
 
         bool is_keep_alive() const;
 
+        // 使用预先序列化的响应行与头部（不含结尾空行），替换已设置的响应行、头部与正文；
+        // 写出时整段拷贝，之后设置的头部（含Connection）追加在其后。预序列化的头部不能通过get_header读取
+        void set_serialized_head(std::shared_ptr<const std::string> head, StatusCode status_code);
+
         // 将响应数据写入buffer
         void append_buffer(muduo::net::Buffer *output) const;
 
@@ -87,6 +93,9 @@ namespace zhttp
 
         const std::string &get_request_origin() const;
 
+        // 响应的存活标记，响应对象销毁后失效；请求处理期间登记、稍后才可能触发的回调据此判断能否写入响应
+        std::weak_ptr<HttpResponse *> lifetime();
+
         // 获取当前时间转为RFC 1123 字符串格式
         // Day, DD Mon YYYY HH:MM:SS GMT
         static std::string to_http_date(const muduo::Timestamp &time) ;
@@ -99,6 +108,21 @@ namespace zhttp
         std::string body_;// 响应正文
         bool is_keep_alive_ = false;// 是否保持连接
         std::string request_origin_; // 请求来源
+        std::shared_ptr<const std::string> serialized_head_; // 预序列化的响应行与头部
+
+        // 存活标记不随响应复制，副本有自己的标记
+        struct Lifetime
+        {
+            Lifetime() = default;
+
+            Lifetime(const Lifetime &) {}
+
+            Lifetime &operator=(const Lifetime &) { return *this; }
+
+            std::shared_ptr<HttpResponse *> self_;
+        };
+
+        Lifetime lifetime_;
     };
 
     // 每行之间的分隔符
@@ -1,6 +1,7 @@
 #pragma once
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <thread>
 
@@ -10,8 +11,14 @@
 
 #include "http_request.h"
 #include "http_response.h"
+#include "http_context.h"
+#include "connection_state.h"
+#include "balanced_tcp_server.h"
+#include "timing_wheel.h"
 #include "middleware/middleware_chain.h"
+#include "middleware/ipfilter/ip_filter_middle.h"
 #include "router/router.h"
+#include "router/route_group.h"
 #include "ssl/ssl_context.h"
 #include "ssl/ssl_connection.h"
 
@@ -73,26 +80,93 @@ namespace zhttp
         void add_regex_route(HttpRequest::Method method, const std::string &path,
                              zrouter::Router::HandlerPtr handler) const;
 
-        // 添加中间件
+        // 注册类型化路由，如 server.Get<kUserPath>([](const HttpRequest &, HttpResponse *, uint64_t id) {...})
+        template<const char *Pattern, typename F>
+        void add_typed_route(HttpRequest::Method method, F &&handler) const
+        {
+            router_->register_typed<Pattern>(method, std::forward<F>(handler));
+        }
+
+        template<const char *Pattern, typename F>
+        void Get(F &&handler) const { add_typed_route<Pattern>(HttpRequest::Method::GET, std::forward<F>(handler)); }
+
+        template<const char *Pattern, typename F>
+        void Post(F &&handler) const { add_typed_route<Pattern>(HttpRequest::Method::POST, std::forward<F>(handler)); }
+
+        template<const char *Pattern, typename F>
+        void Put(F &&handler) const { add_typed_route<Pattern>(HttpRequest::Method::PUT, std::forward<F>(handler)); }
+
+        template<const char *Pattern, typename F>
+        void Delete(F &&handler) const
+        {
+            add_typed_route<Pattern>(HttpRequest::Method::DELETE, std::forward<F>(handler));
+        }
+
+        template<const char *Pattern, typename F>
+        void Patch(F &&handler) const
+        {
+            add_typed_route<Pattern>(HttpRequest::Method::PATCH, std::forward<F>(handler));
+        }
+
+        // 添加全局中间件，只作用于命中路由的请求
         void add_middleware(std::shared_ptr<zmiddleware::Middleware> middleware) const;
 
+        // 路由分组，中间件只作用于前缀下的路由，如 server.group("/api", {auth, cors})
+        zrouter::RouteGroup group(const std::string &prefix,
+                                  std::vector<std::shared_ptr<zmiddleware::Middleware>> middlewares = {}) const;
+
         // 添加SSL上下文
         void set_ssl_context();
 
+        // 设置连接超时，需在start前调用
+        void set_timeouts(const TimeoutConfig &timeouts);
+
+        // 空闲连接精简模式：请求间隙释放连接持有的缓冲，需在start前调用
+        void set_lean_idle(bool lean_idle);
+
+        // 设置新连接分配IO线程的策略，需在start前调用
+        void set_loop_policy(LoopPolicy policy) const;
+
+        // 设置IP黑白名单：连接在accept后即按对端地址过滤；信任X-Forwarded-For时另在路由之前按请求过滤。需在start前调用
+        void set_ip_filter(std::shared_ptr<zmiddleware::IpFilterMiddleware> filter);
+
     private:
         // 初始化
         void init(uint16_t port, const std::string &name, muduo::net::TcpServer::Option option);
 
+        // 为IO线程创建时间轮
+        void init_timing_wheel(muduo::net::EventLoop *loop);
+
+        // 获取IO线程的时间轮
+        TimingWheel *get_timing_wheel(muduo::net::EventLoop *loop);
+
+        // 根据解析进度刷新连接超时
+        void refresh_timeout(const HttpContext &context, bool has_pending) const;
+
+        // 连接进入请求间隙，释放空缓冲
+        static void enter_idle(const muduo::net::TcpConnectionPtr &conn);
+
         // 新链接建立与断开回调
         void on_connection(const muduo::net::TcpConnectionPtr &conn);
 
-        // 接受到数据回调
+        // 接受到数据回调，统计处理耗时
         void on_message(const muduo::net::TcpConnectionPtr &conn,
+                        ConnectionState &state,
                         muduo::net::Buffer *buf,
                         muduo::Timestamp receive_time);
 
+        // 解析并处理数据
+        void process_message(const muduo::net::TcpConnectionPtr &conn,
+                             ConnectionState &state,
+                             muduo::net::Buffer *buf,
+                             muduo::Timestamp receive_time);
+
+        // 把连接输出缓冲区的排队字节数同步到IO线程负载
+        static void sync_queued_bytes(const muduo::net::TcpConnectionPtr &conn, ConnectionState &state);
+
         // 得到一个完整的HTTP请求后的回调处理
         void on_request(const muduo::net::TcpConnectionPtr &conn,
+                        ConnectionState &state,
                         const zhttp::HttpRequest &request);
 
         // 中间件-路由-中间件处理
@@ -100,16 +174,20 @@ namespace zhttp
                             zhttp::HttpResponse *response) const;
 
         // 向客户端响应数据
-        void send(const muduo::net::TcpConnectionPtr &conn, muduo::net::Buffer &output);
+        static void send(const muduo::net::TcpConnectionPtr &conn, ConnectionState &state,
+                         muduo::net::Buffer &output);
 
     private:
         std::unique_ptr<muduo::net::InetAddress> listen_addr_;           // 监听地址
         std::unique_ptr<muduo::net::EventLoop> main_loop_;               // 主线程loop
-        std::unique_ptr<muduo::net::TcpServer> server_;                  // tcp server
+        std::unique_ptr<BalancedTcpServer> server_;                      // tcp server
         std::unique_ptr<zrouter::Router> router_;                        // 路由
-        std::unique_ptr<zmiddleware::MiddlewareChain> middleware_chain_; // 中间件链
         std::unique_ptr<zssl::SslContext> ssl_context_;                  // SSL上下文
-        std::unordered_map<muduo::net::TcpConnectionPtr, std::unique_ptr<zssl::SslConnection>> ssl_connections_;
+        std::unordered_map<muduo::net::EventLoop *, std::unique_ptr<TimingWheel>> timing_wheels_; // 每个IO线程的时间轮
+        std::mutex timing_wheels_mutex_; // 保护timing_wheels_
+        TimeoutConfig timeouts_; // 连接超时配置
+        bool lean_idle_ = false; // 是否启用空闲连接精简模式
+        std::shared_ptr<zmiddleware::IpFilterMiddleware> request_filter_; // 路由之前的请求级IP过滤，未启用时为空
         HttpCallback callback_;                                      // 默认回调函数
         bool is_ssl_ = false;                                        // 是否启用SSL
         inline static std::string options_path_ = "/options/method"; // OPTIONS请求的路径
@@ -169,6 +247,30 @@ namespace zhttp
             middlewares_.emplace_back(std::move(middleware));
         }
 
+        // 建造IO线程分配策略
+        void build_loop_policy(const LoopPolicy policy)
+        {
+            loop_policy_ = policy;
+        }
+
+        // 建造连接超时配置
+        void build_timeouts(const TimeoutConfig &timeouts)
+        {
+            timeouts_ = timeouts;
+        }
+
+        // 是否启用空闲连接精简模式
+        void build_lean_idle(const bool lean_idle)
+        {
+            lean_idle_ = lean_idle;
+        }
+
+        // 建造IP黑白名单
+        void build_ip_filter(std::shared_ptr<zmiddleware::IpFilterMiddleware> ip_filter)
+        {
+            ip_filter_ = std::move(ip_filter);
+        }
+
     protected:
         std::string cert_file_path_;                                                 // 证书文件路径
         std::string key_file_path_;                                                  // 私钥文件路径
@@ -179,6 +281,10 @@ namespace zhttp
         uint32_t thread_num_ = std::thread::hardware_concurrency();                  // 启动线程数
         muduo::net::TcpServer::Option option_ = muduo::net::TcpServer::kNoReusePort; // 服务器选项
         std::vector<std::shared_ptr<zmiddleware::Middleware>> middlewares_;          // 中间件列表
+        TimeoutConfig timeouts_;                                                     // 连接超时配置
+        bool lean_idle_ = false;                                                     // 空闲连接精简模式
+        LoopPolicy loop_policy_ = LoopPolicy::LeastLoaded;                           // IO线程分配策略
+        std::shared_ptr<zmiddleware::IpFilterMiddleware> ip_filter_;                 // IP黑白名单
     };
 
     // HTTP服务器建造者
@@ -218,6 +324,13 @@ namespace zhttp
             // 创建HTTP服务器实例
             auto server = std::make_unique<HttpServer>(port_, name_, use_ssl_, option_);
             server->set_thread_num(thread_num_);
+            server->set_timeouts(timeouts_);
+            server->set_lean_idle(lean_idle_);
+            server->set_loop_policy(loop_policy_);
+            if (ip_filter_)
+            {
+                server->set_ip_filter(ip_filter_);
+            }
 
             // 设置SSL上下文
             if (use_ssl_)
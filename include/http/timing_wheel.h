@@ -0,0 +1,100 @@
+#pragma once
+
+#include <muduo/net/Callbacks.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace zhttp
+{
+    // 连接超时配置（秒），0 表示不启用
+    struct TimeoutConfig
+    {
+        uint32_t idle_timeout_ = 60;   // keep-alive 空闲超时：等待下一个请求的最长时间
+        uint32_t header_timeout_ = 10; // 请求头（含TLS握手）必须在此时间内收齐，不随活动刷新
+        uint32_t body_timeout_ = 30;   // 请求体两次进展之间的最长间隔
+
+        uint32_t max_timeout() const
+        {
+            return std::max(idle_timeout_, std::max(header_timeout_, body_timeout_));
+        }
+    };
+
+    /* 每个IO线程一个哈希时间轮：槽位为侵入式双向链表，
+       更新超时只需摘链与挂链，O(1)；每秒推进一个槽位并关闭其中到期的连接。
+       时间轮只能在所属loop线程中使用 */
+    class TimingWheel
+    {
+    public:
+        enum class TimeoutType
+        {
+            Idle,
+            Header,
+            Body
+        };
+
+        // 时间轮节点，由连接持有
+        struct Entry
+        {
+            Entry() = default;
+
+            Entry(std::weak_ptr<muduo::net::TcpConnection> conn, TimingWheel *wheel)
+                : conn_(std::move(conn)), wheel_(wheel) {}
+
+            ~Entry();
+
+            Entry(const Entry &) = delete;
+
+            Entry &operator=(const Entry &) = delete;
+
+            std::weak_ptr<muduo::net::TcpConnection> conn_; // 所属连接
+            TimingWheel *wheel_ = nullptr; // 所属时间轮
+            Entry *prev_ = nullptr;
+            Entry *next_ = nullptr;
+            uint64_t deadline_ = 0; // 到期的tick
+            TimeoutType type_ = TimeoutType::Idle;
+            bool linked_ = false; // 是否挂在时间轮上
+        };
+
+        using ExpireCallback = std::function<void(Entry &)>;
+
+        // max_timeout为最大超时秒数，槽位数取不小于max_timeout+2的2的幂
+        TimingWheel(uint32_t max_timeout, ExpireCallback cb);
+
+        ~TimingWheel();
+
+        TimingWheel(const TimingWheel &) = delete;
+
+        TimingWheel &operator=(const TimingWheel &) = delete;
+
+        // 重新设置节点的超时，timeout为0时仅移除
+        void update(Entry *entry, uint32_t timeout, TimeoutType type);
+
+        // 从时间轮中移除节点
+        void remove(Entry *entry);
+
+        // 推进一个tick（1秒），触发到期节点的回调
+        void tick();
+
+        // 超时类型名称
+        static const char *type_name(TimeoutType type);
+
+        // 当前挂入的节点数
+        size_t size() const { return size_; }
+
+    private:
+        // 链表操作
+        static void link(Entry *head, Entry *entry);
+
+        static void unlink(Entry *entry);
+
+    private:
+        std::vector<Entry> slots_; // 每个槽位的哨兵节点
+        size_t mask_;
+        uint64_t current_tick_ = 0;
+        size_t size_ = 0;
+        ExpireCallback expire_callback_;
+    };
+} // namespace zhttp
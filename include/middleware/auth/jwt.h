@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include "utils/base64url.h"
+
+typedef struct evp_pkey_st EVP_PKEY;
+
+namespace zhttp::zmiddleware
+{
+    // 支持的签名算法
+    enum class JwtAlgorithm
+    {
+        RS256,
+        ES256
+    };
+
+    // 令牌验证结果
+    enum class JwtStatus
+    {
+        Ok,
+        Malformed,            // 格式错误：分段、base64url或JSON
+        UnsupportedAlgorithm, // 非RS256/ES256，包括"none"
+        UnknownKey,           // 没有与kid及算法匹配的公钥
+        BadSignature,
+        Expired,
+        NotYetValid,
+        BadIssuer,
+        BadAudience
+    };
+
+    const char *to_string(JwtStatus status);
+
+    // 验证通过的声明，解析一次后在缓存与处理器之间共享
+    struct JwtClaims
+    {
+        std::string subject_;     // sub
+        std::string issuer_;      // iss
+        std::string key_id_;      // 签名所用公钥的kid
+        int64_t expires_at_ = 0;  // exp，0表示没有
+        int64_t not_before_ = 0;  // nbf，0表示没有
+        int64_t issued_at_ = 0;   // iat，0表示没有
+        nlohmann::json payload_;  // 全部声明
+
+        // 读取字符串声明，不存在或类型不符时返回空串
+        std::string get_string(const std::string &name) const;
+    };
+
+    // 一个公钥
+    struct Jwk
+    {
+        std::string key_id_;
+        JwtAlgorithm algorithm_;
+        std::shared_ptr<EVP_PKEY> key_;
+    };
+
+    /* JWKS公钥集合，按kid索引。构建后只读，可被多个线程同时用于验证 */
+    class JwkSet
+    {
+    public:
+        // 解析JWKS文档，跳过不支持或格式错误的密钥；文档本身不是合法JSON时返回nullptr
+        static std::unique_ptr<JwkSet> parse(std::string_view document, size_t *skipped = nullptr);
+
+        // 查找公钥，kid为空时返回唯一一把算法匹配的密钥
+        const Jwk *find(std::string_view key_id, JwtAlgorithm algorithm) const;
+
+        size_t size() const { return keys_.size(); }
+
+    private:
+        std::unordered_map<std::string, Jwk> keys_;
+    };
+
+    /* 无状态的JWT验证：分段、base64url解码、签名校验与标准声明检查 */
+    class JwtVerifier
+    {
+    public:
+        // 接受的NumericDate绝对值上限（9999-12-31T23:59:59Z），超出的令牌视为格式错误，时间运算不会溢出
+        static constexpr int64_t kMaxNumericDate = 253402300799;
+
+        struct Options
+        {
+            std::string issuer_;
+            std::string audience_;
+            int64_t leeway_ = 0; // 取值[0, kMaxNumericDate]
+            bool require_exp_ = true;
+        };
+
+        // leeway_超出范围时抛出std::invalid_argument
+        explicit JwtVerifier(Options options);
+
+        // 验证令牌，now为Unix时间（秒），成功时写出claims
+        JwtStatus verify(std::string_view token, const JwkSet &keys, int64_t now,
+                         std::shared_ptr<const JwtClaims> &claims) const;
+
+        // 只检查时间相关声明，供缓存命中时复核
+        JwtStatus check_time(const JwtClaims &claims, int64_t now) const;
+
+    private:
+        Options options_;
+    };
+
+    namespace jwt
+    {
+        // base64url编解码，实现见utils/base64url.h
+        using zutils::base64url_decode;
+        using zutils::base64url_encode;
+    } // namespace jwt
+} // namespace zhttp::zmiddleware
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace zhttp::zmiddleware
+{
+    struct JwtConfig
+    {
+        std::string jwks_file_;               // JWKS文件路径（{"keys":[...]}），支持RS256与ES256公钥
+        uint32_t reload_interval_ = 30;       // 检查JWKS文件变化的间隔（秒），0表示不自动重载
+        std::string issuer_;                  // 要求的iss，空表示不检查
+        std::string audience_;                // 要求的aud（字符串或数组中包含即可），空表示不检查
+        uint32_t leeway_ = 30;                // exp/nbf允许的时钟偏差（秒）
+        bool require_exp_ = true;             // 是否要求令牌带exp
+        bool optional_ = false;               // 没有Authorization头时放行（不写入声明），带了无效令牌仍拒绝
+        size_t cache_capacity_ = 100000;      // 验证结果缓存的总容量，0表示不缓存
+        uint32_t cache_shard_count_ = 16;     // 缓存分片数量（向上取整为2的幂）
+
+        static JwtConfig default_config()
+        {
+            return {};
+        }
+    };
+} // namespace zhttp::zmiddleware
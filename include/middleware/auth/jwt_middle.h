@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include "../middleware.h"
+#include "jwt.h"
+#include "jwt_config.h"
+#include "verified_token_cache.h"
+
+namespace zhttp::zmiddleware
+{
+    /* JWT Bearer令牌鉴权中间件。
+       令牌用JWKS中的RS256/ES256公钥验签，验证结果按令牌摘要缓存到exp，同一令牌的后续请求不再验签。
+       验证通过的声明写入请求属性kClaimsKey（洋葱式调用时同时写入MiddlewareContext），
+       处理器用JwtAuthMiddleware::claims(request)读取，无需再次解析。
+       JWKS文件由后台线程按修改时间检查并热加载，密钥集原子替换，替换后旧的缓存结果全部失效 */
+    class JwtAuthMiddleware final : public Middleware
+    {
+    public:
+        static constexpr std::string_view kClaimsKey = "jwt.claims";
+
+        explicit JwtAuthMiddleware(JwtConfig config = JwtConfig::default_config());
+
+        ~JwtAuthMiddleware() override;
+
+        // 洋葱式处理：鉴权失败时写入401并短路
+        void handle(MiddlewareContext &context, const Next &next) override
+        {
+            process(context, next);
+        }
+
+        // 供静态管线内联调用，见pipeline.h
+        template<typename NextFn>
+        void process(MiddlewareContext &context, NextFn &&next)
+        {
+            const JwtStatus status = authenticate(context.request());
+            if (status != JwtStatus::Ok)
+            {
+                reject(context.request(), context.response(), status);
+                return;
+            }
+            if (const auto *claims = context.request().get_attribute<std::shared_ptr<const JwtClaims>>(kClaimsKey))
+            {
+                context.set(kClaimsKey, *claims);
+            }
+            next();
+        }
+
+        // 请求前处理：鉴权失败时以抛出401响应的方式短路
+        void before(HttpRequest &request) override;
+
+        void after(HttpResponse &response) override;
+
+        // 校验请求的Authorization头，通过时把声明写入请求属性
+        JwtStatus authenticate(HttpRequest &request);
+
+        // 校验令牌，先查缓存
+        JwtStatus verify(std::string_view token, std::shared_ptr<const JwtClaims> &claims);
+
+        // 从JWKS文件重新加载密钥，文件无法读取或不是合法JWKS时返回false且保留原密钥
+        bool reload();
+
+        // 直接替换密钥集
+        void set_keys(std::unique_ptr<JwkSet> keys);
+
+        size_t key_count() const;
+
+        size_t cached_tokens() const { return cache_ ? cache_->size() : 0; }
+
+        // 读取请求上验证通过的声明，未鉴权时返回nullptr
+        static const JwtClaims *claims(const HttpRequest &request);
+
+    private:
+        // 写入401响应
+        static void reject(const HttpRequest &request, HttpResponse &response, JwtStatus status);
+
+        // 后台检查JWKS文件变化
+        void watch_loop();
+
+        // JWKS文件的修改时间，无法访问时为-1
+        int64_t file_mtime() const;
+
+    private:
+        JwtConfig config_;
+        JwtVerifier verifier_;
+        std::unique_ptr<VerifiedTokenCache> cache_;  // cache_capacity_为0时为空
+        std::atomic<const JwkSet *> keys_{nullptr};  // 当前密钥集，替换后由EpochDomain回收
+        std::atomic<uint64_t> generation_{0};        // 密钥集代数，每次替换加一
+        std::mutex reload_mutex_;
+        int64_t loaded_mtime_ = -1;                  // 已加载文件的修改时间，受reload_mutex_保护
+        std::thread watch_thread_;
+        std::mutex watch_mutex_;
+        std::condition_variable watch_cv_;
+        bool stop_ = false;
+    };
+} // namespace zhttp::zmiddleware
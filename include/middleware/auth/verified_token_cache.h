@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include "jwt.h"
+
+namespace zhttp::zmiddleware
+{
+    /* 已验证令牌的分片LRU缓存。
+       键为令牌的SHA-256摘要，避免保存令牌原文，也不会因哈希碰撞把伪造令牌当成已验证；
+       条目在令牌失效时刻（exp加容差）之后视为未命中，并记录写入时的密钥集代数，JWKS替换后旧条目自动失效 */
+    class VerifiedTokenCache
+    {
+    public:
+        using Digest = std::array<uint8_t, 32>;
+
+        VerifiedTokenCache(size_t capacity, uint32_t shard_count);
+
+        VerifiedTokenCache(const VerifiedTokenCache &) = delete;
+
+        VerifiedTokenCache &operator=(const VerifiedTokenCache &) = delete;
+
+        static Digest digest(std::string_view token);
+
+        // 查找，过期或代数不符的条目被删除并返回nullptr
+        std::shared_ptr<const JwtClaims> find(const Digest &key, int64_t now, uint64_t generation);
+
+        // 写入，valid_until为条目失效的Unix时间（秒）
+        void insert(const Digest &key, std::shared_ptr<const JwtClaims> claims, int64_t valid_until,
+                    uint64_t generation);
+
+        void clear();
+
+        size_t size() const;
+
+    private:
+        struct DigestHash
+        {
+            size_t operator()(const Digest &digest) const
+            {
+                size_t hash;
+                std::memcpy(&hash, digest.data(), sizeof(hash));
+                return hash;
+            }
+        };
+
+        struct Entry
+        {
+            Digest key_;
+            std::shared_ptr<const JwtClaims> claims_;
+            int64_t valid_until_;
+            uint64_t generation_;
+        };
+
+        struct alignas(64) Shard
+        {
+            mutable std::mutex mutex_;
+            std::list<Entry> lru_; // 头部最近使用
+            std::unordered_map<Digest, std::list<Entry>::iterator, DigestHash> index_;
+        };
+
+        Shard &shard_for(const Digest &key) const;
+
+    private:
+        size_t shard_capacity_;
+        size_t shard_mask_;
+        std::unique_ptr<Shard[]> shards_;
+    };
+} // namespace zhttp::zmiddleware
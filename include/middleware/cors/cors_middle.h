@@ -3,6 +3,7 @@
 #include "http/http_request.h"
 #include "http/http_response.h"
 #include "cors_config.h"
+#include "cors_policy.h"
 
 namespace zhttp::zmiddleware
 {
@@ -11,7 +12,27 @@ namespace zhttp::zmiddleware
     public:
         explicit CorsMiddleware(CorsConfig config = CorsConfig::default_config());
 
-        // 请求前处理
+        // 洋葱式处理：预检请求直接写入响应并短路
+        void handle(MiddlewareContext &context, const Next &next) override
+        {
+            process(context, next);
+        }
+
+        // 供静态管线内联调用，见pipeline.h
+        template<typename NextFn>
+        void process(MiddlewareContext &context, NextFn &&next)
+        {
+            if (is_preflight(context.request()))
+            {
+                // 预检请求直接作为最终响应，不再进入路由处理器
+                serve_preflight(context.request(), context.response());
+                return;
+            }
+            next();
+            after(context.response());
+        }
+
+        // 请求前处理：预检请求以抛出响应的方式短路，供before/after调用方使用
         void before(HttpRequest& request)override;
 
         // 响应后处理
@@ -23,17 +44,18 @@ namespace zhttp::zmiddleware
         ~CorsMiddleware() override = default;
     private:
 
-        // 检查请求源是否允许
-        bool is_origin_allowed(const std::string&origin);
+        // 是否为跨域预检请求
+        bool is_preflight(const HttpRequest &request) const;
 
-        // 处理预检请求
-        void handle_preflight_request(const HttpRequest& request, HttpResponse& response) ;
+        // 处理预检请求，以结构化头部写入response
+        void handle_preflight_request(const HttpRequest& request, HttpResponse& response) const;
 
-        // 添加CORS头部
-        void add_cors_headers(HttpResponse& response,const std::string & origin) const;
+        // 处理预检请求，优先使用预序列化的响应头
+        void serve_preflight(const HttpRequest &request, HttpResponse &response) const;
 
     protected:
         CorsConfig config_;
+        CorsPolicy policy_; // 由config_编译出的策略
 
     };
 } // namespace zhttp::zmiddleware
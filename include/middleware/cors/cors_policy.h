@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "cors_config.h"
+#include "http/http_response.h"
+
+namespace zhttp::zmiddleware
+{
+    /* 由CorsConfig一次性编译出的CORS策略。
+       精确源放入哈希表，"*.example.com"形式（可带协议前缀，如"https://"）的通配源放入按主机名倒序的后缀树；
+       拼接好的响应头值与每个精确源的预检响应（响应行+CORS头）都在构造时生成，
+       预检请求只需一次哈希查找，写出时整段拷贝 */
+    class CorsPolicy
+    {
+    public:
+        using Head = std::shared_ptr<const std::string>;
+
+        explicit CorsPolicy(const CorsConfig &config);
+
+        ~CorsPolicy();
+
+        CorsPolicy(CorsPolicy &&) noexcept;
+
+        CorsPolicy &operator=(CorsPolicy &&) noexcept;
+
+        // 源是否允许跨域
+        bool is_origin_allowed(const std::string &origin) const;
+
+        // 已允许源的预检响应头，version为"HTTP/1.0"或"HTTP/1.1"；源不允许或版本未知时返回nullptr
+        Head preflight_head(const std::string &origin, std::string_view version) const;
+
+        // 以结构化方式添加CORS头部
+        void apply_headers(HttpResponse &response, std::string_view origin) const;
+
+        // 普通跨域响应使用的Access-Control-Allow-Origin值
+        const std::string &response_origin() const { return response_origin_; }
+
+    private:
+        struct SuffixNode;
+
+        // 预检响应头中Access-Control-Allow-Origin之外的部分
+        std::string build_head(std::string_view origin, size_t version) const;
+
+        // 在后缀树中匹配通配源
+        bool match_wildcard(std::string_view origin) const;
+
+        static int version_index(std::string_view version);
+
+    private:
+        bool allow_all_ = false;                     // 允许所有源
+        std::unordered_map<std::string, std::array<Head, 2>> exact_; // 精确源 -> 预序列化的预检响应头（HTTP/1.0、1.1）
+        std::unique_ptr<SuffixNode> suffixes_;       // 通配源后缀树，按主机名倒序插入
+        std::string response_origin_;                // 普通跨域响应的Allow-Origin
+        std::vector<std::pair<std::string, std::string>> headers_; // Allow-Origin之外的CORS头部
+        std::string head_tail_;                      // 预检响应头中Allow-Origin之后的部分
+    };
+} // namespace zhttp::zmiddleware
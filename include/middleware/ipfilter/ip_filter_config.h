@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace zhttp::zmiddleware
+{
+    struct IpFilterConfig
+    {
+        bool deny_by_default_ = false;              // 没有规则匹配时是否拒绝（白名单模式）
+        std::vector<std::string> allow_;            // 允许的CIDR
+        std::vector<std::string> deny_;             // 拒绝的CIDR
+        std::string rules_file_;                    // 规则文件，每行"deny <CIDR>"、"allow <CIDR>"或单独的CIDR（拒绝），#开头为注释
+        bool trust_forwarded_for_ = false;          // 是否信任来自代理的X-Forwarded-For
+        std::vector<std::string> trusted_proxies_;  // 可信代理的CIDR
+
+        static IpFilterConfig default_config()
+        {
+            return {};
+        }
+    };
+} // namespace zhttp::zmiddleware
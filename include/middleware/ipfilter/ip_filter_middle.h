@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "../middleware.h"
+#include "ip_filter_config.h"
+#include "ip_trie.h"
+
+namespace zhttp::zmiddleware
+{
+    /* IP黑白名单中间件。
+       规则编译为IpTrie，按最长前缀匹配；新规则整体构建后原子替换，旧规则在没有读者时回收，查找不加锁。
+       连接级检查（allow_connection）在accept之后、解析之前调用，拒绝的连接直接关闭；
+       请求级检查只在信任X-Forwarded-For时有意义：对端是可信代理时，取XFF中最右侧的非代理地址作为客户端 */
+    class IpFilterMiddleware final : public Middleware
+    {
+    public:
+        explicit IpFilterMiddleware(IpFilterConfig config = IpFilterConfig::default_config());
+
+        ~IpFilterMiddleware() override;
+
+        // 洋葱式处理：客户端地址被拒绝时写入403并短路
+        void handle(MiddlewareContext &context, const Next &next) override
+        {
+            process(context, next);
+        }
+
+        // 供静态管线内联调用，见pipeline.h
+        template<typename NextFn>
+        void process(MiddlewareContext &context, NextFn &&next)
+        {
+            if (!allow_request(context.request()))
+            {
+                reject(context.request(), context.response());
+                return;
+            }
+            next();
+        }
+
+        // 请求前处理：被拒绝时以抛出403响应的方式短路
+        void before(HttpRequest &request) override;
+
+        void after(HttpResponse &response) override;
+
+        // 连接级检查，供accept之后调用
+        bool allow_connection(const sockaddr *peer) const;
+
+        // 地址是否被允许
+        bool allow_address(const IpAddress &address) const;
+
+        // 请求级检查，考虑可信代理的X-Forwarded-For
+        bool allow_request(const HttpRequest &request) const;
+
+        // 在路由之前调用的请求级检查：被拒绝时向response写入403并返回false
+        bool filter_request(const HttpRequest &request, HttpResponse &response) const;
+
+        // 从配置与规则文件重新构建规则并替换，文件无法打开时返回false且保留原规则
+        bool reload();
+
+        // 直接替换规则，发布前建立首级索引
+        void set_rules(std::unique_ptr<IpTrie> rules);
+
+        // 当前规则数量
+        size_t rule_count() const;
+
+        const IpFilterConfig &config() const { return config_; }
+
+        // 从文件追加规则，返回无法解析的行数；文件无法打开时返回-1
+        static long load_file(const std::string &path, IpTrie &trie);
+
+    private:
+        // 写入403响应
+        static void reject(const HttpRequest &request, HttpResponse &response);
+
+        // 由请求得到客户端地址
+        bool client_address(const HttpRequest &request, IpAddress &address) const;
+
+    private:
+        IpFilterConfig config_;
+        std::atomic<const IpTrie *> rules_{nullptr}; // 当前规则，替换后由EpochDomain回收
+        IpTrie proxies_;                             // 可信代理
+        std::mutex reload_mutex_;                    // 串行化规则替换
+    };
+} // namespace zhttp::zmiddleware
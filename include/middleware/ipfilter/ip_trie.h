@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+struct sockaddr;
+
+namespace zhttp::zmiddleware
+{
+    // 128位地址，IPv4按IPv4映射地址（::ffff:a.b.c.d）存放
+    struct IpAddress
+    {
+        uint64_t hi_ = 0;
+        uint64_t lo_ = 0;
+
+        // 解析"1.2.3.4"或"2001:db8::1"
+        static bool parse(std::string_view text, IpAddress &address);
+
+        // 从套接字地址构造，不支持的地址族返回false
+        static bool from_sockaddr(const sockaddr *addr, IpAddress &address);
+
+        static IpAddress from_v4(uint32_t host_order);
+
+        bool is_v4() const { return hi_ == 0 && (lo_ >> 32) == 0xffff; }
+    };
+
+    /* 路径压缩的二叉前缀树（Patricia trie），按最长前缀匹配CIDR规则。
+       节点按下标存放在连续数组中，查找只沿一条路径向下，每层一次异或与掩码比较，
+       20万条规则时深度通常不超过30层。构建完成后只读，可被多个线程同时查找。
+       compile()为IPv4地址的前16位建立直接索引（类似poptrie的首级数组），查找直接从对应子树开始，
+       省去前面十几层依赖的随机访存 */
+    class IpTrie
+    {
+    public:
+        enum class Action : uint8_t
+        {
+            None,  // 没有匹配的规则
+            Allow,
+            Deny
+        };
+
+        IpTrie();
+
+        // 插入"10.0.0.0/8"、"2001:db8::/32"或单个地址，格式错误返回false；插入会使索引失效
+        bool insert(std::string_view cidr, Action action);
+
+        // 插入前缀，length为128位地址中的前缀长度
+        void insert(const IpAddress &prefix, uint32_t length, Action action);
+
+        // 最长前缀匹配
+        Action lookup(const IpAddress &address) const;
+
+        // 建立IPv4首级索引，规则插入完毕、开始并发查找前调用
+        void compile();
+
+        // 规则数量
+        size_t size() const { return rules_; }
+
+        size_t node_count() const { return nodes_.size(); }
+
+    private:
+        struct Node
+        {
+            uint64_t hi_;
+            uint64_t lo_;
+            uint32_t child_[2]; // 子节点下标，0表示无（根节点不会成为子节点）
+            uint8_t length_;    // 前缀长度，0~128
+            Action action_;
+        };
+
+        // IPv4首级索引项：该/16块内可直接开始查找的节点，以及沿途已匹配的规则
+        struct IndexEntry
+        {
+            uint32_t node_;
+            Action best_;
+        };
+
+        static constexpr uint32_t kIndexBits = 16;
+
+        uint32_t add_node(const IpAddress &prefix, uint32_t length, Action action);
+
+    private:
+        std::vector<Node> nodes_;
+        std::vector<IndexEntry> v4_index_; // 为空表示未编译
+        size_t rules_ = 0;
+    };
+} // namespace zhttp::zmiddleware
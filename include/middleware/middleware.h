@@ -1,15 +1,44 @@
 #pragma once
 #include "http/http_request.h"
 #include "http/http_response.h"
+#include "middleware_context.h"
+#include <functional>
 #include <memory>
 
 namespace zhttp::zmiddleware
 {
+    class MiddlewareChain;
+
+    // 调用管线中的下一层，最内层为路由处理器
+    class Next
+    {
+    public:
+        using Terminal = std::function<void(MiddlewareContext &)>;
+
+        Next(const MiddlewareChain *chain, size_t index, MiddlewareContext *context, const Terminal *terminal)
+                : chain_(chain), index_(index), context_(context), terminal_(terminal)
+        {
+        }
+
+        void operator()() const;
+
+    private:
+        const MiddlewareChain *chain_;
+        size_t index_;                 // 下一层中间件的下标
+        MiddlewareContext *context_;
+        const Terminal *terminal_;
+    };
+
     class Middleware
     {
     public:
         virtual ~Middleware() = default;
 
+        /* 洋葱式处理：在next()之前处理请求，之后处理响应。
+           不调用next()即短路，直接把context.response()作为最终响应，无需抛出异常。
+           默认实现是before/after的适配器 */
+        virtual void handle(MiddlewareContext &context, const Next &next);
+
         // 请求前处理
         virtual void before(HttpRequest &request) = 0;
 
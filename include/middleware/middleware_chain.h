@@ -1,4 +1,5 @@
 #pragma once
+#include <vector>
 #include "middleware.h"
 
 namespace zhttp::zmiddleware
@@ -8,6 +9,11 @@ namespace zhttp::zmiddleware
     public:
         MiddlewareChain() = default;
 
+        explicit MiddlewareChain(std::vector<std::shared_ptr<Middleware>> middlewares)
+                : middlewares_(std::move(middlewares))
+        {
+        }
+
         ~MiddlewareChain() = default;
 
         // 添加中间件
@@ -16,6 +22,19 @@ namespace zhttp::zmiddleware
         void process_before(HttpRequest& request) const;
 
         void process_after(HttpResponse& response);
+
+        // 洋葱式执行：依次调用各中间件的handle，最内层调用terminal（路由处理器）；
+        // 中间件可不调用next()直接返回响应
+        void run(MiddlewareContext &context, const Next::Terminal &terminal) const;
+
+        // 中间件数量
+        size_t size() const { return middlewares_.size(); }
+    private:
+        friend class Next;
+
+        // 执行第index层
+        void call(size_t index, MiddlewareContext &context, const Next::Terminal &terminal) const;
+
     private:
         std::vector<std::shared_ptr<Middleware>> middlewares_; // 中间件链
     };
@@ -0,0 +1,60 @@
+#pragma once
+#include <any>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "http/http_request.h"
+#include "http/http_response.h"
+
+namespace zhttp::zmiddleware
+{
+    /* 单个请求在中间件管线中的上下文。
+       同一帧内既能看到请求也能看到响应，并可按键保存本请求的状态（如请求ID、鉴权结果）供后续中间件与处理器读取 */
+    class MiddlewareContext
+    {
+    public:
+        MiddlewareContext(HttpRequest &request, HttpResponse &response)
+                : request_(request), response_(response)
+        {
+        }
+
+        HttpRequest &request() { return request_; }
+
+        HttpResponse &response() { return response_; }
+
+        // 保存本请求的状态，同名覆盖
+        template<typename T>
+        void set(std::string_view key, T value)
+        {
+            for (auto &[name, slot] : state_)
+            {
+                if (name == key)
+                {
+                    slot = std::move(value);
+                    return;
+                }
+            }
+            state_.emplace_back(std::string(key), std::move(value));
+        }
+
+        // 读取本请求的状态，不存在或类型不符时返回nullptr
+        template<typename T>
+        T *get(std::string_view key)
+        {
+            for (auto &[name, slot] : state_)
+            {
+                if (name == key)
+                {
+                    return std::any_cast<T>(&slot);
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        HttpRequest &request_;
+        HttpResponse &response_;
+        std::vector<std::pair<std::string, std::any>> state_; // 状态通常只有几项，线性查找即可
+    };
+} // namespace zhttp::zmiddleware
@@ -0,0 +1,166 @@
+#pragma once
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "middleware.h"
+
+/* 编译期组合的中间件管线。
+   Pipeline<RequestId, Cors, Auth> 把各中间件按值存放在同一个对象中，没有逐个堆分配，
+   调用链在编译期展开，编译器可以内联每一层；运行时的MiddlewareChain仍用于动态组合。
+   每个中间件类型按以下顺序选择调用方式：
+   1.模板成员 process(MiddlewareContext &, NextFn &&next)，不调用next()即短路；
+   2.before(HttpRequest &)/after(HttpResponse &)，before可以抛出HttpResponse短路（由服务器捕获）。
+   单独的before()/after()只能用于全部中间件都提供before/after的管线，只有process的中间件无法拆成两个阶段。
+   与运行时链不同，静态管线不捕获after中的异常 */
+namespace zhttp::zmiddleware
+{
+    namespace detail
+    {
+        using NextProbe = void (*)();
+
+        template<typename M, typename = void>
+        struct has_process : std::false_type
+        {
+        };
+
+        template<typename M>
+        struct has_process<M, std::void_t<decltype(std::declval<M &>().process(
+                std::declval<MiddlewareContext &>(), std::declval<NextProbe>()))>> : std::true_type
+        {
+        };
+
+        template<typename M, typename = void>
+        struct has_before_after : std::false_type
+        {
+        };
+
+        template<typename M>
+        struct has_before_after<M, std::void_t<decltype(std::declval<M &>().before(std::declval<HttpRequest &>())),
+                decltype(std::declval<M &>().after(std::declval<HttpResponse &>()))>> : std::true_type
+        {
+        };
+
+        template<typename... Ms>
+        inline constexpr bool all_before_after = (has_before_after<Ms>::value && ...);
+    } // namespace detail
+
+    template<typename... Ms>
+    class Pipeline
+    {
+        static_assert(((detail::has_process<Ms>::value || detail::has_before_after<Ms>::value) && ...),
+                      "pipeline middleware must provide process(context, next) or before(request)/after(response)");
+
+    public:
+        Pipeline() = default;
+
+        // 访问第I个中间件，用于配置
+        template<size_t I>
+        auto &get() { return std::get<I>(middlewares_); }
+
+        // 执行管线，最内层调用terminal(context)
+        template<typename Terminal>
+        void run(MiddlewareContext &context, Terminal &&terminal)
+        {
+            call<0>(context, terminal);
+        }
+
+        // 只执行请求阶段，供before/after式的调用方使用
+        void before(HttpRequest &request)
+        {
+            static_assert(detail::all_before_after<Ms...>,
+                          "Pipeline::before requires every middleware to provide before(request)/after(response)");
+            std::apply([&request](auto &...middleware) { (middleware.before(request), ...); }, middlewares_);
+        }
+
+        // 只执行响应阶段，逆序
+        void after(HttpResponse &response)
+        {
+            static_assert(detail::all_before_after<Ms...>,
+                          "Pipeline::after requires every middleware to provide before(request)/after(response)");
+            after_from<sizeof...(Ms)>(response);
+        }
+
+        static constexpr size_t size() { return sizeof...(Ms); }
+
+    private:
+        template<size_t I, typename Terminal>
+        void call(MiddlewareContext &context, Terminal &terminal)
+        {
+            if constexpr (I == sizeof...(Ms))
+            {
+                terminal(context);
+            }
+            else
+            {
+                auto &middleware = std::get<I>(middlewares_);
+                using M = std::decay_t<decltype(middleware)>;
+                if constexpr (detail::has_process<M>::value)
+                {
+                    middleware.process(context, [this, &context, &terminal] { call<I + 1>(context, terminal); });
+                }
+                else
+                {
+                    middleware.before(context.request());
+                    call<I + 1>(context, terminal);
+                    middleware.after(context.response());
+                }
+            }
+        }
+
+        template<size_t I>
+        void after_from(HttpResponse &response)
+        {
+            if constexpr (I > 0)
+            {
+                std::get<I - 1>(middlewares_).after(response);
+                after_from<I - 1>(response);
+            }
+        }
+
+    private:
+        std::tuple<Ms...> middlewares_;
+    };
+
+    /* 把静态管线包装成一个运行时中间件，整组只有一次虚调用，
+       例如 server.add_middleware(std::make_shared<StaticMiddleware<RequestId, CorsMiddleware>>()) */
+    template<typename... Ms>
+    class StaticMiddleware final : public Middleware
+    {
+    public:
+        void handle(MiddlewareContext &context, const Next &next) override
+        {
+            pipeline_.run(context, [&next](MiddlewareContext &) { next(); });
+        }
+
+        // 虚函数总会实例化，含只有process的中间件时无法拆成两个阶段，调用即报错
+        void before(HttpRequest &request) override
+        {
+            if constexpr (detail::all_before_after<Ms...>)
+            {
+                pipeline_.before(request);
+            }
+            else
+            {
+                throw std::logic_error("static pipeline with process-only middleware must run through handle()");
+            }
+        }
+
+        void after(HttpResponse &response) override
+        {
+            if constexpr (detail::all_before_after<Ms...>)
+            {
+                pipeline_.after(response);
+            }
+            else
+            {
+                throw std::logic_error("static pipeline with process-only middleware must run through handle()");
+            }
+        }
+
+        Pipeline<Ms...> &pipeline() { return pipeline_; }
+
+    private:
+        Pipeline<Ms...> pipeline_;
+    };
+} // namespace zhttp::zmiddleware
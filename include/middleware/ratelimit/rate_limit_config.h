@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+namespace zhttp::zmiddleware
+{
+    // 限流键的来源
+    enum class RateLimitKeyType
+    {
+        IP,    // 按客户端IP限流
+        HEADER // 按指定请求头限流（如 X-Api-Key），缺失时退化为按IP
+    };
+
+    struct RateLimitConfig
+    {
+        RateLimitKeyType key_type_ = RateLimitKeyType::IP; // 限流键来源
+        std::string key_header_; // key_type_为HEADER时使用的请求头
+        double rate_ = 100.0; // 每秒补充的令牌数
+        uint32_t burst_ = 200; // 桶容量（允许的突发请求数）
+        uint32_t shard_count_ = 64; // 分片数量（向上取整为2的幂）
+        uint32_t idle_timeout_ = 300; // 空闲键淘汰时间（秒）
+        uint32_t evict_interval_ = 30; // 后台淘汰间隔（秒）
+
+        static RateLimitConfig default_config()
+        {
+            return {};
+        }
+    };
+} // namespace zhttp::zmiddleware
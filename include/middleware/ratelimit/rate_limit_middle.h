@@ -0,0 +1,67 @@
+#pragma once
+#include "../middleware.h"
+#include "rate_limit_config.h"
+#include "token_bucket_table.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace zhttp::zmiddleware
+{
+    class RateLimitMiddleware final : public Middleware
+    {
+    public:
+        explicit RateLimitMiddleware(RateLimitConfig config = RateLimitConfig::default_config());
+
+        ~RateLimitMiddleware() override;
+
+        // 洋葱式处理：令牌不足时直接写入429响应并短路
+        void handle(MiddlewareContext &context, const Next &next) override
+        {
+            process(context, next);
+        }
+
+        // 供静态管线内联调用，见pipeline.h
+        template<typename NextFn>
+        void process(MiddlewareContext &context, NextFn &&next)
+        {
+            if (!admit(context.request()))
+            {
+                reject(context.request(), context.response());
+                return;
+            }
+            next();
+        }
+
+        // 请求前处理：令牌不足时以抛出429响应的方式短路，供before/after调用方使用
+        void before(HttpRequest &request) override;
+
+        // 响应后处理
+        void after(HttpResponse &response) override;
+
+        // 获取当前跟踪的键数量
+        size_t tracked_keys() const;
+
+    private:
+        // 尝试获取令牌
+        bool admit(const HttpRequest &request);
+
+        // 写入429响应
+        void reject(const HttpRequest &request, HttpResponse &response) const;
+
+        // 从请求中提取限流键
+        std::string extract_key(const HttpRequest &request) const;
+
+        // 后台淘汰空闲键
+        void evict_loop();
+
+    private:
+        RateLimitConfig config_;
+        TokenBucketTable table_; // 分片令牌桶表
+        std::string retry_after_; // 预先计算的Retry-After值
+        std::thread evict_thread_; // 后台淘汰线程
+        std::mutex evict_mutex_;
+        std::condition_variable evict_cv_;
+        bool stop_ = false;
+    };
+} // namespace zhttp::zmiddleware
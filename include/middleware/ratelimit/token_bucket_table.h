@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace zhttp::zmiddleware
+{
+    /* 分片令牌桶表：每个键一个令牌桶，桶状态打包在一个64位原子变量中，
+       热路径只持有分片读锁并做一次CAS，只有新键插入与淘汰需要分片写锁 */
+    class TokenBucketTable
+    {
+    public:
+        TokenBucketTable(double rate, uint32_t burst, uint32_t shard_count);
+
+        ~TokenBucketTable() = default;
+
+        TokenBucketTable(const TokenBucketTable &) = delete;
+
+        TokenBucketTable &operator=(const TokenBucketTable &) = delete;
+
+        // 尝试从key对应的桶中取一个令牌，now_ms为单调时钟毫秒数
+        bool try_acquire(const std::string &key, int64_t now_ms);
+
+        // 淘汰空闲超过idle_ms的桶，返回淘汰数量
+        size_t evict_idle(int64_t now_ms, int64_t idle_ms);
+
+        // 当前键数量
+        size_t size() const;
+
+        // 获取单调时钟毫秒数
+        static int64_t now_ms();
+
+    private:
+        // 状态布局：高32位为上次补充时间（相对epoch_的毫秒），低32位为千分之一令牌数
+        struct Bucket
+        {
+            explicit Bucket(uint64_t state) : state_(state) {}
+
+            std::atomic<uint64_t> state_;
+        };
+
+        struct alignas(64) Shard
+        {
+            mutable std::shared_mutex mutex_;
+            std::unordered_map<std::string, Bucket> buckets_;
+        };
+
+        // 在已有的桶上补充并消费令牌
+        bool consume(Bucket &bucket, uint32_t now_rel) const;
+
+        // 计算相对时间
+        uint32_t relative_ms(int64_t now_ms) const;
+
+        Shard &shard_for(const std::string &key);
+
+        static uint64_t pack(uint32_t time_ms, uint32_t milli_tokens)
+        {
+            return (static_cast<uint64_t>(time_ms) << 32) | milli_tokens;
+        }
+
+    private:
+        double milli_tokens_per_ms_; // 每毫秒补充的千分之一令牌数（数值上等于每秒令牌数）
+        uint32_t capacity_; // 桶容量（千分之一令牌）
+        int64_t epoch_ms_; // 相对时间起点
+        size_t shard_mask_;
+        std::unique_ptr<Shard[]> shards_;
+    };
+} // namespace zhttp::zmiddleware
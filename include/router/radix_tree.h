@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "router_handler.h"
+
+namespace zhttp::zmiddleware
+{
+    class MiddlewareChain;
+}
+
+namespace zhttp::zrouter
+{
+    // 路由目标：对象式处理器或回调函数，二选一
+    struct RouteTarget
+    {
+        std::shared_ptr<RouterHandler> handler_;
+        std::function<void(const HttpRequest &, HttpResponse *)> callback_;
+        std::shared_ptr<zmiddleware::MiddlewareChain> middlewares_ = nullptr; // 路由的中间件管线，发布快照时解析
+
+        explicit operator bool() const { return handler_ || callback_; }
+
+        void operator()(const HttpRequest &request, HttpResponse *response) const
+        {
+            if (handler_)
+            {
+                handler_->handle_request(request, response);
+            }
+            else
+            {
+                callback_(request, response);
+            }
+        }
+    };
+
+    /* 压缩前缀树（radix tree）路由表。
+       模式由静态片段、":name"参数段（匹配到下一个'/'为止）与末尾的"*name"通配段组成，
+       每个节点按请求方法保存路由目标。
+       匹配优先级：静态 > 参数 > 通配，静态分支走不通时回溯到参数分支，
+       查找代价只与路径长度有关，与路由数量无关 */
+    class RadixTree
+    {
+    public:
+        static constexpr size_t kMethodCount = static_cast<size_t>(HttpRequest::Method::OPTIONS) + 1;
+
+        RadixTree();
+
+        ~RadixTree();
+
+        // 插入路由，模式冲突（同一位置参数名不同、通配段不在末尾）时抛出std::invalid_argument
+        void insert(std::string_view pattern, HttpRequest::Method method, RouteTarget target);
+
+        // 查找路由，匹配出的参数追加到request中；未命中时request不变
+        const RouteTarget *find(HttpRequest &request) const;
+
+        // 只判断方法与路径是否命中，不记录参数
+        const RouteTarget *find(HttpRequest::Method method, std::string_view path) const;
+
+        // 模式是否只包含静态片段与参数/通配段，可以放入前缀树
+        static bool is_tree_pattern(std::string_view pattern);
+
+        // 已注册的路由数量
+        size_t size() const { return size_; }
+
+    private:
+        struct Node;
+
+        // 插入静态片段，返回片段末尾对应的节点
+        static Node *insert_static(Node *node, std::string_view chunk);
+
+        // request为空时不记录参数
+        static const RouteTarget *match(const Node *node, std::string_view path, size_t pos,
+                                        size_t method, HttpRequest *request);
+
+        // 参数名驻留到全局表中，匹配结果中的参数名视图始终有效
+        static std::string_view intern(std::string_view name);
+
+    private:
+        std::unique_ptr<Node> root_;
+        size_t size_ = 0;
+    };
+} // namespace zhttp::zrouter
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace zhttp::zrouter
+{
+    /* 多模式正则集合（类似RE2::Set）：全部模式编译进同一个Thompson NFA，
+       匹配时按需构造DFA状态并缓存，对路径只做一次线性扫描即可得到所有整串匹配的模式；
+       捕获组只对最终选中的模式用Pike VM再跑一遍，同样是线性时间。
+       支持的语法：字面量、'.'、字符类、\d\w\s及其取反、分组(含(?:))、'|'、
+       * + ? {n} {n,} {n,m}（及非贪婪形式），模式首尾的^与$；
+       反向引用、断言等不支持的语法在add时抛出std::invalid_argument */
+    class RegexSet
+    {
+    public:
+        using Group = std::pair<size_t, size_t>; // 捕获组在文本中的(偏移, 长度)，未参与匹配时偏移为npos
+
+        RegexSet();
+
+        ~RegexSet();
+
+        // 添加一个模式（整串匹配），返回模式编号
+        uint32_t add(std::string_view pattern);
+
+        // 一次扫描，按编号升序输出全部匹配的模式
+        void match(std::string_view text, std::vector<uint32_t> &matches) const;
+
+        // 获取指定模式在text上的捕获组，不匹配时返回false
+        bool captures(uint32_t id, std::string_view text, std::vector<Group> &groups) const;
+
+        // 模式数量
+        size_t size() const { return starts_.size(); }
+
+        // 已缓存的DFA状态数量
+        size_t dfa_states() const;
+
+    private:
+        struct Inst
+        {
+            enum class Op : uint8_t
+            {
+                Byte,  // 消耗一个属于字符类arg_的字节
+                Split, // 优先走x_，其次y_
+                Jmp,   // 跳转到x_
+                Save,  // 记录捕获位置到槽arg_
+                Match  // 模式arg_匹配成功
+            };
+
+            Op op_;
+            uint32_t arg_ = 0;
+            uint32_t x_ = 0;
+            uint32_t y_ = 0;
+        };
+
+        struct DState
+        {
+            std::vector<uint32_t> insts_;                        // 消耗字节的指令集合（已排序）
+            std::vector<uint32_t> matches_;                      // 到达此状态时已匹配的模式
+            std::unique_ptr<std::atomic<DState *>[]> next_;      // 按字节等价类索引的转移，空表示尚未计算
+        };
+
+        class Parser;
+
+        // 编译字节等价类与DFA起始状态，在首次匹配时调用
+        void compile() const;
+
+        // 计算epsilon闭包，收集Byte与Match指令
+        void closure(uint32_t pc, std::vector<uint32_t> &out, std::vector<bool> &visited) const;
+
+        // 由指令集合得到DFA状态，超过状态上限时返回nullptr
+        DState *intern_state(std::vector<uint32_t> insts) const;
+
+        // 计算转移
+        DState *compute_next(DState *state, uint32_t byte_class) const;
+
+        // DFA状态过多时退回NFA状态集合模拟
+        void match_nfa(std::string_view text, std::vector<uint32_t> &matches) const;
+
+    private:
+        static constexpr size_t kMaxStates = 10000; // DFA缓存的状态上限
+
+        std::vector<Inst> prog_;                 // 所有模式的指令
+        std::vector<std::bitset<256>> classes_;  // Byte指令引用的字符类
+        std::vector<uint32_t> starts_;           // 各模式的起始指令
+        std::vector<uint32_t> group_counts_;     // 各模式的捕获组数量
+
+        mutable std::mutex mutex_;                          // 保护DFA构造
+        mutable std::atomic<bool> compiled_{false};
+        mutable std::array<uint8_t, 256> byte_class_{};     // 字节 -> 等价类
+        mutable std::vector<uint8_t> class_rep_;            // 等价类 -> 代表字节
+        mutable std::deque<DState> states_;                 // DFA状态，地址稳定
+        mutable std::map<std::vector<uint32_t>, DState *> state_index_;
+        mutable DState *start_ = nullptr;
+        mutable DState *dead_ = nullptr;
+    };
+} // namespace zhttp::zrouter
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "router.h"
+
+namespace zhttp::zrouter
+{
+    /* 路由分组。
+       组内注册的路径都带上组前缀，组的中间件只作用于前缀下的路由（按路径段对齐），
+       例如 server.group("/api", {auth, cors}).Get("/users", cb) 注册 /api/users 并经过auth与cors。
+       分组可以嵌套，外层中间件先于内层执行 */
+    class RouteGroup
+    {
+    public:
+        using HandlerPtr = Router::HandlerPtr;
+        using HandlerCallback = Router::HandlerCallback;
+        using MiddlewareList = std::vector<std::shared_ptr<zmiddleware::Middleware>>;
+
+        RouteGroup(Router *router, std::string prefix, MiddlewareList middlewares = {});
+
+        // 子分组
+        RouteGroup group(const std::string &prefix, MiddlewareList middlewares = {}) const;
+
+        // 为本组追加中间件
+        void use(MiddlewareList middlewares) const;
+
+        // 注册静态路由
+        void Get(const std::string &path, const HandlerCallback &cb) const;
+
+        void Get(const std::string &path, HandlerPtr handler) const;
+
+        void Post(const std::string &path, const HandlerCallback &cb) const;
+
+        void Post(const std::string &path, HandlerPtr handler) const;
+
+        void Put(const std::string &path, const HandlerCallback &cb) const;
+
+        void Put(const std::string &path, HandlerPtr handler) const;
+
+        void Delete(const std::string &path, const HandlerCallback &cb) const;
+
+        void Delete(const std::string &path, HandlerPtr handler) const;
+
+        void Patch(const std::string &path, const HandlerCallback &cb) const;
+
+        void Patch(const std::string &path, HandlerPtr handler) const;
+
+        // 注册动态路由
+        void add_regex_route(HttpRequest::Method method, const std::string &path, const HandlerCallback &cb) const;
+
+        void add_regex_route(HttpRequest::Method method, const std::string &path, HandlerPtr handler) const;
+
+        // 注册类型化路由，见typed_route.h
+        template<const char *Pattern, typename F>
+        void add_typed_route(HttpRequest::Method method, F &&handler) const
+        {
+            router_->register_typed<Pattern>(method, std::forward<F>(handler), prefix_);
+        }
+
+        template<const char *Pattern, typename F>
+        void Get(F &&handler) const { add_typed_route<Pattern>(HttpRequest::Method::GET, std::forward<F>(handler)); }
+
+        template<const char *Pattern, typename F>
+        void Post(F &&handler) const { add_typed_route<Pattern>(HttpRequest::Method::POST, std::forward<F>(handler)); }
+
+        const std::string &prefix() const { return prefix_; }
+
+    private:
+        Router *router_;
+        std::string prefix_; // 不以'/'结尾
+    };
+} // namespace zhttp::zrouter
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "router_handler.h"
+#include "radix_tree.h"
+#include "regex_set.h"
+#include "middleware/middleware_chain.h"
+
+namespace zhttp::zrouter
+{
+    // 一条路由的注册信息，路由表由注册信息列表构建
+    struct RouteDefinition
+    {
+        enum class Kind
+        {
+            Exact,  // 精确匹配
+            Dynamic // 参数、通配或正则匹配
+        };
+
+        Kind kind_;
+        std::string path_;
+        HttpRequest::Method method_;
+        RouteTarget target_;
+    };
+
+    // 中间件作用域：前缀下（按路径段对齐）的所有路由都经过这些中间件，空前缀表示全局
+    struct MiddlewareScope
+    {
+        std::string prefix_;
+        std::vector<std::shared_ptr<zmiddleware::Middleware>> middlewares_;
+    };
+
+    /* 路由表快照。
+       构建完成后只读，可被多个线程同时查找；修改路由时由Router构建新快照整体替换。
+       精确路由放在开放寻址的扁平哈希表中，一次哈希加线性探测即可命中；
+       动态路由依次查找前缀树、正则集合与std::regex后备列表。
+       每条路由的中间件管线在构建时按作用域解析好，同一组作用域的路由共享一条管线 */
+    class RouteTable
+    {
+    public:
+        using HandlerPtr = std::shared_ptr<RouterHandler>;
+        using HandlerCallback = std::function<void(const HttpRequest &, HttpResponse *)>;
+
+        RouteTable() = default;
+
+        using ChainPtr = std::shared_ptr<zmiddleware::MiddlewareChain>;
+
+        // 由注册信息列表与中间件作用域构建
+        explicit RouteTable(const std::vector<RouteDefinition> &definitions,
+                            const std::vector<MiddlewareScope> &scopes = {});
+
+        // 加入一条路由，只在发布前调用；模式冲突时抛出std::invalid_argument
+        void add(const RouteDefinition &definition);
+
+        // 精确匹配，未命中返回nullptr
+        const RouteTarget *find_exact(const HttpRequest &request) const;
+
+        const RouteTarget *find_exact(HttpRequest::Method method, std::string_view path) const;
+
+        // 前缀树与正则表达式匹配，路径参数写入request，未命中返回nullptr且request不变
+        const RouteTarget *find_dynamic(HttpRequest &request) const;
+
+        // 按方法与路径依次查找精确与动态路由，不写入路径参数，未命中返回nullptr
+        const RouteTarget *find_route(HttpRequest::Method method, std::string_view path) const;
+
+        // 路径所在作用域的中间件管线，没有中间件时返回nullptr
+        const ChainPtr &resolve_middlewares(std::string_view path) const;
+
+        // 精确路由数量
+        size_t exact_size() const { return entries_.size(); }
+
+        // 将路径转换为正则表达式
+        static std::string convert_to_pattern(const std::string &path);
+
+        static std::regex convert_to_regex(const std::string &path);
+
+    private:
+        // 精确路由，同一键可同时有处理器与回调函数，处理器优先
+        struct ExactEntry
+        {
+            HttpRequest::Method method_;
+            std::string path_;
+            size_t hash_;
+            RouteTarget target_;
+        };
+
+        // 编入RegexSet的正则路由，下标即模式编号
+        struct RegexRoute
+        {
+            HttpRequest::Method method_;
+            RouteTarget target_;
+            uint32_t order_; // 在全部正则路由中的注册次序
+        };
+
+        // RegexSet不支持的正则路由，逐个用std::regex匹配
+        struct FallbackRoute
+        {
+            std::regex regex_path_;
+            HttpRequest::Method method_;
+            RouteTarget target_;
+            uint32_t order_; // 在全部正则路由中的注册次序
+        };
+
+        // 正则路由的优先级：处理器优先于回调函数，同类按注册顺序，值小者优先
+        static std::pair<bool, uint32_t> regex_priority(const RouteTarget &target, uint32_t order);
+
+        static size_t hash_key(HttpRequest::Method method, std::string_view path);
+
+        // 查找精确路由表项，未命中返回nullptr
+        const ExactEntry *find_entry(HttpRequest::Method method, std::string_view path) const;
+
+        // 为每个不同的作用域前缀预先组装管线
+        void build_scopes(const std::vector<MiddlewareScope> &scopes);
+
+        // 前缀是否按路径段覆盖path
+        static bool in_scope(std::string_view prefix, std::string_view path);
+
+        void add_exact(const RouteDefinition &definition);
+
+        // 按当前表项重建槽位，保持装载因子不超过1/2
+        void rehash(size_t slot_count);
+
+        void add_dynamic(const RouteDefinition &definition);
+
+        // 正则路由加入正则集合，不支持时返回false
+        bool add_regex_route(const std::string &path, const HttpRequest::Method &method, const RouteTarget &target);
+
+        // 在正则集合中选出优先级最高的路由，不写入路径参数，未命中返回nullptr
+        const RegexRoute *find_regex_set(HttpRequest::Method method, std::string_view path, uint32_t &id) const;
+
+        // 依次尝试优先级高于best的std::regex路由，命中时捕获组写入match，未命中返回nullptr
+        const FallbackRoute *find_fallback(HttpRequest::Method method, std::string_view path,
+                                           const RegexRoute *best, std::cmatch &match) const;
+
+        // 提前路径参数
+        static void extract_path_parameters(const std::cmatch &match, HttpRequest &request);
+
+    private:
+        std::vector<ExactEntry> entries_;      // 精确路由表项，按注册顺序紧凑存放
+        std::vector<uint32_t> slots_;          // 开放寻址槽位，存表项下标+1，0为空
+        RadixTree tree_;                       // 参数与通配路由
+        RegexSet regex_set_;                   // 正则路由的组合自动机
+        std::vector<RegexRoute> regex_routes_; // 正则集合中的路由，下标为模式编号
+        std::vector<FallbackRoute> regex_handlers_;  // 正则表达式匹配
+        std::vector<FallbackRoute> regex_callbacks_; // 正则表达式匹配
+        uint32_t regex_order_ = 0;                   // 下一条正则路由的注册次序，两类正则路由共用
+        std::vector<std::pair<std::string, ChainPtr>> scope_chains_; // (作用域前缀, 管线)，前缀由长到短
+    };
+} // namespace zhttp::zrouter
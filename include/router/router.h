@@ -1,103 +1,107 @@
 #pragma once
 
-#include <unordered_map>
+#include <atomic>
 #include <functional>
 #include <string>
-#include <regex>
-#include <utility>
+#include <mutex>
 #include <vector>
 #include <memory>
-#include<regex>
 #include "router_handler.h"
+#include "route_table.h"
+#include "typed_route.h"
 
 /*选择注册对象式的路由处理器还是注册回调函数式的处理器取决于处理器执行的复杂程度
 如果是简单的处理可以注册回调函数，否则注册对象式路由处理器(对象中可封装多个相关函数)*/
 namespace zhttp::zrouter
 {
+    /* 路由器。
+       路由保存在不可变的RouteTable快照中，查找时只需进入纪元临界区并读取快照指针，不加锁；
+       注册与删除在写锁下构建新快照并原子替换，旧快照待所有读者离开后由EpochDomain回收。
+       freeze()之前的注册只暂存，首次查找时统一发布；之后每次修改立即发布 */
     class Router
     {
     public:
         using HandlerPtr = std::shared_ptr<RouterHandler>;
         using HandlerCallback = std::function<void(const HttpRequest &, HttpResponse *)>;
-    public:
-        // 路由键
-        struct RouteKey
-        {
-            bool operator==(const RouteKey &other) const
-            {
-                return method == other.method && path == other.path;
-            }
-
-            HttpRequest::Method method;
-            std::string path;
-        };
-
-        // 路由键的哈希函数
-        struct RouteKeyHash
-        {
-            std::size_t operator()(const RouteKey &key) const
-            {
-                size_t path_hash = std::hash<std::string>()(key.path);
-                size_t method_hash = std::hash<int>()(static_cast<int>(key.method));
-                return path_hash * 31 + method_hash;
-            }
-        };
-
-        struct RouteCallbackObj
-        {
-            RouteCallbackObj(std::regex regex_path, const HttpRequest::Method &method, HandlerCallback callback)
-                    : regex_path_(std::move(regex_path)), method_(method), callback_(std::move(callback))
-            {
 
-            }
-
-            std::regex regex_path_;
-            HttpRequest::Method method_;
-            HandlerCallback callback_;
-        };
+    public:
+        Router();
 
-        struct RouteHandlerObj
-        {
-            RouteHandlerObj(std::regex &&regex_path, const HttpRequest::Method &method, HandlerPtr &&handler)
-                    : regex_path_(std::move(regex_path)), method_(method), handler_(std::move(handler))
-            {
+        ~Router();
 
-            }
+        Router(const Router &) = delete;
 
-            std::regex regex_path_;
-            HttpRequest::Method method_;
-            HandlerPtr handler_;
-        };
+        Router &operator=(const Router &) = delete;
 
-    public:
         // 注册路由处理器
         void register_handler(const std::string &path, const HttpRequest::Method &method, HandlerPtr handler);
 
         // 注册路由回调函数
         void register_callback(const std::string &path, const HttpRequest::Method &method, HandlerCallback callback);
 
-        // 注册动态路由处理器
+        // 注册动态路由处理器：只含":name"/"*name"段的模式进入前缀树，
+        // 其余编入多模式正则集合，集合不支持的语法（如反向引用）退回std::regex逐个匹配
         void register_regex_handler(const std::string &path, const HttpRequest::Method &method, HandlerPtr handler);
 
         // 注册动态路由回调函数
         void register_regex_callback(const std::string &path, const HttpRequest::Method &method,
                                      HandlerCallback callback);
 
-        // 路由处理
+        // 注册类型化路由，模式在编译期解析，参数解码后作为处理函数的实参，见typed_route.h
+        template<const char *Pattern, typename F>
+        void register_typed(const HttpRequest::Method &method, F &&handler, const std::string &prefix = "")
+        {
+            register_route({RouteDefinition::Kind::Dynamic,
+                            prefix + std::string(typed::TypedPattern<Pattern>::kTree), method,
+                            typed::make_target<Pattern>(std::forward<F>(handler))});
+        }
+
+        // 为前缀下的路由添加中间件，空前缀表示全局；各路由的管线在发布快照时解析
+        void use(const std::string &prefix, std::vector<std::shared_ptr<zmiddleware::Middleware>> middlewares);
+
+        // 删除路由，path为注册时的路径或模式，返回删除的条数
+        size_t remove_route(const std::string &path, const HttpRequest::Method &method);
+
+        // 发布当前路由并进入运行期，此后的修改立即生效
+        void freeze();
+
+        // 路由处理，路径参数写入请求副本，原请求不变
         bool route(const HttpRequest &request, HttpResponse *response);
 
+        // 路由处理，路径参数直接写入request，避免复制请求；命中后依次执行该路由的中间件与处理器
+        bool dispatch(HttpRequest &request, HttpResponse *response);
+
+        // OPTIONS请求：按原路径命中的路由的作用域执行中间件（如CORS预检），再交给target_path上的处理器
+        bool dispatch_options(HttpRequest &request, HttpResponse *response, const std::string &target_path);
+
     private:
-        // 将路径转换为正则表达式
-        static std::regex convert_to_regex(const std::string &path);
+        // 加入一条路由，模式冲突时抛出std::invalid_argument且不改变已有路由
+        void register_route(RouteDefinition definition);
 
-        // 提前路径参数
-        static void extract_path_parameters(const std::smatch &match, HttpRequest &request);
+        // 发布暂存的快照，调用方需持有mutex_
+        void publish();
+
+        // 获取当前快照，调用方需处于纪元临界区内
+        const RouteTable *snapshot();
+
+        // 修改后发布或标记待发布，调用方需持有mutex_
+        void commit();
+
+        // OPTIONS请求应执行的管线：原路径命中的路由的管线，未命中时按路径所在作用域
+        static zmiddleware::MiddlewareChain *resolve_options_middlewares(const RouteTable &table,
+                                                                         std::string_view path);
+
+        // 在中间件管线中执行路由目标
+        static void invoke(const RouteTarget &target, zmiddleware::MiddlewareChain *middlewares,
+                           HttpRequest &request, HttpResponse *response);
 
     private:
-        std::unordered_map<RouteKey, HandlerPtr, RouteKeyHash> handlers_;//精确匹配
-        std::unordered_map<RouteKey, HandlerCallback, RouteKeyHash> callbacks_;//精确匹配
-        std::vector<RouteHandlerObj> regex_handlers_;//正则表达式匹配
-        std::vector<RouteCallbackObj> regex_callbacks_;//正则表达式匹配
+        std::mutex mutex_;                          // 写者互斥，保护以下非原子成员
+        std::vector<RouteDefinition> definitions_;  // 全部路由的注册信息
+        std::vector<MiddlewareScope> scopes_;       // 中间件作用域
+        std::unique_ptr<RouteTable> staging_;       // 尚未发布的快照
+        std::atomic<RouteTable *> table_;           // 已发布的快照
+        std::atomic<bool> pending_{false};          // 是否有尚未发布的修改
+        bool frozen_ = false;                       // 是否已进入运行期
     };
 }// namespace router
-
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "radix_tree.h"
+
+/* 编译期类型化路由。
+   模式写成静态字符数组，参数段形如"{id:u64}"、"{slug}"，末尾可有通配段"{*rest}"：
+       static constexpr char kUserPost[] = "/users/{id:u64}/posts/{slug}";
+       server.Get<kUserPost>([](const HttpRequest &, HttpResponse *, uint64_t id, std::string_view slug) {...});
+   模式在编译期解析并转换为前缀树模式"/users/:id/posts/:slug"，语法错误与处理函数签名不符都在编译期报错；
+   请求到来时参数由std::from_chars直接解码为处理函数的实参，解码失败（非数字、溢出）按未命中返回404 */
+namespace zhttp::zrouter::typed
+{
+    enum class ParamType
+    {
+        Str, // std::string_view，缺省类型
+        U64, // uint64_t
+        I64, // int64_t
+        U32, // uint32_t
+        I32, // int32_t
+    };
+
+    // 参数类型对应的C++类型
+    template<ParamType T> struct ParamTraits;
+    template<> struct ParamTraits<ParamType::Str> { using type = std::string_view; };
+    template<> struct ParamTraits<ParamType::U64> { using type = uint64_t; };
+    template<> struct ParamTraits<ParamType::I64> { using type = int64_t; };
+    template<> struct ParamTraits<ParamType::U32> { using type = uint32_t; };
+    template<> struct ParamTraits<ParamType::I32> { using type = int32_t; };
+
+    // 编译期解析结果
+    struct PatternInfo
+    {
+        static constexpr size_t kMaxParams = 16;
+
+        bool valid_ = true;
+        size_t count_ = 0;                 // 参数个数
+        ParamType types_[kMaxParams]{};    // 各参数类型，按出现顺序
+        size_t tree_size_ = 0;             // 转换后的前缀树模式长度
+    };
+
+    namespace detail
+    {
+        constexpr size_t length(const char *s)
+        {
+            size_t n = 0;
+            while (s[n] != '\0')
+            {
+                ++n;
+            }
+            return n;
+        }
+
+        constexpr bool is_name_char(const char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        }
+
+        constexpr bool type_equals(std::string_view type, const char *name)
+        {
+            return type == std::string_view(name);
+        }
+
+        // 解析模式；out非空时同时写出前缀树模式
+        constexpr PatternInfo parse(const std::string_view pattern, char *out)
+        {
+            PatternInfo info;
+            if (pattern.empty() || pattern[0] != '/')
+            {
+                info.valid_ = false;
+                return info;
+            }
+
+            size_t pos = 0;
+            size_t written = 0;
+            while (pos < pattern.size())
+            {
+                const char c = pattern[pos];
+                if (c == '}')
+                {
+                    info.valid_ = false;
+                    return info;
+                }
+                if (c != '{')
+                {
+                    if (c == ':' || c == '*')
+                    {
+                        info.valid_ = false; // 前缀树的保留字符不能出现在静态片段中
+                        return info;
+                    }
+                    if (out)
+                    {
+                        out[written] = c;
+                    }
+                    ++written;
+                    ++pos;
+                    continue;
+                }
+
+                // 参数必须独占一个路径段
+                const size_t close = pattern.find('}', pos);
+                if (pattern[pos - 1] != '/' || close == std::string_view::npos ||
+                    (close + 1 < pattern.size() && pattern[close + 1] != '/') ||
+                    info.count_ == PatternInfo::kMaxParams)
+                {
+                    info.valid_ = false;
+                    return info;
+                }
+
+                std::string_view body = pattern.substr(pos + 1, close - pos - 1);
+                const bool wildcard = !body.empty() && body[0] == '*';
+                if (wildcard)
+                {
+                    body.remove_prefix(1);
+                }
+                const size_t colon = body.find(':');
+                const std::string_view name = body.substr(0, colon);
+                const std::string_view type = colon == std::string_view::npos ? "str" : body.substr(colon + 1);
+
+                bool name_ok = !name.empty();
+                for (const char ch : name)
+                {
+                    name_ok = name_ok && is_name_char(ch);
+                }
+                if (!name_ok || (wildcard && close + 1 != pattern.size()))
+                {
+                    info.valid_ = false;
+                    return info;
+                }
+
+                ParamType param_type = ParamType::Str;
+                if (type_equals(type, "u64")) param_type = ParamType::U64;
+                else if (type_equals(type, "i64")) param_type = ParamType::I64;
+                else if (type_equals(type, "u32")) param_type = ParamType::U32;
+                else if (type_equals(type, "i32")) param_type = ParamType::I32;
+                else if (!type_equals(type, "str") || (wildcard && colon != std::string_view::npos))
+                {
+                    info.valid_ = false;
+                    return info;
+                }
+                info.types_[info.count_++] = param_type;
+
+                if (out)
+                {
+                    out[written] = wildcard ? '*' : ':';
+                    for (size_t i = 0; i < name.size(); ++i)
+                    {
+                        out[written + 1 + i] = name[i];
+                    }
+                }
+                written += 1 + name.size();
+                pos = close + 1;
+            }
+            info.tree_size_ = written;
+            return info;
+        }
+
+        template<typename T>
+        bool decode(const std::string_view text, T &value)
+        {
+            if constexpr (std::is_same_v<T, std::string_view>)
+            {
+                value = text;
+                return true;
+            }
+            else
+            {
+                const char *end = text.data() + text.size();
+                const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+                return ec == std::errc() && ptr == end;
+            }
+        }
+    } // namespace detail
+
+    // 模式的编译期信息，Pattern须为具有静态存储期的字符数组
+    template<const char *Pattern>
+    struct TypedPattern
+    {
+        static constexpr std::string_view kSource{Pattern, detail::length(Pattern)};
+        static constexpr PatternInfo kInfo = detail::parse(kSource, nullptr);
+        static_assert(kInfo.valid_, "invalid typed route pattern: parameters are whole segments "
+                                    "like {name}, {name:u64|i64|u32|i32|str} or a trailing {*name}");
+
+        template<size_t I>
+        using arg_type = typename ParamTraits<kInfo.types_[I]>::type;
+
+        // 前缀树模式，如"/users/:id/posts/:slug"
+        static constexpr auto kTreeChars = []
+        {
+            std::array<char, kInfo.tree_size_ + 1> chars{};
+            detail::parse(kSource, chars.data());
+            return chars;
+        }();
+        static constexpr std::string_view kTree{kTreeChars.data(), kInfo.tree_size_};
+    };
+
+    namespace detail
+    {
+        template<const char *Pattern, typename F, size_t... I>
+        void invoke(const F &handler, const HttpRequest &request, HttpResponse *response, std::index_sequence<I...>)
+        {
+            using Info = TypedPattern<Pattern>;
+            std::tuple<typename Info::template arg_type<I>...> args;
+
+            const std::string_view path = request.get_path();
+            const auto &params = request.get_path_parameter_list();
+            // 分组前缀中的参数排在前面，类型化参数取末尾的sizeof...(I)个
+            const size_t base = params.size() - sizeof...(I);
+            const bool ok = params.size() >= sizeof...(I) &&
+                            (decode(path.substr(params[base + I].offset_, params[base + I].length_),
+                                    std::get<I>(args)) && ...);
+            if (!ok)
+            {
+                response->set_status_code(HttpResponse::StatusCode::NotFound);
+                response->set_status_message("Not Found");
+                response->set_body("404 Not Found");
+                return;
+            }
+            std::invoke(handler, request, response, std::get<I>(args)...);
+        }
+
+        template<const char *Pattern, typename F, size_t... I>
+        constexpr bool invocable(std::index_sequence<I...>)
+        {
+            using Info = TypedPattern<Pattern>;
+            return std::is_invocable_v<const F &, const HttpRequest &, HttpResponse *,
+                                       typename Info::template arg_type<I>...>;
+        }
+    } // namespace detail
+
+    // 生成路由目标，处理函数签名须为(const HttpRequest &, HttpResponse *, 各参数类型...)
+    template<const char *Pattern, typename F>
+    RouteTarget make_target(F &&handler)
+    {
+        using Info = TypedPattern<Pattern>;
+        using Handler = std::decay_t<F>;
+        using Indices = std::make_index_sequence<Info::kInfo.count_>;
+        static_assert(detail::invocable<Pattern, Handler>(Indices{}),
+                      "typed route handler must accept (const HttpRequest &, HttpResponse *, params...) "
+                      "matching the pattern's parameter types");
+
+        return RouteTarget{nullptr, [handler = Handler(std::forward<F>(handler))]
+                (const HttpRequest &request, HttpResponse *response)
+        {
+            detail::invoke<Pattern>(handler, request, response, Indices{});
+        }};
+    }
+} // namespace zhttp::zrouter::typed
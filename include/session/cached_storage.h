@@ -0,0 +1,114 @@
+#pragma once
+#include "session_storage.h"
+#include "invalidation_bus.h"
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace zhttp::zsession
+{
+    struct NearCacheConfig
+    {
+        size_t capacity_ = 100000;   // 本地缓存的会话数上限
+        uint32_t ttl_ms_ = 2000;     // 本地副本的有效期（毫秒），限制失效消息丢失时的不一致窗口
+        uint32_t shard_count_ = 16;  // 分片数量（向上取整为2的幂）
+    };
+
+    /* 带进程内近端缓存的会话存储，包装任意后端（通常为DbSessionStorage）。
+       load先查本地分片LRU，命中时不访问后端；store/remove写穿到后端，更新本地副本并经失效总线通知其他节点。
+       本地副本只保存很短时间，失效消息丢失时的不一致窗口不超过ttl_ms_。
+       每个分片记录失效次数：从后端加载期间若发生过失效，加载结果不进入缓存，避免旧数据覆盖新的失效 */
+    class CachedSessionStorage final : public SessionStorage
+    {
+    public:
+        struct Stats
+        {
+            uint64_t hits_ = 0;
+            uint64_t misses_ = 0;
+            uint64_t invalidations_ = 0; // 收到的远端失效
+        };
+
+        explicit CachedSessionStorage(SessionStorage::ptr backend, InvalidationBus::ptr bus = nullptr,
+                                      NearCacheConfig config = {});
+
+        ~CachedSessionStorage() override;
+
+        void store(const std::shared_ptr<Session> &session) override;
+
+        std::shared_ptr<Session> load(const std::string &session_id) override;
+
+        bool remove(const std::string &session_id) override;
+
+        void clear_expired() override;
+
+        // 命中时在本地刷新并写穿，未命中时交给后端的load_and_refresh
+        std::shared_ptr<Session> load_and_refresh(const std::string &session_id) override;
+
+        // 直接交给后端，本地副本的过期时间在副本有效期内不受影响
+        void touch(const std::vector<ExpiryUpdate> &updates) override;
+
+        bool is_shared() const override { return backend_->is_shared(); }
+
+        // 直接交给后端
+        bool for_each_session_id(const std::function<void(const std::string &)> &fn) override;
+
+        // 丢弃本地副本
+        void invalidate(const std::string &session_id);
+
+        // 丢弃全部本地副本
+        void invalidate_all();
+
+        Stats stats() const;
+
+        // 本地缓存的会话数
+        size_t size() const;
+
+    private:
+        struct Entry
+        {
+            std::string session_id_;
+            std::shared_ptr<const Session> session_; // 只读副本，返回给调用方前复制
+            int64_t deadline_ms_;
+        };
+
+        struct alignas(64) Shard
+        {
+            mutable std::mutex mutex_;
+            std::list<Entry> lru_; // 头部最近使用
+            std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+            uint64_t invalidations_ = 0; // 本分片的失效次数
+        };
+
+        Shard &shard_for(const std::string &session_id) const;
+
+        // 查找未过期的本地副本并返回拷贝；未命中时返回nullptr并给出当前失效次数
+        std::shared_ptr<Session> lookup(Shard &shard, const std::string &session_id, int64_t now_ms,
+                                        uint64_t &seen_invalidations);
+
+        // 后端加载结果进入缓存，期间发生过失效时放弃
+        void fill(Shard &shard, const std::string &session_id, const std::shared_ptr<Session> &session,
+                  uint64_t seen_invalidations, int64_t now_ms) const;
+
+        // 写入本地副本，调用方持有分片锁
+        void put(Shard &shard, const std::string &session_id, std::shared_ptr<const Session> session,
+                 int64_t now_ms) const;
+
+        // 删除本地副本并记一次失效，调用方持有分片锁
+        static void drop(Shard &shard, const std::string &session_id);
+
+        static int64_t now_ms();
+
+    private:
+        SessionStorage::ptr backend_;
+        InvalidationBus::ptr bus_;
+        NearCacheConfig config_;
+        size_t shard_capacity_;
+        size_t shard_mask_;
+        std::unique_ptr<Shard[]> shards_;
+        std::atomic<uint64_t> hits_{0};
+        std::atomic<uint64_t> misses_{0};
+        std::atomic<uint64_t> remote_invalidations_{0};
+        std::shared_ptr<void> subscription_; // 最后声明，析构时最先取消订阅
+    };
+} // namespace zhttp::zsession
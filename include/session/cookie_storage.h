@@ -0,0 +1,82 @@
+#pragma once
+#include "session_storage.h"
+#include <shared_mutex>
+#include <vector>
+
+namespace zhttp::zsession
+{
+    // Cookie会话的AES-256-GCM密钥
+    struct CookieKey
+    {
+        uint8_t id_ = 0; // 密钥编号，写入令牌，用于轮换期间选择解密密钥
+        std::string secret_; // 32字节密钥
+    };
+
+    /* 无状态的Cookie会话存储：会话属性与过期时间以AES-256-GCM加密认证后整体放入Cookie，
+       读取与写入都不访问服务器端存储。
+       令牌格式为"z1."加base64url(密钥编号 | 12字节随机nonce | 密文 | 16字节标签)，前缀作为附加认证数据。
+       加密后超过max_cookie_bytes的会话改存fallback，Cookie中只放会话ID；会话缩小后回到Cookie，
+       留在fallback中的旧副本随过期清理。
+       密钥轮换：rotate设置新的加密密钥，旧密钥继续用于解密，直到retire移除。
+       令牌无法在服务器端撤销，destroy_session只删除fallback中的会话，敏感会话应缩短超时时间 */
+    class CookieSessionStorage final : public SessionStorage
+    {
+    public:
+        static constexpr size_t kKeyBytes = 32;
+
+        // keys不能为空，第一个为当前加密密钥；fallback为空时使用内存存储
+        explicit CookieSessionStorage(std::vector<CookieKey> keys, SessionStorage::ptr fallback = nullptr,
+                                      size_t max_cookie_bytes = 3800);
+
+        // 超出大小上限的会话写入fallback，其余不做任何事
+        void store(const std::shared_ptr<Session> &session) override;
+
+        // 解密令牌，令牌无效或过期时返回nullptr；不是令牌的值按会话ID从fallback读取
+        std::shared_ptr<Session> load(const std::string &session_id) override;
+
+        bool remove(const std::string &session_id) override;
+
+        void clear_expired() override;
+
+        // 只有fallback中的会话需要顺延，Cookie会话由SessionManager重新下发
+        void touch(const std::vector<ExpiryUpdate> &updates) override;
+
+        bool is_shared() const override { return fallback_->is_shared(); }
+
+        bool stores_in_cookie() const override { return true; }
+
+        // 会话能放入Cookie时返回加密后的令牌
+        std::optional<std::string> cookie_token(const Session &session) override;
+
+        // 设置新的加密密钥，原有密钥保留用于解密
+        void rotate(CookieKey key);
+
+        // 移除解密密钥，不能移除当前加密密钥
+        void retire(uint8_t key_id);
+
+        // 生成随机密钥
+        static CookieKey generate_key(uint8_t id);
+
+        // 令牌前缀
+        static bool is_token(const std::string &value);
+
+    private:
+        // 明文：8字节过期时间（秒）| 1字节ID长度 | 会话ID | 会话属性编码
+        static std::string plaintext(const Session &session);
+
+        // 明文长度对应的令牌长度
+        static size_t token_length(size_t plaintext_length);
+
+        std::string seal(const std::string &plaintext) const;
+
+        std::shared_ptr<Session> open(const std::string &token) const;
+
+        static void check_key(const CookieKey &key);
+
+    private:
+        std::vector<CookieKey> keys_; // 第一个为加密密钥
+        mutable std::shared_mutex keys_mutex_;
+        SessionStorage::ptr fallback_;
+        size_t max_cookie_bytes_;
+    };
+} // namespace zhttp::zsession
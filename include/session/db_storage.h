@@ -1,20 +1,59 @@
 #pragma once
 #include "session_storage.h"
+#include <unordered_map>
 
 namespace zhttp::zsession
 {
+    // 会话在Redis Hash中的存储布局
+    enum class RedisSessionLayout
+    {
+        Blob,   // 全部属性编码为一个attributes字段
+        Fields, // 每个属性一个"attr:<名称>"字段，按需读取，只写改动过的字段
+    };
+
     class DbSessionStorage final : public SessionStorage
     {
     public:
         DbSessionStorage() = default;
+
+        // prefetch为Fields布局下加载会话时随过期时间一起以HMGET取回的属性，其余属性在首次读取时获取
+        explicit DbSessionStorage(RedisSessionLayout layout, std::vector<std::string> prefetch = {});
+
         ~DbSessionStorage() override = default;
 
         void store(const std::shared_ptr<Session> &session) override;
 
         std::shared_ptr<Session> load(const std::string &session_id) override;
 
-        void remove(const std::string &session_id) override;
+        bool remove(const std::string &session_id) override;
 
         void clear_expired() override;
+
+        // Blob布局由Lua脚本在服务器端读取会话并顺延过期时间，一次往返
+        std::shared_ptr<Session> load_and_refresh(const std::string &session_id) override;
+
+        // 以流水线批量执行条件写入脚本，每批一次往返
+        void touch(const std::vector<ExpiryUpdate> &updates) override;
+
+        bool is_shared() const override { return true; }
+
+        // 以SCAN遍历全部会话键，不阻塞Redis
+        bool for_each_session_id(const std::function<void(const std::string &)> &fn) override;
+
+    private:
+        // 从Hash字段还原会话，数据不完整时返回nullptr
+        static std::shared_ptr<Session> decode(const std::string &session_id,
+                                               const std::unordered_map<std::string, std::string> &fields);
+
+        // Fields布局：写入改动过的属性字段
+        void store_fields(const std::shared_ptr<Session> &session, std::chrono::seconds ttl) const;
+
+        // Fields布局：取回过期时间与预取属性，返回部分加载的会话
+        std::shared_ptr<Session> load_fields(const std::string &session_id);
+
+    private:
+        RedisSessionLayout layout_ = RedisSessionLayout::Blob;
+        std::vector<std::string> prefetch_; // 预取的属性名
+        std::vector<std::string> prefetch_fields_; // HMGET的字段：expiry、attributes与预取属性对应的字段
     };
 } //  namespace zhttp::zsession
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace zhttp::zsession
+{
+    /* 分层时间轮，按秒管理会话过期。
+       4层、每层64个槽，覆盖约194天；节点为侵入式双向链表，重新调度只需摘链与挂链，O(1)。
+       推进时只访问到期的槽：高层槽在低层转满一圈时整体下沉一次，
+       所以清理的代价与到期节点数（加上每个节点至多3次下沉）成正比，与节点总数无关。
+       更远的到期时间按覆盖范围的上限放置，到点时由回调复核后重新调度。
+       不是线程安全的，由调用方加锁 */
+    class ExpiryWheel
+    {
+    public:
+        // 时间轮节点，由被管理的对象持有（或继承）
+        struct Node
+        {
+            Node *prev_ = nullptr;
+            Node *next_ = nullptr;
+            int64_t expiry_ = 0;   // 到期时间（秒）
+            uint16_t list_ = 0;    // 所在链表
+            bool linked_ = false;  // 是否挂在时间轮上
+        };
+
+        explicit ExpiryWheel(int64_t now);
+
+        ExpiryWheel(const ExpiryWheel &) = delete;
+
+        ExpiryWheel &operator=(const ExpiryWheel &) = delete;
+
+        // 设置节点的到期时间并挂到对应槽位，已挂链时先摘链
+        void schedule(Node *node, int64_t expiry);
+
+        // 从时间轮中移除节点
+        void remove(Node *node);
+
+        /* 推进到now，到期节点摘链后依次交给on_expire(Node *)。
+           回调中可以重新调度或销毁当前节点，但不能操作其他节点；到期时间不晚于当前时间的重新调度在下一次推进时触发 */
+        template<typename F>
+        void advance(int64_t now, F &&on_expire)
+        {
+            while (current_ < now)
+            {
+                ++current_;
+                // 从高层到低层下沉，保证高层下沉到低层的节点在本tick内还会被继续处理
+                int level = 0;
+                while (level + 1 < kLevels && (current_ & ((int64_t{1} << (kBits * (level + 1))) - 1)) == 0)
+                {
+                    ++level;
+                }
+                for (; level > 0; --level)
+                {
+                    Node *node = detach(index(level, (current_ >> (kBits * level)) & kMask));
+                    while (node)
+                    {
+                        Node *next = node->next_;
+                        place(node);
+                        node = next;
+                    }
+                }
+                fire(index(0, current_ & kMask), on_expire);
+            }
+            fire(kDueList, on_expire);
+        }
+
+        // 当前时间（秒）
+        int64_t now() const { return current_; }
+
+        size_t size() const { return size_; }
+
+    private:
+        static constexpr int kBits = 6;
+        static constexpr int kSlots = 1 << kBits;
+        static constexpr int64_t kMask = kSlots - 1;
+        static constexpr int kLevels = 4;
+        static constexpr int64_t kSpan = int64_t{1} << (kBits * kLevels); // 覆盖的秒数
+        static constexpr uint16_t kDueList = kLevels * kSlots;             // 已到期、等待下次推进的节点
+
+        static constexpr uint16_t index(const int level, const int64_t slot)
+        {
+            return static_cast<uint16_t>(level * kSlots + slot);
+        }
+
+        // 按到期时间挂到对应槽位
+        void place(Node *node);
+
+        void link(Node *node, uint16_t list);
+
+        void unlink(Node *node);
+
+        // 摘下整条链表，节点仍标记为已挂链，由调用方逐个处理
+        Node *detach(uint16_t list);
+
+        template<typename F>
+        void fire(const uint16_t list, F &on_expire)
+        {
+            Node *node = detach(list);
+            while (node)
+            {
+                Node *next = node->next_;
+                node->prev_ = node->next_ = nullptr;
+                node->linked_ = false;
+                --size_;
+                on_expire(node);
+                node = next;
+            }
+        }
+
+    private:
+        Node *lists_[kDueList + 1]{};
+        int64_t current_;   // 已推进到的时间（秒）
+        size_t size_ = 0;   // 挂链节点数
+    };
+} // namespace zhttp::zsession
@@ -0,0 +1,58 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace zhttp::zsession
+{
+    /* 跨节点的会话失效通知，每个节点持有一个实例。
+       节点写入或删除会话后发布会话ID，其他节点收到后丢弃本地缓存的副本，发布者自己不会收到；
+       订阅中断、可能漏掉消息时回调on_reset，订阅方应清空全部本地缓存 */
+    class InvalidationBus
+    {
+    public:
+        using ptr = std::shared_ptr<InvalidationBus>;
+        using MessageCallback = std::function<void(const std::string &session_id)>;
+        using ResetCallback = std::function<void()>;
+
+        virtual ~InvalidationBus() = default;
+
+        virtual void publish(const std::string &session_id) = 0;
+
+        // 注册订阅者，返回的令牌析构时取消订阅（等待进行中的回调结束）；回调可能在任意线程中调用
+        virtual std::shared_ptr<void> subscribe(MessageCallback on_message, ResetCallback on_reset) = 0;
+    };
+
+    /* 进程内的失效总线：每个端点模拟一个节点，publish时同步通知其他端点的订阅者。
+       用于测试，以及同一进程内多个存储实例之间的失效 */
+    class LocalInvalidationHub : public std::enable_shared_from_this<LocalInvalidationHub>
+    {
+    public:
+        // 创建一个节点端点
+        InvalidationBus::ptr endpoint();
+
+        // 模拟订阅中断，通知全部订阅者
+        void reset();
+
+    private:
+        class Endpoint;
+
+        struct Subscriber
+        {
+            const Endpoint *endpoint_;
+            InvalidationBus::MessageCallback on_message_;
+            InvalidationBus::ResetCallback on_reset_;
+        };
+
+        void publish(const Endpoint *origin, const std::string &session_id);
+
+        std::shared_ptr<void> subscribe(const Endpoint *endpoint, InvalidationBus::MessageCallback on_message,
+                                        InvalidationBus::ResetCallback on_reset);
+
+    private:
+        std::mutex mutex_; // 回调在锁内调用，取消订阅时等待进行中的回调
+        std::vector<std::shared_ptr<Subscriber>> subscribers_;
+    };
+} // namespace zhttp::zsession
@@ -1,12 +1,18 @@
 #pragma once
 #include "session_storage.h"
+#include "expiry_wheel.h"
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace zhttp::zsession
 {
+    /* 内存会话存储：按会话ID哈希分片，每个分片一把互斥锁，各IO线程并发访问不同分片互不阻塞。
+       每个分片用分层时间轮跟踪过期时间，clear_expired只处理到期的会话，代价与会话总数无关 */
     class InMemoryStorage final : public SessionStorage
     {
     public:
-        InMemoryStorage() = default;
+        explicit InMemoryStorage(uint32_t shard_count = 64);
 
         ~InMemoryStorage() override = default;
 
@@ -17,12 +23,39 @@ namespace zhttp::zsession
         std::shared_ptr<Session> load(const std::string &session_id) override;
 
         // 删除会话
-        void remove(const std::string &session_id) override;
+        bool remove(const std::string &session_id) override;
 
         // 清除过期会话
         void clear_expired() override;
 
+        // 枚举全部会话的ID，包括已过期但尚未清理的会话
+        bool for_each_session_id(const std::function<void(const std::string &)> &fn) override;
+
+        // 会话数量
+        size_t size() const;
+
+    private:
+        struct Entry : ExpiryWheel::Node
+        {
+            std::shared_ptr<Session> session_;
+        };
+
+        struct alignas(64) Shard
+        {
+            explicit Shard(int64_t now) : wheel_(now) {}
+
+            mutable std::mutex mutex_;
+            std::unordered_map<std::string, Entry> sessions_; // 节点地址在rehash后不变，可直接挂在时间轮上
+            ExpiryWheel wheel_;
+        };
+
+        Shard &shard_for(const std::string &session_id) const;
+
+        // 会话过期时间（秒，向上取整）
+        static int64_t expiry_seconds(const Session &session);
+
     private:
-        std::unordered_map<std::string, std::shared_ptr<Session> > sessions_; // 存储会话的哈希表
+        size_t shard_mask_;
+        std::vector<std::unique_ptr<Shard>> shards_;
     };
 } //  namespace zhttp::zsession
@@ -0,0 +1,53 @@
+#pragma once
+#include "invalidation_bus.h"
+#include "db_pool/redis_connection.h"
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+
+namespace zhttp::zsession
+{
+    /* 基于Redis发布订阅的失效总线。
+       发布走连接池，消息为"<节点ID> <会话ID>"，节点据此忽略自己发布的消息；
+       订阅占用一条独立连接，由后台线程消费，连接中断后重连并通知订阅者清空本地缓存 */
+    class RedisInvalidationBus final : public InvalidationBus
+    {
+    public:
+        explicit RedisInvalidationBus(const std::string &host, int port = 6379, const std::string &password = "",
+                                      int db = 0, std::string channel = "zhttp:session:invalidate",
+                                      int timeout_ms = 1000);
+
+        ~RedisInvalidationBus() override;
+
+        void publish(const std::string &session_id) override;
+
+        std::shared_ptr<void> subscribe(MessageCallback on_message, ResetCallback on_reset) override;
+
+        const std::string &node_id() const { return node_id_; }
+
+    private:
+        struct Subscriber
+        {
+            MessageCallback on_message_;
+            ResetCallback on_reset_;
+        };
+
+        // 后台消费订阅消息
+        void consume_loop();
+
+        void dispatch(const std::string &message);
+
+        void notify_reset();
+
+    private:
+        std::string channel_;
+        std::string node_id_;                            // 随机生成，区分本节点发布的消息
+        std::unique_ptr<zdb::RedisConnection> connection_; // 订阅专用连接
+        std::mutex mutex_;                               // 保护subscribers_，回调在锁内调用
+        std::vector<std::shared_ptr<Subscriber>> subscribers_;
+        std::thread consume_thread_;
+        std::mutex stop_mutex_;
+        std::condition_variable stop_cv_;
+        std::atomic<bool> stop_{false};
+    };
+} // namespace zhttp::zsession
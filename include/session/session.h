@@ -2,24 +2,50 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <chrono>
+#include <functional>
+#include <optional>
 #include <nlohmann/json.hpp>
 
 namespace zhttp::zsession
 {
+    class SessionManager;
+    class SessionCodec;
+
+    // 部分加载的会话按需读取其余属性
+    class AttributeLoader
+    {
+    public:
+        using ptr = std::shared_ptr<AttributeLoader>;
+
+        virtual ~AttributeLoader() = default;
+
+        // 读取单个属性，不存在时返回nullopt
+        virtual std::optional<std::string> load(const std::string &key) = 0;
+
+        // 读取全部属性
+        virtual std::unordered_map<std::string, std::string> load_all() = 0;
+    };
+
     class Session
     {
     public:
+        // 延迟创建的会话首次写入属性时调用，负责分配ID、下发Cookie并持久化
+        using Materializer = std::function<void(Session &)>;
+
         explicit Session(std::string session_id, uint32_t timeout = 3600);
 
         // 获取会话ID
         const std::string &get_session_id() const;
 
-        // 设置与提取会话属性
+        // 设置与提取会话属性；部分加载的会话读取未加载的属性时经loader访问存储
         void set_attribute(const std::string &key, const std::string &value);
 
         std::string get_attribute(const std::string &key) const;
 
+        bool has_attribute(const std::string &key) const;
+
         // 刷新过期时间
         void refresh();
 
@@ -32,7 +58,7 @@ namespace zhttp::zsession
         // 清空会话属性
         void clear_attributes();
 
-        // 获取json格式会话属性
+        // 获取json格式会话属性，部分加载时先取回全部属性
         nlohmann::json get_attributes_json() const;
 
         // 获取过期时间
@@ -40,11 +66,64 @@ namespace zhttp::zsession
 
         void set_expiry_time(std::chrono::system_clock::time_point time_point);
 
+        // 自上次持久化以来属性是否有改动，新建的会话视为有改动
+        bool is_dirty() const;
+
+        // 改动过的属性名，包括已删除的属性
+        const std::unordered_set<std::string> &get_dirty_keys() const;
+
+        // 持久化或从存储加载后清除改动标记
+        void clear_dirty();
+
+        // 是否为尚未分配ID的延迟会话
+        bool is_lazy() const;
+
+        // 设为延迟会话：读取为空，首次set_attribute时调用materializer
+        void set_materializer(Materializer materializer);
+
+        // 标记为部分加载：未加载的属性在首次读取时经loader获取，需要全部属性时一次取回
+        void set_attribute_loader(AttributeLoader::ptr loader);
+
+        // 是否只加载了部分属性
+        bool is_partial() const;
+
+        /* 部分加载时取回其余全部属性并丢弃loader，本地的改动优先。
+           按需加载只改变缓存的属性，不改变会话的逻辑内容，因此为const；
+           会话被缓存或复制前须先调用，副本不应与原对象共用loader */
+        void load_all_attributes() const;
+
+    private:
+        friend class SessionManager; // 由SessionManager为延迟会话分配ID
+        friend class SessionCodec; // 直接编解码属性表
+
     private:
         std::string session_id_; // 会话ID
-        std::unordered_map<std::string, std::string> attributes_; // 会话属性
+        mutable std::unordered_map<std::string, std::string> attributes_; // 会话属性，部分加载时读取会补充
         std::chrono::system_clock::time_point expiry_time_; // 过期时间
         uint32_t timeout_; // 会话超时时间（秒）
+        std::unordered_set<std::string> dirty_keys_; // 改动过的属性
+        bool dirty_ = true; // 属性有改动，尚未持久化
+        Materializer materializer_; // 非空表示延迟会话
+        mutable AttributeLoader::ptr loader_; // 非空表示只加载了部分属性
+        mutable std::unordered_set<std::string> absent_keys_; // 部分加载时已确认不存在的属性
+
+        // 重新下发Cookie的回调只属于本次请求交出的对象，存储快照等副本不带回调
+        struct CookieWriter
+        {
+            CookieWriter() = default;
+
+            CookieWriter(const CookieWriter &) {}
+
+            CookieWriter &operator=(const CookieWriter &) { return *this; }
+
+            explicit operator bool() const { return static_cast<bool>(write_); }
+
+            void operator()(const std::string &value) const { write_(value); }
+
+            std::function<void(const std::string &)> write_;
+        };
+
+        CookieWriter cookie_writer_; // 会话内容存放在Cookie中时，写入后经此重新下发Cookie
     };
 } // namespace zhttp::zsession
 
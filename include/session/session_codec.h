@@ -0,0 +1,27 @@
+#pragma once
+#include "session.h"
+#include <string_view>
+
+namespace zhttp::zsession
+{
+    /* 会话属性的二进制编码。
+       格式：魔数"\xA5S"、1字节版本号、varint属性个数，随后每个属性依次为varint键长、键、varint值长、值。
+       解码直接写入会话的属性表，没有中间DOM；以'{'开头的数据按旧的JSON格式解析，便于迁移期间读取存量会话 */
+    class SessionCodec
+    {
+    public:
+        static constexpr uint8_t kVersion = 1;
+
+        // 编码会话的全部属性，部分加载的会话先取回其余属性
+        static std::string encode(const Session &session);
+
+        // 解码并替换会话的属性，不标记改动；数据损坏或版本未知时返回false，会话属性保持不变
+        static bool decode(std::string_view data, Session &session);
+
+        // 数据是否为本编码格式（而非旧的JSON）
+        static bool is_binary(std::string_view data);
+
+    private:
+        static bool decode_json(std::string_view data, Session &session);
+    };
+} // namespace zhttp::zsession
@@ -0,0 +1,103 @@
+#pragma once
+#include "session_storage.h"
+#include "invalidation_bus.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace zhttp::zsession
+{
+    struct SessionFilterConfig
+    {
+        size_t capacity_ = 1000000; // 预计的活跃会话数，按每个会话约10个计数器分配
+        uint32_t hash_count_ = 7; // 每个ID占用的计数器个数，1~9
+        std::chrono::seconds rebuild_interval_{600}; // 从存储重建的周期，0表示只在启动与订阅中断时构建
+        InvalidationBus::ptr bus_; // 向共享存储的其他节点广播新建的会话，应使用独立的频道而不是近端缓存的失效总线
+    };
+
+    /* 活跃会话ID的计数布隆过滤器，放在存储之前，确定不存在的ID（伪造、已删除）不再访问存储。
+       4位计数器按64字节分块，一个ID的全部计数器落在同一块内，查询只有一次缓存未命中；计数器饱和后不再减少。
+       会话创建时由SessionManager加入；删除时只有存储确认本次删除了该会话才减少计数，同一ID不会被减两次。
+       重建时枚举存储中的全部ID（含已过期未清理的），因此存储中存在的ID都在表中；
+       清理过期等在存储内部发生的删除只会留下误判，由周期重建消除。
+       过滤器在首次从存储构建完成前放行全部ID，存储不支持枚举时始终放行。
+       多个节点共享存储时必须配置bus_：新建的会话经总线广播给其他节点；订阅中断可能漏掉消息，
+       此时过滤器暂时放行全部ID并立即重建。共享存储而没有配置总线时构造函数抛出std::invalid_argument */
+    class SessionIdFilter
+    {
+    public:
+        struct Stats
+        {
+            uint64_t checks_ = 0; // 查询次数
+            uint64_t rejected_ = 0; // 判定不存在、跳过存储的次数
+            uint64_t false_positives_ = 0; // 放行后存储中不存在的次数
+            uint64_t rebuilds_ = 0; // 成功重建的次数
+            size_t entries_ = 0; // 当前记录的ID数
+            double estimated_fp_rate_ = 0; // 按当前装载量估计的误判率，未计入分块的影响，实测值通常略高
+            double observed_fp_rate_ = 0; // 实测误判率：不存在的ID中被放行的比例
+        };
+
+        explicit SessionIdFilter(SessionStorage::ptr storage, SessionFilterConfig config = {});
+
+        ~SessionIdFilter();
+
+        SessionIdFilter(const SessionIdFilter &) = delete;
+
+        SessionIdFilter &operator=(const SessionIdFilter &) = delete;
+
+        // ID可能存在时返回true，返回false时ID一定不存在
+        bool might_contain(const std::string &session_id);
+
+        // 记录新创建的会话并广播给其他节点，须在写入存储之后调用
+        void add(const std::string &session_id);
+
+        // 删除会话，只能在存储确认删除了该ID之后调用；表中确定没有的ID直接忽略
+        void remove(const std::string &session_id);
+
+        // 放行的ID在存储中不存在
+        void report_false_positive();
+
+        // 从存储重建，存储不支持枚举或枚举失败时返回false并保留当前数据；重建期间订阅中断过时不标记为就绪
+        bool rebuild();
+
+        // 是否已从存储构建完成
+        bool ready() const;
+
+        Stats stats() const;
+
+    private:
+        class Table;
+
+        uint64_t hash(const std::string &session_id) const;
+
+        // 只写入本节点的表
+        void add_local(const std::string &session_id);
+
+        // 订阅中断后放行全部ID，由后台线程立即重建
+        void request_rebuild();
+
+        void rebuild_loop();
+
+    private:
+        SessionStorage::ptr storage_;
+        SessionFilterConfig config_;
+        uint64_t seed_ = 0; // 哈希种子，外部无法构造必然误判的ID
+        std::shared_ptr<Table> table_; // 以std::atomic_load/atomic_store读写
+        std::shared_ptr<Table> staging_; // 重建中的新表，由update_mutex_保护
+        std::mutex update_mutex_; // 串行化增删与换表，保证重建期间新增的ID不会丢失
+        std::mutex rebuild_mutex_; // 串行化重建
+        std::atomic<bool> ready_{false};
+        std::atomic<uint64_t> resets_{0}; // 订阅中断的次数
+        std::atomic<uint64_t> checks_{0};
+        std::atomic<uint64_t> rejected_{0};
+        std::atomic<uint64_t> false_positives_{0};
+        std::atomic<uint64_t> rebuilds_{0};
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stop_ = false;
+        bool rebuild_requested_ = false;
+        std::thread thread_;
+        std::shared_ptr<void> subscription_; // 其他节点新建会话的订阅
+    };
+} // namespace zhttp::zsession
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace zhttp::zsession
+{
+    /* 会话ID生成器。
+       每个线程持有独立的ChaCha20密钥流，密钥取自getrandom，线程之间没有共享状态与锁；
+       密钥流按块生成并缓冲，每块开头的48字节用作下一块的密钥与IV后立即丢弃（快速密钥擦除），
+       已发出的ID无法由之后泄露的内部状态倒推。进程fork后子进程会重新取种。
+       ID为128位随机数，编码为22个字符的base64url（无填充），可直接放入Cookie */
+    class SessionIdGenerator
+    {
+    public:
+        static constexpr size_t kIdBytes = 16;
+        static constexpr size_t kIdLength = 22;
+
+        // 生成新的会话ID，线程安全
+        static std::string generate();
+
+        // 取随机字节，线程安全
+        static void fill(uint8_t *out, size_t length);
+
+        // 把16字节编码为22个base64url字符
+        static void encode(const uint8_t *bytes, char *out);
+    };
+} // namespace zhttp::zsession
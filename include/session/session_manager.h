@@ -2,9 +2,12 @@
 #include "session.h"
 #include "memory_storage.h"
 #include "db_storage.h"
+#include "session_refresher.h"
+#include "session_id_generator.h"
+#include "session_filter.h"
 #include "http/http_request.h"
 #include "http/http_response.h"
-#include <random>
+#include <optional>
 #include <shared_mutex>
 
 namespace zhttp::zsession
@@ -23,16 +26,31 @@ namespace zhttp::zsession
             return instance;
         }
 
-        // 从请求中获取或创建会话
+        /* 从请求中获取会话；请求没有有效会话时返回延迟会话：ID为空、属性为空，
+           首次set_attribute时才分配ID、向response写入Cookie并持久化；复制出的副本被写入时为副本分配ID。
+           响应发送后才写入的会话仍会持久化，但客户端收不到Cookie */
         std::shared_ptr<Session> get_session(const HttpRequest &request, HttpResponse *response);
 
         // 设置会话存储
         void set_session_storage(SessionStorage::ptr session_storage);
 
+        // 设置滑动过期的最小写入间隔，同一会话在间隔内最多写入一次过期时间
+        void set_refresh_interval(std::chrono::seconds interval);
+
+        /* 启用活跃会话ID过滤器，确定不存在的ID不再访问存储；更换存储时随之重建。
+           存储由多个节点共享而config没有配置总线时抛出std::invalid_argument */
+        void enable_session_filter(SessionFilterConfig config = {});
+
+        // 停用会话ID过滤器
+        void disable_session_filter();
+
+        // 过滤器统计，未启用时返回空
+        std::optional<SessionIdFilter::Stats> session_filter_stats() const;
+
         // 销毁会话
         void destroy_session(const std::string &session_id) const;
 
-        // 更新会话
+        // 更新会话，属性未改动时只合并刷新过期时间
         void update_session(const std::shared_ptr<Session> &session) const;
 
         // 清除所有过期会话
@@ -41,8 +59,14 @@ namespace zhttp::zsession
     private:
         SessionManager();
 
-        // 生成随机会话ID
-        std::string generate_session_id();
+        /* 为延迟会话分配ID、持久化并下发Cookie。session是实际被写入的对象，可能是调用方复制出的副本；
+           origin为get_session交出的原对象，两者相同时直接存储原对象，否则存储一份快照。
+           响应已经发送（会话在请求结束后才写入）时不再下发Cookie */
+        void materialize(Session &session, const std::weak_ptr<Session> &origin,
+                         const std::weak_ptr<HttpResponse *> &response);
+
+        // 生成随机会话ID，线程安全
+        static std::string generate_session_id();
 
         // 从请求中获取会话ID
         static std::string get_session_id_from_request(const HttpRequest &request);
@@ -52,7 +76,10 @@ namespace zhttp::zsession
 
     private:
         std::shared_ptr<SessionStorage> session_storage_; // 会话存储
-        std::mt19937 rng_ = std::mt19937(std::random_device{}()); // 随机数生成器
+        std::chrono::seconds refresh_interval_{30}; // 滑动过期的最小写入间隔
+        std::unique_ptr<SessionRefresher> refresher_; // 过期时间的后台合并写入
+        std::optional<SessionFilterConfig> filter_config_; // 过滤器配置，未启用时为空
+        std::unique_ptr<SessionIdFilter> filter_; // 活跃会话ID过滤器
         mutable std::shared_mutex rb_mutex_{}; // 读写锁
     };
 } // namespace zhttp::zsession
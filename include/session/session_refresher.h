@@ -0,0 +1,69 @@
+#pragma once
+#include "session_storage.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace zhttp::zsession
+{
+    /* 滑动过期的写回合并器。
+       只读的请求不直接写存储，而是记录会话的新过期时间；后台线程每隔flush_period把待写入的会话
+       通过SessionStorage::touch批量写入。同一会话在interval内最多写入一次，interval应远小于会话超时时间 */
+    class SessionRefresher
+    {
+    public:
+        explicit SessionRefresher(SessionStorage::ptr storage,
+                                  std::chrono::seconds interval = std::chrono::seconds(30),
+                                  std::chrono::milliseconds flush_period = std::chrono::milliseconds(1000));
+
+        // 停止后台线程并写入剩余的刷新
+        ~SessionRefresher();
+
+        SessionRefresher(const SessionRefresher &) = delete;
+
+        SessionRefresher &operator=(const SessionRefresher &) = delete;
+
+        // 记录一次访问
+        void touch(const std::string &session_id, std::chrono::system_clock::time_point expiry_time);
+
+        // 会话刚被完整写入，interval内不再需要顺延
+        void written(const std::string &session_id);
+
+        // 会话已删除，丢弃待写入的刷新
+        void forget(const std::string &session_id);
+
+        // 立即写入全部待刷新的会话
+        void flush();
+
+        // 待写入的会话数
+        size_t pending() const;
+
+    private:
+        using SteadyTime = std::chrono::steady_clock::time_point;
+
+        struct alignas(64) Shard
+        {
+            mutable std::mutex mutex_;
+            std::unordered_map<std::string, std::chrono::system_clock::time_point> pending_; // 待写入的过期时间
+            std::unordered_map<std::string, SteadyTime> written_; // 最近一次写入的时间
+        };
+
+        static constexpr size_t kShardCount = 16;
+
+        Shard &shard_for(const std::string &session_id);
+
+        void flush_loop();
+
+    private:
+        SessionStorage::ptr storage_;
+        std::chrono::seconds interval_;
+        std::chrono::milliseconds flush_period_;
+        Shard shards_[kShardCount];
+        std::mutex flush_mutex_; // 串行化flush
+        SteadyTime last_prune_{}; // 上次清理写入记录的时间，由flush_mutex_保护
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stop_ = false;
+        std::thread thread_;
+    };
+} // namespace zhttp::zsession
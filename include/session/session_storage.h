@@ -1,8 +1,17 @@
 #pragma once
 #include "session.h"
+#include <functional>
+#include <vector>
 
 namespace zhttp::zsession
 {
+    // 顺延过期时间的请求
+    struct ExpiryUpdate
+    {
+        std::string session_id_;
+        std::chrono::system_clock::time_point expiry_time_;
+    };
+
     class SessionStorage
     {
     public:
@@ -16,10 +25,60 @@ namespace zhttp::zsession
         // 加载会话
         virtual std::shared_ptr<Session> load(const std::string &session_id) = 0;
 
-        // 删除会话
-        virtual void remove(const std::string &session_id) = 0;
+        // 删除会话，返回会话是否存在并被本次调用删除
+        virtual bool remove(const std::string &session_id) = 0;
 
         virtual void clear_expired() = 0; // 清除过期会话
+
+        // 加载会话并刷新过期时间，未过期时等价于load、refresh、store；远端存储可以合并为一次往返
+        virtual std::shared_ptr<Session> load_and_refresh(const std::string &session_id)
+        {
+            auto session = load(session_id);
+            if (session && !session->is_expired())
+            {
+                session->refresh();
+                store(session);
+            }
+            return session;
+        }
+
+        // 批量顺延过期时间，不存在的会话跳过；默认逐个load、设置过期时间后store，远端存储应合并为批量写入
+        virtual void touch(const std::vector<ExpiryUpdate> &updates)
+        {
+            for (const auto &update : updates)
+            {
+                if (auto session = load(update.session_id_);
+                    session && session->get_expiry_time() < update.expiry_time_)
+                {
+                    session->set_expiry_time(update.expiry_time_);
+                    store(session);
+                }
+            }
+        }
+
+        // 存储是否由多个节点共享，如Redis
+        virtual bool is_shared() const
+        {
+            return false;
+        }
+
+        // 会话内容是否可能存放在Cookie中；为true时SessionManager在会话写入与顺延后重新下发Cookie
+        virtual bool stores_in_cookie() const
+        {
+            return false;
+        }
+
+        // 会话内容存放在Cookie中时返回要下发的Cookie值，由服务器端保存时返回nullopt
+        virtual std::optional<std::string> cookie_token(const Session &)
+        {
+            return std::nullopt;
+        }
+
+        // 枚举存储中的全部会话ID，包括已过期但尚未清理的会话；不支持枚举的存储返回false
+        virtual bool for_each_session_id(const std::function<void(const std::string &)> &)
+        {
+            return false;
+        }
     };
 
     // 简单工厂模式
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ssl_context.h"
+#include "http/buffer_pool.h"
 #include <muduo/net/TcpConnection.h>
 #include <muduo/net/Buffer.h>
 
@@ -14,6 +15,8 @@ namespace zhttp::zssl
     class SslConnection
     {
     public:
+        static constexpr size_t kMaxBioCapacity = 64 * 1024; // 读完报文后只替换容量超过此值的内存BIO
+
         SslConnection(muduo::net::TcpConnectionPtr conn, SslContext *ctx);
 
         ~SslConnection();
@@ -31,7 +34,13 @@ namespace zhttp::zssl
         [[nodiscard]] bool is_handshake_completed() const;
 
         // 获取解密缓冲区
-        muduo::net::Buffer *get_decrypted_buffer() { return &decrypted_buffer_; }
+        muduo::net::Buffer *get_decrypted_buffer();
+
+        // 空闲时释放缓冲：归还空缓冲区，替换已读空的内存BIO，并让OpenSSL释放记录缓冲
+        void shrink();
+
+        // 开启SSL_MODE_RELEASE_BUFFERS，每次读完报文后归还空缓冲区并替换过大的内存BIO
+        void enable_release_buffers();
 
         // SSL BIO 操作回调
         static int bio_write(BIO *bio, const char *data, int len);
@@ -60,6 +69,12 @@ namespace zhttp::zssl
         // 读取write_bio数据
         void drain_write_bio();
 
+        // 把空的解密缓冲区归还缓存池
+        void release_decrypted_buffer();
+
+        // 归还空缓冲区，并把已读空且容量超过min_capacity的内存BIO替换为新的空BIO
+        void release_buffers(size_t min_capacity);
+
     private:
         SSL *ssl_; // ssl连接
         SslContext *context_; // ssl上下文
@@ -67,10 +82,11 @@ namespace zhttp::zssl
         SslState state_; // ssl状态
         BIO *read_bio_; // 网络数据->ssl
         BIO *write_bio_; // ssl->网络数据
-        muduo::net::Buffer read_buffer_; // 读取缓冲区
-        muduo::net::Buffer write_buffer_; // 写入缓冲区
-        muduo::net::Buffer decrypted_buffer_; //  解密缓冲区
+        BufferPool::BufferPtr read_buffer_; // 读取缓冲区，按需从缓存池获取
+        BufferPool::BufferPtr write_buffer_; // 写入缓冲区，按需从缓存池获取
+        BufferPool::BufferPtr decrypted_buffer_; //  解密缓冲区，按需从缓存池获取
         MessageCallback message_callback_; // 消息回调函数
         muduo::Timestamp receive_time_; // 接收时间
+        bool release_buffers_ = false; // 读完报文后是否释放空闲缓冲
     };
 } // namespace zhttp::zssl
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace zhttp::zutils
+{
+    // base64url解码（无填充），非法字符返回false
+    bool base64url_decode(std::string_view input, std::string &output);
+
+    // base64url编码（无填充）
+    std::string base64url_encode(std::string_view input);
+} // namespace zhttp::zutils
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace zhttp::zutils
+{
+    /* 基于纪元的内存回收（EBR）。
+       读者进入临界区时登记当前全局纪元，退出时清除；写者替换对象后把旧对象连同当时的纪元挂入回收表，
+       只有当所有活跃读者登记的纪元都晚于该纪元时才真正释放。
+       读者路径只有两次原子写，不加锁；每个线程在首次使用时注册一个记录，线程退出后记录留给其他线程复用。
+       记录可能仍被线程本地缓存引用，域销毁时不释放记录 */
+    class EpochDomain
+    {
+    public:
+        // 读者临界区，析构时退出
+        class Guard
+        {
+        public:
+            explicit Guard(EpochDomain &domain);
+
+            ~Guard();
+
+            Guard(const Guard &) = delete;
+
+            Guard &operator=(const Guard &) = delete;
+
+        private:
+            EpochDomain &domain_;
+        };
+
+        // 进程内全局的回收域
+        static EpochDomain &global();
+
+        EpochDomain();
+
+        ~EpochDomain();
+
+        // 进入读者临界区
+        Guard pin() { return Guard(*this); }
+
+        // 登记待回收对象，在没有读者可能持有它时调用deleter
+        void retire(std::function<void()> deleter);
+
+        template<typename T>
+        void retire(T *object)
+        {
+            retire([object] { delete object; });
+        }
+
+        // 尝试释放已安全的对象，返回仍待回收的数量
+        size_t reclaim();
+
+    private:
+        struct Record
+        {
+            static constexpr uint64_t kIdle = UINT64_MAX;
+
+            std::atomic<uint64_t> epoch_{kIdle}; // 读者登记的纪元，空闲时为kIdle
+            std::atomic<bool> in_use_{false};    // 是否已被某个线程占用
+            uint32_t depth_ = 0;                 // 嵌套深度，只由占用线程访问
+            Record *next_ = nullptr;
+        };
+
+        // 获取当前线程的记录
+        Record *local_record();
+
+        void enter();
+
+        void exit();
+
+    private:
+        const uint64_t id_;                  // 域编号，线程本地缓存以此区分，永不复用
+        std::atomic<uint64_t> epoch_{1};     // 全局纪元
+        std::atomic<Record *> records_{nullptr}; // 读者记录链表，只增不删
+        std::mutex retire_mutex_;            // 保护retired_
+        std::vector<std::pair<uint64_t, std::function<void()>>> retired_; // (退休纪元, 释放函数)
+    };
+} // namespace zhttp::zutils
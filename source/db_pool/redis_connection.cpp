@@ -42,6 +42,7 @@ namespace zhttp::zdb
                 return false;
             }
 
+            count_round_trip();
             redis_->ping();
             ZHTTP_LOG_DEBUG("Redis ping successful");
             return true;
@@ -122,6 +123,7 @@ namespace zhttp::zdb
             ZHTTP_LOG_DEBUG("Redis connection established to {}:{}", host_, port_);
 
             // 测试连接
+            count_round_trip();
             redis_->ping();
             ZHTTP_LOG_INFO("Redis connection fully established and configured");
         }
@@ -137,6 +139,7 @@ namespace zhttp::zdb
         std::lock_guard<std::mutex> lock(mutex_);
         try
         {
+            count_round_trip();
             if (ttl.count() > 0)
             {
                 redis_->setex(key, ttl, value);
@@ -158,6 +161,7 @@ namespace zhttp::zdb
         std::lock_guard<std::mutex> lock(mutex_);
         try
         {
+            count_round_trip();
             auto value = redis_->get(key);
             return value ? *value : "";
         }
@@ -173,6 +177,7 @@ namespace zhttp::zdb
         std::lock_guard<std::mutex> lock(mutex_);
         try
         {
+            count_round_trip();
             return redis_->exists(key) > 0;
         }
         catch (const std::exception &e)
@@ -187,6 +192,7 @@ namespace zhttp::zdb
         std::lock_guard<std::mutex> lock(mutex_);
         try
         {
+            count_round_trip();
             return redis_->del(key) > 0;
         }
         catch (const std::exception &e)
@@ -201,6 +207,7 @@ namespace zhttp::zdb
         std::lock_guard<std::mutex> lock(mutex_);
         try
         {
+            count_round_trip();
             redis_->hset(key, field, value);
         }
         catch (const std::exception &e)
@@ -215,6 +222,7 @@ namespace zhttp::zdb
         std::lock_guard<std::mutex> lock(mutex_);
         try
         {
+            count_round_trip();
             auto value = redis_->hget(key, field);
             return value ? *value : "";
         }
@@ -231,6 +239,7 @@ namespace zhttp::zdb
         try
         {
             std::unordered_map<std::string, std::string> result;
+            count_round_trip();
             redis_->hgetall(key, std::inserter(result, result.end()));
             return result;
         }
@@ -246,6 +255,7 @@ namespace zhttp::zdb
         std::lock_guard<std::mutex> lock(mutex_);
         try
         {
+            count_round_trip();
             redis_->expire(key, ttl);
         }
         catch (const std::exception &e)
@@ -266,6 +276,7 @@ namespace zhttp::zdb
             do
             {
                 std::vector<std::string> batch_keys;
+                count_round_trip();
                 cursor = redis_->scan(cursor, pattern, (long long)count, std::back_inserter(batch_keys));
                 
                 for (const auto &key : batch_keys)
@@ -283,4 +294,177 @@ namespace zhttp::zdb
         }
     }
 
+    void RedisConnection::publish(const std::string &channel, const std::string &message) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try
+        {
+            count_round_trip();
+            redis_->publish(channel, message);
+        }
+        catch (const std::exception &e)
+        {
+            ZHTTP_LOG_ERROR("Redis PUBLISH failed for channel {}: {}", channel, e.what());
+            throw DBException(e.what());
+        }
+    }
+
+    sw::redis::Subscriber RedisConnection::subscriber() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try
+        {
+            return redis_->subscriber();
+        }
+        catch (const std::exception &e)
+        {
+            ZHTTP_LOG_ERROR("Failed to create Redis subscriber: {}", e.what());
+            throw DBException(e.what());
+        }
+    }
+
+    std::vector<std::optional<std::string>> RedisConnection::hmget(const std::string &key,
+                                                                   const std::vector<std::string> &fields) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try
+        {
+            std::vector<std::optional<std::string>> values;
+            values.reserve(fields.size());
+            count_round_trip();
+            redis_->hmget(key, fields.begin(), fields.end(), std::back_inserter(values));
+            return values;
+        }
+        catch (const std::exception &e)
+        {
+            ZHTTP_LOG_ERROR("Redis HMGET failed for key {}: {}", key, e.what());
+            throw DBException(e.what());
+        }
+    }
+
+    void RedisConnection::hset_expire(const std::string &key,
+                                      const std::unordered_map<std::string, std::string> &fields,
+                                      const std::chrono::seconds ttl,
+                                      const std::vector<std::string> &removed_fields) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try
+        {
+            // 流水线化的事务：MULTI、HDEL、HSET、EXPIRE、EXEC一次发出，只等待一次回复
+            count_round_trip();
+            auto transaction = redis_->transaction(true, false);
+            if (!removed_fields.empty())
+            {
+                transaction.hdel(key, removed_fields.begin(), removed_fields.end());
+            }
+            if (!fields.empty())
+            {
+                transaction.hset(key, fields.begin(), fields.end());
+            }
+            transaction.expire(key, ttl).exec();
+        }
+        catch (const std::exception &e)
+        {
+            ZHTTP_LOG_ERROR("Redis HSET/EXPIRE failed for key {}: {}", key, e.what());
+            throw DBException(e.what());
+        }
+    }
+
+    const std::string &RedisConnection::script_sha(const std::string &script, const bool reload) const
+    {
+        auto it = script_shas_.find(script);
+        if (it == script_shas_.end() || reload)
+        {
+            count_round_trip();
+            std::string sha = redis_->script_load(script);
+            it = script_shas_.insert_or_assign(script, std::move(sha)).first;
+        }
+        return it->second;
+    }
+
+    std::vector<std::string> RedisConnection::eval(const std::string &script, const std::vector<std::string> &keys,
+                                                   const std::vector<std::string> &args) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try
+        {
+            std::vector<std::string> result;
+            try
+            {
+                const std::string &sha = script_sha(script, false);
+                count_round_trip();
+                redis_->evalsha(sha, keys.begin(), keys.end(), args.begin(), args.end(), std::back_inserter(result));
+            }
+            catch (const sw::redis::ReplyError &e)
+            {
+                // 服务器重启或执行过SCRIPT FLUSH后脚本缓存丢失，重新加载一次
+                if (std::string_view(e.what()).rfind("NOSCRIPT", 0) != 0)
+                {
+                    throw;
+                }
+                result.clear();
+                const std::string &sha = script_sha(script, true);
+                count_round_trip();
+                redis_->evalsha(sha, keys.begin(), keys.end(), args.begin(), args.end(), std::back_inserter(result));
+            }
+            return result;
+        }
+        catch (const std::exception &e)
+        {
+            ZHTTP_LOG_ERROR("Redis EVALSHA failed: {}", e.what());
+            throw DBException(e.what());
+        }
+    }
+
+    std::vector<long long> RedisConnection::eval_pipelined(const std::string &script,
+                                                           const std::vector<ScriptCall> &calls) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        try
+        {
+            std::vector<long long> results(calls.size());
+            bool reload = false;
+            for (int attempt = 0; attempt < 2; ++attempt)
+            {
+                const std::string &sha = script_sha(script, reload);
+                auto pipeline = redis_->pipeline(false);
+                for (const auto &call : calls)
+                {
+                    pipeline.evalsha(sha, call.keys_.begin(), call.keys_.end(), call.args_.begin(), call.args_.end());
+                }
+                count_round_trip();
+                auto replies = pipeline.exec();
+
+                // 脚本缓存丢失时所有调用都会返回NOSCRIPT，重新加载后整批重试一次
+                reload = false;
+                for (size_t i = 0; i < calls.size(); ++i)
+                {
+                    try
+                    {
+                        results[i] = replies.get<long long>(i);
+                    }
+                    catch (const sw::redis::ReplyError &e)
+                    {
+                        if (attempt > 0 || std::string_view(e.what()).rfind("NOSCRIPT", 0) != 0)
+                        {
+                            throw;
+                        }
+                        reload = true;
+                        break;
+                    }
+                }
+                if (!reload)
+                {
+                    break;
+                }
+            }
+            return results;
+        }
+        catch (const std::exception &e)
+        {
+            ZHTTP_LOG_ERROR("Redis pipelined EVALSHA failed: {}", e.what());
+            throw DBException(e.what());
+        }
+    }
+
 } // namespace zhttp::zdb
@@ -0,0 +1,238 @@
+#include "http/balanced_tcp_server.h"
+#include "log/http_logger.h"
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+namespace zhttp
+{
+    void LoopLoad::sample(const int64_t window_ns)
+    {
+        const int64_t busy = busy_ns_.exchange(0, std::memory_order_relaxed);
+        const double window = std::min(1.0, static_cast<double>(busy) / static_cast<double>(window_ns));
+        // 指数平滑，约0.3秒后反映负载变化
+        const double ratio = busy_ratio_.load(std::memory_order_relaxed) * 0.5 + window * 0.5;
+        busy_ratio_.store(ratio, std::memory_order_relaxed);
+    }
+
+    double LoopLoad::score() const
+    {
+        return static_cast<double>(connections()) +
+               static_cast<double>(std::max<int64_t>(queued_bytes(), 0)) / kQueuedBytesUnit +
+               busy_ratio() * kBusyWeight;
+    }
+
+    BalancedTcpServer::BalancedTcpServer(muduo::net::EventLoop *loop,
+                                         const muduo::net::InetAddress &listen_addr,
+                                         const std::string &name,
+                                         const muduo::net::TcpServer::Option option)
+        : loop_(loop), name_(name), ip_port_(listen_addr.toIpPort()),
+          listen_fd_(::socket(listen_addr.family(), SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP)),
+          idle_fd_(::open("/dev/null", O_RDONLY | O_CLOEXEC)),
+          thread_pool_(std::make_unique<muduo::net::EventLoopThreadPool>(loop, name))
+    {
+        if (listen_fd_ < 0)
+        {
+            ZHTTP_LOG_FATAL("Failed to create listen socket: {}", std::strerror(errno));
+            abort();
+        }
+
+        int on = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (option == muduo::net::TcpServer::kReusePort)
+        {
+            ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+        }
+
+        const socklen_t len = listen_addr.family() == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+        if (::bind(listen_fd_, listen_addr.getSockAddr(), len) != 0)
+        {
+            ZHTTP_LOG_FATAL("Failed to bind {}: {}", ip_port_, std::strerror(errno));
+            abort();
+        }
+
+        accept_channel_ = std::make_unique<muduo::net::Channel>(loop_, listen_fd_);
+        accept_channel_->setReadCallback([this](muduo::Timestamp) { handle_accept(); });
+    }
+
+    BalancedTcpServer::~BalancedTcpServer()
+    {
+        for (auto &[name, conn] : connections_)
+        {
+            muduo::net::TcpConnectionPtr guard(conn);
+            conn.reset();
+            guard->getLoop()->runInLoop([guard] { guard->connectDestroyed(); });
+        }
+        accept_channel_->disableAll();
+        accept_channel_->remove();
+        ::close(listen_fd_);
+        ::close(idle_fd_);
+    }
+
+    void BalancedTcpServer::set_thread_num(const int num) const
+    {
+        thread_pool_->setThreadNum(num);
+    }
+
+    void BalancedTcpServer::start()
+    {
+        if (started_)
+        {
+            return;
+        }
+        started_ = true;
+
+        // 线程池start返回时，各IO线程已完成初始化回调
+        thread_pool_->start(thread_init_callback_);
+        loops_ = thread_pool_->getAllLoops();
+        for (muduo::net::EventLoop *io_loop : loops_)
+        {
+            auto load = std::make_unique<LoopLoad>();
+            LoopLoad *raw_load = load.get();
+            io_loop->runEvery(kSampleInterval, [raw_load]
+            {
+                raw_load->sample(static_cast<int64_t>(kSampleInterval * 1e9));
+            });
+            loads_.emplace_back(std::move(load));
+        }
+
+        loop_->runInLoop([this]
+        {
+            if (::listen(listen_fd_, SOMAXCONN) != 0)
+            {
+                ZHTTP_LOG_FATAL("Failed to listen on {}: {}", ip_port_, std::strerror(errno));
+                abort();
+            }
+            accept_channel_->enableReading();
+        });
+        ZHTTP_LOG_INFO("BalancedTcpServer[{}] listening on {} with {} IO loops, policy: {}", name_, ip_port_,
+                       loops_.size(), policy_ == LoopPolicy::LeastLoaded ? "least-loaded" : "round-robin");
+    }
+
+    LoopLoad *BalancedTcpServer::get_load(const muduo::net::EventLoop *loop) const
+    {
+        for (size_t i = 0; i < loops_.size(); ++i)
+        {
+            if (loops_[i] == loop)
+            {
+                return loads_[i].get();
+            }
+        }
+        return nullptr;
+    }
+
+    // 监听套接字可读
+    void BalancedTcpServer::handle_accept()
+    {
+        // 一次就绪尽量取完，减少epoll唤醒
+        while (true)
+        {
+            sockaddr_in6 peer{};
+            socklen_t len = sizeof(peer);
+            const int fd = ::accept4(listen_fd_, reinterpret_cast<sockaddr *>(&peer), &len,
+                                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd >= 0)
+            {
+                if (accept_filter_ && !accept_filter_(reinterpret_cast<const sockaddr *>(&peer)))
+                {
+                    ::close(fd); // 被过滤的连接不进入IO线程，也不分配缓冲区
+                    continue;
+                }
+                new_connection(fd, muduo::net::InetAddress(peer));
+                continue;
+            }
+
+            if (errno == EMFILE || errno == ENFILE)
+            {
+                // fd耗尽：借占位fd接受并立即关闭，避免监听套接字一直可读导致忙轮询
+                ZHTTP_LOG_ERROR("Too many open files, rejecting connection");
+                ::close(idle_fd_);
+                idle_fd_ = ::accept(listen_fd_, nullptr, nullptr);
+                ::close(idle_fd_);
+                idle_fd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+            }
+            else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED)
+            {
+                ZHTTP_LOG_ERROR("accept failed: {}", std::strerror(errno));
+            }
+            if (errno != EINTR && errno != ECONNABORTED)
+            {
+                break;
+            }
+        }
+    }
+
+    // 为新连接选择IO线程
+    size_t BalancedTcpServer::select_loop()
+    {
+        if (loops_.size() == 1)
+        {
+            return 0;
+        }
+        if (policy_ == LoopPolicy::RoundRobin)
+        {
+            const size_t index = next_;
+            next_ = (next_ + 1) % loops_.size();
+            return index;
+        }
+
+        // 分数相同时从轮询位置开始选，避免总是落在第一个loop上
+        size_t best = next_;
+        double best_score = std::numeric_limits<double>::max();
+        for (size_t n = 0; n < loops_.size(); ++n)
+        {
+            const size_t i = (next_ + n) % loops_.size();
+            if (const double score = loads_[i]->score(); score < best_score)
+            {
+                best = i;
+                best_score = score;
+            }
+        }
+        next_ = (best + 1) % loops_.size();
+        return best;
+    }
+
+    void BalancedTcpServer::new_connection(const int fd, const muduo::net::InetAddress &peer_addr)
+    {
+        const size_t index = select_loop();
+        muduo::net::EventLoop *io_loop = loops_[index];
+        const std::string conn_name = name_ + "-" + ip_port_ + "#" + std::to_string(next_conn_id_++);
+
+        sockaddr_in6 local{};
+        socklen_t len = sizeof(local);
+        ::getsockname(fd, reinterpret_cast<sockaddr *>(&local), &len);
+
+        ZHTTP_LOG_DEBUG("New connection {} from {} assigned to loop {} (score {:.2f})", conn_name,
+                        peer_addr.toIpPort(), index, loads_[index]->score());
+
+        auto conn = std::make_shared<muduo::net::TcpConnection>(io_loop, conn_name, fd,
+                                                                muduo::net::InetAddress(local), peer_addr);
+        connections_[conn_name] = conn;
+        loads_[index]->add_connection(1);
+        conn->setConnectionCallback(connection_callback_ ? connection_callback_
+                                                         : muduo::net::defaultConnectionCallback);
+        conn->setMessageCallback(message_callback_ ? message_callback_ : muduo::net::defaultMessageCallback);
+        conn->setCloseCallback([this](const muduo::net::TcpConnectionPtr &c) { remove_connection(c); });
+        io_loop->runInLoop([conn] { conn->connectEstablished(); });
+    }
+
+    void BalancedTcpServer::remove_connection(const muduo::net::TcpConnectionPtr &conn)
+    {
+        loop_->runInLoop([this, conn] { remove_connection_in_loop(conn); });
+    }
+
+    void BalancedTcpServer::remove_connection_in_loop(const muduo::net::TcpConnectionPtr &conn)
+    {
+        connections_.erase(conn->name());
+        if (LoopLoad *load = get_load(conn->getLoop()))
+        {
+            load->add_connection(-1);
+        }
+        conn->getLoop()->queueInLoop([conn] { conn->connectDestroyed(); });
+    }
+} // namespace zhttp
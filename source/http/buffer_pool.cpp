@@ -0,0 +1,35 @@
+#include "http/buffer_pool.h"
+
+namespace zhttp
+{
+    BufferPool &BufferPool::local()
+    {
+        thread_local BufferPool pool;
+        return pool;
+    }
+
+    BufferPool::BufferPtr BufferPool::acquire()
+    {
+        if (buffers_.empty())
+        {
+            return std::make_unique<muduo::net::Buffer>();
+        }
+        BufferPtr buffer = std::move(buffers_.back());
+        buffers_.pop_back();
+        return buffer;
+    }
+
+    void BufferPool::release(BufferPtr buffer)
+    {
+        if (!buffer || buffer->readableBytes() > 0 || buffers_.size() >= kMaxCached)
+        {
+            return;
+        }
+        // 大请求撑大的缓冲区不长期占用内存
+        if (buffer->internalCapacity() > kMaxCapacity)
+        {
+            buffer->shrink(0);
+        }
+        buffers_.emplace_back(std::move(buffer));
+    }
+} // namespace zhttp
@@ -263,6 +263,16 @@ namespace zhttp
         return complete;
     }
 
+    bool HttpContext::is_expect_request_line() const
+    {
+        return state_ == HttpRequestParseState::ExpectRequestLine;
+    }
+
+    bool HttpContext::is_expect_body() const
+    {
+        return state_ == HttpRequestParseState::ExpectBody;
+    }
+
     const HttpRequest &HttpContext::request() const
     {
         return request_;
@@ -282,4 +292,14 @@ namespace zhttp
         ZHTTP_LOG_DEBUG("HTTP context reset completed");
     }
 
+    void HttpContext::set_timer_entry(std::shared_ptr<TimingWheel::Entry> entry)
+    {
+        timer_entry_ = std::move(entry);
+    }
+
+    TimingWheel::Entry *HttpContext::timer_entry() const
+    {
+        return timer_entry_.get();
+    }
+
 } // namespace zhttp
\ No newline at end of file
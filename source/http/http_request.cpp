@@ -81,8 +81,56 @@ namespace zhttp
             ZHTTP_LOG_DEBUG("HTTP request path parameter found: '{}' = '{}'", key, it->second);
             return it->second;
         }
+        return std::string(get_path_parameter(key));
+    }
+
+    void HttpRequest::add_path_parameter(const std::string_view name, const size_t offset, const size_t length)
+    {
+        path_parameter_list_.push_back({name, static_cast<uint32_t>(offset), static_cast<uint32_t>(length)});
+    }
+
+    void HttpRequest::pop_path_parameter()
+    {
+        path_parameter_list_.pop_back();
+    }
+
+    std::string_view HttpRequest::get_path_parameter(const std::string_view key) const
+    {
+        const std::string_view path = path_;
+        for (const auto &param : path_parameter_list_)
+        {
+            if (!param.name_.empty() && param.name_ == key)
+            {
+                return path.substr(param.offset_, param.length_);
+            }
+        }
+
+        // 兼容按位置命名的参数：param1、param2...
+        constexpr std::string_view prefix = "param";
+        if (key.size() > prefix.size() && key.compare(0, prefix.size(), prefix) == 0)
+        {
+            size_t index = 0;
+            for (size_t i = prefix.size(); i < key.size(); ++i)
+            {
+                if (key[i] < '0' || key[i] > '9')
+                {
+                    return {};
+                }
+                index = index * 10 + (key[i] - '0');
+            }
+            if (index >= 1 && index <= path_parameter_list_.size())
+            {
+                const auto &param = path_parameter_list_[index - 1];
+                return path.substr(param.offset_, param.length_);
+            }
+        }
         ZHTTP_LOG_DEBUG("HTTP request path parameter not found: '{}'", key);
-        return "";
+        return {};
+    }
+
+    const std::vector<HttpRequest::PathParameter> &HttpRequest::get_path_parameter_list() const
+    {
+        return path_parameter_list_;
     }
 
     // 设置与获取请求查询参数
@@ -227,6 +275,18 @@ namespace zhttp
         return content_length_;
     }
 
+    // 设置与获取客户端地址
+    void HttpRequest::set_remote_address(const std::string_view &address)
+    {
+        remote_address_ = std::string(address.begin(), address.end());
+        ZHTTP_LOG_DEBUG("HTTP request remote address set to: {}", remote_address_);
+    }
+
+    const std::string &HttpRequest::get_remote_address() const
+    {
+        return remote_address_;
+    }
+
     void HttpRequest::swap(HttpRequest &other) noexcept
     {
         ZHTTP_LOG_DEBUG("Swapping HTTP request objects");
@@ -235,11 +295,14 @@ namespace zhttp
         path_.swap(other.path_);
         version_.swap(other.version_);
         path_parameters_.swap(other.path_parameters_);
+        path_parameter_list_.swap(other.path_parameter_list_);
         query_parameters_.swap(other.query_parameters_);
         std::swap(receive_time_, other.receive_time_);
         headers_.swap(other.headers_);
         content_.swap(other.content_);
         std::swap(content_length_, other.content_length_);
+        remote_address_.swap(other.remote_address_);
+        attributes_.swap(other.attributes_);
 
         ZHTTP_LOG_DEBUG("HTTP request objects swapped successfully");
     }
@@ -118,15 +118,32 @@ namespace zhttp
         return is_keep_alive_;
     }
 
+    void HttpResponse::set_serialized_head(std::shared_ptr<const std::string> head, const StatusCode status_code)
+    {
+        serialized_head_ = std::move(head);
+        status_code_ = status_code;
+        headers_.clear();
+        body_.clear();
+        set_keep_alive(is_keep_alive_);
+    }
+
     void HttpResponse::append_buffer(muduo::net::Buffer *output) const
     {
         ZHTTP_LOG_DEBUG("Appending HTTP response to buffer");
-        
-        // 响应行
-        std::string response_line = version_ + " " + std::to_string(static_cast<int>(status_code_)) + " " + status_message_ + delim;
-        output->append(response_line);
-        
-        ZHTTP_LOG_DEBUG("Response line appended: {}", response_line.substr(0, response_line.length() - 2)); // 去掉\r\n显示
+
+        if (serialized_head_)
+        {
+            // 预序列化的响应行与头部整段拷贝
+            output->append(*serialized_head_);
+        }
+        else
+        {
+            // 响应行
+            std::string response_line = version_ + " " + std::to_string(static_cast<int>(status_code_)) + " " + status_message_ + delim;
+            output->append(response_line);
+
+            ZHTTP_LOG_DEBUG("Response line appended: {}", response_line.substr(0, response_line.length() - 2)); // 去掉\r\n显示
+        }
         
         // 响应头
         size_t header_count = 0;
@@ -159,6 +176,15 @@ namespace zhttp
         return  request_origin_;
     }
 
+    std::weak_ptr<HttpResponse *> HttpResponse::lifetime()
+    {
+        if (!lifetime_.self_)
+        {
+            lifetime_.self_ = std::make_shared<HttpResponse *>(this);
+        }
+        return lifetime_.self_;
+    }
+
     std::string HttpResponse::to_http_date(const muduo::Timestamp &time)
     {
         const time_t seconds = time.secondsSinceEpoch();
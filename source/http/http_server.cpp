@@ -1,6 +1,8 @@
 #include "http/http_server.h"
 #include "http/http_context.h"
+#include "http/buffer_pool.h"
 #include "log/http_logger.h"
+#include <chrono>
 #include <utility>
 
 namespace zhttp
@@ -20,14 +22,14 @@ namespace zhttp
     void HttpServer::set_thread_num(const uint32_t num) const
     {
         ZHTTP_LOG_INFO("Setting thread number to {}", num);
-        server_->setThreadNum(static_cast<int>(num));
+        server_->set_thread_num(static_cast<int>(num));
     }
 
     // 启动
     void HttpServer::start() const
     {
         ZHTTP_LOG_INFO("HttpServer[{}] starts listening on {}", 
-                      server_->name(), server_->ipPort());
+                      server_->name(), server_->ip_port());
         if (is_ssl_)
         {
             ZHTTP_LOG_INFO("SSL is enabled, setting up SSL context");
@@ -38,6 +40,8 @@ namespace zhttp
                 abort();
             }
         }
+        // 启动后的路由修改以快照方式发布
+        router_->freeze();
         server_->start();
         ZHTTP_LOG_INFO("Server started, entering event loop");
         main_loop_->loop();
@@ -150,8 +154,16 @@ namespace zhttp
     // 添加中间件
     void HttpServer::add_middleware(std::shared_ptr<zmiddleware::Middleware> middleware) const
     {
-        ZHTTP_LOG_DEBUG("Adding middleware to chain");
-        middleware_chain_->add_middleware(std::move(middleware));
+        ZHTTP_LOG_DEBUG("Adding global middleware");
+        router_->use("", {std::move(middleware)});
+    }
+
+    // 路由分组
+    zrouter::RouteGroup HttpServer::group(const std::string &prefix,
+                                          std::vector<std::shared_ptr<zmiddleware::Middleware>> middlewares) const
+    {
+        ZHTTP_LOG_DEBUG("Creating route group {} with {} middlewares", prefix, middlewares.size());
+        return zrouter::RouteGroup(router_.get(), prefix, std::move(middlewares));
     }
 
     // 初始化
@@ -162,10 +174,9 @@ namespace zhttp
         // 初始化服务端元素
         listen_addr_ = std::make_unique<muduo::net::InetAddress>(port);
         main_loop_ = std::make_unique<muduo::net::EventLoop>();
-        server_ = std::make_unique<muduo::net::TcpServer>
+        server_ = std::make_unique<BalancedTcpServer>
                 (main_loop_.get(), *listen_addr_, name, option);
         router_ = std::make_unique<zrouter::Router>();
-        middleware_chain_ = std::make_unique<zmiddleware::MiddlewareChain>();
         
         ZHTTP_LOG_DEBUG("Server components initialized successfully");
         
@@ -175,15 +186,11 @@ namespace zhttp
                            std::forward<decltype(PH2)>(PH2));
         };
 
-        // 设置链接与数据回调
-        server_->setConnectionCallback([this](auto &&PH1) { on_connection(std::forward<decltype(PH1)>(PH1)); });
-        server_->setMessageCallback([this](auto &&PH1,
-                                           auto &&PH2, auto &&PH3)
-        {
-            on_message(std::forward<decltype(PH1)>(PH1),
-                       std::forward<decltype(PH2)>(PH2),
-                       std::forward<decltype(PH3)>(PH3));
-        });
+        // 每个IO线程启动时创建自己的时间轮
+        server_->set_thread_init_callback([this](muduo::net::EventLoop *loop) { init_timing_wheel(loop); });
+
+        // 设置链接回调，数据回调在连接建立时按连接设置
+        server_->set_connection_callback([this](auto &&PH1) { on_connection(std::forward<decltype(PH1)>(PH1)); });
 
         // 注册默认OPTIONS回调
         const HttpCallback default_options_callback = [&](const zhttp::HttpRequest &req, zhttp::HttpResponse *res)
@@ -211,6 +218,116 @@ namespace zhttp
         ZHTTP_LOG_INFO("SSL context setup completed");
     }
 
+    // 设置连接超时
+    void HttpServer::set_timeouts(const TimeoutConfig &timeouts)
+    {
+        ZHTTP_LOG_INFO("Setting timeouts: idle={}s, header={}s, body={}s",
+                       timeouts.idle_timeout_, timeouts.header_timeout_, timeouts.body_timeout_);
+        timeouts_ = timeouts;
+    }
+
+    // 设置空闲连接精简模式
+    void HttpServer::set_lean_idle(const bool lean_idle)
+    {
+        ZHTTP_LOG_INFO("Lean idle connections: {}", lean_idle ? "enabled" : "disabled");
+        lean_idle_ = lean_idle;
+    }
+
+    // 设置IO线程分配策略
+    void HttpServer::set_loop_policy(const LoopPolicy policy) const
+    {
+        server_->set_policy(policy);
+    }
+
+    // 设置IP黑白名单
+    void HttpServer::set_ip_filter(std::shared_ptr<zmiddleware::IpFilterMiddleware> filter)
+    {
+        ZHTTP_LOG_INFO("Setting IP filter with {} rules", filter->rule_count());
+        server_->set_accept_filter([filter](const sockaddr *peer) { return filter->allow_connection(peer); });
+
+        // 经可信代理转发的请求，真实客户端地址只能从请求头得到；在路由之前检查，未命中路由的请求同样过滤
+        request_filter_ = filter->config().trust_forwarded_for_ ? std::move(filter) : nullptr;
+    }
+
+    // 为IO线程创建时间轮
+    void HttpServer::init_timing_wheel(muduo::net::EventLoop *loop)
+    {
+        if (timeouts_.max_timeout() == 0)
+        {
+            ZHTTP_LOG_INFO("Connection timeouts disabled");
+            return;
+        }
+
+        auto wheel = std::make_unique<TimingWheel>(timeouts_.max_timeout(), [](TimingWheel::Entry &entry)
+        {
+            if (const auto conn = entry.conn_.lock())
+            {
+                ZHTTP_LOG_INFO("Connection {} {} timeout, closing", conn->name(),
+                               TimingWheel::type_name(entry.type_));
+                conn->forceClose();
+            }
+        });
+        TimingWheel *raw_wheel = wheel.get();
+        {
+            std::lock_guard<std::mutex> lock(timing_wheels_mutex_);
+            timing_wheels_[loop] = std::move(wheel);
+        }
+        loop->runEvery(1.0, [raw_wheel] { raw_wheel->tick(); });
+        ZHTTP_LOG_DEBUG("Timing wheel started for IO loop");
+    }
+
+    // 获取IO线程的时间轮
+    TimingWheel *HttpServer::get_timing_wheel(muduo::net::EventLoop *loop)
+    {
+        std::lock_guard<std::mutex> lock(timing_wheels_mutex_);
+        const auto it = timing_wheels_.find(loop);
+        return it == timing_wheels_.end() ? nullptr : it->second.get();
+    }
+
+    // 根据解析进度刷新连接超时
+    void HttpServer::refresh_timeout(const HttpContext &context, const bool has_pending) const
+    {
+        TimingWheel::Entry *entry = context.timer_entry();
+        if (!entry)
+        {
+            return;
+        }
+
+        if (context.is_expect_body())
+        {
+            // 请求体：每次有进展都顺延
+            entry->wheel_->update(entry, timeouts_.body_timeout_, TimingWheel::TimeoutType::Body);
+        }
+        else if (!context.is_expect_request_line() || has_pending)
+        {
+            // 请求头：从首个字节开始计时，之后的活动不再顺延
+            if (!entry->linked_ || entry->type_ != TimingWheel::TimeoutType::Header)
+            {
+                entry->wheel_->update(entry, timeouts_.header_timeout_, TimingWheel::TimeoutType::Header);
+            }
+        }
+        else
+        {
+            entry->wheel_->update(entry, timeouts_.idle_timeout_, TimingWheel::TimeoutType::Idle);
+        }
+    }
+
+    // 连接进入请求间隙，释放空缓冲
+    void HttpServer::enter_idle(const muduo::net::TcpConnectionPtr &conn)
+    {
+        // muduo的收发缓冲区默认各占1KB，空闲时换成零容量缓冲区，下次读写时再按需增长
+        if (conn->inputBuffer()->readableBytes() == 0)
+        {
+            muduo::net::Buffer empty(0);
+            conn->inputBuffer()->swap(empty);
+        }
+        if (conn->outputBuffer()->readableBytes() == 0)
+        {
+            muduo::net::Buffer empty(0);
+            conn->outputBuffer()->swap(empty);
+        }
+    }
+
     // 新链接建立回调
     void HttpServer::on_connection(const muduo::net::TcpConnectionPtr &conn)
     {
@@ -219,74 +336,155 @@ namespace zhttp
         if (conn->connected())
         {
             ZHTTP_LOG_INFO("New connection established: {}", conn->peerAddress().toIpPort());
-            
+
+            // 连接状态由连接自身的context持有，回调直接捕获裸指针，连接存活期间始终有效
+            auto state = std::make_shared<ConnectionState>();
+            ConnectionState *raw_state = state.get();
+            state->load_ = server_->get_load(conn->getLoop());
+            conn->setWriteCompleteCallback([raw_state](const muduo::net::TcpConnectionPtr &c)
+            {
+                sync_queued_bytes(c, *raw_state);
+            });
+            if (TimingWheel *wheel = get_timing_wheel(conn->getLoop()))
+            {
+                // TLS连接先进入握手，计入请求头超时
+                auto entry = std::make_shared<TimingWheel::Entry>(conn, wheel);
+                if (is_ssl_)
+                {
+                    wheel->update(entry.get(), timeouts_.header_timeout_, TimingWheel::TimeoutType::Header);
+                }
+                else
+                {
+                    wheel->update(entry.get(), timeouts_.idle_timeout_, TimingWheel::TimeoutType::Idle);
+                }
+                state->context_.set_timer_entry(std::move(entry));
+            }
+            conn->setContext(state);
+
             if (is_ssl_)
             {
                 ZHTTP_LOG_DEBUG("Creating SSL connection for {}", conn->name());
-                // 创建SSL连接
-                auto ssl_connection = std::make_unique<zssl::SslConnection>(conn,
-                                                                            ssl_context_.get());
-                ssl_connection->set_message_callback([this](auto &&PH1,
-                                                            auto &&PH2, auto &&PH3)
+                // 创建SSL连接，它会接管连接的数据回调，解密后再交给on_message
+                state->ssl_ = std::make_unique<zssl::SslConnection>(conn, ssl_context_.get());
+                state->ssl_->set_message_callback([this, raw_state](const muduo::net::TcpConnectionPtr &c,
+                                                                    muduo::net::Buffer *buf,
+                                                                    muduo::Timestamp receive_time)
                 {
-                    on_message(std::forward<decltype(PH1)>(PH1),
-                               std::forward<decltype(PH2)>(PH2),
-                               std::forward<decltype(PH3)>(PH3));
+                    on_message(c, *raw_state, buf, receive_time);
                 });
-                ssl_connections_[conn] = std::move(ssl_connection);
-                ssl_connections_[conn]->handshake();
+                if (lean_idle_)
+                {
+                    state->ssl_->enable_release_buffers();
+                }
+                state->ssl_->handshake();
                 ZHTTP_LOG_DEBUG("SSL handshake initiated for {}", conn->name());
             }
-            conn->setContext(HttpContext()); // 为每个链接设置HttpContext
+            else
+            {
+                conn->setMessageCallback([this, raw_state](const muduo::net::TcpConnectionPtr &c,
+                                                           muduo::net::Buffer *buf,
+                                                           muduo::Timestamp receive_time)
+                {
+                    on_message(c, *raw_state, buf, receive_time);
+                });
+            }
         }
         else
         {
-            if (is_ssl_)
+            const auto *state = boost::any_cast<ConnectionStatePtr>(conn->getMutableContext());
+            if (!state || !*state)
             {
-                ssl_connections_.erase(conn); // 删除SSL连接
-                ZHTTP_LOG_INFO("SSL connection closed: {}", conn->name());
+                return;
             }
-            else
+
+            // 连接已断开，立即从时间轮摘下
+            if (TimingWheel::Entry *entry = (*state)->context_.timer_entry())
+            {
+                entry->wheel_->remove(entry);
+            }
+
+            ZHTTP_LOG_INFO("{} closed: {}, requests: {}, received: {} bytes, sent: {} bytes",
+                           (*state)->ssl_ ? "SSL connection" : "Connection", conn->name(), (*state)->stats_.requests_,
+                           (*state)->stats_.bytes_received_, (*state)->stats_.bytes_sent_);
+
+            if ((*state)->load_)
             {
-                ZHTTP_LOG_INFO("Connection closed: {}", conn->name());
+                (*state)->load_->add_queued_bytes(-static_cast<int64_t>((*state)->queued_bytes_));
             }
+
+            // SslConnection持有连接的shared_ptr，必须在此释放以打破循环引用
+            conn->setContext(boost::any());
         }
     }
 
-    // 接受到数据回调
-    void HttpServer::on_message(const muduo::net::TcpConnectionPtr &conn, muduo::net::Buffer *buf,
-                                muduo::Timestamp receive_time)
+    // 接受到数据回调，统计处理耗时
+    void HttpServer::on_message(const muduo::net::TcpConnectionPtr &conn, ConnectionState &state,
+                                muduo::net::Buffer *buf, muduo::Timestamp receive_time)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        process_message(conn, state, buf, receive_time);
+        if (state.load_)
+        {
+            state.load_->add_busy(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    // 把连接输出缓冲区的排队字节数同步到IO线程负载
+    void HttpServer::sync_queued_bytes(const muduo::net::TcpConnectionPtr &conn, ConnectionState &state)
+    {
+        const size_t queued = conn->outputBuffer()->readableBytes();
+        if (state.load_ && queued != state.queued_bytes_)
+        {
+            state.load_->add_queued_bytes(static_cast<int64_t>(queued) - static_cast<int64_t>(state.queued_bytes_));
+            state.queued_bytes_ = queued;
+        }
+    }
+
+    // 解析并处理数据
+    void HttpServer::process_message(const muduo::net::TcpConnectionPtr &conn, ConnectionState &state,
+                                     muduo::net::Buffer *buf, muduo::Timestamp receive_time)
     {
         ZHTTP_LOG_DEBUG("Received message from {}, buffer size: {}", 
                        conn->name(), buf->readableBytes());
-        
-        auto *context = boost::any_cast<HttpContext>(conn->getMutableContext());
-        if (!context->parse_request(buf, receive_time))
+
+        HttpContext &context = state.context_;
+        const size_t readable = buf->readableBytes();
+        const bool parsed = context.parse_request(buf, receive_time);
+        state.stats_.bytes_received_ += readable - buf->readableBytes();
+        if (!parsed)
         {
             // 解析失败
             ZHTTP_LOG_ERROR("HTTP request parsing failed for connection {}", conn->name());
             const std::string response = "HTTP/1.1 400 Bad Request\r\n\r\n";
             muduo::net::Buffer output;
             output.append(response);
-            send(conn, output);
+            send(conn, state, output);
             conn->shutdown();
             return;
         }
 
-        if (!context->is_parse_complete())
+        if (!context.is_parse_complete())
         {
             ZHTTP_LOG_DEBUG("HTTP request parsing incomplete, waiting for more data from {}", 
                            conn->name());
+            refresh_timeout(context, buf->readableBytes() > 0);
             return;
         }
 
         ZHTTP_LOG_DEBUG("HTTP request parsing completed for {}", conn->name());
-        on_request(conn, context->request());
-        context->reset();
+        context.request().set_remote_address(conn->peerAddress().toIp());
+        on_request(conn, state, context.request());
+        context.reset();
+        refresh_timeout(context, buf->readableBytes() > 0);
+        if (lean_idle_ && buf->readableBytes() == 0 && conn->connected())
+        {
+            enter_idle(conn);
+        }
     }
 
     // 得到一个完整的HTTP请求后的回调处理
-    void HttpServer::on_request(const muduo::net::TcpConnectionPtr &conn,
+    void HttpServer::on_request(const muduo::net::TcpConnectionPtr &conn, ConnectionState &state,
                                 const zhttp::HttpRequest &request)
     {
         ZHTTP_LOG_INFO("Processing HTTP request: {} {} from {}", 
@@ -312,13 +510,16 @@ namespace zhttp
 
         callback_(request, &response);
 
-        // 响应数据
-        muduo::net::Buffer output;
-        response.append_buffer(&output);
+        // 响应数据，缓冲区取自当前IO线程的缓存池
+        BufferPool::BufferPtr output = BufferPool::local().acquire();
+        response.append_buffer(output.get());
         ZHTTP_LOG_DEBUG("Sending response to {}, status: {}", 
                        conn->name(), static_cast<int>(response.get_status_code()));
 
-        send(conn, output);
+        ++state.stats_.requests_;
+        send(conn, state, *output);
+        output->retrieveAll();
+        BufferPool::local().release(std::move(output));
 
         if (!response.is_keep_alive())
         {
@@ -334,41 +535,41 @@ namespace zhttp
         try
         {
             ZHTTP_LOG_DEBUG("Starting middleware-route-middleware processing");
-            
-            // 处理请求前中间件
-            HttpRequest req = request;
-            middleware_chain_->process_before(req);
-            ZHTTP_LOG_DEBUG("Before middleware processing completed");
-
-            // 特殊处理 OPTIONS 请求
-            if (req.get_method() == HttpRequest::Method::OPTIONS)
-            {
-                ZHTTP_LOG_DEBUG("Processing OPTIONS request");
-                req.set_path(options_path_);
-            }
 
-            // 路由处理
-            if (!router_->route(req, response))
-            {
-                ZHTTP_LOG_WARN("Route not found: {} {}", 
-                              req.get_method_string(req.get_method()), req.get_path());
-                response->set_status_code(zhttp::HttpResponse::StatusCode::NotFound);
-                response->set_status_message("Not Found");
-                response->set_body("404 Not Found");
-                response->set_keep_alive(false);
-            }
-            else
+            // 经可信代理转发的请求在路由之前按真实客户端地址过滤，被拒绝时已写入403；未命中路由的请求同样不能绕过
+            if (!request_filter_ || request_filter_->filter_request(request, *response))
             {
-                ZHTTP_LOG_DEBUG("Route processed successfully");
+                // 路由处理，中间件由命中的路由按作用域执行，未命中的请求不经过中间件
+                HttpRequest req = request;
+                bool routed;
+                if (req.get_method() == HttpRequest::Method::OPTIONS)
+                {
+                    // 特殊处理 OPTIONS 请求：按原路径的作用域执行中间件（如CORS预检）
+                    ZHTTP_LOG_DEBUG("Processing OPTIONS request");
+                    routed = router_->dispatch_options(req, response, options_path_);
+                }
+                else
+                {
+                    routed = router_->dispatch(req, response);
+                }
+                if (!routed)
+                {
+                    ZHTTP_LOG_WARN("Route not found: {} {}", 
+                                  req.get_method_string(req.get_method()), req.get_path());
+                    response->set_status_code(zhttp::HttpResponse::StatusCode::NotFound);
+                    response->set_status_message("Not Found");
+                    response->set_body("404 Not Found");
+                    response->set_keep_alive(false);
+                }
+                else
+                {
+                    ZHTTP_LOG_DEBUG("Route processed successfully");
+                }
             }
-
-            // 处理请求后中间件
-            middleware_chain_->process_after(*response);
-            ZHTTP_LOG_DEBUG("After middleware processing completed");
         }
         catch (const HttpResponse &req)
         {
-            // 处理中间件抛出的响应（如CORS预检请求）
+            // 处理仍以抛出方式短路的before/after中间件的响应
             ZHTTP_LOG_DEBUG("Middleware threw HttpResponse, using it as final response");
             *response = req;
         }
@@ -386,7 +587,8 @@ namespace zhttp
     }
 
     // 向客户端发送数据
-    void HttpServer::send(const muduo::net::TcpConnectionPtr &conn, muduo::net::Buffer &output)
+    void HttpServer::send(const muduo::net::TcpConnectionPtr &conn, ConnectionState &state,
+                          muduo::net::Buffer &output)
     {
         if (!conn->connected())
         {
@@ -396,9 +598,10 @@ namespace zhttp
 
         ZHTTP_LOG_DEBUG("Sending {} bytes to {}", output.readableBytes(), conn->name());
 
-        if (is_ssl_ && ssl_connections_.count(conn))
+        state.stats_.bytes_sent_ += output.readableBytes();
+        if (state.ssl_)
         {
-            ssl_connections_[conn]->send(output.toStringPiece().data(), output.readableBytes());
+            state.ssl_->send(output.toStringPiece().data(), output.readableBytes());
             ZHTTP_LOG_DEBUG("Data sent via SSL connection");
         }
         else
@@ -406,5 +609,6 @@ namespace zhttp
             conn->send(&output);
             ZHTTP_LOG_DEBUG("Data sent via regular connection");
         }
+        sync_queued_bytes(conn, state);
     }
 } // namespace zhttp
@@ -0,0 +1,130 @@
+#include "http/timing_wheel.h"
+#include "log/http_logger.h"
+
+namespace zhttp
+{
+    TimingWheel::Entry::~Entry()
+    {
+        if (linked_)
+        {
+            wheel_->remove(this);
+        }
+    }
+
+    TimingWheel::TimingWheel(uint32_t max_timeout, ExpireCallback cb)
+        : expire_callback_(std::move(cb))
+    {
+        // 槽位数大于最大超时，保证同一槽位中的节点都在同一圈内到期
+        size_t slots = 1;
+        while (slots < static_cast<size_t>(max_timeout) + 2)
+        {
+            slots <<= 1;
+        }
+        slots_ = std::vector<Entry>(slots);
+        for (auto &head : slots_)
+        {
+            head.prev_ = head.next_ = &head;
+        }
+        mask_ = slots - 1;
+        ZHTTP_LOG_DEBUG("TimingWheel created with {} slots", slots);
+    }
+
+    TimingWheel::~TimingWheel()
+    {
+        // 摘下所有节点，避免连接析构时访问已销毁的时间轮
+        for (auto &head : slots_)
+        {
+            while (head.next_ != &head)
+            {
+                Entry *entry = head.next_;
+                unlink(entry);
+                entry->linked_ = false;
+            }
+            head.prev_ = head.next_ = nullptr;
+        }
+    }
+
+    void TimingWheel::update(Entry *entry, uint32_t timeout, TimeoutType type)
+    {
+        remove(entry);
+        entry->type_ = type;
+        if (timeout == 0)
+        {
+            return;
+        }
+
+        // 到期时间向上取整一个tick，保证不早于timeout秒
+        entry->deadline_ = current_tick_ + timeout + 1;
+        link(&slots_[entry->deadline_ & mask_], entry);
+        entry->linked_ = true;
+        ++size_;
+    }
+
+    void TimingWheel::remove(Entry *entry)
+    {
+        if (!entry->linked_)
+        {
+            return;
+        }
+        unlink(entry);
+        entry->linked_ = false;
+        --size_;
+    }
+
+    void TimingWheel::tick()
+    {
+        ++current_tick_;
+        Entry &head = slots_[current_tick_ & mask_];
+
+        // 先把到期节点摘下，再逐个回调，回调中可以安全地更新或移除任意节点
+        std::vector<Entry *> expired;
+        for (Entry *entry = head.next_; entry != &head; entry = entry->next_)
+        {
+            if (entry->deadline_ <= current_tick_)
+            {
+                expired.push_back(entry);
+            }
+        }
+        for (Entry *entry : expired)
+        {
+            remove(entry);
+        }
+        for (Entry *entry : expired)
+        {
+            if (expire_callback_)
+            {
+                expire_callback_(*entry);
+            }
+        }
+    }
+
+    const char *TimingWheel::type_name(TimeoutType type)
+    {
+        switch (type)
+        {
+            case TimeoutType::Idle:
+                return "idle";
+            case TimeoutType::Header:
+                return "header";
+            case TimeoutType::Body:
+                return "body";
+            default:
+                return "unknown";
+        }
+    }
+
+    void TimingWheel::link(Entry *head, Entry *entry)
+    {
+        entry->prev_ = head->prev_;
+        entry->next_ = head;
+        head->prev_->next_ = entry;
+        head->prev_ = entry;
+    }
+
+    void TimingWheel::unlink(Entry *entry)
+    {
+        entry->prev_->next_ = entry->next_;
+        entry->next_->prev_ = entry->prev_;
+        entry->prev_ = entry->next_ = nullptr;
+    }
+} // namespace zhttp
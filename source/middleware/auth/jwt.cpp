@@ -0,0 +1,413 @@
+#include "middleware/auth/jwt.h"
+#include <openssl/core_names.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <openssl/param_build.h>
+#include <cmath>
+#include <stdexcept>
+
+namespace zhttp::zmiddleware
+{
+    namespace
+    {
+        constexpr int kMinRsaBits = 2048;
+
+        struct BnDeleter
+        {
+            void operator()(BIGNUM *bn) const { BN_free(bn); }
+        };
+
+        struct BuilderDeleter
+        {
+            void operator()(OSSL_PARAM_BLD *builder) const { OSSL_PARAM_BLD_free(builder); }
+        };
+
+        struct ParamDeleter
+        {
+            void operator()(OSSL_PARAM *params) const { OSSL_PARAM_free(params); }
+        };
+
+        struct PkeyCtxDeleter
+        {
+            void operator()(EVP_PKEY_CTX *ctx) const { EVP_PKEY_CTX_free(ctx); }
+        };
+
+        struct MdCtxDeleter
+        {
+            void operator()(EVP_MD_CTX *ctx) const { EVP_MD_CTX_free(ctx); }
+        };
+
+        bool parse_algorithm(const std::string &name, JwtAlgorithm &algorithm)
+        {
+            if (name == "RS256")
+            {
+                algorithm = JwtAlgorithm::RS256;
+                return true;
+            }
+            if (name == "ES256")
+            {
+                algorithm = JwtAlgorithm::ES256;
+                return true;
+            }
+            return false;
+        }
+
+        std::string string_member(const nlohmann::json &object, const char *name)
+        {
+            const auto it = object.find(name);
+            return it != object.end() && it->is_string() ? it->get<std::string>() : std::string();
+        }
+
+        // 由OSSL_PARAM构造公钥
+        std::shared_ptr<EVP_PKEY> key_from_params(const char *type, OSSL_PARAM_BLD *builder)
+        {
+            const std::unique_ptr<OSSL_PARAM, ParamDeleter> params(OSSL_PARAM_BLD_to_param(builder));
+            const std::unique_ptr<EVP_PKEY_CTX, PkeyCtxDeleter> ctx(EVP_PKEY_CTX_new_from_name(nullptr, type, nullptr));
+            EVP_PKEY *key = nullptr;
+            if (!params || !ctx || EVP_PKEY_fromdata_init(ctx.get()) != 1 ||
+                EVP_PKEY_fromdata(ctx.get(), &key, EVP_PKEY_PUBLIC_KEY, params.get()) != 1)
+            {
+                return nullptr;
+            }
+            return std::shared_ptr<EVP_PKEY>(key, EVP_PKEY_free);
+        }
+
+        std::shared_ptr<EVP_PKEY> rsa_key(const nlohmann::json &jwk)
+        {
+            std::string n, e;
+            if (!jwt::base64url_decode(string_member(jwk, "n"), n) || !jwt::base64url_decode(string_member(jwk, "e"), e) ||
+                n.empty() || e.empty())
+            {
+                return nullptr;
+            }
+            const std::unique_ptr<BIGNUM, BnDeleter> modulus(
+                    BN_bin2bn(reinterpret_cast<const unsigned char *>(n.data()), static_cast<int>(n.size()), nullptr));
+            const std::unique_ptr<BIGNUM, BnDeleter> exponent(
+                    BN_bin2bn(reinterpret_cast<const unsigned char *>(e.data()), static_cast<int>(e.size()), nullptr));
+            const std::unique_ptr<OSSL_PARAM_BLD, BuilderDeleter> builder(OSSL_PARAM_BLD_new());
+            if (!modulus || !exponent || !builder ||
+                OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_N, modulus.get()) != 1 ||
+                OSSL_PARAM_BLD_push_BN(builder.get(), OSSL_PKEY_PARAM_RSA_E, exponent.get()) != 1)
+            {
+                return nullptr;
+            }
+            auto key = key_from_params("RSA", builder.get());
+            if (key && EVP_PKEY_get_bits(key.get()) < kMinRsaBits)
+            {
+                return nullptr; // 拒绝过短的RSA密钥
+            }
+            return key;
+        }
+
+        std::shared_ptr<EVP_PKEY> ec_key(const nlohmann::json &jwk)
+        {
+            std::string x, y;
+            if (string_member(jwk, "crv") != "P-256" || !jwt::base64url_decode(string_member(jwk, "x"), x) ||
+                !jwt::base64url_decode(string_member(jwk, "y"), y) || x.size() != 32 || y.size() != 32)
+            {
+                return nullptr;
+            }
+            // 未压缩点格式：0x04 || x || y
+            std::string point = "\x04" + x + y;
+            const std::unique_ptr<OSSL_PARAM_BLD, BuilderDeleter> builder(OSSL_PARAM_BLD_new());
+            if (!builder ||
+                OSSL_PARAM_BLD_push_utf8_string(builder.get(), OSSL_PKEY_PARAM_GROUP_NAME, "prime256v1", 0) != 1 ||
+                OSSL_PARAM_BLD_push_octet_string(builder.get(), OSSL_PKEY_PARAM_PUB_KEY, point.data(), point.size()) != 1)
+            {
+                return nullptr;
+            }
+            return key_from_params("EC", builder.get());
+        }
+
+        // JWS的ES256签名为定长r||s，OpenSSL需要DER编码
+        bool ecdsa_to_der(const std::string &raw, std::string &der)
+        {
+            if (raw.size() != 64)
+            {
+                return false;
+            }
+            ECDSA_SIG *sig = ECDSA_SIG_new();
+            BIGNUM *r = BN_bin2bn(reinterpret_cast<const unsigned char *>(raw.data()), 32, nullptr);
+            BIGNUM *s = BN_bin2bn(reinterpret_cast<const unsigned char *>(raw.data()) + 32, 32, nullptr);
+            if (!sig || !r || !s || ECDSA_SIG_set0(sig, r, s) != 1)
+            {
+                BN_free(r);
+                BN_free(s);
+                ECDSA_SIG_free(sig);
+                return false;
+            }
+            const int length = i2d_ECDSA_SIG(sig, nullptr);
+            der.resize(length > 0 ? length : 0);
+            auto *out = reinterpret_cast<unsigned char *>(der.data());
+            const bool ok = length > 0 && i2d_ECDSA_SIG(sig, &out) == length;
+            ECDSA_SIG_free(sig);
+            return ok;
+        }
+
+        bool verify_signature(const Jwk &key, std::string_view signing_input, const std::string &signature)
+        {
+            std::string der;
+            const std::string *sig = &signature;
+            if (key.algorithm_ == JwtAlgorithm::ES256)
+            {
+                if (!ecdsa_to_der(signature, der))
+                {
+                    return false;
+                }
+                sig = &der;
+            }
+
+            const std::unique_ptr<EVP_MD_CTX, MdCtxDeleter> ctx(EVP_MD_CTX_new());
+            return ctx &&
+                   EVP_DigestVerifyInit(ctx.get(), nullptr, EVP_sha256(), nullptr, key.key_.get()) == 1 &&
+                   EVP_DigestVerify(ctx.get(), reinterpret_cast<const unsigned char *>(sig->data()), sig->size(),
+                                    reinterpret_cast<const unsigned char *>(signing_input.data()),
+                                    signing_input.size()) == 1;
+        }
+
+        // 读取NumericDate声明，不存在时为0，类型不符或超出范围返回false
+        bool numeric_date(const nlohmann::json &payload, const char *name, int64_t &value)
+        {
+            const auto it = payload.find(name);
+            if (it == payload.end())
+            {
+                value = 0;
+                return true;
+            }
+            if (it->is_number_float())
+            {
+                // 先检查范围再转换，超出int64_t的浮点数转换是未定义行为
+                const double seconds = it->get<double>();
+                if (!std::isfinite(seconds) || std::fabs(seconds) > static_cast<double>(JwtVerifier::kMaxNumericDate))
+                {
+                    return false;
+                }
+                value = static_cast<int64_t>(seconds);
+                return true;
+            }
+            if (it->is_number_unsigned())
+            {
+                const uint64_t seconds = it->get<uint64_t>();
+                if (seconds > static_cast<uint64_t>(JwtVerifier::kMaxNumericDate))
+                {
+                    return false;
+                }
+                value = static_cast<int64_t>(seconds);
+                return true;
+            }
+            if (!it->is_number_integer())
+            {
+                return false;
+            }
+            value = it->get<int64_t>();
+            return value >= -JwtVerifier::kMaxNumericDate;
+        }
+
+        bool audience_matches(const nlohmann::json &payload, const std::string &audience)
+        {
+            const auto it = payload.find("aud");
+            if (it == payload.end())
+            {
+                return false;
+            }
+            if (it->is_string())
+            {
+                return it->get_ref<const std::string &>() == audience;
+            }
+            if (it->is_array())
+            {
+                for (const auto &item : *it)
+                {
+                    if (item.is_string() && item.get_ref<const std::string &>() == audience)
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+    }
+
+    const char *to_string(const JwtStatus status)
+    {
+        switch (status)
+        {
+            case JwtStatus::Ok: return "ok";
+            case JwtStatus::Malformed: return "malformed token";
+            case JwtStatus::UnsupportedAlgorithm: return "unsupported algorithm";
+            case JwtStatus::UnknownKey: return "unknown key";
+            case JwtStatus::BadSignature: return "bad signature";
+            case JwtStatus::Expired: return "token expired";
+            case JwtStatus::NotYetValid: return "token not yet valid";
+            case JwtStatus::BadIssuer: return "bad issuer";
+            case JwtStatus::BadAudience: return "bad audience";
+        }
+        return "unknown";
+    }
+
+    std::string JwtClaims::get_string(const std::string &name) const
+    {
+        return string_member(payload_, name.c_str());
+    }
+
+    std::unique_ptr<JwkSet> JwkSet::parse(const std::string_view document, size_t *skipped)
+    {
+        const nlohmann::json doc = nlohmann::json::parse(document, nullptr, false);
+        if (doc.is_discarded() || !doc.is_object() || !doc.contains("keys") || !doc["keys"].is_array())
+        {
+            return nullptr;
+        }
+
+        auto set = std::make_unique<JwkSet>();
+        size_t bad = 0;
+        for (const auto &jwk : doc["keys"])
+        {
+            if (!jwk.is_object() || (jwk.contains("use") && string_member(jwk, "use") != "sig"))
+            {
+                ++bad;
+                continue;
+            }
+
+            const std::string type = string_member(jwk, "kty");
+            JwtAlgorithm algorithm = type == "EC" ? JwtAlgorithm::ES256 : JwtAlgorithm::RS256;
+            JwtAlgorithm declared;
+            if (jwk.contains("alg") && (!parse_algorithm(string_member(jwk, "alg"), declared) || declared != algorithm))
+            {
+                ++bad;
+                continue;
+            }
+
+            std::shared_ptr<EVP_PKEY> key = type == "RSA" ? rsa_key(jwk) : type == "EC" ? ec_key(jwk) : nullptr;
+            std::string key_id = string_member(jwk, "kid");
+            if (!key || set->keys_.count(key_id))
+            {
+                ++bad;
+                continue;
+            }
+            set->keys_.emplace(key_id, Jwk{key_id, algorithm, std::move(key)});
+        }
+        if (skipped)
+        {
+            *skipped = bad;
+        }
+        return set;
+    }
+
+    const Jwk *JwkSet::find(const std::string_view key_id, const JwtAlgorithm algorithm) const
+    {
+        if (key_id.empty())
+        {
+            // 没有kid时只接受唯一一把算法匹配的密钥，避免逐把尝试
+            const Jwk *found = nullptr;
+            for (const auto &[id, key] : keys_)
+            {
+                if (key.algorithm_ == algorithm)
+                {
+                    if (found)
+                    {
+                        return nullptr;
+                    }
+                    found = &key;
+                }
+            }
+            return found;
+        }
+        const auto it = keys_.find(std::string(key_id));
+        return it != keys_.end() && it->second.algorithm_ == algorithm ? &it->second : nullptr;
+    }
+
+    JwtStatus JwtVerifier::verify(const std::string_view token, const JwkSet &keys, const int64_t now,
+                                  std::shared_ptr<const JwtClaims> &claims) const
+    {
+        const size_t first = token.find('.');
+        const size_t second = first == std::string_view::npos ? first : token.find('.', first + 1);
+        if (second == std::string_view::npos || token.find('.', second + 1) != std::string_view::npos)
+        {
+            return JwtStatus::Malformed;
+        }
+
+        std::string header_text, payload_text, signature;
+        if (!jwt::base64url_decode(token.substr(0, first), header_text) ||
+            !jwt::base64url_decode(token.substr(second + 1), signature))
+        {
+            return JwtStatus::Malformed;
+        }
+        const nlohmann::json header = nlohmann::json::parse(header_text, nullptr, false);
+        if (header.is_discarded() || !header.is_object())
+        {
+            return JwtStatus::Malformed;
+        }
+
+        JwtAlgorithm algorithm;
+        if (!parse_algorithm(string_member(header, "alg"), algorithm))
+        {
+            return JwtStatus::UnsupportedAlgorithm;
+        }
+        const std::string key_id = string_member(header, "kid");
+        const Jwk *key = keys.find(key_id, algorithm);
+        if (!key)
+        {
+            return JwtStatus::UnknownKey;
+        }
+
+        // 先验签，签名通过后才解析载荷
+        if (!verify_signature(*key, token.substr(0, second), signature))
+        {
+            return JwtStatus::BadSignature;
+        }
+
+        if (!jwt::base64url_decode(token.substr(first + 1, second - first - 1), payload_text))
+        {
+            return JwtStatus::Malformed;
+        }
+        auto result = std::make_shared<JwtClaims>();
+        result->payload_ = nlohmann::json::parse(payload_text, nullptr, false);
+        if (result->payload_.is_discarded() || !result->payload_.is_object() ||
+            !numeric_date(result->payload_, "exp", result->expires_at_) ||
+            !numeric_date(result->payload_, "nbf", result->not_before_) ||
+            !numeric_date(result->payload_, "iat", result->issued_at_) ||
+            (options_.require_exp_ && result->expires_at_ == 0))
+        {
+            return JwtStatus::Malformed;
+        }
+        result->subject_ = string_member(result->payload_, "sub");
+        result->issuer_ = string_member(result->payload_, "iss");
+        result->key_id_ = key->key_id_;
+
+        if (const JwtStatus status = check_time(*result, now); status != JwtStatus::Ok)
+        {
+            return status;
+        }
+        if (!options_.issuer_.empty() && result->issuer_ != options_.issuer_)
+        {
+            return JwtStatus::BadIssuer;
+        }
+        if (!options_.audience_.empty() && !audience_matches(result->payload_, options_.audience_))
+        {
+            return JwtStatus::BadAudience;
+        }
+        claims = std::move(result);
+        return JwtStatus::Ok;
+    }
+
+    JwtVerifier::JwtVerifier(Options options) : options_(std::move(options))
+    {
+        if (options_.leeway_ < 0 || options_.leeway_ > kMaxNumericDate)
+        {
+            throw std::invalid_argument("jwt leeway out of range");
+        }
+    }
+
+    JwtStatus JwtVerifier::check_time(const JwtClaims &claims, const int64_t now) const
+    {
+        if (claims.expires_at_ != 0 && now >= claims.expires_at_ + options_.leeway_)
+        {
+            return JwtStatus::Expired;
+        }
+        if (claims.not_before_ != 0 && now + options_.leeway_ < claims.not_before_)
+        {
+            return JwtStatus::NotYetValid;
+        }
+        return JwtStatus::Ok;
+    }
+} // namespace zhttp::zmiddleware
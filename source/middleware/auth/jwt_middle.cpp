@@ -0,0 +1,254 @@
+#include "middleware/auth/jwt_middle.h"
+#include "log/http_logger.h"
+#include "utils/epoch.h"
+#include <sys/stat.h>
+#include <cctype>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace zhttp::zmiddleware
+{
+    namespace
+    {
+        // 提取"Bearer <token>"中的令牌，方案名不区分大小写
+        std::string_view bearer_token(const std::string &authorization)
+        {
+            constexpr std::string_view scheme = "bearer ";
+            if (authorization.size() <= scheme.size())
+            {
+                return {};
+            }
+            for (size_t i = 0; i < scheme.size(); ++i)
+            {
+                if (std::tolower(static_cast<unsigned char>(authorization[i])) != scheme[i])
+                {
+                    return {};
+                }
+            }
+            std::string_view token(authorization);
+            token.remove_prefix(scheme.size());
+            while (!token.empty() && token.front() == ' ')
+            {
+                token.remove_prefix(1);
+            }
+            while (!token.empty() && token.back() == ' ')
+            {
+                token.remove_suffix(1);
+            }
+            return token;
+        }
+    }
+
+    JwtAuthMiddleware::JwtAuthMiddleware(JwtConfig config)
+        : config_(std::move(config)),
+          verifier_(JwtVerifier::Options{config_.issuer_, config_.audience_,
+                                         static_cast<int64_t>(config_.leeway_), config_.require_exp_})
+    {
+        if (config_.cache_capacity_ > 0)
+        {
+            cache_ = std::make_unique<VerifiedTokenCache>(config_.cache_capacity_, config_.cache_shard_count_);
+        }
+        if (config_.jwks_file_.empty() || !reload())
+        {
+            set_keys(std::make_unique<JwkSet>());
+        }
+        if (!config_.jwks_file_.empty() && config_.reload_interval_ > 0)
+        {
+            watch_thread_ = std::thread(&JwtAuthMiddleware::watch_loop, this);
+        }
+        ZHTTP_LOG_INFO("JwtAuthMiddleware created: keys={}, cache capacity={}", key_count(), config_.cache_capacity_);
+    }
+
+    JwtAuthMiddleware::~JwtAuthMiddleware()
+    {
+        {
+            std::lock_guard<std::mutex> lock(watch_mutex_);
+            stop_ = true;
+        }
+        watch_cv_.notify_all();
+        if (watch_thread_.joinable())
+        {
+            watch_thread_.join();
+        }
+        delete keys_.load(std::memory_order_relaxed);
+    }
+
+    void JwtAuthMiddleware::before(HttpRequest &request)
+    {
+        const JwtStatus status = authenticate(request);
+        if (status == JwtStatus::Ok)
+        {
+            return;
+        }
+        HttpResponse response;
+        reject(request, response, status);
+        throw response;
+    }
+
+    void JwtAuthMiddleware::after(HttpResponse &)
+    {
+    }
+
+    JwtStatus JwtAuthMiddleware::authenticate(HttpRequest &request)
+    {
+        const std::string authorization = request.get_header("Authorization");
+        if (authorization.empty() && config_.optional_)
+        {
+            return JwtStatus::Ok;
+        }
+        const std::string_view token = bearer_token(authorization);
+        if (token.empty())
+        {
+            return JwtStatus::Malformed;
+        }
+
+        std::shared_ptr<const JwtClaims> claims;
+        const JwtStatus status = verify(token, claims);
+        if (status != JwtStatus::Ok)
+        {
+            ZHTTP_LOG_WARN("JWT rejected from {}: {}", request.get_remote_address(), to_string(status));
+            return status;
+        }
+        request.set_attribute(kClaimsKey, std::move(claims));
+        return JwtStatus::Ok;
+    }
+
+    JwtStatus JwtAuthMiddleware::verify(const std::string_view token, std::shared_ptr<const JwtClaims> &claims)
+    {
+        const int64_t now = std::time(nullptr);
+        VerifiedTokenCache::Digest digest{};
+        if (cache_)
+        {
+            digest = VerifiedTokenCache::digest(token);
+            if (auto cached = cache_->find(digest, now, generation_.load(std::memory_order_acquire)))
+            {
+                // 缓存到exp加容差为止，nbf仍需按当前时间复核
+                const JwtStatus status = verifier_.check_time(*cached, now);
+                if (status == JwtStatus::Ok)
+                {
+                    claims = std::move(cached);
+                }
+                return status;
+            }
+        }
+
+        JwtStatus status;
+        uint64_t generation;
+        {
+            const auto guard = zutils::EpochDomain::global().pin();
+            generation = generation_.load(std::memory_order_acquire);
+            status = verifier_.verify(token, *keys_.load(std::memory_order_acquire), now, claims);
+        }
+
+        if (status == JwtStatus::Ok && cache_)
+        {
+            // exp与leeway都有上限，相加不会溢出
+            const int64_t valid_until = claims->expires_at_ != 0
+                                            ? claims->expires_at_ + config_.leeway_
+                                            : std::numeric_limits<int64_t>::max();
+            cache_->insert(digest, claims, valid_until, generation);
+        }
+        return status;
+    }
+
+    bool JwtAuthMiddleware::reload()
+    {
+        std::lock_guard<std::mutex> lock(reload_mutex_);
+        const int64_t mtime = file_mtime();
+        std::ifstream in(config_.jwks_file_);
+        if (!in)
+        {
+            ZHTTP_LOG_ERROR("Cannot open JWKS file: {}", config_.jwks_file_);
+            return false;
+        }
+        std::ostringstream content;
+        content << in.rdbuf();
+
+        size_t skipped = 0;
+        auto keys = JwkSet::parse(content.str(), &skipped);
+        if (!keys)
+        {
+            ZHTTP_LOG_ERROR("Invalid JWKS file: {}", config_.jwks_file_);
+            return false;
+        }
+        if (skipped > 0)
+        {
+            ZHTTP_LOG_WARN("Skipped {} unsupported or invalid keys in {}", skipped, config_.jwks_file_);
+        }
+        ZHTTP_LOG_INFO("Loaded {} JWT keys from {}", keys->size(), config_.jwks_file_);
+        loaded_mtime_ = mtime;
+        set_keys(std::move(keys));
+        return true;
+    }
+
+    void JwtAuthMiddleware::set_keys(std::unique_ptr<JwkSet> keys)
+    {
+        // 先发布新密钥再推进代数；验证时先读代数再读密钥，读到新代数就一定用的是新密钥，
+        // 用旧密钥验证的结果只会带着旧代数写入缓存，不会再命中
+        const JwkSet *old = keys_.exchange(keys.release(), std::memory_order_acq_rel);
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+        if (old)
+        {
+            zutils::EpochDomain::global().retire(old);
+        }
+        if (cache_)
+        {
+            cache_->clear();
+        }
+    }
+
+    size_t JwtAuthMiddleware::key_count() const
+    {
+        const auto guard = zutils::EpochDomain::global().pin();
+        return keys_.load(std::memory_order_acquire)->size();
+    }
+
+    const JwtClaims *JwtAuthMiddleware::claims(const HttpRequest &request)
+    {
+        const auto *claims = request.get_attribute<std::shared_ptr<const JwtClaims>>(kClaimsKey);
+        return claims ? claims->get() : nullptr;
+    }
+
+    void JwtAuthMiddleware::reject(const HttpRequest &request, HttpResponse &response, const JwtStatus status)
+    {
+        response.set_response_line(request.get_version(), HttpResponse::StatusCode::Unauthorized, "Unauthorized");
+        response.set_header("WWW-Authenticate", request.get_header("Authorization").empty()
+                                                    ? "Bearer"
+                                                    : std::string("Bearer error=\"invalid_token\", error_description=\"") +
+                                                      to_string(status) + "\"");
+        response.set_content_type("text/plain");
+        response.set_body("401 Unauthorized");
+    }
+
+    void JwtAuthMiddleware::watch_loop()
+    {
+        const auto interval = std::chrono::seconds(config_.reload_interval_);
+        std::unique_lock<std::mutex> lock(watch_mutex_);
+        while (!watch_cv_.wait_for(lock, interval, [this] { return stop_; }))
+        {
+            int64_t loaded;
+            {
+                std::lock_guard<std::mutex> reload_lock(reload_mutex_);
+                loaded = loaded_mtime_;
+            }
+            const int64_t mtime = file_mtime();
+            if (mtime >= 0 && mtime != loaded)
+            {
+                ZHTTP_LOG_INFO("JWKS file {} changed, reloading", config_.jwks_file_);
+                reload();
+            }
+        }
+    }
+
+    int64_t JwtAuthMiddleware::file_mtime() const
+    {
+        struct stat st{};
+        if (::stat(config_.jwks_file_.c_str(), &st) != 0)
+        {
+            return -1;
+        }
+        return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    }
+} // namespace zhttp::zmiddleware
@@ -0,0 +1,97 @@
+#include "middleware/auth/verified_token_cache.h"
+#include <algorithm>
+#include <openssl/evp.h>
+
+namespace zhttp::zmiddleware
+{
+    VerifiedTokenCache::VerifiedTokenCache(const size_t capacity, const uint32_t shard_count)
+    {
+        size_t shards = 1;
+        while (shards < shard_count)
+        {
+            shards <<= 1;
+        }
+        shard_mask_ = shards - 1;
+        shard_capacity_ = std::max<size_t>(1, (capacity + shards - 1) / shards);
+        shards_ = std::make_unique<Shard[]>(shards);
+    }
+
+    VerifiedTokenCache::Digest VerifiedTokenCache::digest(const std::string_view token)
+    {
+        Digest digest{};
+        EVP_Digest(token.data(), token.size(), digest.data(), nullptr, EVP_sha256(), nullptr);
+        return digest;
+    }
+
+    VerifiedTokenCache::Shard &VerifiedTokenCache::shard_for(const Digest &key) const
+    {
+        // 桶内哈希用前8字节，分片用之后的字节，两者互不相关
+        uint64_t bits;
+        std::memcpy(&bits, key.data() + 8, sizeof(bits));
+        return shards_[bits & shard_mask_];
+    }
+
+    std::shared_ptr<const JwtClaims> VerifiedTokenCache::find(const Digest &key, const int64_t now,
+                                                              const uint64_t generation)
+    {
+        Shard &shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        const auto it = shard.index_.find(key);
+        if (it == shard.index_.end())
+        {
+            return nullptr;
+        }
+        if (now >= it->second->valid_until_ || it->second->generation_ != generation)
+        {
+            shard.lru_.erase(it->second);
+            shard.index_.erase(it);
+            return nullptr;
+        }
+        shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+        return it->second->claims_;
+    }
+
+    void VerifiedTokenCache::insert(const Digest &key, std::shared_ptr<const JwtClaims> claims,
+                                    const int64_t valid_until, const uint64_t generation)
+    {
+        Shard &shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        if (const auto it = shard.index_.find(key); it != shard.index_.end())
+        {
+            it->second->claims_ = std::move(claims);
+            it->second->valid_until_ = valid_until;
+            it->second->generation_ = generation;
+            shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+            return;
+        }
+
+        if (shard.lru_.size() >= shard_capacity_)
+        {
+            shard.index_.erase(shard.lru_.back().key_);
+            shard.lru_.pop_back();
+        }
+        shard.lru_.push_front(Entry{key, std::move(claims), valid_until, generation});
+        shard.index_.emplace(key, shard.lru_.begin());
+    }
+
+    void VerifiedTokenCache::clear()
+    {
+        for (size_t i = 0; i <= shard_mask_; ++i)
+        {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex_);
+            shards_[i].index_.clear();
+            shards_[i].lru_.clear();
+        }
+    }
+
+    size_t VerifiedTokenCache::size() const
+    {
+        size_t total = 0;
+        for (size_t i = 0; i <= shard_mask_; ++i)
+        {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex_);
+            total += shards_[i].lru_.size();
+        }
+        return total;
+    }
+} // namespace zhttp::zmiddleware
@@ -1,21 +1,27 @@
 #include "middleware/cors/cors_middle.h"
-#include <muduo/base/Logging.h>
-#include <algorithm>
+#include "log/http_logger.h"
 #include <utility>
 
 namespace zhttp::zmiddleware
 {
-    CorsMiddleware::CorsMiddleware(CorsConfig config) : config_(std::move(config)) {}
+    CorsMiddleware::CorsMiddleware(CorsConfig config) : config_(std::move(config)), policy_(config_) {}
 
-    // 请求前处理
-    void CorsMiddleware::before(zhttp::HttpRequest &request)
+    // 是否为跨域预检请求
+    bool CorsMiddleware::is_preflight(const HttpRequest &request) const
     {
-        LOG_DEBUG << "Processing request";
+        if (request.get_method() != HttpRequest::Method::OPTIONS)
+        {
+            return false;
+        }
         // 判断是否为跨域请求（有 Origin 字段）
         const std::string &origin = request.get_header("Origin");
-        bool is_cors_request = !origin.empty() && config_.server_origin_ != origin;
+        return !origin.empty() && config_.server_origin_ != origin;
+    }
 
-        if (request.get_method() == HttpRequest::Method::OPTIONS && is_cors_request)
+    // 请求前处理
+    void CorsMiddleware::before(zhttp::HttpRequest &request)
+    {
+        if (is_preflight(request))
         {
             // 仅处理跨域的 OPTIONS 预检请求
             HttpResponse response;
@@ -28,8 +34,6 @@ namespace zhttp::zmiddleware
 
     void CorsMiddleware::after(zhttp::HttpResponse &response)
     {
-        LOG_DEBUG << "CorsMiddleware::after - Processing response";
-
         // 判断是否为跨域请求（有 Origin 字段）
         const std::string &origin = response.get_request_origin();
         bool is_cors_request = !origin.empty() && config_.server_origin_ != origin;
@@ -37,25 +41,8 @@ namespace zhttp::zmiddleware
         if(!is_cors_request)
             return;
 
-        if (!config_.allow_origins_.empty())
-        {
-            // 如果允许所有源
-            if (std::find(config_.allow_origins_.begin(), config_.allow_origins_.end(), "*") !=
-                config_.allow_origins_.end())
-            {
-                add_cors_headers(response, "*");
-            }
-            else
-            {
-                // 否则设置允许的源
-                add_cors_headers(response, config_.allow_origins_[0]);
-            }
-        }
-        else
-        {
-            // 如果没有允许的源，则允许所有源
-            add_cors_headers(response, "*");
-        }
+        // 允许所有源时为"*"，否则为第一个允许的源
+        policy_.apply_headers(response, policy_.response_origin());
     }
 
     // 将字符串数组连接成单个字符串
@@ -73,78 +60,34 @@ namespace zhttp::zmiddleware
         return result;
     }
 
-    // 检查请求源是否允许进行跨域请求
-    bool CorsMiddleware::is_origin_allowed(const std::string &origin)
-    {
-        // 如果没有允许的源，则允许所有源
-        if (config_.allow_origins_.empty()) return true;
-
-        if (std::find(config_.allow_origins_.begin(), config_.allow_origins_.end(), "*")
-            != config_.allow_origins_.end())
-        {
-            return true;
-        }
-
-        // 检查请求源是否在允许的源列表中
-        return std::find(config_.allow_origins_.begin(), config_.allow_origins_.end(), origin)
-               != config_.allow_origins_.end();
-    }
-
     // 处理预检请求
-    void CorsMiddleware::handle_preflight_request(const HttpRequest &request, HttpResponse &response)
+    void CorsMiddleware::handle_preflight_request(const HttpRequest &request, HttpResponse &response) const
     {
         const auto origin = request.get_header("Origin");
-        if (!is_origin_allowed(origin))
+        if (!policy_.is_origin_allowed(origin))
         {
-            LOG_WARN << "CORS preflight blocked for origin: " << origin;
+            ZHTTP_LOG_WARN("CORS preflight blocked for origin: {}", origin);
             response.set_response_line(request.get_version(),
                                   HttpResponse::StatusCode::Forbidden,
                                   "Forbidden");
             return;
         }
-        add_cors_headers(response, origin);
+        policy_.apply_headers(response, origin);
         response.set_response_line(request.get_version(),
                               HttpResponse::StatusCode::NoContent,
                               "No Content");
-        LOG_INFO << "CORS preflight OK for origin: " << origin;
+        ZHTTP_LOG_DEBUG("CORS preflight OK for origin: {}", origin);
     }
 
-
-    // 添加CORS头部
-    void CorsMiddleware::add_cors_headers(HttpResponse &response, const std::string &origin) const
+    // 处理预检请求，已允许的源直接使用预序列化的响应头
+    void CorsMiddleware::serve_preflight(const HttpRequest &request, HttpResponse &response) const
     {
-        // 设置允许的源
-        response.set_header("Access-Control-Allow-Origin", origin);
-
-        // 设置凭证
-        if (config_.allow_credentials)
-        {
-            response.set_header("Access-Control-Allow-Credentials", "true");
-        }
-
-        // 设置允许的请求头
-        if (!config_.allow_methods_.empty())
-        {
-            response.set_header("Access-Control-Allow-Methods",
-                                join(config_.allow_methods_, ","));
-        }
-
-        // 设置接受的请求头
-        if (!config_.allow_headers_.empty())
+        if (CorsPolicy::Head head = policy_.preflight_head(request.get_header("Origin"), request.get_version()))
         {
-            response.set_header("Access-Control-Allow-Headers",
-                                join(config_.allow_headers_, ","));
+            response.set_serialized_head(std::move(head), HttpResponse::StatusCode::NoContent);
+            return;
         }
-
-        // 最大缓存时间
-        response.set_header("Access-Control-Max-Age",
-                            std::to_string(config_.max_age));
-
-        LOG_DEBUG << "CORS headers added: "
-                  << "Access-Control-Allow-Origin: " << origin
-                  << ", Access-Control-Allow-Methods: " << join(config_.allow_methods_, ",")
-                  << ", Access-Control-Max-Age: " << config_.max_age;
-
+        handle_preflight_request(request, response);
     }
 
-} // namespace zhttp::zmiddleware
\ No newline at end of file
+} // namespace zhttp::zmiddleware
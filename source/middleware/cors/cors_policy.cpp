@@ -0,0 +1,195 @@
+#include "middleware/cors/cors_policy.h"
+#include "middleware/cors/cors_middle.h"
+#include <algorithm>
+
+namespace zhttp::zmiddleware
+{
+    namespace
+    {
+        constexpr std::string_view kSchemeDelim = "://";
+        constexpr std::array<std::string_view, 2> kVersions{"HTTP/1.0", "HTTP/1.1"};
+    }
+
+    // 后缀树节点，边为主机名中的一个字符（自右向左）
+    struct CorsPolicy::SuffixNode
+    {
+        std::vector<std::pair<char, std::unique_ptr<SuffixNode>>> children_;
+        std::vector<std::string> schemes_; // 在此结束的通配源要求的协议，空串表示任意协议
+        bool terminal_ = false;
+
+        SuffixNode *child(const char c) const
+        {
+            for (const auto &[key, node] : children_)
+            {
+                if (key == c)
+                {
+                    return node.get();
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    CorsPolicy::CorsPolicy(const CorsConfig &config) : suffixes_(std::make_unique<SuffixNode>())
+    {
+        const auto &origins = config.allow_origins_;
+        // 没有配置允许的源时允许所有源，与原有行为一致
+        allow_all_ = origins.empty() || std::find(origins.begin(), origins.end(), "*") != origins.end();
+        response_origin_ = allow_all_ ? "*" : origins.front();
+
+        // 拼接好的响应头值
+        if (config.allow_credentials)
+        {
+            headers_.emplace_back("Access-Control-Allow-Credentials", "true");
+        }
+        if (!config.allow_methods_.empty())
+        {
+            headers_.emplace_back("Access-Control-Allow-Methods", CorsMiddleware::join(config.allow_methods_, ","));
+        }
+        if (!config.allow_headers_.empty())
+        {
+            headers_.emplace_back("Access-Control-Allow-Headers", CorsMiddleware::join(config.allow_headers_, ","));
+        }
+        headers_.emplace_back("Access-Control-Max-Age", std::to_string(config.max_age));
+
+        head_tail_ = delim;
+        for (const auto &[key, value] : headers_)
+        {
+            head_tail_ += key + ": " + value + delim;
+        }
+
+        for (const auto &origin : origins)
+        {
+            const size_t star = origin.find("*.");
+            if (origin == "*")
+            {
+                continue;
+            }
+            if (star == std::string::npos)
+            {
+                exact_[origin] = {std::make_shared<const std::string>(build_head(origin, 0)),
+                                  std::make_shared<const std::string>(build_head(origin, 1))};
+                continue;
+            }
+
+            // 通配源：[scheme://]*.suffix，后缀按主机名倒序插入
+            std::string scheme;
+            if (star > 0)
+            {
+                scheme = origin.substr(0, star);
+                if (scheme.size() < kSchemeDelim.size() ||
+                    scheme.compare(scheme.size() - kSchemeDelim.size(), kSchemeDelim.size(), kSchemeDelim) != 0)
+                {
+                    continue; // 通配符只能作为主机名的第一段
+                }
+            }
+            const std::string_view suffix = std::string_view(origin).substr(star + 1);
+            SuffixNode *node = suffixes_.get();
+            for (auto it = suffix.rbegin(); it != suffix.rend(); ++it)
+            {
+                SuffixNode *next = node->child(*it);
+                if (!next)
+                {
+                    node->children_.emplace_back(*it, std::make_unique<SuffixNode>());
+                    next = node->children_.back().second.get();
+                }
+                node = next;
+            }
+            node->terminal_ = true;
+            node->schemes_.push_back(std::move(scheme));
+        }
+    }
+
+    CorsPolicy::~CorsPolicy() = default;
+
+    CorsPolicy::CorsPolicy(CorsPolicy &&) noexcept = default;
+
+    CorsPolicy &CorsPolicy::operator=(CorsPolicy &&) noexcept = default;
+
+    std::string CorsPolicy::build_head(const std::string_view origin, const size_t version) const
+    {
+        std::string head;
+        head.reserve(64 + origin.size() + head_tail_.size());
+        head.append(kVersions[version]).append(" 204 No Content").append(delim);
+        head.append("Access-Control-Allow-Origin: ").append(origin).append(head_tail_);
+        return head;
+    }
+
+    int CorsPolicy::version_index(const std::string_view version)
+    {
+        for (size_t i = 0; i < kVersions.size(); ++i)
+        {
+            if (kVersions[i] == version)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    bool CorsPolicy::match_wildcard(const std::string_view origin) const
+    {
+        const size_t scheme_end = origin.find(kSchemeDelim);
+        const size_t host_begin = scheme_end == std::string_view::npos ? 0 : scheme_end + kSchemeDelim.size();
+        const std::string_view scheme = origin.substr(0, host_begin);
+        // 通配源只约束主机名，端口不参与匹配
+        const size_t port_begin = origin.rfind(':');
+        const size_t host_end = port_begin != std::string_view::npos && port_begin > host_begin ? port_begin
+                                                                                               : origin.size();
+
+        const SuffixNode *node = suffixes_.get();
+        for (size_t i = host_end; i > host_begin; --i)
+        {
+            node = node->child(origin[i - 1]);
+            if (!node)
+            {
+                return false;
+            }
+            // 通配段至少匹配一个字符
+            if (node->terminal_ && i - 1 > host_begin)
+            {
+                for (const auto &required : node->schemes_)
+                {
+                    if (required.empty() || required == scheme)
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    bool CorsPolicy::is_origin_allowed(const std::string &origin) const
+    {
+        return allow_all_ || exact_.count(origin) > 0 || match_wildcard(origin);
+    }
+
+    CorsPolicy::Head CorsPolicy::preflight_head(const std::string &origin, const std::string_view version) const
+    {
+        const int index = version_index(version);
+        if (index < 0)
+        {
+            return nullptr;
+        }
+        if (const auto it = exact_.find(origin); it != exact_.end())
+        {
+            return it->second[index];
+        }
+        // 通配或全部允许的源不缓存，避免任意Origin撑大缓存；按预先拼好的片段组装
+        if (allow_all_ || match_wildcard(origin))
+        {
+            return std::make_shared<const std::string>(build_head(origin, index));
+        }
+        return nullptr;
+    }
+
+    void CorsPolicy::apply_headers(HttpResponse &response, const std::string_view origin) const
+    {
+        response.set_header("Access-Control-Allow-Origin", origin);
+        for (const auto &[key, value] : headers_)
+        {
+            response.set_header(key, value);
+        }
+    }
+} // namespace zhttp::zmiddleware
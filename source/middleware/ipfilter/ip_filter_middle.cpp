@@ -0,0 +1,249 @@
+#include "middleware/ipfilter/ip_filter_middle.h"
+#include "log/http_logger.h"
+#include "utils/epoch.h"
+#include <fstream>
+
+namespace zhttp::zmiddleware
+{
+    namespace
+    {
+        std::string_view trim(std::string_view text)
+        {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+            {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+            {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+    }
+
+    IpFilterMiddleware::IpFilterMiddleware(IpFilterConfig config) : config_(std::move(config))
+    {
+        for (const auto &cidr : config_.trusted_proxies_)
+        {
+            if (!proxies_.insert(cidr, IpTrie::Action::Allow))
+            {
+                ZHTTP_LOG_WARN("Invalid trusted proxy CIDR: {}", cidr);
+            }
+        }
+        if (!reload())
+        {
+            // 规则文件无法打开时仍使用配置中的规则
+            auto rules = std::make_unique<IpTrie>();
+            for (const auto &cidr : config_.allow_)
+            {
+                rules->insert(cidr, IpTrie::Action::Allow);
+            }
+            for (const auto &cidr : config_.deny_)
+            {
+                rules->insert(cidr, IpTrie::Action::Deny);
+            }
+            set_rules(std::move(rules));
+        }
+    }
+
+    IpFilterMiddleware::~IpFilterMiddleware()
+    {
+        delete rules_.load(std::memory_order_relaxed);
+    }
+
+    long IpFilterMiddleware::load_file(const std::string &path, IpTrie &trie)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            return -1;
+        }
+
+        long invalid = 0;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::string_view text = trim(line);
+            if (text.empty() || text.front() == '#')
+            {
+                continue;
+            }
+
+            IpTrie::Action action = IpTrie::Action::Deny;
+            if (text.compare(0, 6, "allow ") == 0)
+            {
+                action = IpTrie::Action::Allow;
+                text = trim(text.substr(6));
+            }
+            else if (text.compare(0, 5, "deny ") == 0)
+            {
+                text = trim(text.substr(5));
+            }
+            if (!trie.insert(text, action))
+            {
+                ++invalid;
+            }
+        }
+        return invalid;
+    }
+
+    bool IpFilterMiddleware::reload()
+    {
+        auto rules = std::make_unique<IpTrie>();
+        for (const auto &cidr : config_.allow_)
+        {
+            if (!rules->insert(cidr, IpTrie::Action::Allow))
+            {
+                ZHTTP_LOG_WARN("Invalid allow CIDR: {}", cidr);
+            }
+        }
+        for (const auto &cidr : config_.deny_)
+        {
+            if (!rules->insert(cidr, IpTrie::Action::Deny))
+            {
+                ZHTTP_LOG_WARN("Invalid deny CIDR: {}", cidr);
+            }
+        }
+
+        if (!config_.rules_file_.empty())
+        {
+            const long invalid = load_file(config_.rules_file_, *rules);
+            if (invalid < 0)
+            {
+                ZHTTP_LOG_ERROR("Cannot open IP rules file: {}", config_.rules_file_);
+                return false;
+            }
+            if (invalid > 0)
+            {
+                ZHTTP_LOG_WARN("Skipped {} invalid lines in IP rules file {}", invalid, config_.rules_file_);
+            }
+        }
+
+        ZHTTP_LOG_INFO("IP filter loaded {} rules ({} trie nodes)", rules->size(), rules->node_count());
+        set_rules(std::move(rules));
+        return true;
+    }
+
+    void IpFilterMiddleware::set_rules(std::unique_ptr<IpTrie> rules)
+    {
+        rules->compile();
+        std::lock_guard<std::mutex> lock(reload_mutex_);
+        const IpTrie *old = rules_.exchange(rules.release(), std::memory_order_acq_rel);
+        if (old)
+        {
+            zutils::EpochDomain::global().retire(old);
+        }
+    }
+
+    size_t IpFilterMiddleware::rule_count() const
+    {
+        const auto guard = zutils::EpochDomain::global().pin();
+        return rules_.load(std::memory_order_acquire)->size();
+    }
+
+    bool IpFilterMiddleware::allow_address(const IpAddress &address) const
+    {
+        IpTrie::Action action;
+        {
+            const auto guard = zutils::EpochDomain::global().pin();
+            action = rules_.load(std::memory_order_acquire)->lookup(address);
+        }
+        if (action == IpTrie::Action::None)
+        {
+            return !config_.deny_by_default_;
+        }
+        return action == IpTrie::Action::Allow;
+    }
+
+    bool IpFilterMiddleware::allow_connection(const sockaddr *peer) const
+    {
+        IpAddress address;
+        if (!IpAddress::from_sockaddr(peer, address))
+        {
+            return !config_.deny_by_default_;
+        }
+        // 可信代理的连接放行，由请求级检查按X-Forwarded-For判断
+        if (config_.trust_forwarded_for_ && proxies_.lookup(address) == IpTrie::Action::Allow)
+        {
+            return true;
+        }
+        return allow_address(address);
+    }
+
+    bool IpFilterMiddleware::client_address(const HttpRequest &request, IpAddress &address) const
+    {
+        if (!IpAddress::parse(request.get_remote_address(), address))
+        {
+            return false;
+        }
+        if (!config_.trust_forwarded_for_ || proxies_.lookup(address) != IpTrie::Action::Allow)
+        {
+            return true;
+        }
+
+        // 对端是可信代理：自右向左跳过代理，第一个非代理地址即客户端
+        const std::string forwarded = request.get_header("X-Forwarded-For");
+        std::string_view rest = forwarded;
+        while (!rest.empty())
+        {
+            const size_t comma = rest.rfind(',');
+            const std::string_view entry = trim(comma == std::string_view::npos ? rest : rest.substr(comma + 1));
+            rest = comma == std::string_view::npos ? std::string_view() : rest.substr(0, comma);
+
+            IpAddress hop;
+            if (!IpAddress::parse(entry, hop))
+            {
+                break; // 无法解析的条目来自客户端，以最近一跳为准
+            }
+            address = hop;
+            if (proxies_.lookup(hop) != IpTrie::Action::Allow)
+            {
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool IpFilterMiddleware::allow_request(const HttpRequest &request) const
+    {
+        IpAddress address;
+        if (!client_address(request, address))
+        {
+            return !config_.deny_by_default_;
+        }
+        return allow_address(address);
+    }
+
+    void IpFilterMiddleware::before(HttpRequest &request)
+    {
+        if (allow_request(request))
+        {
+            return;
+        }
+        HttpResponse response;
+        reject(request, response);
+        throw response;
+    }
+
+    bool IpFilterMiddleware::filter_request(const HttpRequest &request, HttpResponse &response) const
+    {
+        if (allow_request(request))
+        {
+            return true;
+        }
+        reject(request, response);
+        return false;
+    }
+
+    void IpFilterMiddleware::after(HttpResponse &)
+    {
+    }
+
+    void IpFilterMiddleware::reject(const HttpRequest &request, HttpResponse &response)
+    {
+        ZHTTP_LOG_WARN("Request from {} rejected by IP filter", request.get_remote_address());
+        response.set_response_line(request.get_version(), HttpResponse::StatusCode::Forbidden, "Forbidden");
+        response.set_content_type("text/plain");
+        response.set_body("403 Forbidden");
+    }
+} // namespace zhttp::zmiddleware
@@ -0,0 +1,262 @@
+#include "middleware/ipfilter/ip_trie.h"
+#include <arpa/inet.h>
+#include <charconv>
+#include <cstring>
+#include <netinet/in.h>
+#include <string>
+
+namespace zhttp::zmiddleware
+{
+    namespace
+    {
+        uint64_t load_be64(const uint8_t *bytes)
+        {
+            uint64_t value = 0;
+            for (int i = 0; i < 8; ++i)
+            {
+                value = value << 8 | bytes[i];
+            }
+            return value;
+        }
+
+        IpAddress from_v6_bytes(const uint8_t *bytes)
+        {
+            return IpAddress{load_be64(bytes), load_be64(bytes + 8)};
+        }
+
+        // 前length位的掩码
+        void mask(const uint32_t length, uint64_t &hi, uint64_t &lo)
+        {
+            hi = length == 0 ? 0 : length >= 64 ? ~0ULL : ~0ULL << (64 - length);
+            lo = length <= 64 ? 0 : length >= 128 ? ~0ULL : ~0ULL << (128 - length);
+        }
+
+        bool matches(const IpAddress &address, const uint64_t hi, const uint64_t lo, const uint32_t length)
+        {
+            uint64_t mask_hi, mask_lo;
+            mask(length, mask_hi, mask_lo);
+            return ((address.hi_ ^ hi) & mask_hi) == 0 && ((address.lo_ ^ lo) & mask_lo) == 0;
+        }
+
+        uint32_t bit_at(const uint64_t hi, const uint64_t lo, const uint32_t index)
+        {
+            return index < 64 ? (hi >> (63 - index)) & 1 : (lo >> (127 - index)) & 1;
+        }
+
+        // 两个地址的公共前缀长度，不超过limit
+        uint32_t common_prefix(const uint64_t hi1, const uint64_t lo1, const uint64_t hi2, const uint64_t lo2,
+                               const uint32_t limit)
+        {
+            uint32_t common = 128;
+            if (const uint64_t x = hi1 ^ hi2; x != 0)
+            {
+                common = __builtin_clzll(x);
+            }
+            else if (const uint64_t y = lo1 ^ lo2; y != 0)
+            {
+                common = 64 + __builtin_clzll(y);
+            }
+            return common < limit ? common : limit;
+        }
+    }
+
+    IpAddress IpAddress::from_v4(const uint32_t host_order)
+    {
+        return IpAddress{0, 0xffff00000000ULL | host_order};
+    }
+
+    bool IpAddress::parse(const std::string_view text, IpAddress &address)
+    {
+        char buffer[INET6_ADDRSTRLEN];
+        if (text.empty() || text.size() >= sizeof(buffer))
+        {
+            return false;
+        }
+        std::memcpy(buffer, text.data(), text.size());
+        buffer[text.size()] = '\0';
+
+        if (in_addr v4{}; ::inet_pton(AF_INET, buffer, &v4) == 1)
+        {
+            address = from_v4(ntohl(v4.s_addr));
+            return true;
+        }
+        if (in6_addr v6{}; ::inet_pton(AF_INET6, buffer, &v6) == 1)
+        {
+            address = from_v6_bytes(v6.s6_addr);
+            return true;
+        }
+        return false;
+    }
+
+    bool IpAddress::from_sockaddr(const sockaddr *addr, IpAddress &address)
+    {
+        if (addr->sa_family == AF_INET)
+        {
+            address = from_v4(ntohl(reinterpret_cast<const sockaddr_in *>(addr)->sin_addr.s_addr));
+            return true;
+        }
+        if (addr->sa_family == AF_INET6)
+        {
+            address = from_v6_bytes(reinterpret_cast<const sockaddr_in6 *>(addr)->sin6_addr.s6_addr);
+            return true;
+        }
+        return false;
+    }
+
+    IpTrie::IpTrie()
+    {
+        nodes_.push_back(Node{0, 0, {0, 0}, 0, Action::None});
+    }
+
+    bool IpTrie::insert(const std::string_view cidr, const Action action)
+    {
+        const size_t slash = cidr.find('/');
+        IpAddress prefix;
+        if (!IpAddress::parse(cidr.substr(0, slash), prefix))
+        {
+            return false;
+        }
+
+        const bool v4 = prefix.is_v4() && cidr.find(':') == std::string_view::npos;
+        uint32_t length = v4 ? 32 : 128;
+        if (slash != std::string_view::npos)
+        {
+            const std::string_view digits = cidr.substr(slash + 1);
+            const auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), length);
+            if (ec != std::errc() || ptr != digits.data() + digits.size() || length > (v4 ? 32u : 128u))
+            {
+                return false;
+            }
+        }
+        insert(prefix, v4 ? length + 96 : length, action);
+        return true;
+    }
+
+    uint32_t IpTrie::add_node(const IpAddress &prefix, const uint32_t length, const Action action)
+    {
+        uint64_t mask_hi, mask_lo;
+        mask(length, mask_hi, mask_lo);
+        nodes_.push_back(Node{prefix.hi_ & mask_hi, prefix.lo_ & mask_lo, {0, 0},
+                              static_cast<uint8_t>(length), action});
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    void IpTrie::insert(const IpAddress &prefix, const uint32_t length, const Action action)
+    {
+        v4_index_.clear();
+
+        // 不变式：当前节点的前缀是待插入前缀的前缀
+        uint32_t index = 0;
+        while (true)
+        {
+            if (nodes_[index].length_ == length)
+            {
+                if (nodes_[index].action_ == Action::None)
+                {
+                    ++rules_;
+                }
+                nodes_[index].action_ = action; // 重复的前缀以后者为准
+                return;
+            }
+
+            const uint32_t bit = bit_at(prefix.hi_, prefix.lo_, nodes_[index].length_);
+            const uint32_t child = nodes_[index].child_[bit];
+            if (child == 0)
+            {
+                const uint32_t leaf = add_node(prefix, length, action);
+                nodes_[index].child_[bit] = leaf;
+                ++rules_;
+                return;
+            }
+
+            const Node &node = nodes_[child];
+            const uint32_t common = common_prefix(prefix.hi_, prefix.lo_, node.hi_, node.lo_,
+                                                  std::min<uint32_t>(length, node.length_));
+            if (common == node.length_)
+            {
+                index = child;
+                continue;
+            }
+
+            // 在公共前缀处分裂出中间节点
+            const uint32_t child_bit = bit_at(node.hi_, node.lo_, common);
+            const uint32_t middle = add_node(prefix, common, Action::None);
+            nodes_[middle].child_[child_bit] = child;
+            if (common == length)
+            {
+                nodes_[middle].action_ = action;
+            }
+            else
+            {
+                const uint32_t leaf = add_node(prefix, length, action);
+                nodes_[middle].child_[bit_at(prefix.hi_, prefix.lo_, common)] = leaf;
+            }
+            nodes_[index].child_[bit] = middle;
+            ++rules_;
+            return;
+        }
+    }
+
+    IpTrie::Action IpTrie::lookup(const IpAddress &address) const
+    {
+        Action best = Action::None;
+        const Node *node = nodes_.data();
+        if (!v4_index_.empty() && address.is_v4())
+        {
+            const IndexEntry &entry = v4_index_[(address.lo_ >> (32 - kIndexBits)) & ((1u << kIndexBits) - 1)];
+            node = &nodes_[entry.node_];
+            best = entry.best_;
+        }
+        while (true)
+        {
+            if (node->action_ != Action::None)
+            {
+                best = node->action_;
+            }
+            if (node->length_ == 128)
+            {
+                return best;
+            }
+            const uint32_t child = node->child_[bit_at(address.hi_, address.lo_, node->length_)];
+            if (child == 0)
+            {
+                return best;
+            }
+            node = &nodes_[child];
+            if (!matches(address, node->hi_, node->lo_, node->length_))
+            {
+                return best;
+            }
+        }
+    }
+
+    void IpTrie::compile()
+    {
+        constexpr uint32_t index_length = 96 + kIndexBits;
+        std::vector<IndexEntry> index(1u << kIndexBits);
+        for (uint32_t block = 0; block < index.size(); ++block)
+        {
+            // 沿块的起始地址下降到前缀长度不超过96+16的最深节点，块内所有地址都经过这段路径
+            const IpAddress base = IpAddress::from_v4(block << (32 - kIndexBits));
+            uint32_t current = 0;
+            Action best = Action::None;
+            while (true)
+            {
+                const Node &node = nodes_[current];
+                if (node.action_ != Action::None)
+                {
+                    best = node.action_;
+                }
+                const uint32_t child = node.child_[bit_at(base.hi_, base.lo_, node.length_)];
+                if (child == 0 || nodes_[child].length_ > index_length ||
+                    !matches(base, nodes_[child].hi_, nodes_[child].lo_, nodes_[child].length_))
+                {
+                    break;
+                }
+                current = child;
+            }
+            index[block] = IndexEntry{current, best};
+        }
+        v4_index_ = std::move(index);
+    }
+} // namespace zhttp::zmiddleware
@@ -0,0 +1,27 @@
+#include "middleware/middleware.h"
+#include "middleware/middleware_chain.h"
+#include "log/http_logger.h"
+
+namespace zhttp::zmiddleware
+{
+    void Next::operator()() const
+    {
+        chain_->call(index_, *context_, *terminal_);
+    }
+
+    // before/after适配器
+    void Middleware::handle(MiddlewareContext &context, const Next &next)
+    {
+        before(context.request());
+        next();
+        try
+        {
+            after(context.response());
+        }
+        catch (const std::exception &e)
+        {
+            // 与process_after一致：响应阶段的异常不中断其他中间件
+            ZHTTP_LOG_ERROR("Error in middleware after processing: {}", e.what());
+        }
+    }
+} // namespace zhttp::zmiddleware
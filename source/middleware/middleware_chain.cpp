@@ -43,6 +43,31 @@ namespace zhttp::zmiddleware
         ZHTTP_LOG_DEBUG("All before middlewares processed successfully");
     }
 
+    // 洋葱式执行
+    void MiddlewareChain::run(MiddlewareContext &context, const Next::Terminal &terminal) const
+    {
+        call(0, context, terminal);
+    }
+
+    void MiddlewareChain::call(const size_t index, MiddlewareContext &context, const Next::Terminal &terminal) const
+    {
+        if (index == middlewares_.size())
+        {
+            terminal(context);
+            return;
+        }
+        const auto &middleware = middlewares_[index];
+        const Next next(this, index + 1, &context, &terminal);
+        if (middleware)
+        {
+            middleware->handle(context, next);
+        }
+        else
+        {
+            next();
+        }
+    }
+
     // 处理响应中间件
     void MiddlewareChain::process_after(HttpResponse &response)
     {
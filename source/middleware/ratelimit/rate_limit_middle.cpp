@@ -0,0 +1,103 @@
+#include "middleware/ratelimit/rate_limit_middle.h"
+#include "log/http_logger.h"
+#include <cmath>
+
+namespace zhttp::zmiddleware
+{
+    RateLimitMiddleware::RateLimitMiddleware(RateLimitConfig config)
+        : config_(std::move(config)),
+          table_(config_.rate_, config_.burst_, config_.shard_count_),
+          retry_after_(std::to_string(config_.rate_ > 0
+                                          ? static_cast<int64_t>(std::ceil(1.0 / config_.rate_))
+                                          : static_cast<int64_t>(config_.idle_timeout_)))
+    {
+        ZHTTP_LOG_INFO("RateLimitMiddleware created: rate={}/s, burst={}, shards={}",
+                       config_.rate_, config_.burst_, config_.shard_count_);
+        evict_thread_ = std::thread(&RateLimitMiddleware::evict_loop, this);
+    }
+
+    RateLimitMiddleware::~RateLimitMiddleware()
+    {
+        {
+            std::lock_guard<std::mutex> lock(evict_mutex_);
+            stop_ = true;
+        }
+        evict_cv_.notify_all();
+        if (evict_thread_.joinable())
+        {
+            evict_thread_.join();
+        }
+    }
+
+    // 请求前处理
+    void RateLimitMiddleware::before(HttpRequest &request)
+    {
+        if (admit(request))
+        {
+            return;
+        }
+        HttpResponse response;
+        reject(request, response);
+        throw response;
+    }
+
+    bool RateLimitMiddleware::admit(const HttpRequest &request)
+    {
+        const std::string key = extract_key(request);
+        if (table_.try_acquire(key, TokenBucketTable::now_ms()))
+        {
+            return true;
+        }
+        ZHTTP_LOG_WARN("Rate limit exceeded for key: {}", key);
+        return false;
+    }
+
+    void RateLimitMiddleware::reject(const HttpRequest &request, HttpResponse &response) const
+    {
+        response.set_response_line(request.get_version(),
+                                   HttpResponse::StatusCode::TooManyRequests,
+                                   "Too Many Requests");
+        response.set_header("Retry-After", retry_after_);
+        response.set_content_type("text/plain");
+        response.set_body("429 Too Many Requests");
+    }
+
+    void RateLimitMiddleware::after(HttpResponse &)
+    {
+    }
+
+    size_t RateLimitMiddleware::tracked_keys() const
+    {
+        return table_.size();
+    }
+
+    // 从请求中提取限流键
+    std::string RateLimitMiddleware::extract_key(const HttpRequest &request) const
+    {
+        if (config_.key_type_ == RateLimitKeyType::HEADER)
+        {
+            if (std::string value = request.get_header(config_.key_header_); !value.empty())
+            {
+                return value;
+            }
+        }
+        return request.get_remote_address();
+    }
+
+    // 后台淘汰空闲键
+    void RateLimitMiddleware::evict_loop()
+    {
+        const auto interval = std::chrono::seconds(std::max<uint32_t>(config_.evict_interval_, 1));
+        const int64_t idle_ms = static_cast<int64_t>(config_.idle_timeout_) * 1000;
+
+        std::unique_lock<std::mutex> lock(evict_mutex_);
+        while (!evict_cv_.wait_for(lock, interval, [this] { return stop_; }))
+        {
+            const size_t evicted = table_.evict_idle(TokenBucketTable::now_ms(), idle_ms);
+            if (evicted > 0)
+            {
+                ZHTTP_LOG_DEBUG("Rate limiter evicted {} idle keys", evicted);
+            }
+        }
+    }
+} // namespace zhttp::zmiddleware
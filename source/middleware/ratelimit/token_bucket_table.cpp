@@ -0,0 +1,144 @@
+#include "middleware/ratelimit/token_bucket_table.h"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+namespace zhttp::zmiddleware
+{
+    namespace
+    {
+        constexpr uint32_t kMilliPerToken = 1000; // 一个令牌对应的千分之一令牌数
+        constexpr uint32_t kMaxBurst = UINT32_MAX / kMilliPerToken; // 低32位可表示的最大容量
+
+        size_t round_up_pow2(size_t n)
+        {
+            size_t p = 1;
+            while (p < n) p <<= 1;
+            return p;
+        }
+    }
+
+    TokenBucketTable::TokenBucketTable(double rate, uint32_t burst, uint32_t shard_count)
+        : milli_tokens_per_ms_(std::max(rate, 0.0)),
+          capacity_(std::clamp<uint32_t>(burst, 1, kMaxBurst) * kMilliPerToken),
+          epoch_ms_(now_ms()),
+          shard_mask_(round_up_pow2(std::max<uint32_t>(shard_count, 1)) - 1),
+          shards_(std::make_unique<Shard[]>(shard_mask_ + 1))
+    {
+    }
+
+    bool TokenBucketTable::try_acquire(const std::string &key, int64_t now_ms)
+    {
+        const uint32_t now_rel = relative_ms(now_ms);
+        Shard &shard = shard_for(key);
+
+        // 1.已有键：只持有读锁，在桶上CAS
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex_);
+            if (const auto it = shard.buckets_.find(key); it != shard.buckets_.end())
+            {
+                return consume(it->second, now_rel);
+            }
+        }
+
+        // 2.新键：持有写锁插入一个满桶并消费一个令牌
+        std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+        auto [it, inserted] = shard.buckets_.try_emplace(key, pack(now_rel, capacity_ - kMilliPerToken));
+        if (inserted)
+        {
+            return true;
+        }
+        // 其他线程抢先插入了该键
+        return consume(it->second, now_rel);
+    }
+
+    bool TokenBucketTable::consume(Bucket &bucket, uint32_t now_rel) const
+    {
+        uint64_t old_state = bucket.state_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            const auto last = static_cast<uint32_t>(old_state >> 32);
+            const auto tokens = static_cast<uint32_t>(old_state);
+
+            // 其他线程可能已用更新的时间写入，此时视为没有经过时间
+            uint32_t elapsed = now_rel - last;
+            if (elapsed > UINT32_MAX / 2) elapsed = 0;
+
+            const double refilled = tokens + elapsed * milli_tokens_per_ms_;
+            const uint32_t available = refilled >= capacity_ ? capacity_ : static_cast<uint32_t>(refilled);
+            if (available < kMilliPerToken)
+            {
+                // 令牌不足：不写回，补充量在下次请求时按时间差重新计算
+                return false;
+            }
+
+            const uint64_t new_state = pack(elapsed == 0 ? last : now_rel, available - kMilliPerToken);
+            if (bucket.state_.compare_exchange_weak(old_state, new_state,
+                                                    std::memory_order_relaxed, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+    }
+
+    size_t TokenBucketTable::evict_idle(int64_t now_ms, int64_t idle_ms)
+    {
+        // 空闲时间不小于填满桶所需的时间时，淘汰与保留等价（再次出现时为满桶）
+        if (milli_tokens_per_ms_ > 0)
+        {
+            idle_ms = std::max<int64_t>(idle_ms, static_cast<int64_t>(capacity_ / milli_tokens_per_ms_) + 1);
+        }
+        const uint32_t now_rel = relative_ms(now_ms);
+        size_t evicted = 0;
+
+        for (size_t i = 0; i <= shard_mask_; ++i)
+        {
+            Shard &shard = shards_[i];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex_);
+            for (auto it = shard.buckets_.begin(); it != shard.buckets_.end();)
+            {
+                const auto last = static_cast<uint32_t>(it->second.state_.load(std::memory_order_relaxed) >> 32);
+                if (const uint32_t idle = now_rel - last; idle <= UINT32_MAX / 2 && idle >= idle_ms)
+                {
+                    it = shard.buckets_.erase(it);
+                    ++evicted;
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+        return evicted;
+    }
+
+    size_t TokenBucketTable::size() const
+    {
+        size_t total = 0;
+        for (size_t i = 0; i <= shard_mask_; ++i)
+        {
+            std::shared_lock<std::shared_mutex> lock(shards_[i].mutex_);
+            total += shards_[i].buckets_.size();
+        }
+        return total;
+    }
+
+    int64_t TokenBucketTable::now_ms()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    uint32_t TokenBucketTable::relative_ms(int64_t now_ms) const
+    {
+        // 按32位回绕，相减时使用无符号运算
+        return static_cast<uint32_t>(now_ms - epoch_ms_);
+    }
+
+    TokenBucketTable::Shard &TokenBucketTable::shard_for(const std::string &key)
+    {
+        // 分片用高位，避免与unordered_map内部取模使用的低位相关
+        const size_t h = std::hash<std::string>()(key);
+        return shards_[(h >> 16 ^ h) & shard_mask_];
+    }
+} // namespace zhttp::zmiddleware
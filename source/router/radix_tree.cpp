@@ -0,0 +1,242 @@
+#include "router/radix_tree.h"
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace zhttp::zrouter
+{
+    struct RadixTree::Node
+    {
+        std::string prefix_;                          // 压缩后的静态片段
+        std::string indices_;                         // 各静态子节点前缀的首字符，与children_一一对应
+        std::vector<std::unique_ptr<Node>> children_; // 静态子节点
+        std::unique_ptr<Node> param_child_;           // ":name"子节点
+        std::string_view param_name_;
+        std::unique_ptr<Node> wildcard_child_;        // "*name"子节点，总是叶子
+        std::string_view wildcard_name_;
+        std::array<RouteTarget, kMethodCount> targets_; // 按方法索引的路由目标
+    };
+
+    RadixTree::RadixTree() : root_(std::make_unique<Node>())
+    {
+    }
+
+    RadixTree::~RadixTree() = default;
+
+    bool RadixTree::is_tree_pattern(const std::string_view pattern)
+    {
+        if (pattern.empty() || pattern[0] != '/')
+        {
+            return false;
+        }
+        for (size_t i = 0; i < pattern.size(); ++i)
+        {
+            switch (pattern[i])
+            {
+                case '.': case '[': case ']': case '(': case ')': case '{': case '}':
+                case '?': case '+': case '^': case '$': case '|': case '\\':
+                    return false;
+                case ':':
+                    // 参数段必须独占一段且有名字
+                    if (pattern[i - 1] != '/' || i + 1 == pattern.size() || pattern[i + 1] == '/')
+                    {
+                        return false;
+                    }
+                    break;
+                case '*':
+                    // 通配段必须是最后一段
+                    if (pattern[i - 1] != '/' || pattern.find('/', i) != std::string_view::npos)
+                    {
+                        return false;
+                    }
+                    return pattern.find_first_of(".[](){}?+^$|\\", i) == std::string_view::npos;
+                default:
+                    break;
+            }
+        }
+        return true;
+    }
+
+    std::string_view RadixTree::intern(const std::string_view name)
+    {
+        static std::mutex mutex;
+        static std::unordered_set<std::string> names;
+        std::lock_guard<std::mutex> lock(mutex);
+        return *names.emplace(name).first;
+    }
+
+    RadixTree::Node *RadixTree::insert_static(Node *node, std::string_view chunk)
+    {
+        while (!chunk.empty())
+        {
+            const size_t index = node->indices_.find(chunk[0]);
+            if (index == std::string::npos)
+            {
+                auto child = std::make_unique<Node>();
+                child->prefix_ = std::string(chunk);
+                Node *raw = child.get();
+                node->indices_.push_back(chunk[0]);
+                node->children_.emplace_back(std::move(child));
+                return raw;
+            }
+
+            Node *child = node->children_[index].get();
+            size_t common = 0;
+            while (common < chunk.size() && common < child->prefix_.size() && chunk[common] == child->prefix_[common])
+            {
+                ++common;
+            }
+
+            if (common < child->prefix_.size())
+            {
+                // 拆分：公共前缀成为新的中间节点
+                auto middle = std::make_unique<Node>();
+                middle->prefix_ = child->prefix_.substr(0, common);
+                child->prefix_.erase(0, common);
+                middle->indices_.push_back(child->prefix_[0]);
+                middle->children_.emplace_back(std::move(node->children_[index]));
+                node->children_[index] = std::move(middle);
+                child = node->children_[index].get();
+            }
+            node = child;
+            chunk.remove_prefix(common);
+        }
+        return node;
+    }
+
+    void RadixTree::insert(const std::string_view pattern, const HttpRequest::Method method, RouteTarget target)
+    {
+        if (!is_tree_pattern(pattern))
+        {
+            throw std::invalid_argument("invalid route pattern: " + std::string(pattern));
+        }
+
+        Node *node = root_.get();
+        size_t pos = 0;
+        while (pos < pattern.size())
+        {
+            if (pattern[pos] == ':')
+            {
+                const size_t end = std::min(pattern.find('/', pos), pattern.size());
+                const std::string_view name = pattern.substr(pos + 1, end - pos - 1);
+                if (!node->param_child_)
+                {
+                    node->param_child_ = std::make_unique<Node>();
+                    node->param_name_ = intern(name);
+                }
+                else if (node->param_name_ != name)
+                {
+                    throw std::invalid_argument("route parameter ':" + std::string(name) + "' in " +
+                                                std::string(pattern) + " conflicts with ':" +
+                                                std::string(node->param_name_) + "'");
+                }
+                node = node->param_child_.get();
+                pos = end;
+            }
+            else if (pattern[pos] == '*')
+            {
+                const std::string_view name = pattern.substr(pos + 1);
+                if (!node->wildcard_child_)
+                {
+                    node->wildcard_child_ = std::make_unique<Node>();
+                    node->wildcard_name_ = intern(name);
+                }
+                else if (node->wildcard_name_ != name)
+                {
+                    throw std::invalid_argument("route wildcard '*" + std::string(name) + "' in " +
+                                                std::string(pattern) + " conflicts with '*" +
+                                                std::string(node->wildcard_name_) + "'");
+                }
+                node = node->wildcard_child_.get();
+                pos = pattern.size();
+            }
+            else
+            {
+                const size_t end = std::min(pattern.find_first_of(":*", pos), pattern.size());
+                node = insert_static(node, pattern.substr(pos, end - pos));
+                pos = end;
+            }
+        }
+
+        RouteTarget &slot = node->targets_[static_cast<size_t>(method)];
+        if (!slot)
+        {
+            ++size_;
+        }
+        slot = std::move(target);
+    }
+
+    const RouteTarget *RadixTree::match(const Node *node, const std::string_view path, const size_t pos,
+                                        const size_t method, HttpRequest *request)
+    {
+        if (pos == path.size() && node->targets_[method])
+        {
+            return &node->targets_[method];
+        }
+
+        // 1.静态子节点
+        if (pos < path.size())
+        {
+            if (const size_t index = node->indices_.find(path[pos]); index != std::string::npos)
+            {
+                const Node *child = node->children_[index].get();
+                if (path.compare(pos, child->prefix_.size(), child->prefix_) == 0)
+                {
+                    if (const RouteTarget *target = match(child, path, pos + child->prefix_.size(), method, request))
+                    {
+                        return target;
+                    }
+                }
+            }
+        }
+
+        // 2.参数段：匹配到下一个'/'为止，不能为空
+        if (node->param_child_ && pos < path.size() && path[pos] != '/')
+        {
+            const size_t end = std::min(path.find('/', pos), path.size());
+            if (request)
+            {
+                request->add_path_parameter(node->param_name_, pos, end - pos);
+            }
+            if (const RouteTarget *target = match(node->param_child_.get(), path, end, method, request))
+            {
+                return target;
+            }
+            if (request)
+            {
+                request->pop_path_parameter();
+            }
+        }
+
+        // 3.通配段：匹配剩余全部路径
+        if (node->wildcard_child_ && node->wildcard_child_->targets_[method])
+        {
+            if (request)
+            {
+                request->add_path_parameter(node->wildcard_name_, pos, path.size() - pos);
+            }
+            return &node->wildcard_child_->targets_[method];
+        }
+        return nullptr;
+    }
+
+    const RouteTarget *RadixTree::find(HttpRequest &request) const
+    {
+        const size_t method = static_cast<size_t>(request.get_method());
+        if (method >= kMethodCount || size_ == 0)
+        {
+            return nullptr;
+        }
+        return match(root_.get(), request.get_path(), 0, method, &request);
+    }
+
+    const RouteTarget *RadixTree::find(const HttpRequest::Method method, const std::string_view path) const
+    {
+        const auto index = static_cast<size_t>(method);
+        if (index >= kMethodCount || size_ == 0)
+        {
+            return nullptr;
+        }
+        return match(root_.get(), path, 0, index, nullptr);
+    }
+} // namespace zhttp::zrouter
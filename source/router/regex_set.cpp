@@ -0,0 +1,839 @@
+#include "router/regex_set.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace zhttp::zrouter
+{
+    namespace
+    {
+        // 正则语法树节点
+        struct Node
+        {
+            enum class Kind
+            {
+                Empty,
+                Class,
+                Concat,
+                Alt,
+                Repeat,
+                Group
+            };
+
+            Kind kind_ = Kind::Empty;
+            std::bitset<256> set_;                  // Class
+            std::vector<std::unique_ptr<Node>> kids_; // Concat/Alt/Repeat/Group
+            int min_ = 0;                           // Repeat
+            int max_ = -1;                          // Repeat，-1表示无上限
+            bool greedy_ = true;                    // Repeat
+            int group_ = -1;                        // Group，-1表示非捕获
+        };
+
+        using NodePtr = std::unique_ptr<Node>;
+
+        constexpr int kMaxRepeat = 1000; // {n,m}展开上限
+
+        [[noreturn]] void fail(const std::string_view pattern, const std::string &reason)
+        {
+            throw std::invalid_argument("unsupported regex '" + std::string(pattern) + "': " + reason);
+        }
+
+        std::bitset<256> escape_set(const char c)
+        {
+            std::bitset<256> set;
+            auto add_range = [&set](const int lo, const int hi)
+            {
+                for (int b = lo; b <= hi; ++b) set.set(b);
+            };
+            switch (c)
+            {
+                case 'd': case 'D':
+                    add_range('0', '9');
+                    break;
+                case 'w': case 'W':
+                    add_range('0', '9');
+                    add_range('a', 'z');
+                    add_range('A', 'Z');
+                    set.set('_');
+                    break;
+                case 's': case 'S':
+                    for (const char ws : {' ', '\t', '\n', '\r', '\f', '\v'}) set.set(static_cast<unsigned char>(ws));
+                    break;
+                default:
+                    break;
+            }
+            if (c == 'D' || c == 'W' || c == 'S')
+            {
+                set.flip();
+            }
+            return set;
+        }
+    }
+
+    // 递归下降解析器，生成语法树
+    class RegexSet::Parser
+    {
+    public:
+        explicit Parser(const std::string_view pattern) : pattern_(pattern)
+        {
+        }
+
+        NodePtr parse()
+        {
+            // 模式首尾的^与$表示整串匹配，本身就是默认语义
+            if (!pattern_.empty() && pattern_[0] == '^')
+            {
+                ++pos_;
+            }
+            NodePtr root = parse_alt();
+            if (!at_end())
+            {
+                fail(pattern_, "unexpected ')'");
+            }
+            return root;
+        }
+
+        int groups() const { return groups_; }
+
+    private:
+        bool at_end() const
+        {
+            // 末尾未转义的$视为结束
+            return pos_ >= pattern_.size() || (pattern_[pos_] == '$' && pos_ + 1 == pattern_.size());
+        }
+
+        NodePtr parse_alt()
+        {
+            NodePtr left = parse_concat();
+            if (at_end() || pattern_[pos_] != '|')
+            {
+                return left;
+            }
+            auto alt = std::make_unique<Node>();
+            alt->kind_ = Node::Kind::Alt;
+            alt->kids_.emplace_back(std::move(left));
+            while (!at_end() && pattern_[pos_] == '|')
+            {
+                ++pos_;
+                alt->kids_.emplace_back(parse_concat());
+            }
+            return alt;
+        }
+
+        NodePtr parse_concat()
+        {
+            auto concat = std::make_unique<Node>();
+            concat->kind_ = Node::Kind::Concat;
+            while (!at_end() && pattern_[pos_] != '|' && pattern_[pos_] != ')')
+            {
+                concat->kids_.emplace_back(parse_repeat());
+            }
+            if (concat->kids_.size() == 1)
+            {
+                return std::move(concat->kids_[0]);
+            }
+            return concat;
+        }
+
+        NodePtr parse_repeat()
+        {
+            NodePtr atom = parse_atom();
+            while (!at_end())
+            {
+                int min = 0, max = -1;
+                const char c = pattern_[pos_];
+                if (c == '*') { ++pos_; }
+                else if (c == '+') { min = 1; ++pos_; }
+                else if (c == '?') { max = 1; ++pos_; }
+                else if (c == '{') { parse_braces(min, max); }
+                else break;
+
+                auto repeat = std::make_unique<Node>();
+                repeat->kind_ = Node::Kind::Repeat;
+                repeat->min_ = min;
+                repeat->max_ = max;
+                if (!at_end() && pattern_[pos_] == '?')
+                {
+                    repeat->greedy_ = false;
+                    ++pos_;
+                }
+                repeat->kids_.emplace_back(std::move(atom));
+                atom = std::move(repeat);
+            }
+            return atom;
+        }
+
+        void parse_braces(int &min, int &max)
+        {
+            ++pos_; // '{'
+            auto read_int = [this]() -> int
+            {
+                const size_t start = pos_;
+                int value = 0;
+                while (pos_ < pattern_.size() && pattern_[pos_] >= '0' && pattern_[pos_] <= '9')
+                {
+                    value = value * 10 + (pattern_[pos_++] - '0');
+                    if (value > kMaxRepeat) fail(pattern_, "repeat count too large");
+                }
+                return pos_ == start ? -1 : value;
+            };
+            min = read_int();
+            if (min < 0) fail(pattern_, "bad repeat");
+            max = min;
+            if (pos_ < pattern_.size() && pattern_[pos_] == ',')
+            {
+                ++pos_;
+                max = read_int();
+            }
+            if (pos_ >= pattern_.size() || pattern_[pos_] != '}' || (max >= 0 && max < min))
+            {
+                fail(pattern_, "bad repeat");
+            }
+            ++pos_;
+        }
+
+        NodePtr make_class(const std::bitset<256> &set)
+        {
+            auto node = std::make_unique<Node>();
+            node->kind_ = Node::Kind::Class;
+            node->set_ = set;
+            return node;
+        }
+
+        NodePtr parse_atom()
+        {
+            const char c = pattern_[pos_++];
+            switch (c)
+            {
+                case '(':
+                {
+                    auto group = std::make_unique<Node>();
+                    group->kind_ = Node::Kind::Group;
+                    if (pattern_.compare(pos_, 2, "?:") == 0)
+                    {
+                        pos_ += 2;
+                    }
+                    else if (pos_ < pattern_.size() && pattern_[pos_] == '?')
+                    {
+                        fail(pattern_, "assertions are not supported");
+                    }
+                    else
+                    {
+                        group->group_ = groups_++;
+                    }
+                    group->kids_.emplace_back(parse_alt());
+                    if (pos_ >= pattern_.size() || pattern_[pos_] != ')')
+                    {
+                        fail(pattern_, "missing ')'");
+                    }
+                    ++pos_;
+                    return group;
+                }
+                case '[':
+                    return make_class(parse_class());
+                case '.':
+                {
+                    std::bitset<256> set;
+                    set.set();
+                    set.reset('\n');
+                    set.reset('\r');
+                    return make_class(set);
+                }
+                case '\\':
+                    return make_class(parse_escape());
+                case '*': case '+': case '?': case '{':
+                    fail(pattern_, "nothing to repeat");
+                case '^': case '$':
+                    fail(pattern_, "anchors are only supported at the ends");
+                default:
+                {
+                    std::bitset<256> set;
+                    set.set(static_cast<unsigned char>(c));
+                    return make_class(set);
+                }
+            }
+        }
+
+        std::bitset<256> parse_escape()
+        {
+            if (pos_ >= pattern_.size())
+            {
+                fail(pattern_, "trailing '\\'");
+            }
+            const char c = pattern_[pos_++];
+            std::bitset<256> set;
+            switch (c)
+            {
+                case 'd': case 'D': case 'w': case 'W': case 's': case 'S':
+                    return escape_set(c);
+                case 'n': set.set('\n'); break;
+                case 'r': set.set('\r'); break;
+                case 't': set.set('\t'); break;
+                case 'f': set.set('\f'); break;
+                case 'v': set.set('\v'); break;
+                case 'b': case 'B':
+                    fail(pattern_, "word boundaries are not supported");
+                default:
+                    if (c >= '1' && c <= '9')
+                    {
+                        fail(pattern_, "back references are not supported");
+                    }
+                    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+                    {
+                        fail(pattern_, std::string("unknown escape \\") + c);
+                    }
+                    set.set(static_cast<unsigned char>(c));
+                    break;
+            }
+            return set;
+        }
+
+        std::bitset<256> parse_class()
+        {
+            std::bitset<256> set;
+            bool negate = false;
+            if (pos_ < pattern_.size() && pattern_[pos_] == '^')
+            {
+                negate = true;
+                ++pos_;
+            }
+            while (true)
+            {
+                if (pos_ >= pattern_.size())
+                {
+                    fail(pattern_, "missing ']'");
+                }
+                if (pattern_[pos_] == ']')
+                {
+                    ++pos_;
+                    break;
+                }
+
+                int lo;
+                if (pattern_[pos_] == '\\')
+                {
+                    ++pos_;
+                    const std::bitset<256> escaped = parse_escape_in_class();
+                    if (escaped.count() != 1)
+                    {
+                        set |= escaped; // \d等不能作为区间端点
+                        continue;
+                    }
+                    lo = static_cast<int>(find_single(escaped));
+                }
+                else
+                {
+                    lo = static_cast<unsigned char>(pattern_[pos_++]);
+                }
+
+                int hi = lo;
+                if (pos_ + 1 < pattern_.size() && pattern_[pos_] == '-' && pattern_[pos_ + 1] != ']')
+                {
+                    ++pos_;
+                    if (pattern_[pos_] == '\\')
+                    {
+                        ++pos_;
+                        const std::bitset<256> escaped = parse_escape_in_class();
+                        if (escaped.count() != 1) fail(pattern_, "bad class range");
+                        hi = static_cast<int>(find_single(escaped));
+                    }
+                    else
+                    {
+                        hi = static_cast<unsigned char>(pattern_[pos_++]);
+                    }
+                    if (hi < lo) fail(pattern_, "bad class range");
+                }
+                for (int b = lo; b <= hi; ++b)
+                {
+                    set.set(b);
+                }
+            }
+            if (negate)
+            {
+                set.flip();
+            }
+            return set;
+        }
+
+        std::bitset<256> parse_escape_in_class()
+        {
+            // 字符类中\b表示退格
+            if (pos_ < pattern_.size() && pattern_[pos_] == 'b')
+            {
+                ++pos_;
+                std::bitset<256> set;
+                set.set('\b');
+                return set;
+            }
+            return parse_escape();
+        }
+
+        static size_t find_single(const std::bitset<256> &set)
+        {
+            for (size_t b = 0; b < 256; ++b)
+            {
+                if (set.test(b)) return b;
+            }
+            return 0;
+        }
+
+    private:
+        std::string_view pattern_;
+        size_t pos_ = 0;
+        int groups_ = 0;
+    };
+
+    namespace
+    {
+        // 语法树 -> 指令，沿用Thompson构造
+        template<typename Inst, typename Classes>
+        void emit(const Node &node, std::vector<Inst> &prog, Classes &classes)
+        {
+            using Op = typename Inst::Op;
+            switch (node.kind_)
+            {
+                case Node::Kind::Empty:
+                    break;
+                case Node::Kind::Class:
+                    prog.push_back({Op::Byte, static_cast<uint32_t>(classes.size()), 0, 0});
+                    classes.push_back(node.set_);
+                    break;
+                case Node::Kind::Concat:
+                    for (const auto &kid : node.kids_) emit(*kid, prog, classes);
+                    break;
+                case Node::Kind::Group:
+                    if (node.group_ >= 0) prog.push_back({Op::Save, static_cast<uint32_t>(node.group_ * 2), 0, 0});
+                    emit(*node.kids_[0], prog, classes);
+                    if (node.group_ >= 0) prog.push_back({Op::Save, static_cast<uint32_t>(node.group_ * 2 + 1), 0, 0});
+                    break;
+                case Node::Kind::Alt:
+                {
+                    // split L1, next; L1: a; jmp end; next: split L2, ...; 最后一个分支直接落到end
+                    std::vector<size_t> jumps;
+                    for (size_t i = 0; i < node.kids_.size(); ++i)
+                    {
+                        if (i + 1 == node.kids_.size())
+                        {
+                            emit(*node.kids_[i], prog, classes);
+                            break;
+                        }
+                        const size_t split = prog.size();
+                        prog.push_back({Op::Split, 0, static_cast<uint32_t>(split + 1), 0});
+                        emit(*node.kids_[i], prog, classes);
+                        jumps.push_back(prog.size());
+                        prog.push_back({Op::Jmp, 0, 0, 0});
+                        prog[split].y_ = static_cast<uint32_t>(prog.size());
+                    }
+                    for (const size_t jump : jumps) prog[jump].x_ = static_cast<uint32_t>(prog.size());
+                    break;
+                }
+                case Node::Kind::Repeat:
+                {
+                    const Node &kid = *node.kids_[0];
+                    for (int i = 0; i < node.min_; ++i) emit(kid, prog, classes);
+                    auto make_split = [&](const size_t at, const uint32_t body, const uint32_t out)
+                    {
+                        prog[at].x_ = node.greedy_ ? body : out;
+                        prog[at].y_ = node.greedy_ ? out : body;
+                    };
+                    if (node.max_ < 0)
+                    {
+                        // L: split body, out; body; jmp L; out:
+                        const size_t split = prog.size();
+                        prog.push_back({Op::Split, 0, 0, 0});
+                        emit(kid, prog, classes);
+                        prog.push_back({Op::Jmp, 0, static_cast<uint32_t>(split), 0});
+                        make_split(split, static_cast<uint32_t>(split + 1), static_cast<uint32_t>(prog.size()));
+                    }
+                    else
+                    {
+                        // 可选部分：split body, out; body; split body, out; body; ... out:
+                        std::vector<size_t> splits;
+                        for (int i = node.min_; i < node.max_; ++i)
+                        {
+                            splits.push_back(prog.size());
+                            prog.push_back({Op::Split, 0, 0, 0});
+                            emit(kid, prog, classes);
+                        }
+                        for (const size_t split : splits)
+                        {
+                            make_split(split, static_cast<uint32_t>(split + 1), static_cast<uint32_t>(prog.size()));
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    RegexSet::RegexSet() = default;
+
+    RegexSet::~RegexSet() = default;
+
+    uint32_t RegexSet::add(const std::string_view pattern)
+    {
+        Parser parser(pattern);
+        const NodePtr root = parser.parse();
+
+        // 解析成功后再写入，失败时集合保持不变
+        std::vector<Inst> code;
+        std::vector<std::bitset<256>> classes;
+        emit(*root, code, classes);
+
+        const auto base = static_cast<uint32_t>(prog_.size());
+        const auto class_base = static_cast<uint32_t>(classes_.size());
+        const auto id = static_cast<uint32_t>(starts_.size());
+        for (Inst inst : code)
+        {
+            if (inst.op_ == Inst::Op::Byte) inst.arg_ += class_base;
+            if (inst.op_ == Inst::Op::Split || inst.op_ == Inst::Op::Jmp) inst.x_ += base;
+            if (inst.op_ == Inst::Op::Split) inst.y_ += base;
+            prog_.push_back(inst);
+        }
+        prog_.push_back({Inst::Op::Match, id, 0, 0});
+        classes_.insert(classes_.end(), classes.begin(), classes.end());
+        starts_.push_back(base);
+        group_counts_.push_back(static_cast<uint32_t>(parser.groups()));
+
+        // 新模式使已有的DFA失效，下次匹配时重建（注册与匹配不会并发进行）
+        std::lock_guard<std::mutex> lock(mutex_);
+        compiled_.store(false, std::memory_order_release);
+        return id;
+    }
+
+    void RegexSet::compile() const
+    {
+        // 字节等价类：对所有字符类做划分细化，同类字节在任何Byte指令上的行为相同
+        std::array<uint32_t, 256> klass{};
+        uint32_t count = 1;
+        for (const auto &set : classes_)
+        {
+            std::map<std::pair<uint32_t, bool>, uint32_t> refine;
+            for (size_t b = 0; b < 256; ++b)
+            {
+                const auto key = std::make_pair(klass[b], set.test(b));
+                klass[b] = refine.emplace(key, static_cast<uint32_t>(refine.size())).first->second;
+            }
+            count = static_cast<uint32_t>(refine.size());
+            if (count == 256) break;
+        }
+        class_rep_.assign(count, 0);
+        std::vector<bool> seen(count, false);
+        for (size_t b = 0; b < 256; ++b)
+        {
+            byte_class_[b] = static_cast<uint8_t>(klass[b]);
+            if (!seen[klass[b]])
+            {
+                seen[klass[b]] = true;
+                class_rep_[klass[b]] = static_cast<uint8_t>(b);
+            }
+        }
+
+        states_.clear();
+        state_index_.clear();
+        dead_ = nullptr;
+        dead_ = intern_state({});
+        std::vector<uint32_t> insts;
+        std::vector<bool> visited(prog_.size(), false);
+        for (const uint32_t start : starts_)
+        {
+            closure(start, insts, visited);
+        }
+        start_ = intern_state(std::move(insts));
+        compiled_.store(true, std::memory_order_release);
+    }
+
+    void RegexSet::closure(const uint32_t pc, std::vector<uint32_t> &out, std::vector<bool> &visited) const
+    {
+        if (visited[pc])
+        {
+            return;
+        }
+        visited[pc] = true;
+        const Inst &inst = prog_[pc];
+        switch (inst.op_)
+        {
+            case Inst::Op::Byte:
+            case Inst::Op::Match:
+                out.push_back(pc);
+                break;
+            case Inst::Op::Split:
+                closure(inst.x_, out, visited);
+                closure(inst.y_, out, visited);
+                break;
+            case Inst::Op::Jmp:
+                closure(inst.x_, out, visited);
+                break;
+            case Inst::Op::Save:
+                closure(pc + 1, out, visited);
+                break;
+        }
+    }
+
+    RegexSet::DState *RegexSet::intern_state(std::vector<uint32_t> insts) const
+    {
+        std::sort(insts.begin(), insts.end());
+        if (const auto it = state_index_.find(insts); it != state_index_.end())
+        {
+            return it->second;
+        }
+        if (insts.empty() && dead_)
+        {
+            return dead_;
+        }
+        if (states_.size() >= kMaxStates)
+        {
+            return nullptr;
+        }
+
+        DState &state = states_.emplace_back();
+        state.next_ = std::make_unique<std::atomic<DState *>[]>(class_rep_.size());
+        for (size_t i = 0; i < class_rep_.size(); ++i)
+        {
+            state.next_[i].store(nullptr, std::memory_order_relaxed);
+        }
+        for (const uint32_t pc : insts)
+        {
+            if (prog_[pc].op_ == Inst::Op::Match)
+            {
+                state.matches_.push_back(prog_[pc].arg_);
+            }
+        }
+        std::sort(state.matches_.begin(), state.matches_.end());
+        state.insts_ = insts;
+        state_index_.emplace(std::move(insts), &state);
+        return &state;
+    }
+
+    RegexSet::DState *RegexSet::compute_next(DState *state, const uint32_t byte_class) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (DState *next = state->next_[byte_class].load(std::memory_order_acquire))
+        {
+            return next;
+        }
+
+        const uint8_t byte = class_rep_[byte_class];
+        std::vector<uint32_t> insts;
+        std::vector<bool> visited(prog_.size(), false);
+        for (const uint32_t pc : state->insts_)
+        {
+            if (const Inst &inst = prog_[pc]; inst.op_ == Inst::Op::Byte && classes_[inst.arg_].test(byte))
+            {
+                closure(pc + 1, insts, visited);
+            }
+        }
+        DState *next = intern_state(std::move(insts));
+        if (next)
+        {
+            state->next_[byte_class].store(next, std::memory_order_release);
+        }
+        return next;
+    }
+
+    void RegexSet::match(const std::string_view text, std::vector<uint32_t> &matches) const
+    {
+        matches.clear();
+        if (starts_.empty())
+        {
+            return;
+        }
+        if (!compiled_.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!compiled_.load(std::memory_order_relaxed))
+            {
+                compile();
+            }
+        }
+
+        const DState *state = start_;
+        for (const char c : text)
+        {
+            const uint32_t byte_class = byte_class_[static_cast<unsigned char>(c)];
+            DState *next = state->next_[byte_class].load(std::memory_order_acquire);
+            if (!next && !(next = compute_next(const_cast<DState *>(state), byte_class)))
+            {
+                match_nfa(text, matches);
+                return;
+            }
+            if (next == dead_)
+            {
+                return;
+            }
+            state = next;
+        }
+        matches = state->matches_;
+    }
+
+    void RegexSet::match_nfa(const std::string_view text, std::vector<uint32_t> &matches) const
+    {
+        std::vector<uint32_t> current, next;
+        std::vector<bool> visited(prog_.size(), false);
+        for (const uint32_t start : starts_)
+        {
+            closure(start, current, visited);
+        }
+        for (const char c : text)
+        {
+            next.clear();
+            std::fill(visited.begin(), visited.end(), false);
+            for (const uint32_t pc : current)
+            {
+                if (const Inst &inst = prog_[pc];
+                    inst.op_ == Inst::Op::Byte && classes_[inst.arg_].test(static_cast<unsigned char>(c)))
+                {
+                    closure(pc + 1, next, visited);
+                }
+            }
+            current.swap(next);
+            if (current.empty())
+            {
+                return;
+            }
+        }
+        for (const uint32_t pc : current)
+        {
+            if (prog_[pc].op_ == Inst::Op::Match)
+            {
+                matches.push_back(prog_[pc].arg_);
+            }
+        }
+        std::sort(matches.begin(), matches.end());
+    }
+
+    namespace
+    {
+        // Pike VM：线程按优先级排列，等价于回溯引擎的首个成功路径。
+        // 只在单个模式的指令区间[base, end)内运行，捕获位置存放在扁平数组中
+        template<typename Inst, typename Classes>
+        class PikeVm
+        {
+        public:
+            PikeVm(const std::vector<Inst> &prog, const Classes &classes, const uint32_t base, const uint32_t end,
+                   const size_t slots)
+                : prog_(prog), classes_(classes), base_(base), slots_(slots),
+                  mark_(end - base, SIZE_MAX), scratch_(slots, SIZE_MAX)
+            {
+            }
+
+            // 匹配成功时caps指向成功线程的捕获位置
+            bool run(const std::string_view text, const size_t *&caps)
+            {
+                add(current_, base_, 0);
+                for (size_t i = 0; i < text.size() && !current_.pcs_.empty(); ++i)
+                {
+                    next_.clear();
+                    for (size_t t = 0; t < current_.pcs_.size(); ++t)
+                    {
+                        if (const Inst &inst = prog_[current_.pcs_[t]];
+                            inst.op_ == Inst::Op::Byte && classes_[inst.arg_].test(static_cast<unsigned char>(text[i])))
+                        {
+                            std::copy_n(current_.caps_.begin() + t * slots_, slots_, scratch_.begin());
+                            add(next_, current_.pcs_[t] + 1, i + 1);
+                        }
+                    }
+                    std::swap(current_, next_);
+                }
+                for (size_t t = 0; t < current_.pcs_.size(); ++t)
+                {
+                    if (prog_[current_.pcs_[t]].op_ == Inst::Op::Match)
+                    {
+                        caps = current_.caps_.data() + t * slots_;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+        private:
+            struct List
+            {
+                std::vector<uint32_t> pcs_;
+                std::vector<size_t> caps_;
+
+                void clear()
+                {
+                    pcs_.clear();
+                    caps_.clear();
+                }
+            };
+
+            // 沿epsilon边加入线程，scratch_为当前线程的捕获位置
+            void add(List &list, const uint32_t pc, const size_t step)
+            {
+                if (mark_[pc - base_] == step)
+                {
+                    return;
+                }
+                mark_[pc - base_] = step;
+                const Inst &inst = prog_[pc];
+                switch (inst.op_)
+                {
+                    case Inst::Op::Split:
+                        add(list, inst.x_, step);
+                        add(list, inst.y_, step);
+                        break;
+                    case Inst::Op::Jmp:
+                        add(list, inst.x_, step);
+                        break;
+                    case Inst::Op::Save:
+                    {
+                        const size_t saved = scratch_[inst.arg_];
+                        scratch_[inst.arg_] = step;
+                        add(list, pc + 1, step);
+                        scratch_[inst.arg_] = saved;
+                        break;
+                    }
+                    default:
+                        list.pcs_.push_back(pc);
+                        list.caps_.insert(list.caps_.end(), scratch_.begin(), scratch_.end());
+                        break;
+                }
+            }
+
+        private:
+            const std::vector<Inst> &prog_;
+            const Classes &classes_;
+            const uint32_t base_;
+            const size_t slots_;
+            std::vector<size_t> mark_;
+            std::vector<size_t> scratch_;
+            List current_, next_;
+        };
+    }
+
+    bool RegexSet::captures(const uint32_t id, const std::string_view text, std::vector<Group> &groups) const
+    {
+        const uint32_t base = starts_[id];
+        const uint32_t end = id + 1 < starts_.size() ? starts_[id + 1] : static_cast<uint32_t>(prog_.size());
+        const size_t count = group_counts_[id];
+        PikeVm<Inst, std::vector<std::bitset<256>>> vm(prog_, classes_, base, end, count * 2);
+        const size_t *caps = nullptr;
+        if (!vm.run(text, caps))
+        {
+            return false;
+        }
+
+        groups.clear();
+        for (size_t g = 0; g < count; ++g)
+        {
+            const size_t begin = caps[g * 2];
+            const size_t finish = caps[g * 2 + 1];
+            if (begin == SIZE_MAX || finish == SIZE_MAX)
+            {
+                groups.emplace_back(std::string_view::npos, 0);
+            }
+            else
+            {
+                groups.emplace_back(begin, finish - begin);
+            }
+        }
+        return true;
+    }
+
+    size_t RegexSet::dfa_states() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return states_.size();
+    }
+} // namespace zhttp::zrouter
@@ -0,0 +1,88 @@
+#include "router/route_group.h"
+
+namespace zhttp::zrouter
+{
+    RouteGroup::RouteGroup(Router *router, std::string prefix, MiddlewareList middlewares)
+            : router_(router), prefix_(std::move(prefix))
+    {
+        while (!prefix_.empty() && prefix_.back() == '/')
+        {
+            prefix_.pop_back();
+        }
+        if (!middlewares.empty())
+        {
+            router_->use(prefix_, std::move(middlewares));
+        }
+    }
+
+    RouteGroup RouteGroup::group(const std::string &prefix, MiddlewareList middlewares) const
+    {
+        return RouteGroup(router_, prefix_ + prefix, std::move(middlewares));
+    }
+
+    void RouteGroup::use(MiddlewareList middlewares) const
+    {
+        router_->use(prefix_, std::move(middlewares));
+    }
+
+    void RouteGroup::Get(const std::string &path, const HandlerCallback &cb) const
+    {
+        router_->register_callback(prefix_ + path, HttpRequest::Method::GET, cb);
+    }
+
+    void RouteGroup::Get(const std::string &path, HandlerPtr handler) const
+    {
+        router_->register_handler(prefix_ + path, HttpRequest::Method::GET, std::move(handler));
+    }
+
+    void RouteGroup::Post(const std::string &path, const HandlerCallback &cb) const
+    {
+        router_->register_callback(prefix_ + path, HttpRequest::Method::POST, cb);
+    }
+
+    void RouteGroup::Post(const std::string &path, HandlerPtr handler) const
+    {
+        router_->register_handler(prefix_ + path, HttpRequest::Method::POST, std::move(handler));
+    }
+
+    void RouteGroup::Put(const std::string &path, const HandlerCallback &cb) const
+    {
+        router_->register_callback(prefix_ + path, HttpRequest::Method::PUT, cb);
+    }
+
+    void RouteGroup::Put(const std::string &path, HandlerPtr handler) const
+    {
+        router_->register_handler(prefix_ + path, HttpRequest::Method::PUT, std::move(handler));
+    }
+
+    void RouteGroup::Delete(const std::string &path, const HandlerCallback &cb) const
+    {
+        router_->register_callback(prefix_ + path, HttpRequest::Method::DELETE, cb);
+    }
+
+    void RouteGroup::Delete(const std::string &path, HandlerPtr handler) const
+    {
+        router_->register_handler(prefix_ + path, HttpRequest::Method::DELETE, std::move(handler));
+    }
+
+    void RouteGroup::Patch(const std::string &path, const HandlerCallback &cb) const
+    {
+        router_->register_callback(prefix_ + path, HttpRequest::Method::PATCH, cb);
+    }
+
+    void RouteGroup::Patch(const std::string &path, HandlerPtr handler) const
+    {
+        router_->register_handler(prefix_ + path, HttpRequest::Method::PATCH, std::move(handler));
+    }
+
+    void RouteGroup::add_regex_route(HttpRequest::Method method, const std::string &path,
+                                     const HandlerCallback &cb) const
+    {
+        router_->register_regex_callback(prefix_ + path, method, cb);
+    }
+
+    void RouteGroup::add_regex_route(HttpRequest::Method method, const std::string &path, HandlerPtr handler) const
+    {
+        router_->register_regex_handler(prefix_ + path, method, std::move(handler));
+    }
+} // namespace zhttp::zrouter
@@ -0,0 +1,362 @@
+#include "router/route_table.h"
+#include <algorithm>
+#include "log/http_logger.h"
+
+
+namespace zhttp::zrouter
+{
+    RouteTable::RouteTable(const std::vector<RouteDefinition> &definitions,
+                           const std::vector<MiddlewareScope> &scopes)
+    {
+        build_scopes(scopes);
+        for (const auto &definition : definitions)
+        {
+            add(definition);
+        }
+    }
+
+    void RouteTable::add(const RouteDefinition &definition)
+    {
+        RouteDefinition resolved = definition;
+        resolved.target_.middlewares_ = resolve_middlewares(definition.path_);
+        if (definition.kind_ == RouteDefinition::Kind::Exact)
+        {
+            add_exact(resolved);
+        }
+        else
+        {
+            add_dynamic(resolved);
+        }
+    }
+
+    bool RouteTable::in_scope(const std::string_view prefix, const std::string_view path)
+    {
+        return path.compare(0, prefix.size(), prefix) == 0 &&
+               (path.size() == prefix.size() || path[prefix.size()] == '/');
+    }
+
+    void RouteTable::build_scopes(const std::vector<MiddlewareScope> &scopes)
+    {
+        // 收集不同的前缀，全局作用域总是存在
+        std::vector<std::string> prefixes{""};
+        for (const auto &scope : scopes)
+        {
+            if (std::find(prefixes.begin(), prefixes.end(), scope.prefix_) == prefixes.end())
+            {
+                prefixes.push_back(scope.prefix_);
+            }
+        }
+        std::sort(prefixes.begin(), prefixes.end(), [](const std::string &a, const std::string &b)
+        {
+            return a.size() > b.size();
+        });
+
+        // 管线依次为外层到内层作用域的中间件，同层按注册顺序
+        for (const auto &prefix : prefixes)
+        {
+            std::vector<const MiddlewareScope *> covering;
+            for (const auto &scope : scopes)
+            {
+                if (in_scope(scope.prefix_, prefix))
+                {
+                    covering.push_back(&scope);
+                }
+            }
+            std::stable_sort(covering.begin(), covering.end(), [](const MiddlewareScope *a, const MiddlewareScope *b)
+            {
+                return a->prefix_.size() < b->prefix_.size();
+            });
+
+            std::vector<std::shared_ptr<zmiddleware::Middleware>> middlewares;
+            for (const MiddlewareScope *scope : covering)
+            {
+                middlewares.insert(middlewares.end(), scope->middlewares_.begin(), scope->middlewares_.end());
+            }
+            scope_chains_.emplace_back(prefix, middlewares.empty()
+                                               ? nullptr
+                                               : std::make_shared<zmiddleware::MiddlewareChain>(
+                                                       std::move(middlewares)));
+        }
+    }
+
+    const RouteTable::ChainPtr &RouteTable::resolve_middlewares(const std::string_view path) const
+    {
+        static const ChainPtr none;
+        for (const auto &[prefix, chain] : scope_chains_)
+        {
+            if (in_scope(prefix, path))
+            {
+                return chain;
+            }
+        }
+        return none;
+    }
+
+    size_t RouteTable::hash_key(const HttpRequest::Method method, const std::string_view path)
+    {
+        const size_t path_hash = std::hash<std::string_view>()(path);
+        const size_t method_hash = std::hash<int>()(static_cast<int>(method));
+        return path_hash * 31 + method_hash;
+    }
+
+    const RouteTable::ExactEntry *RouteTable::find_entry(const HttpRequest::Method method,
+                                                         const std::string_view path) const
+    {
+        if (slots_.empty())
+        {
+            return nullptr;
+        }
+        const size_t hash = hash_key(method, path);
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask)
+        {
+            const uint32_t slot = slots_[i];
+            if (slot == 0)
+            {
+                return nullptr;
+            }
+            const ExactEntry &entry = entries_[slot - 1];
+            if (entry.hash_ == hash && entry.method_ == method && entry.path_ == path)
+            {
+                return &entry;
+            }
+        }
+    }
+
+    void RouteTable::add_exact(const RouteDefinition &definition)
+    {
+        // 同一键重复注册时后者覆盖前者
+        auto *entry = const_cast<ExactEntry *>(find_entry(definition.method_, definition.path_));
+        if (!entry)
+        {
+            if ((entries_.size() + 1) * 2 > slots_.size())
+            {
+                rehash(std::max<size_t>(16, slots_.size() * 2));
+            }
+            entries_.push_back(ExactEntry{definition.method_, definition.path_,
+                                          hash_key(definition.method_, definition.path_), RouteTarget{}});
+            entry = &entries_.back();
+
+            const size_t mask = slots_.size() - 1;
+            size_t i = entry->hash_ & mask;
+            while (slots_[i] != 0)
+            {
+                i = (i + 1) & mask;
+            }
+            slots_[i] = static_cast<uint32_t>(entries_.size());
+        }
+
+        if (definition.target_.handler_)
+        {
+            entry->target_.handler_ = definition.target_.handler_;
+        }
+        else
+        {
+            entry->target_.callback_ = definition.target_.callback_;
+        }
+        entry->target_.middlewares_ = definition.target_.middlewares_;
+    }
+
+    void RouteTable::rehash(const size_t slot_count)
+    {
+        slots_.assign(slot_count, 0);
+        const size_t mask = slot_count - 1;
+        for (size_t index = 0; index < entries_.size(); ++index)
+        {
+            size_t i = entries_[index].hash_ & mask;
+            while (slots_[i] != 0)
+            {
+                i = (i + 1) & mask;
+            }
+            slots_[i] = static_cast<uint32_t>(index + 1);
+        }
+    }
+
+    void RouteTable::add_dynamic(const RouteDefinition &definition)
+    {
+        if (RadixTree::is_tree_pattern(definition.path_))
+        {
+            tree_.insert(definition.path_, definition.method_, definition.target_);
+            return;
+        }
+        if (add_regex_route(definition.path_, definition.method_, definition.target_))
+        {
+            return;
+        }
+        auto &fallback = definition.target_.handler_ ? regex_handlers_ : regex_callbacks_;
+        fallback.push_back(FallbackRoute{convert_to_regex(definition.path_), definition.method_,
+                                         definition.target_, regex_order_++});
+    }
+
+    // 正则路由加入正则集合
+    bool RouteTable::add_regex_route(const std::string &path, const HttpRequest::Method &method,
+                                     const RouteTarget &target)
+    {
+        try
+        {
+            const uint32_t id = regex_set_.add(convert_to_pattern(path));
+            regex_routes_.resize(std::max<size_t>(regex_routes_.size(), id + 1));
+            regex_routes_[id] = RegexRoute{method, target, regex_order_++};
+            return true;
+        }
+        catch (const std::invalid_argument &e)
+        {
+            ZHTTP_LOG_WARN("Regex route {} falls back to std::regex: {}", path, e.what());
+            return false;
+        }
+    }
+
+    // 精确匹配
+    const RouteTarget *RouteTable::find_exact(const HttpRequest &request) const
+    {
+        return find_exact(request.get_method(), request.get_path());
+    }
+
+    const RouteTarget *RouteTable::find_exact(const HttpRequest::Method method, const std::string_view path) const
+    {
+        const ExactEntry *entry = find_entry(method, path);
+        return entry ? &entry->target_ : nullptr;
+    }
+
+    // 前缀树与正则表达式匹配
+    const RouteTarget *RouteTable::find_dynamic(HttpRequest &request) const
+    {
+        // 1.查找前缀树
+        if (const RouteTarget *target = tree_.find(request))
+        {
+            return target;
+        }
+
+        // 2.正则集合与不支持集合语法的正则表达式共用一个优先级，先选出正则集合中的最优者
+        uint32_t best_id = 0;
+        const RegexRoute *best = find_regex_set(request.get_method(), request.get_path(), best_id);
+
+        // 3.只需尝试优先级更高的std::regex路由
+        if (std::cmatch match; const FallbackRoute *fallback =
+                find_fallback(request.get_method(), request.get_path(), best, match))
+        {
+            // 提取路径参数
+            extract_path_parameters(match, request);
+            return &fallback->target_;
+        }
+
+        thread_local std::vector<RegexSet::Group> groups;
+        if (!best || !regex_set_.captures(best_id, request.get_path(), groups))
+        {
+            return nullptr;
+        }
+
+        // 捕获组按位置作为param1、param2...
+        for (const auto &[offset, length] : groups)
+        {
+            request.add_path_parameter({}, offset == std::string_view::npos ? 0 : offset, length);
+        }
+        return &best->target_;
+    }
+
+    // 按方法与路径查找，供只需知道命中哪条路由的场合使用
+    const RouteTarget *RouteTable::find_route(const HttpRequest::Method method, const std::string_view path) const
+    {
+        if (const RouteTarget *target = find_exact(method, path))
+        {
+            return target;
+        }
+        if (const RouteTarget *target = tree_.find(method, path))
+        {
+            return target;
+        }
+        uint32_t best_id = 0;
+        const RegexRoute *best = find_regex_set(method, path, best_id);
+        if (std::cmatch match; const FallbackRoute *fallback = find_fallback(method, path, best, match))
+        {
+            return &fallback->target_;
+        }
+        return best ? &best->target_ : nullptr;
+    }
+
+    // 两个std::regex列表各自按注册顺序排列，遇到优先级不高于best的路由即可停止
+    const RouteTable::FallbackRoute *RouteTable::find_fallback(const HttpRequest::Method method,
+                                                               const std::string_view path,
+                                                               const RegexRoute *best, std::cmatch &match) const
+    {
+        for (const auto *fallbacks : {&regex_handlers_, &regex_callbacks_})
+        {
+            for (const auto &fallback : *fallbacks)
+            {
+                if (best && regex_priority(fallback.target_, fallback.order_) >
+                            regex_priority(best->target_, best->order_))
+                {
+                    break;
+                }
+                if (fallback.method_ == method &&
+                    std::regex_match(path.data(), path.data() + path.size(), match, fallback.regex_path_))
+                {
+                    return &fallback;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    std::pair<bool, uint32_t> RouteTable::regex_priority(const RouteTarget &target, const uint32_t order)
+    {
+        return {!target.handler_, order};
+    }
+
+    // 在正则集合中匹配
+    const RouteTable::RegexRoute *RouteTable::find_regex_set(const HttpRequest::Method method,
+                                                             const std::string_view path, uint32_t &id) const
+    {
+        if (regex_set_.size() == 0)
+        {
+            return nullptr;
+        }
+
+        thread_local std::vector<uint32_t> matches;
+        regex_set_.match(path, matches);
+
+        // 处理器优先于回调函数，同类按注册顺序
+        const RegexRoute *best = nullptr;
+        for (const uint32_t candidate_id : matches)
+        {
+            const RegexRoute &candidate = regex_routes_[candidate_id];
+            if (candidate.method_ != method)
+            {
+                continue;
+            }
+            if (!best || regex_priority(candidate.target_, candidate.order_) <
+                         regex_priority(best->target_, best->order_))
+            {
+                best = &candidate;
+                id = candidate_id;
+            }
+        }
+        return best;
+    }
+
+    // 将路径转换为正则表达式
+    //输入路径模式：/users/:id/posts/:postId
+    //转换后的正则表达式：^/users/([^/]+)/posts/([^/]+)$
+    //可匹配的路径示例：/users/123/posts/456
+    std::string RouteTable::convert_to_pattern(const std::string &path)
+    {
+        return "^" + std::regex_replace(path, std::regex(R"(/:([^/]+))"), R"(/([^/]+))") + "$";
+    }
+
+    std::regex RouteTable::convert_to_regex(const std::string &path)
+    {
+        return std::regex(convert_to_pattern(path));
+    }
+
+
+    // 提前路径参数
+    void RouteTable::extract_path_parameters(const std::cmatch &match, HttpRequest &request)
+    {
+        // 跳过索引 0，因为索引 0 存储的是整个匹配的路径字符串，并非捕获组。
+        for (size_t i = 1; i < match.size(); ++i)
+        {
+            request.set_path_parameters("param" + std::to_string(i), match[i].str());
+        }
+    }
+
+} // namespace zhttp::zrouter
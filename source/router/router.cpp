@@ -1,14 +1,25 @@
 #include "router/router.h"
+#include <algorithm>
+#include "utils/epoch.h"
 
 
 namespace zhttp::zrouter
 {
+    Router::Router() : table_(new RouteTable())
+    {
+    }
+
+    Router::~Router()
+    {
+        // 析构时不会再有读者
+        delete table_.load(std::memory_order_relaxed);
+    }
+
     // 注册路由处理器
     void Router::register_handler(const std::string &path, const HttpRequest::Method &method,
                                   Router::HandlerPtr handler)
     {
-        const Router::RouteKey key{method, path};
-        handlers_[key] = std::move(handler);
+        register_route({RouteDefinition::Kind::Exact, path, method, RouteTarget{std::move(handler), nullptr}});
     }
 
 
@@ -16,15 +27,14 @@ namespace zhttp::zrouter
     void Router::register_callback(const std::string &path, const HttpRequest::Method &method,
                                    Router::HandlerCallback callback)
     {
-        const Router::RouteKey key{method, path};
-        callbacks_[key] = std::move(callback);
+        register_route({RouteDefinition::Kind::Exact, path, method, RouteTarget{nullptr, std::move(callback)}});
     }
 
     // 注册动态路由处理器
     void Router::register_regex_handler(const std::string &path, const HttpRequest::Method &method,
                                         Router::HandlerPtr handler)
     {
-        regex_handlers_.emplace_back(convert_to_regex(path), method, std::move(handler));
+        register_route({RouteDefinition::Kind::Dynamic, path, method, RouteTarget{std::move(handler), nullptr}});
     }
 
 
@@ -32,80 +42,200 @@ namespace zhttp::zrouter
     void Router::register_regex_callback(const std::string &path, const HttpRequest::Method &method,
                                          Router::HandlerCallback callback)
     {
-        regex_callbacks_.emplace_back(convert_to_regex(path), method, std::move(callback));
+        register_route({RouteDefinition::Kind::Dynamic, path, method, RouteTarget{nullptr, std::move(callback)}});
     }
 
+    void Router::register_route(RouteDefinition definition)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!staging_)
+        {
+            staging_ = std::make_unique<RouteTable>(definitions_, scopes_);
+        }
+        try
+        {
+            staging_->add(definition);
+        }
+        catch (...)
+        {
+            // 暂存快照可能已被部分修改，下次从注册信息重建
+            staging_.reset();
+            throw;
+        }
+        definitions_.push_back(std::move(definition));
+        commit();
+    }
 
-    // 路由处理
-    bool Router::route(const HttpRequest &request, HttpResponse *response)
+    void Router::use(const std::string &prefix, std::vector<std::shared_ptr<zmiddleware::Middleware>> middlewares)
     {
-        const Router::RouteKey key{request.get_method(), request.get_path()};
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string normalized = prefix;
+        while (!normalized.empty() && normalized.back() == '/')
+        {
+            normalized.pop_back();
+        }
+        scopes_.push_back(MiddlewareScope{std::move(normalized), std::move(middlewares)});
+
+        // 作用域变化影响所有路由的管线，重新构建
+        staging_.reset();
+        commit();
+    }
 
-        // 1.查找处理器
-        if (const auto it = handlers_.find(key); it != handlers_.end())
+    void Router::commit()
+    {
+        if (frozen_)
         {
-            it->second->handle_request(request, response);
-            return true;
+            publish();
         }
+        else
+        {
+            pending_.store(true, std::memory_order_release);
+        }
+    }
 
-        // 2.查找回调函数
-        if (const auto it_callback = callbacks_.find(key); it_callback != callbacks_.end())
+    // 删除路由
+    size_t Router::remove_route(const std::string &path, const HttpRequest::Method &method)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t before = definitions_.size();
+        definitions_.erase(std::remove_if(definitions_.begin(), definitions_.end(),
+                                          [&](const RouteDefinition &definition)
+                                          {
+                                              return definition.method_ == method && definition.path_ == path;
+                                          }),
+                           definitions_.end());
+        const size_t removed = before - definitions_.size();
+        if (removed > 0)
         {
-            it_callback->second(request, response);
-            return true;
+            staging_ = std::make_unique<RouteTable>(definitions_, scopes_);
+            publish();
         }
+        return removed;
+    }
 
-        // 3.查找正则表达式处理器
-        for (const auto &[regex_path, method, handler]: regex_handlers_)
+    void Router::freeze()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        frozen_ = true;
+        if (pending_.load(std::memory_order_relaxed))
         {
-            if (std::smatch match; std::regex_match(request.get_path(), match, regex_path) && method == request.get_method())
-            {
-                // 提取路径参数
-                HttpRequest new_request = request;
-                extract_path_parameters(match, new_request);
-                handler->handle_request(new_request, response);
-                return true;
-            }
+            publish();
+        }
+    }
+
+    void Router::publish()
+    {
+        if (!staging_)
+        {
+            staging_ = std::make_unique<RouteTable>(definitions_, scopes_);
         }
+        RouteTable *old = table_.exchange(staging_.release(), std::memory_order_acq_rel);
+        pending_.store(false, std::memory_order_release);
+        zutils::EpochDomain::global().retire(old);
+    }
 
-        // 4.查找正则表达式回调函数
-        for (const auto &[regex_path, method, callback]: regex_callbacks_)
+    const RouteTable *Router::snapshot()
+    {
+        // 启动前注册的路由在首次查找时发布
+        if (pending_.load(std::memory_order_acquire))
         {
-            if (std::smatch match; std::regex_match(request.get_path(), match, regex_path) && method == request.get_method())
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.load(std::memory_order_relaxed))
             {
-                // 提取路径参数
-                HttpRequest new_request = request;
-                extract_path_parameters(match, new_request);
-                callback(new_request, response);
-                return true;
+                publish();
             }
         }
-        return false;
+        return table_.load(std::memory_order_acquire);
     }
 
-    // 将路径转换为正则表达式
-    //输入路径模式：/users/:id/posts/:postId
-    //转换后的正则表达式：^/users/([^/]+)/posts/([^/]+)$
-    //可匹配的路径示例：/users/123/posts/456
-    std::regex Router::convert_to_regex(const std::string &path)
+    void Router::invoke(const RouteTarget &target, zmiddleware::MiddlewareChain *middlewares,
+                        HttpRequest &request, HttpResponse *response)
     {
-        const std::string regex_pattern = "^" + std::regex_replace(path,
-                                                             std::regex(R"(/:([^/]+))"),
-                                                             R"(/([^/]+))") + "$";
-        return std::regex(regex_pattern);
+        if (!middlewares)
+        {
+            target(request, response);
+            return;
+        }
+        zmiddleware::MiddlewareContext context(request, *response);
+        middlewares->run(context, [&target](zmiddleware::MiddlewareContext &ctx)
+        {
+            target(ctx.request(), &ctx.response());
+        });
     }
 
+    // 路由处理
+    bool Router::route(const HttpRequest &request, HttpResponse *response)
+    {
+        const auto guard = zutils::EpochDomain::global().pin();
+        const RouteTable *table = snapshot();
+        if (const RouteTarget *target = table->find_exact(request); target && !target->middlewares_)
+        {
+            (*target)(request, response);
+            return true;
+        }
+        HttpRequest new_request = request;
+        return dispatch(new_request, response);
+    }
 
-    // 提前路径参数
-    void Router::extract_path_parameters(const std::smatch &match, HttpRequest &request)
+    bool Router::dispatch(HttpRequest &request, HttpResponse *response)
     {
-        // 跳过索引 0，因为索引 0 存储的是整个匹配的路径字符串，并非捕获组。
-        for (size_t i = 1; i < match.size(); ++i)
+        const auto guard = zutils::EpochDomain::global().pin();
+        const RouteTable *table = snapshot();
+        const RouteTarget *target = table->find_exact(request);
+        if (!target)
+        {
+            target = table->find_dynamic(request);
+        }
+        if (!target)
         {
-            request.set_path_parameters("param" + std::to_string(i), match[i].str());
+            return false;
         }
+        invoke(*target, target->middlewares_.get(), request, response);
+        return true;
     }
 
-} // namespace zhttp::zrouter
+    // 作用域按模式前缀组织，先找出原路径命中的路由，沿用其发布时解析的管线
+    zmiddleware::MiddlewareChain *Router::resolve_options_middlewares(const RouteTable &table,
+                                                                      const std::string_view path)
+    {
+        for (const auto method : {HttpRequest::Method::GET, HttpRequest::Method::POST, HttpRequest::Method::PUT,
+                                  HttpRequest::Method::PATCH, HttpRequest::Method::DELETE, HttpRequest::Method::HEAD})
+        {
+            if (const RouteTarget *target = table.find_route(method, path))
+            {
+                return target->middlewares_.get();
+            }
+        }
 
+        // 没有路由命中时按路径所在的静态作用域
+        return table.resolve_middlewares(path).get();
+    }
 
+    bool Router::dispatch_options(HttpRequest &request, HttpResponse *response, const std::string &target_path)
+    {
+        const auto guard = zutils::EpochDomain::global().pin();
+        const RouteTable *table = snapshot();
+        const RouteTarget *target = table->find_exact(request.get_method(), target_path);
+        if (!target)
+        {
+            return false;
+        }
+
+        // 中间件看到的是原路径，到达处理器前再改写到OPTIONS处理器的路径
+        zmiddleware::MiddlewareChain *middlewares = resolve_options_middlewares(*table, request.get_path());
+        if (!middlewares)
+        {
+            request.set_path(target_path);
+            (*target)(request, response);
+            return true;
+        }
+        zmiddleware::MiddlewareContext context(request, *response);
+        middlewares->run(context, [target, &target_path](zmiddleware::MiddlewareContext &ctx)
+        {
+            ctx.request().set_path(target_path);
+            (*target)(ctx.request(), &ctx.response());
+        });
+        return true;
+    }
+
+} // namespace zhttp::zrouter
@@ -0,0 +1,259 @@
+#include "session/cached_storage.h"
+#include "log/http_logger.h"
+#include <algorithm>
+
+namespace zhttp::zsession
+{
+    CachedSessionStorage::CachedSessionStorage(SessionStorage::ptr backend, InvalidationBus::ptr bus,
+                                               const NearCacheConfig config)
+        : backend_(std::move(backend)), bus_(std::move(bus)), config_(config)
+    {
+        size_t shards = 1;
+        while (shards < config_.shard_count_)
+        {
+            shards <<= 1;
+        }
+        shard_mask_ = shards - 1;
+        shard_capacity_ = std::max<size_t>(1, (config_.capacity_ + shards - 1) / shards);
+        shards_ = std::make_unique<Shard[]>(shards);
+
+        if (bus_)
+        {
+            subscription_ = bus_->subscribe(
+                    [this](const std::string &session_id)
+                    {
+                        remote_invalidations_.fetch_add(1, std::memory_order_relaxed);
+                        invalidate(session_id);
+                    },
+                    [this]
+                    {
+                        ZHTTP_LOG_WARN("Session invalidation stream reset, dropping near cache");
+                        invalidate_all();
+                    });
+        }
+        ZHTTP_LOG_INFO("CachedSessionStorage created: capacity={}, ttl={}ms, shards={}",
+                       config_.capacity_, config_.ttl_ms_, shards);
+    }
+
+    CachedSessionStorage::~CachedSessionStorage()
+    {
+        subscription_.reset();
+    }
+
+    CachedSessionStorage::Shard &CachedSessionStorage::shard_for(const std::string &session_id) const
+    {
+        const uint64_t hash = std::hash<std::string>{}(session_id) * 0x9E3779B97F4A7C15ULL;
+        return shards_[(hash >> 40) & shard_mask_];
+    }
+
+    int64_t CachedSessionStorage::now_ms()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void CachedSessionStorage::put(Shard &shard, const std::string &session_id,
+                                   std::shared_ptr<const Session> session, const int64_t now_ms) const
+    {
+        const int64_t deadline = now_ms + config_.ttl_ms_;
+        if (const auto it = shard.index_.find(session_id); it != shard.index_.end())
+        {
+            it->second->session_ = std::move(session);
+            it->second->deadline_ms_ = deadline;
+            shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+            return;
+        }
+        if (shard.lru_.size() >= shard_capacity_)
+        {
+            shard.index_.erase(shard.lru_.back().session_id_);
+            shard.lru_.pop_back();
+        }
+        shard.lru_.push_front(Entry{session_id, std::move(session), deadline});
+        shard.index_.emplace(session_id, shard.lru_.begin());
+    }
+
+    void CachedSessionStorage::drop(Shard &shard, const std::string &session_id)
+    {
+        ++shard.invalidations_;
+        if (const auto it = shard.index_.find(session_id); it != shard.index_.end())
+        {
+            shard.lru_.erase(it->second);
+            shard.index_.erase(it);
+        }
+    }
+
+    void CachedSessionStorage::store(const std::shared_ptr<Session> &session)
+    {
+        backend_->store(session);
+
+        // 写穿后更新本地副本；同时记一次失效，使并发中加载到旧数据的请求不会覆盖它。
+        // 副本须是完整的，否则命中缓存的请求会绕过缓存按需读取后端
+        session->load_all_attributes();
+        auto snapshot = std::make_shared<const Session>(*session);
+        Shard &shard = shard_for(session->get_session_id());
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            drop(shard, session->get_session_id());
+            put(shard, session->get_session_id(), std::move(snapshot), now_ms());
+        }
+        // 只顺延过期时间的写入不通知其他节点，它们的副本很快会自然过期
+        if (bus_ && session->is_dirty())
+        {
+            bus_->publish(session->get_session_id());
+        }
+    }
+
+    std::shared_ptr<Session> CachedSessionStorage::lookup(Shard &shard, const std::string &session_id,
+                                                          const int64_t now_ms, uint64_t &seen_invalidations)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        if (const auto it = shard.index_.find(session_id); it != shard.index_.end())
+        {
+            if (it->second->deadline_ms_ > now_ms && !it->second->session_->is_expired())
+            {
+                shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                auto session = std::make_shared<Session>(*it->second->session_); // 每个请求拿到独立的副本
+                session->clear_dirty();
+                return session;
+            }
+            shard.lru_.erase(it->second);
+            shard.index_.erase(it);
+        }
+        seen_invalidations = shard.invalidations_;
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    void CachedSessionStorage::fill(Shard &shard, const std::string &session_id,
+                                    const std::shared_ptr<Session> &session, const uint64_t seen_invalidations,
+                                    const int64_t now_ms) const
+    {
+        if (!session)
+        {
+            return;
+        }
+        session->load_all_attributes(); // 缓存完整副本，不与请求共用loader
+        auto snapshot = std::make_shared<const Session>(*session);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        if (shard.invalidations_ == seen_invalidations)
+        {
+            put(shard, session_id, std::move(snapshot), now_ms);
+        }
+    }
+
+    std::shared_ptr<Session> CachedSessionStorage::load(const std::string &session_id)
+    {
+        Shard &shard = shard_for(session_id);
+        const int64_t now = now_ms();
+        uint64_t seen_invalidations = 0;
+        if (auto session = lookup(shard, session_id, now, seen_invalidations))
+        {
+            return session;
+        }
+
+        auto session = backend_->load(session_id);
+        fill(shard, session_id, session, seen_invalidations, now);
+        return session;
+    }
+
+    std::shared_ptr<Session> CachedSessionStorage::load_and_refresh(const std::string &session_id)
+    {
+        Shard &shard = shard_for(session_id);
+        const int64_t now = now_ms();
+        uint64_t seen_invalidations = 0;
+        if (auto session = lookup(shard, session_id, now, seen_invalidations))
+        {
+            session->refresh();
+            store(session);
+            return session;
+        }
+
+        auto session = backend_->load_and_refresh(session_id);
+        if (session && !session->is_expired())
+        {
+            fill(shard, session_id, session, seen_invalidations, now);
+        }
+        return session;
+    }
+
+    bool CachedSessionStorage::remove(const std::string &session_id)
+    {
+        const bool removed = backend_->remove(session_id);
+        invalidate(session_id);
+        if (bus_)
+        {
+            bus_->publish(session_id);
+        }
+        return removed;
+    }
+
+    void CachedSessionStorage::touch(const std::vector<ExpiryUpdate> &updates)
+    {
+        backend_->touch(updates);
+    }
+
+    bool CachedSessionStorage::for_each_session_id(const std::function<void(const std::string &)> &fn)
+    {
+        return backend_->for_each_session_id(fn);
+    }
+
+    void CachedSessionStorage::clear_expired()
+    {
+        backend_->clear_expired();
+
+        const int64_t now = now_ms();
+        for (size_t i = 0; i <= shard_mask_; ++i)
+        {
+            Shard &shard = shards_[i];
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            for (auto it = shard.lru_.begin(); it != shard.lru_.end();)
+            {
+                if (it->deadline_ms_ <= now || it->session_->is_expired())
+                {
+                    shard.index_.erase(it->session_id_);
+                    it = shard.lru_.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    void CachedSessionStorage::invalidate(const std::string &session_id)
+    {
+        Shard &shard = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        drop(shard, session_id);
+    }
+
+    void CachedSessionStorage::invalidate_all()
+    {
+        for (size_t i = 0; i <= shard_mask_; ++i)
+        {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex_);
+            ++shards_[i].invalidations_;
+            shards_[i].index_.clear();
+            shards_[i].lru_.clear();
+        }
+    }
+
+    CachedSessionStorage::Stats CachedSessionStorage::stats() const
+    {
+        return Stats{hits_.load(std::memory_order_relaxed), misses_.load(std::memory_order_relaxed),
+                     remote_invalidations_.load(std::memory_order_relaxed)};
+    }
+
+    size_t CachedSessionStorage::size() const
+    {
+        size_t total = 0;
+        for (size_t i = 0; i <= shard_mask_; ++i)
+        {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex_);
+            total += shards_[i].lru_.size();
+        }
+        return total;
+    }
+} // namespace zhttp::zsession
@@ -0,0 +1,273 @@
+#include "session/cookie_storage.h"
+#include "session/memory_storage.h"
+#include "session/session_codec.h"
+#include "session/session_id_generator.h"
+#include "utils/base64url.h"
+#include "log/http_logger.h"
+#include <openssl/evp.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace zhttp::zsession
+{
+    namespace
+    {
+        constexpr char kTokenPrefix[] = "z1.";
+        constexpr size_t kPrefixLength = sizeof(kTokenPrefix) - 1;
+        constexpr size_t kNonceBytes = 12;
+        constexpr size_t kTagBytes = 16;
+        constexpr size_t kOverhead = 1 + kNonceBytes + kTagBytes; // 密钥编号、nonce与标签
+
+        struct CipherCtxDeleter
+        {
+            void operator()(EVP_CIPHER_CTX *ctx) const { EVP_CIPHER_CTX_free(ctx); }
+        };
+
+        // 每个线程复用一个上下文
+        EVP_CIPHER_CTX *cipher_ctx()
+        {
+            thread_local std::unique_ptr<EVP_CIPHER_CTX, CipherCtxDeleter> ctx(EVP_CIPHER_CTX_new());
+            if (!ctx)
+            {
+                throw std::runtime_error("EVP_CIPHER_CTX_new failed");
+            }
+            return ctx.get();
+        }
+
+        const auto *bytes(const std::string &s)
+        {
+            return reinterpret_cast<const unsigned char *>(s.data());
+        }
+    } // namespace
+
+    CookieSessionStorage::CookieSessionStorage(std::vector<CookieKey> keys, SessionStorage::ptr fallback,
+                                               const size_t max_cookie_bytes)
+        : keys_(std::move(keys)), fallback_(std::move(fallback)), max_cookie_bytes_(max_cookie_bytes)
+    {
+        if (keys_.empty())
+        {
+            throw std::invalid_argument("cookie session storage needs at least one key");
+        }
+        for (const auto &key : keys_)
+        {
+            check_key(key);
+        }
+        if (!fallback_)
+        {
+            fallback_ = std::make_shared<InMemoryStorage>();
+        }
+        ZHTTP_LOG_INFO("CookieSessionStorage created: {} keys, current key {}, max cookie {} bytes",
+                       keys_.size(), keys_.front().id_, max_cookie_bytes_);
+    }
+
+    void CookieSessionStorage::check_key(const CookieKey &key)
+    {
+        if (key.secret_.size() != kKeyBytes)
+        {
+            throw std::invalid_argument("cookie session key must be 32 bytes");
+        }
+    }
+
+    CookieKey CookieSessionStorage::generate_key(const uint8_t id)
+    {
+        CookieKey key{id, std::string(kKeyBytes, '\0')};
+        SessionIdGenerator::fill(reinterpret_cast<uint8_t *>(key.secret_.data()), kKeyBytes);
+        return key;
+    }
+
+    void CookieSessionStorage::rotate(CookieKey key)
+    {
+        check_key(key);
+        std::unique_lock<std::shared_mutex> lock(keys_mutex_);
+        keys_.erase(std::remove_if(keys_.begin(), keys_.end(),
+                                   [&key](const CookieKey &k) { return k.id_ == key.id_; }), keys_.end());
+        keys_.insert(keys_.begin(), std::move(key));
+        ZHTTP_LOG_INFO("Cookie session key rotated to {}, {} keys accepted", keys_.front().id_, keys_.size());
+    }
+
+    void CookieSessionStorage::retire(const uint8_t key_id)
+    {
+        std::unique_lock<std::shared_mutex> lock(keys_mutex_);
+        if (keys_.front().id_ == key_id)
+        {
+            throw std::invalid_argument("cannot retire the current cookie session key");
+        }
+        keys_.erase(std::remove_if(keys_.begin(), keys_.end(),
+                                   [key_id](const CookieKey &k) { return k.id_ == key_id; }), keys_.end());
+        ZHTTP_LOG_INFO("Cookie session key {} retired", key_id);
+    }
+
+    bool CookieSessionStorage::is_token(const std::string &value)
+    {
+        return value.compare(0, kPrefixLength, kTokenPrefix) == 0;
+    }
+
+    std::string CookieSessionStorage::plaintext(const Session &session)
+    {
+        const auto expiry = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+                session.get_expiry_time().time_since_epoch()).count());
+        const std::string &session_id = session.get_session_id();
+        if (session_id.size() > 255)
+        {
+            throw std::length_error("session id too long for a cookie session");
+        }
+
+        std::string out;
+        for (int shift = 56; shift >= 0; shift -= 8)
+        {
+            out.push_back(static_cast<char>(expiry >> shift & 0xFF));
+        }
+        out.push_back(static_cast<char>(session_id.size()));
+        out.append(session_id);
+        out.append(SessionCodec::encode(session));
+        return out;
+    }
+
+    size_t CookieSessionStorage::token_length(const size_t plaintext_length)
+    {
+        const size_t binary = kOverhead + plaintext_length;
+        return kPrefixLength + (binary * 4 + 2) / 3; // base64url无填充
+    }
+
+    std::string CookieSessionStorage::seal(const std::string &plaintext) const
+    {
+        std::string binary(kOverhead + plaintext.size(), '\0');
+        auto *out = reinterpret_cast<unsigned char *>(binary.data());
+        SessionIdGenerator::fill(out + 1, kNonceBytes);
+
+        EVP_CIPHER_CTX *ctx = cipher_ctx();
+        int length = 0;
+        int final_length = 0;
+        bool ok;
+        {
+            std::shared_lock<std::shared_mutex> lock(keys_mutex_);
+            const CookieKey &key = keys_.front();
+            out[0] = key.id_;
+            ok = EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, bytes(key.secret_), out + 1) == 1;
+        }
+        ok = ok && EVP_EncryptUpdate(ctx, nullptr, &length, reinterpret_cast<const unsigned char *>(kTokenPrefix),
+                                     static_cast<int>(kPrefixLength)) == 1 &&
+             EVP_EncryptUpdate(ctx, out + 1 + kNonceBytes, &length, bytes(plaintext),
+                               static_cast<int>(plaintext.size())) == 1 &&
+             EVP_EncryptFinal_ex(ctx, out + 1 + kNonceBytes + length, &final_length) == 1 &&
+             EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, static_cast<int>(kTagBytes),
+                                 out + 1 + kNonceBytes + plaintext.size()) == 1;
+        if (!ok)
+        {
+            throw std::runtime_error("AES-GCM encryption of cookie session failed");
+        }
+        return kTokenPrefix + zutils::base64url_encode(binary);
+    }
+
+    std::shared_ptr<Session> CookieSessionStorage::open(const std::string &token) const
+    {
+        std::string binary;
+        if (!zutils::base64url_decode(std::string_view(token).substr(kPrefixLength), binary) ||
+            binary.size() < kOverhead)
+        {
+            return nullptr;
+        }
+        const auto *in = reinterpret_cast<const unsigned char *>(binary.data());
+        const size_t cipher_length = binary.size() - kOverhead;
+
+        std::string plain(cipher_length, '\0');
+        auto *out = reinterpret_cast<unsigned char *>(plain.data());
+        EVP_CIPHER_CTX *ctx = cipher_ctx();
+        int length = 0;
+        bool ok;
+        {
+            std::shared_lock<std::shared_mutex> lock(keys_mutex_);
+            const auto key = std::find_if(keys_.begin(), keys_.end(),
+                                          [id = in[0]](const CookieKey &k) { return k.id_ == id; });
+            if (key == keys_.end())
+            {
+                ZHTTP_LOG_DEBUG("Cookie session sealed with unknown key {}", in[0]);
+                return nullptr;
+            }
+            ok = EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr, bytes(key->secret_), in + 1) == 1;
+        }
+        ok = ok && EVP_DecryptUpdate(ctx, nullptr, &length, reinterpret_cast<const unsigned char *>(kTokenPrefix),
+                                     static_cast<int>(kPrefixLength)) == 1 &&
+             EVP_DecryptUpdate(ctx, out, &length, in + 1 + kNonceBytes, static_cast<int>(cipher_length)) == 1 &&
+             EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, static_cast<int>(kTagBytes),
+                                 const_cast<unsigned char *>(in + 1 + kNonceBytes + cipher_length)) == 1 &&
+             EVP_DecryptFinal_ex(ctx, out + length, &length) == 1;
+        if (!ok || plain.size() < 9)
+        {
+            ZHTTP_LOG_DEBUG("Cookie session failed authentication");
+            return nullptr;
+        }
+
+        uint64_t expiry = 0;
+        for (size_t i = 0; i < 8; ++i)
+        {
+            expiry = expiry << 8 | static_cast<uint8_t>(plain[i]);
+        }
+        const size_t id_length = static_cast<uint8_t>(plain[8]);
+        if (plain.size() < 9 + id_length)
+        {
+            return nullptr;
+        }
+        const std::string_view encoded = std::string_view(plain).substr(9 + id_length);
+        auto session = std::make_shared<Session>(plain.substr(9, id_length));
+        if (!SessionCodec::is_binary(encoded) || !SessionCodec::decode(encoded, *session))
+        {
+            return nullptr;
+        }
+        session->set_expiry_time(std::chrono::system_clock::time_point(std::chrono::seconds(expiry)));
+        session->clear_dirty();
+        return session;
+    }
+
+    void CookieSessionStorage::store(const std::shared_ptr<Session> &session)
+    {
+        if (token_length(plaintext(*session).size()) <= max_cookie_bytes_)
+        {
+            return; // 会话全部内容随Cookie下发
+        }
+        ZHTTP_LOG_DEBUG("Session {} exceeds cookie size limit, storing server side", session->get_session_id());
+        // 存入副本，调用方的对象挂有本次请求的回调且之后仍会被修改
+        fallback_->store(std::make_shared<Session>(*session));
+    }
+
+    std::optional<std::string> CookieSessionStorage::cookie_token(const Session &session)
+    {
+        const std::string plain = plaintext(session);
+        if (token_length(plain.size()) > max_cookie_bytes_)
+        {
+            return std::nullopt;
+        }
+        return seal(plain);
+    }
+
+    std::shared_ptr<Session> CookieSessionStorage::load(const std::string &session_id)
+    {
+        if (!is_token(session_id))
+        {
+            auto session = fallback_->load(session_id);
+            // 复制一份，重新下发Cookie的回调只挂到本次请求的副本上
+            return session ? std::make_shared<Session>(*session) : nullptr;
+        }
+        auto session = open(session_id);
+        if (!session || session->is_expired())
+        {
+            return nullptr;
+        }
+        return session;
+    }
+
+    bool CookieSessionStorage::remove(const std::string &session_id)
+    {
+        return !is_token(session_id) && fallback_->remove(session_id);
+    }
+
+    void CookieSessionStorage::clear_expired()
+    {
+        fallback_->clear_expired();
+    }
+
+    void CookieSessionStorage::touch(const std::vector<ExpiryUpdate> &updates)
+    {
+        fallback_->touch(updates);
+    }
+} // namespace zhttp::zsession
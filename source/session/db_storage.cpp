@@ -1,23 +1,118 @@
 #include "session/db_storage.h"
+#include "session/session_codec.h"
 #include "db_pool/redis_pool.h"
 #include "log/http_logger.h"
-#include <nlohmann/json.hpp>
+#include <algorithm>
 #include <chrono>
+#include <unordered_set>
 
 namespace zhttp::zsession
 {
+    namespace
+    {
+        /* 读取会话并顺延过期时间：KEYS[1]为会话key，ARGV为当前时间、新的过期时间（秒级时间戳）与TTL。
+           已过期的会话直接删除并返回空数组，否则返回HGETALL的结果，其中expiry已替换为新值 */
+        const std::string kLoadAndRefreshScript = R"lua(
+local data = redis.call('HGETALL', KEYS[1])
+if #data == 0 then
+    return data
+end
+for i = 1, #data, 2 do
+    if data[i] == 'expiry' then
+        if tonumber(data[i + 1]) < tonumber(ARGV[1]) then
+            redis.call('DEL', KEYS[1])
+            return {}
+        end
+        data[i + 1] = ARGV[2]
+    end
+end
+redis.call('HSET', KEYS[1], 'expiry', ARGV[2])
+redis.call('EXPIRE', KEYS[1], ARGV[3])
+return data
+)lua";
+
+        // 会话仍存在时写入新的过期时间：ARGV为过期时间（秒级时间戳）与TTL，返回是否写入
+        const std::string kTouchScript = R"lua(
+if redis.call('EXISTS', KEYS[1]) == 0 then
+    return 0
+end
+redis.call('HSET', KEYS[1], 'expiry', ARGV[1])
+redis.call('EXPIRE', KEYS[1], ARGV[2])
+return 1
+)lua";
+
+        constexpr size_t kTouchBatch = 256; // 每条流水线携带的会话数
+
+        const std::string kAttributeFieldPrefix = "attr:"; // Fields布局中属性字段的前缀
+
+        // Fields布局的按需读取，预取时已确认不存在的属性不再访问Redis
+        class FieldAttributeLoader final : public AttributeLoader
+        {
+        public:
+            FieldAttributeLoader(std::string key, std::unordered_set<std::string> absent)
+                : key_(std::move(key)), absent_(std::move(absent))
+            {
+            }
+
+            std::optional<std::string> load(const std::string &name) override
+            {
+                if (absent_.count(name))
+                {
+                    return std::nullopt;
+                }
+                const auto conn = zdb::RedisConnectionPool::get_instance().get_connection();
+                return std::move(conn->hmget(key_, {kAttributeFieldPrefix + name}).front());
+            }
+
+            std::unordered_map<std::string, std::string> load_all() override
+            {
+                const auto conn = zdb::RedisConnectionPool::get_instance().get_connection();
+                std::unordered_map<std::string, std::string> attributes;
+                for (auto &[field, value] : conn->hgetall(key_))
+                {
+                    if (field.compare(0, kAttributeFieldPrefix.size(), kAttributeFieldPrefix) == 0)
+                    {
+                        attributes.emplace(field.substr(kAttributeFieldPrefix.size()), std::move(value));
+                    }
+                }
+                return attributes;
+            }
+
+        private:
+            std::string key_;
+            std::unordered_set<std::string> absent_;
+        };
+
+        int64_t epoch_seconds(const std::chrono::system_clock::time_point time_point)
+        {
+            return std::chrono::duration_cast<std::chrono::seconds>(time_point.time_since_epoch()).count();
+        }
+    } // namespace
+
+    DbSessionStorage::DbSessionStorage(const RedisSessionLayout layout, std::vector<std::string> prefetch)
+        : layout_(layout), prefetch_(std::move(prefetch))
+    {
+        prefetch_fields_ = {"expiry", "attributes"};
+        for (const auto &name : prefetch_)
+        {
+            prefetch_fields_.push_back(kAttributeFieldPrefix + name);
+        }
+    }
+
     // 存储会话到Redis
     void DbSessionStorage::store(const std::shared_ptr<Session> &session)
     {
         ZHTTP_LOG_DEBUG("Storing session {} to Redis", session->get_session_id());
+
+        // 属性没有改动时只顺延过期时间，且不会重建已被删除的会话
+        if (!session->is_dirty())
+        {
+            touch({ExpiryUpdate{session->get_session_id(), session->get_expiry_time()}});
+            return;
+        }
         
         try
         {
-            auto &redis_pool = zdb::RedisConnectionPool::get_instance();
-            const auto conn = redis_pool.get_connection();
-            const nlohmann::json j = session->get_attributes_json();
-            const std::string attrs = j.dump();
-
             const auto expiry_time = session->get_expiry_time();
             const auto now = std::chrono::system_clock::now();
             const auto ttl = std::chrono::duration_cast<std::chrono::seconds>(expiry_time - now);
@@ -28,15 +123,22 @@ namespace zhttp::zsession
                 return;
             }
 
+            if (layout_ == RedisSessionLayout::Fields)
+            {
+                store_fields(session, ttl);
+                return;
+            }
+
+            auto &redis_pool = zdb::RedisConnectionPool::get_instance();
+            const auto conn = redis_pool.get_connection();
+            const std::string attrs = SessionCodec::encode(*session);
             const std::string key = "session:" + session->get_session_id();
             
-            // 使用Redis Hash存储会话数据
-            conn->hset(key, "attributes", attrs);
-            conn->hset(key, "expiry", std::to_string(
-                std::chrono::duration_cast<std::chrono::seconds>(expiry_time.time_since_epoch()).count()));
-            
-            // 设置过期时间
-            conn->expire(key, ttl);
+            // 使用Redis Hash存储会话数据，字段写入与过期时间设置在同一次往返中完成
+            conn->hset_expire(key, {
+                {"attributes", attrs},
+                {"expiry", std::to_string(epoch_seconds(expiry_time))}
+            }, ttl);
             
             ZHTTP_LOG_INFO("Session {} stored to Redis successfully with TTL {} seconds", 
                           session->get_session_id(), ttl.count());
@@ -53,6 +155,11 @@ namespace zhttp::zsession
     std::shared_ptr<Session> DbSessionStorage::load(const std::string &session_id)
     {
         ZHTTP_LOG_DEBUG("Loading session {} from Redis", session_id);
+
+        if (layout_ == RedisSessionLayout::Fields)
+        {
+            return load_fields(session_id);
+        }
         
         try
         {
@@ -60,58 +167,192 @@ namespace zhttp::zsession
             const auto conn = redis_pool.get_connection();
             const std::string key = "session:" + session_id;
             
-            // 检查key是否存在
-            if (!conn->exists(key))
+            // 不存在的key返回空结果，无需先EXISTS
+            const auto result = conn->hgetall(key);
+            if (result.empty())
             {
                 ZHTTP_LOG_DEBUG("Session {} not found in Redis", session_id);
                 return nullptr;
             }
 
-            // 获取会话数据
-            auto result = conn->hgetall(key);
-            if (result.empty())
+            auto session = decode(session_id, result);
+            if (!session)
             {
-                ZHTTP_LOG_DEBUG("Session {} data is empty in Redis", session_id);
                 return nullptr;
             }
 
-            const auto attrs_it = result.find("attributes");
-            const auto expiry_it = result.find("expiry");
-            
-            if (attrs_it == result.end() || expiry_it == result.end())
+            // 检查是否过期
+            if (session->is_expired())
             {
-                ZHTTP_LOG_WARN("Incomplete session data for {} in Redis", session_id);
+                ZHTTP_LOG_WARN("Session {} has expired, removing from Redis", session_id);
+                remove(session_id);
                 return nullptr;
             }
+            
+            ZHTTP_LOG_DEBUG("Session {} loaded from Redis successfully", session_id);
+            return session;
+        }
+        catch (const std::exception &e)
+        {
+            ZHTTP_LOG_ERROR("Failed to load session {} from Redis: {}", session_id, e.what());
+            return nullptr;
+        }
+    }
 
-            // 检查是否过期
-            const int64_t expiry = std::stoll(expiry_it->second);
-            const auto expiry_time = std::chrono::system_clock::time_point(std::chrono::seconds(expiry));
-            if (expiry_time < std::chrono::system_clock::now())
+    // 加载会话并刷新过期时间
+    std::shared_ptr<Session> DbSessionStorage::load_and_refresh(const std::string &session_id)
+    {
+        ZHTTP_LOG_DEBUG("Loading and refreshing session {} in Redis", session_id);
+
+        // 脚本返回整个Hash，Fields布局下只取所需字段更省，退回为load后合并刷新
+        if (layout_ == RedisSessionLayout::Fields)
+        {
+            return SessionStorage::load_and_refresh(session_id);
+        }
+
+        try
+        {
+            auto &redis_pool = zdb::RedisConnectionPool::get_instance();
+            const auto conn = redis_pool.get_connection();
+
+            // 新的过期时间按会话的超时时间计算
+            Session probe(session_id);
+            probe.refresh();
+            const int64_t now = epoch_seconds(std::chrono::system_clock::now());
+            const int64_t expiry = epoch_seconds(probe.get_expiry_time());
+
+            const auto reply = conn->eval(kLoadAndRefreshScript, {"session:" + session_id},
+                                          {std::to_string(now), std::to_string(expiry),
+                                           std::to_string(std::max<int64_t>(1, expiry - now))});
+            if (reply.empty())
             {
-                ZHTTP_LOG_WARN("Session {} has expired, removing from Redis", session_id);
-                remove(session_id);
+                ZHTTP_LOG_DEBUG("Session {} not found or expired in Redis", session_id);
                 return nullptr;
             }
 
-            // 创建会话对象
-            auto session = std::make_shared<Session>(session_id);
-            
-            // 解析属性
-            nlohmann::json j = nlohmann::json::parse(attrs_it->second, nullptr, false);
-            if (!j.is_object())
+            std::unordered_map<std::string, std::string> fields;
+            for (size_t i = 0; i + 1 < reply.size(); i += 2)
+            {
+                fields.emplace(reply[i], reply[i + 1]);
+            }
+            auto session = decode(session_id, fields);
+            ZHTTP_LOG_DEBUG("Session {} loaded and refreshed in Redis", session_id);
+            return session;
+        }
+        catch (const std::exception &e)
+        {
+            ZHTTP_LOG_ERROR("Failed to load and refresh session {} in Redis: {}", session_id, e.what());
+            return nullptr;
+        }
+    }
+
+    // 从Hash字段还原会话
+    std::shared_ptr<Session> DbSessionStorage::decode(const std::string &session_id,
+                                                      const std::unordered_map<std::string, std::string> &fields)
+    {
+        const auto attrs_it = fields.find("attributes");
+        const auto expiry_it = fields.find("expiry");
+        if (attrs_it == fields.end() || expiry_it == fields.end())
+        {
+            ZHTTP_LOG_WARN("Incomplete session data for {} in Redis", session_id);
+            return nullptr;
+        }
+
+        // 解析属性，旧的JSON数据同样可读，下次写入时转为二进制编码
+        auto session = std::make_shared<Session>(session_id);
+        if (!SessionCodec::decode(attrs_it->second, *session))
+        {
+            ZHTTP_LOG_ERROR("Invalid attribute encoding for session {} in Redis", session_id);
+            return nullptr;
+        }
+        const int64_t expiry = std::stoll(expiry_it->second);
+        session->set_expiry_time(std::chrono::system_clock::time_point(std::chrono::seconds(expiry)));
+        session->clear_dirty();
+        return session;
+    }
+
+    // Fields布局：写入改动过的属性字段
+    void DbSessionStorage::store_fields(const std::shared_ptr<Session> &session, const std::chrono::seconds ttl) const
+    {
+        std::unordered_map<std::string, std::string> fields;
+        std::vector<std::string> removed{"attributes"}; // 从Blob布局迁移过来的会话去掉旧字段
+        for (const auto &name : session->get_dirty_keys())
+        {
+            if (session->has_attribute(name))
+            {
+                fields.emplace(kAttributeFieldPrefix + name, session->get_attribute(name));
+            }
+            else
+            {
+                removed.push_back(kAttributeFieldPrefix + name);
+            }
+        }
+        fields.emplace("expiry", std::to_string(epoch_seconds(session->get_expiry_time())));
+
+        const auto conn = zdb::RedisConnectionPool::get_instance().get_connection();
+        conn->hset_expire("session:" + session->get_session_id(), fields, ttl, removed);
+        ZHTTP_LOG_DEBUG("Session {} stored to Redis: {} fields written, {} removed",
+                        session->get_session_id(), fields.size() - 1, removed.size() - 1);
+    }
+
+    // Fields布局：取回过期时间与预取属性
+    std::shared_ptr<Session> DbSessionStorage::load_fields(const std::string &session_id)
+    {
+        try
+        {
+            const auto conn = zdb::RedisConnectionPool::get_instance().get_connection();
+            const std::string key = "session:" + session_id;
+            auto values = conn->hmget(key, prefetch_fields_);
+            if (values.size() != prefetch_fields_.size() || !values[0])
             {
-                ZHTTP_LOG_ERROR("Invalid JSON format for session {} attributes in Redis", session_id);
+                ZHTTP_LOG_DEBUG("Session {} not found in Redis", session_id);
                 return nullptr;
             }
-            
-            for (auto it = j.begin(); it != j.end(); ++it)
+
+            std::shared_ptr<Session> session;
+            if (values[1])
             {
-                session->set_attribute(it.key(), it.value().get<std::string>());
+                // 仍为Blob布局的会话整体解码，并把全部属性记为改动，下次写入时转为字段
+                session = decode(session_id, {{"expiry", *values[0]}, {"attributes", *values[1]}});
+                if (!session)
+                {
+                    return nullptr;
+                }
+                Session migrated(session_id);
+                for (auto &[name, value] : session->get_attributes_json().items())
+                {
+                    migrated.set_attribute(name, value.get<std::string>());
+                }
+                migrated.set_expiry_time(session->get_expiry_time());
+                session = std::make_shared<Session>(std::move(migrated));
+            }
+            else
+            {
+                session = std::make_shared<Session>(session_id);
+                std::unordered_set<std::string> absent;
+                for (size_t i = 0; i < prefetch_.size(); ++i)
+                {
+                    if (auto &value = values[i + 2])
+                    {
+                        session->set_attribute(prefetch_[i], std::move(*value));
+                    }
+                    else
+                    {
+                        absent.insert(prefetch_[i]);
+                    }
+                }
+                session->set_expiry_time(std::chrono::system_clock::time_point(
+                        std::chrono::seconds(std::stoll(*values[0]))));
+                session->set_attribute_loader(std::make_shared<FieldAttributeLoader>(key, std::move(absent)));
+                session->clear_dirty();
+            }
+
+            if (session->is_expired())
+            {
+                ZHTTP_LOG_WARN("Session {} has expired, removing from Redis", session_id);
+                remove(session_id);
+                return nullptr;
             }
-            session->set_expiry_time(expiry_time);
-            
-            ZHTTP_LOG_DEBUG("Session {} loaded from Redis successfully", session_id);
             return session;
         }
         catch (const std::exception &e)
@@ -121,8 +362,47 @@ namespace zhttp::zsession
         }
     }
 
+    // 批量顺延过期时间
+    void DbSessionStorage::touch(const std::vector<ExpiryUpdate> &updates)
+    {
+        ZHTTP_LOG_DEBUG("Refreshing expiry of {} sessions in Redis", updates.size());
+
+        try
+        {
+            auto &redis_pool = zdb::RedisConnectionPool::get_instance();
+            const int64_t now = epoch_seconds(std::chrono::system_clock::now());
+            std::vector<zdb::ScriptCall> calls;
+            calls.reserve(std::min(updates.size(), kTouchBatch));
+
+            for (size_t begin = 0; begin < updates.size(); begin += kTouchBatch)
+            {
+                calls.clear();
+                const size_t end = std::min(updates.size(), begin + kTouchBatch);
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const int64_t expiry = epoch_seconds(updates[i].expiry_time_);
+                    if (expiry <= now)
+                    {
+                        continue;
+                    }
+                    calls.push_back(zdb::ScriptCall{{"session:" + updates[i].session_id_},
+                                                    {std::to_string(expiry), std::to_string(expiry - now)}});
+                }
+                if (!calls.empty())
+                {
+                    redis_pool.get_connection()->eval_pipelined(kTouchScript, calls);
+                }
+            }
+        }
+        catch (const std::exception &e)
+        {
+            ZHTTP_LOG_ERROR("Failed to refresh session expiry in Redis: {}", e.what());
+            throw;
+        }
+    }
+
     // 删除会话
-    void DbSessionStorage::remove(const std::string &session_id)
+    bool DbSessionStorage::remove(const std::string &session_id)
     {
         ZHTTP_LOG_DEBUG("Removing session {} from Redis", session_id);
         
@@ -135,11 +415,10 @@ namespace zhttp::zsession
             if (conn->del(key))
             {
                 ZHTTP_LOG_INFO("Session {} removed from Redis successfully", session_id);
+                return true;
             }
-            else
-            {
-                ZHTTP_LOG_DEBUG("Session {} not found for removal in Redis", session_id);
-            }
+            ZHTTP_LOG_DEBUG("Session {} not found for removal in Redis", session_id);
+            return false;
         }
         catch (const std::exception &e)
         {
@@ -167,12 +446,10 @@ namespace zhttp::zsession
             {
                 try
                 {
-                    // 获取会话数据检查是否过期
-                    auto result = conn->hgetall(key);
-
-                    if (auto expiry_it = result.find("expiry"); expiry_it != result.end())
+                    // 只取过期时间字段检查是否过期
+                    if (const auto expiry_field = conn->hget(key, "expiry"); !expiry_field.empty())
                     {
-                        int64_t expiry = std::stoll(expiry_it->second);
+                        int64_t expiry = std::stoll(expiry_field);
 
                         if (auto expiry_time = std::chrono::system_clock::time_point(std::chrono::seconds(expiry));
                             expiry_time < std::chrono::system_clock::now())
@@ -201,5 +478,17 @@ namespace zhttp::zsession
             throw;
         }
     }
+
+    bool DbSessionStorage::for_each_session_id(const std::function<void(const std::string &)> &fn)
+    {
+        auto &redis_pool = zdb::RedisConnectionPool::get_instance();
+        const auto conn = redis_pool.get_connection();
+        constexpr size_t prefix_length = sizeof("session:") - 1;
+        for (const auto &key : conn->scan_keys("session:*", 1000))
+        {
+            fn(key.substr(prefix_length));
+        }
+        return true;
+    }
     
 } // namespace zhttp::zsession
\ No newline at end of file
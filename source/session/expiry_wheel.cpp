@@ -0,0 +1,88 @@
+#include "session/expiry_wheel.h"
+
+namespace zhttp::zsession
+{
+    ExpiryWheel::ExpiryWheel(const int64_t now) : current_(now)
+    {
+    }
+
+    void ExpiryWheel::schedule(Node *node, const int64_t expiry)
+    {
+        if (node->linked_)
+        {
+            unlink(node);
+        }
+        else
+        {
+            ++size_;
+        }
+        node->expiry_ = expiry;
+        place(node);
+    }
+
+    void ExpiryWheel::remove(Node *node)
+    {
+        if (node->linked_)
+        {
+            unlink(node);
+            node->linked_ = false;
+            --size_;
+        }
+    }
+
+    void ExpiryWheel::place(Node *node)
+    {
+        if (node->expiry_ <= current_)
+        {
+            link(node, kDueList);
+            return;
+        }
+
+        // 超出覆盖范围的按上限放置，到点后由回调复核
+        const int64_t expiry = node->expiry_ - current_ < kSpan ? node->expiry_ : current_ + kSpan - 1;
+        const int64_t delta = expiry - current_;
+        int level = 0;
+        while (delta >= int64_t{1} << (kBits * (level + 1)))
+        {
+            ++level;
+        }
+        link(node, index(level, (expiry >> (kBits * level)) & kMask));
+    }
+
+    void ExpiryWheel::link(Node *node, const uint16_t list)
+    {
+        node->list_ = list;
+        node->prev_ = nullptr;
+        node->next_ = lists_[list];
+        if (lists_[list])
+        {
+            lists_[list]->prev_ = node;
+        }
+        lists_[list] = node;
+        node->linked_ = true;
+    }
+
+    void ExpiryWheel::unlink(Node *node)
+    {
+        if (node->prev_)
+        {
+            node->prev_->next_ = node->next_;
+        }
+        else
+        {
+            lists_[node->list_] = node->next_;
+        }
+        if (node->next_)
+        {
+            node->next_->prev_ = node->prev_;
+        }
+        node->prev_ = node->next_ = nullptr;
+    }
+
+    ExpiryWheel::Node *ExpiryWheel::detach(const uint16_t list)
+    {
+        Node *head = lists_[list];
+        lists_[list] = nullptr;
+        return head;
+    }
+} // namespace zhttp::zsession
@@ -0,0 +1,74 @@
+#include "session/invalidation_bus.h"
+#include <algorithm>
+
+namespace zhttp::zsession
+{
+    class LocalInvalidationHub::Endpoint final : public InvalidationBus
+    {
+    public:
+        explicit Endpoint(std::shared_ptr<LocalInvalidationHub> hub) : hub_(std::move(hub)) {}
+
+        void publish(const std::string &session_id) override
+        {
+            hub_->publish(this, session_id);
+        }
+
+        std::shared_ptr<void> subscribe(MessageCallback on_message, ResetCallback on_reset) override
+        {
+            return hub_->subscribe(this, std::move(on_message), std::move(on_reset));
+        }
+
+    private:
+        std::shared_ptr<LocalInvalidationHub> hub_;
+    };
+
+    InvalidationBus::ptr LocalInvalidationHub::endpoint()
+    {
+        return std::make_shared<Endpoint>(shared_from_this());
+    }
+
+    void LocalInvalidationHub::reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &subscriber : subscribers_)
+        {
+            subscriber->on_reset_();
+        }
+    }
+
+    void LocalInvalidationHub::publish(const Endpoint *origin, const std::string &session_id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &subscriber : subscribers_)
+        {
+            if (subscriber->endpoint_ != origin)
+            {
+                subscriber->on_message_(session_id);
+            }
+        }
+    }
+
+    std::shared_ptr<void> LocalInvalidationHub::subscribe(const Endpoint *endpoint,
+                                                          InvalidationBus::MessageCallback on_message,
+                                                          InvalidationBus::ResetCallback on_reset)
+    {
+        auto subscriber = std::make_shared<Subscriber>(Subscriber{endpoint, std::move(on_message), std::move(on_reset)});
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            subscribers_.push_back(subscriber);
+        }
+
+        // 令牌析构时从列表中移除
+        std::weak_ptr<LocalInvalidationHub> weak_hub = shared_from_this();
+        return std::shared_ptr<void>(subscriber.get(), [weak_hub, subscriber](void *) mutable
+        {
+            if (const auto hub = weak_hub.lock())
+            {
+                std::lock_guard<std::mutex> lock(hub->mutex_);
+                hub->subscribers_.erase(std::remove(hub->subscribers_.begin(), hub->subscribers_.end(), subscriber),
+                                        hub->subscribers_.end());
+            }
+            subscriber.reset();
+        });
+    }
+} // namespace zhttp::zsession
@@ -1,83 +1,155 @@
 #include "session/memory_storage.h"
 #include "log/http_logger.h"
+#include <algorithm>
 
 namespace zhttp::zsession
 {
+    namespace
+    {
+        int64_t now_seconds()
+        {
+            return std::chrono::duration_cast<std::chrono::seconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    InMemoryStorage::InMemoryStorage(const uint32_t shard_count)
+    {
+        size_t shards = 1;
+        while (shards < shard_count)
+        {
+            shards <<= 1;
+        }
+        shard_mask_ = shards - 1;
+
+        const int64_t now = now_seconds();
+        shards_.reserve(shards);
+        for (size_t i = 0; i < shards; ++i)
+        {
+            shards_.emplace_back(std::make_unique<Shard>(now));
+        }
+        ZHTTP_LOG_INFO("InMemoryStorage created with {} shards", shards);
+    }
+
+    InMemoryStorage::Shard &InMemoryStorage::shard_for(const std::string &session_id) const
+    {
+        // 与unordered_map使用同一哈希，取高位选分片，避免与桶下标相关
+        const uint64_t hash = std::hash<std::string>{}(session_id) * 0x9E3779B97F4A7C15ULL;
+        return *shards_[(hash >> 40) & shard_mask_];
+    }
+
+    int64_t InMemoryStorage::expiry_seconds(const Session &session)
+    {
+        return std::chrono::ceil<std::chrono::seconds>(session.get_expiry_time().time_since_epoch()).count();
+    }
+
     // 存储会话
     void InMemoryStorage::store(const std::shared_ptr<Session> &session)
     {
         ZHTTP_LOG_DEBUG("Storing session: {}", session->get_session_id());
-        sessions_[session->get_session_id()] = session;
-        ZHTTP_LOG_INFO("Session {} stored successfully, total sessions: {}", 
-                      session->get_session_id(), sessions_.size());
+        Shard &shard = shard_for(session->get_session_id());
+        const int64_t expiry = expiry_seconds(*session);
+        // 存储持有独立副本，调用方之后的修改须再次store才可见，与Redis、Cookie存储语义一致
+        auto copy = std::make_shared<Session>(*session);
+        copy->clear_dirty(); // 已存储的内容即是持久化状态，加载出的副本不带改动标记
+
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        Entry &entry = shard.sessions_[session->get_session_id()];
+        entry.session_ = std::move(copy);
+        if (!entry.linked_ || entry.expiry_ != expiry)
+        {
+            shard.wheel_.schedule(&entry, expiry);
+        }
     }
 
     // 加载会话
     std::shared_ptr<Session> InMemoryStorage::load(const std::string &session_id)
     {
         ZHTTP_LOG_DEBUG("Loading session: {}", session_id);
-        
-        if (const auto it = sessions_.find(session_id); it != sessions_.end())
+        Shard &shard = shard_for(session_id);
+
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        const auto it = shard.sessions_.find(session_id);
+        if (it == shard.sessions_.end())
         {
-            if (it->second->is_expired())
-            {
-                ZHTTP_LOG_WARN("Session {} has expired, removing from storage", session_id);
-                sessions_.erase(it);
-                return nullptr;
-            }
-            
-            ZHTTP_LOG_DEBUG("Session {} loaded successfully", session_id);
-            return it->second;
+            ZHTTP_LOG_DEBUG("Session {} not found in storage", session_id);
+            return nullptr;
+        }
+        if (it->second.session_->is_expired())
+        {
+            ZHTTP_LOG_DEBUG("Session {} has expired, removing from storage", session_id);
+            shard.wheel_.remove(&it->second);
+            shard.sessions_.erase(it);
+            return nullptr;
         }
-        
-        ZHTTP_LOG_DEBUG("Session {} not found in storage", session_id);
-        return nullptr;
+        // 返回副本：调用方在锁外refresh或修改属性，不能与清理线程及其他请求共享同一对象
+        return std::make_shared<Session>(*it->second.session_);
     }
 
     // 删除会话
-    void InMemoryStorage::remove(const std::string &session_id)
+    bool InMemoryStorage::remove(const std::string &session_id)
     {
         ZHTTP_LOG_DEBUG("Removing session: {}", session_id);
-        
-        auto removed_count = sessions_.erase(session_id);
-        if (removed_count > 0)
-        {
-            ZHTTP_LOG_INFO("Session {} removed successfully, remaining sessions: {}", 
-                          session_id, sessions_.size());
-        }
-        else
+        Shard &shard = shard_for(session_id);
+
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        if (const auto it = shard.sessions_.find(session_id); it != shard.sessions_.end())
         {
-            ZHTTP_LOG_DEBUG("Session {} not found for removal", session_id);
+            shard.wheel_.remove(&it->second);
+            shard.sessions_.erase(it);
+            return true;
         }
+        return false;
     }
 
-    // 清除所有过期会话
+    // 清除过期会话：逐个分片推进时间轮，只访问到期的会话
     void InMemoryStorage::clear_expired()
     {
-        ZHTTP_LOG_DEBUG("Starting expired session cleanup, current sessions: {}", sessions_.size());
-        
-        size_t initial_count = sessions_.size();
-        auto it = sessions_.begin();
-        size_t removed_count = 0;
-        
-        while (it != sessions_.end())
+        const int64_t now = now_seconds();
+        size_t removed = 0;
+        size_t rescheduled = 0;
+        for (const auto &shard : shards_)
         {
-            if (it->second->is_expired())
+            std::lock_guard<std::mutex> lock(shard->mutex_);
+            shard->wheel_.advance(now, [&](ExpiryWheel::Node *node)
             {
-                ZHTTP_LOG_DEBUG("Removing expired session: {}", it->first);
-                it = sessions_.erase(it);
-                removed_count++;
-            }
-            else
+                auto *entry = static_cast<Entry *>(node);
+                // 以会话自身的过期时间为准，时间轮按秒取整可能早于实际过期
+                if (!entry->session_->is_expired())
+                {
+                    shard->wheel_.schedule(entry, std::max(expiry_seconds(*entry->session_), now + 1));
+                    ++rescheduled;
+                    return;
+                }
+                const std::string session_id = entry->session_->get_session_id(); // 键随节点一起销毁，先复制
+                shard->sessions_.erase(session_id);
+                ++removed;
+            });
+        }
+        ZHTTP_LOG_INFO("Expired session cleanup completed: removed {}, rescheduled {}", removed, rescheduled);
+    }
+
+    bool InMemoryStorage::for_each_session_id(const std::function<void(const std::string &)> &fn)
+    {
+        for (const auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex_);
+            for (const auto &[session_id, entry] : shard->sessions_)
             {
-                ++it;
+                fn(session_id);
             }
         }
-        
-        ZHTTP_LOG_INFO("Expired session cleanup completed: removed {}, remaining {}", 
-                      removed_count, sessions_.size());
+        return true;
     }
 
+    size_t InMemoryStorage::size() const
+    {
+        size_t total = 0;
+        for (const auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex_);
+            total += shard->sessions_.size();
+        }
+        return total;
+    }
 } // namespace zhttp::zsession
-
-
@@ -0,0 +1,148 @@
+#include "session/redis_invalidation_bus.h"
+#include "db_pool/redis_pool.h"
+#include "log/http_logger.h"
+#include <algorithm>
+#include <random>
+
+namespace zhttp::zsession
+{
+    namespace
+    {
+        std::string random_node_id()
+        {
+            std::random_device rd;
+            std::uniform_int_distribution<uint64_t> dis;
+            char buf[17];
+            std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(dis(rd)));
+            return buf;
+        }
+    }
+
+    RedisInvalidationBus::RedisInvalidationBus(const std::string &host, const int port, const std::string &password,
+                                               const int db, std::string channel, const int timeout_ms)
+        : channel_(std::move(channel)),
+          node_id_(random_node_id()),
+          connection_(std::make_unique<zdb::RedisConnection>(host, port, password, db, timeout_ms))
+    {
+        consume_thread_ = std::thread(&RedisInvalidationBus::consume_loop, this);
+        ZHTTP_LOG_INFO("Session invalidation bus started on channel {} as node {}", channel_, node_id_);
+    }
+
+    RedisInvalidationBus::~RedisInvalidationBus()
+    {
+        {
+            std::lock_guard<std::mutex> lock(stop_mutex_);
+            stop_ = true;
+        }
+        stop_cv_.notify_all();
+        if (consume_thread_.joinable())
+        {
+            consume_thread_.join(); // consume()最多阻塞一个socket超时
+        }
+    }
+
+    void RedisInvalidationBus::publish(const std::string &session_id)
+    {
+        try
+        {
+            const auto conn = zdb::RedisConnectionPool::get_instance().get_connection();
+            conn->publish(channel_, node_id_ + " " + session_id);
+        }
+        catch (const std::exception &e)
+        {
+            // 发布失败时其他节点的副本最多在本地TTL后过期
+            ZHTTP_LOG_WARN("Failed to publish invalidation for session {}: {}", session_id, e.what());
+        }
+    }
+
+    std::shared_ptr<void> RedisInvalidationBus::subscribe(MessageCallback on_message, ResetCallback on_reset)
+    {
+        auto subscriber = std::make_shared<Subscriber>(Subscriber{std::move(on_message), std::move(on_reset)});
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            subscribers_.push_back(subscriber);
+        }
+        // 总线需比订阅令牌存活更久
+        return std::shared_ptr<void>(subscriber.get(), [this, subscriber](void *) mutable
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            subscribers_.erase(std::remove(subscribers_.begin(), subscribers_.end(), subscriber), subscribers_.end());
+            subscriber.reset();
+        });
+    }
+
+    void RedisInvalidationBus::consume_loop()
+    {
+        bool subscribed_before = false;
+        while (!stop_)
+        {
+            try
+            {
+                auto subscriber = connection_->subscriber();
+                subscriber.on_message([this](const std::string &, const std::string &message) { dispatch(message); });
+                subscriber.subscribe(channel_);
+                if (subscribed_before)
+                {
+                    notify_reset(); // 中断期间的消息已丢失
+                }
+                subscribed_before = true;
+
+                while (!stop_)
+                {
+                    try
+                    {
+                        subscriber.consume();
+                    }
+                    catch (const sw::redis::TimeoutError &)
+                    {
+                        // 空闲超时，借机检查退出条件
+                    }
+                }
+            }
+            catch (const std::exception &e)
+            {
+                ZHTTP_LOG_WARN("Session invalidation subscription lost: {}", e.what());
+                notify_reset();
+
+                std::unique_lock<std::mutex> lock(stop_mutex_);
+                if (stop_cv_.wait_for(lock, std::chrono::seconds(1), [this] { return stop_.load(); }))
+                {
+                    break;
+                }
+                lock.unlock();
+                try
+                {
+                    connection_->reconnect();
+                }
+                catch (const std::exception &reconnect_error)
+                {
+                    ZHTTP_LOG_WARN("Session invalidation reconnect failed: {}", reconnect_error.what());
+                }
+            }
+        }
+    }
+
+    void RedisInvalidationBus::dispatch(const std::string &message)
+    {
+        const size_t space = message.find(' ');
+        if (space == std::string::npos || message.compare(0, space, node_id_) == 0)
+        {
+            return;
+        }
+        const std::string session_id = message.substr(space + 1);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &subscriber : subscribers_)
+        {
+            subscriber->on_message_(session_id);
+        }
+    }
+
+    void RedisInvalidationBus::notify_reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &subscriber : subscribers_)
+        {
+            subscriber->on_reset_();
+        }
+    }
+} // namespace zhttp::zsession
@@ -21,7 +21,25 @@ namespace zhttp::zsession
     void Session::set_attribute(const std::string &key, const std::string &value)
     {
         ZHTTP_LOG_DEBUG("Setting attribute '{}' for session {}", key, session_id_);
-        attributes_[key] = value;
+        auto [it, inserted] = attributes_.try_emplace(key, value);
+        if (!inserted)
+        {
+            if (it->second == value)
+            {
+                return; // 值未变化，不产生写入
+            }
+            it->second = value;
+        }
+        dirty_keys_.insert(key);
+        dirty_ = true;
+
+        // 延迟会话在第一次写入时才真正创建
+        if (materializer_)
+        {
+            const Materializer materializer = std::move(materializer_);
+            materializer_ = nullptr;
+            materializer(*this);
+        }
     }
 
     std::string Session::get_attribute(const std::string &key) const
@@ -32,11 +50,35 @@ namespace zhttp::zsession
         {
             return it->second;
         }
+
+        // 部分加载且本地未删除过的属性，按需从存储读取
+        if (loader_ && !absent_keys_.count(key) && !dirty_keys_.count(key))
+        {
+            if (auto value = loader_->load(key))
+            {
+                return attributes_.emplace(key, std::move(*value)).first->second;
+            }
+            absent_keys_.insert(key);
+        }
         
         ZHTTP_LOG_DEBUG("Attribute '{}' not found in session {}", key, session_id_);
         return "";
     }
 
+    bool Session::has_attribute(const std::string &key) const
+    {
+        if (attributes_.count(key))
+        {
+            return true;
+        }
+        if (loader_ && !absent_keys_.count(key) && !dirty_keys_.count(key))
+        {
+            get_attribute(key); // 按需加载
+            return attributes_.count(key) > 0;
+        }
+        return false;
+    }
+
     // 刷新过期时间
     void Session::refresh()
     {
@@ -62,9 +104,12 @@ namespace zhttp::zsession
     {
         ZHTTP_LOG_DEBUG("Removing attribute '{}' from session {}", key, session_id_);
         
+        // 部分加载时本地没有的属性可能存在于存储中，同样记为改动
         auto removed = attributes_.erase(key);
-        if (removed > 0)
+        if (removed > 0 || (loader_ && !absent_keys_.count(key)))
         {
+            dirty_keys_.insert(key);
+            dirty_ = true;
             ZHTTP_LOG_DEBUG("Attribute '{}' removed from session {}", key, session_id_);
         }
         else
@@ -76,9 +121,15 @@ namespace zhttp::zsession
     // 清空会话属性
     void Session::clear_attributes()
     {
+        load_all_attributes(); // 未加载的属性也要删除
         size_t count = attributes_.size();
         ZHTTP_LOG_DEBUG("Clearing {} attributes from session {}", count, session_id_);
         
+        for (const auto &attr : attributes_)
+        {
+            dirty_keys_.insert(attr.first);
+        }
+        dirty_ = dirty_ || count > 0;
         attributes_.clear();
         
         ZHTTP_LOG_INFO("All attributes cleared from session {}", session_id_);
@@ -88,6 +139,7 @@ namespace zhttp::zsession
     {
         ZHTTP_LOG_DEBUG("Converting attributes to JSON for session {}", session_id_);
         
+        load_all_attributes();
         nlohmann::json j;
         for (const auto &attr : attributes_)
         {
@@ -108,4 +160,59 @@ namespace zhttp::zsession
         ZHTTP_LOG_DEBUG("Session {} expiry time updated", session_id_);
     }
 
+    bool Session::is_dirty() const
+    {
+        return dirty_;
+    }
+
+    const std::unordered_set<std::string> &Session::get_dirty_keys() const
+    {
+        return dirty_keys_;
+    }
+
+    void Session::clear_dirty()
+    {
+        dirty_keys_.clear();
+        dirty_ = false;
+    }
+
+    bool Session::is_lazy() const
+    {
+        return static_cast<bool>(materializer_);
+    }
+
+    void Session::set_materializer(Materializer materializer)
+    {
+        materializer_ = std::move(materializer);
+    }
+
+    void Session::set_attribute_loader(AttributeLoader::ptr loader)
+    {
+        loader_ = std::move(loader);
+        absent_keys_.clear();
+    }
+
+    bool Session::is_partial() const
+    {
+        return static_cast<bool>(loader_);
+    }
+
+    void Session::load_all_attributes() const
+    {
+        if (!loader_)
+        {
+            return;
+        }
+        ZHTTP_LOG_DEBUG("Loading remaining attributes for session {}", session_id_);
+        for (auto &[key, value] : loader_->load_all())
+        {
+            if (!dirty_keys_.count(key))
+            {
+                attributes_.try_emplace(key, std::move(value));
+            }
+        }
+        loader_.reset();
+        absent_keys_.clear();
+    }
+
 } // namespace zhttp::zsession
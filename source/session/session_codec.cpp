@@ -0,0 +1,154 @@
+#include "session/session_codec.h"
+#include "log/http_logger.h"
+#include <nlohmann/json.hpp>
+
+namespace zhttp::zsession
+{
+    namespace
+    {
+        constexpr char kMagic[2] = {'\xA5', 'S'};
+        constexpr size_t kHeaderSize = sizeof(kMagic) + 1;
+
+        size_t varint_size(uint64_t value)
+        {
+            size_t size = 1;
+            while (value >= 0x80)
+            {
+                value >>= 7;
+                ++size;
+            }
+            return size;
+        }
+
+        void put_varint(std::string &out, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        bool get_varint(std::string_view &in, uint64_t &value)
+        {
+            value = 0;
+            for (unsigned shift = 0; shift < 64 && !in.empty(); shift += 7)
+            {
+                const auto byte = static_cast<uint8_t>(in.front());
+                in.remove_prefix(1);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool get_bytes(std::string_view &in, std::string_view &bytes)
+        {
+            uint64_t length;
+            if (!get_varint(in, length) || length > in.size())
+            {
+                return false;
+            }
+            bytes = in.substr(0, length);
+            in.remove_prefix(length);
+            return true;
+        }
+    } // namespace
+
+    std::string SessionCodec::encode(const Session &session)
+    {
+        session.load_all_attributes();
+        size_t size = kHeaderSize + varint_size(session.attributes_.size());
+        for (const auto &[key, value] : session.attributes_)
+        {
+            size += varint_size(key.size()) + key.size() + varint_size(value.size()) + value.size();
+        }
+
+        std::string out;
+        out.reserve(size);
+        out.append(kMagic, sizeof(kMagic));
+        out.push_back(static_cast<char>(kVersion));
+        put_varint(out, session.attributes_.size());
+        for (const auto &[key, value] : session.attributes_)
+        {
+            put_varint(out, key.size());
+            out.append(key);
+            put_varint(out, value.size());
+            out.append(value);
+        }
+        return out;
+    }
+
+    bool SessionCodec::is_binary(const std::string_view data)
+    {
+        return data.size() >= kHeaderSize && data[0] == kMagic[0] && data[1] == kMagic[1];
+    }
+
+    bool SessionCodec::decode(std::string_view data, Session &session)
+    {
+        if (!is_binary(data))
+        {
+            return decode_json(data, session);
+        }
+        if (static_cast<uint8_t>(data[2]) != kVersion)
+        {
+            ZHTTP_LOG_ERROR("Unsupported session encoding version {} for session {}",
+                            static_cast<uint8_t>(data[2]), session.session_id_);
+            return false;
+        }
+        data.remove_prefix(kHeaderSize);
+
+        uint64_t count;
+        // 每个属性至少占两个字节，据此拒绝伪造的超大个数
+        if (!get_varint(data, count) || count > data.size() / 2)
+        {
+            return false;
+        }
+
+        std::unordered_map<std::string, std::string> attributes;
+        attributes.reserve(count);
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            std::string_view key, value;
+            if (!get_bytes(data, key) || !get_bytes(data, value))
+            {
+                return false;
+            }
+            attributes.insert_or_assign(std::string(key), std::string(value));
+        }
+        if (!data.empty())
+        {
+            return false;
+        }
+        session.attributes_ = std::move(attributes);
+        session.set_attribute_loader(nullptr);
+        return true;
+    }
+
+    bool SessionCodec::decode_json(const std::string_view data, Session &session)
+    {
+        const nlohmann::json j = nlohmann::json::parse(data, nullptr, false);
+        if (!j.is_object())
+        {
+            return false;
+        }
+
+        std::unordered_map<std::string, std::string> attributes;
+        attributes.reserve(j.size());
+        for (auto it = j.begin(); it != j.end(); ++it)
+        {
+            if (!it.value().is_string())
+            {
+                return false;
+            }
+            attributes.insert_or_assign(it.key(), it.value().get<std::string>());
+        }
+        session.attributes_ = std::move(attributes);
+        session.set_attribute_loader(nullptr);
+        return true;
+    }
+} // namespace zhttp::zsession
@@ -0,0 +1,326 @@
+#include "session/session_filter.h"
+#include "session/session_id_generator.h"
+#include "log/http_logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace zhttp::zsession
+{
+    namespace
+    {
+        constexpr size_t kCountersPerEntry = 10;
+        constexpr size_t kCountersPerBlock = 128; // 64字节 = 8个64位字 × 16个4位计数器
+        constexpr uint64_t kCounterMax = 15;
+
+        uint64_t mix(uint64_t x)
+        {
+            x ^= x >> 32;
+            x *= 0xD6E8FEB86659FD93ULL;
+            x ^= x >> 32;
+            x *= 0xD6E8FEB86659FD93ULL;
+            x ^= x >> 32;
+            return x;
+        }
+    } // namespace
+
+    class SessionIdFilter::Table
+    {
+    public:
+        Table(const size_t capacity, const uint32_t hash_count)
+            : blocks_(std::max<size_t>(1, (capacity * kCountersPerEntry + kCountersPerBlock - 1) / kCountersPerBlock)),
+              hash_count_(std::clamp<uint32_t>(hash_count, 1, 9))
+        {
+        }
+
+        void add(const uint64_t hash)
+        {
+            for_each_counter(hash, [](std::atomic<uint64_t> &word, const unsigned shift)
+            {
+                uint64_t value = word.load(std::memory_order_relaxed);
+                while ((value >> shift & kCounterMax) != kCounterMax &&
+                       !word.compare_exchange_weak(value, value + (1ULL << shift), std::memory_order_relaxed))
+                {
+                }
+                return true;
+            });
+            entries_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void remove(const uint64_t hash)
+        {
+            if (!contains(hash))
+            {
+                return; // 表中没有该ID，减少计数会误删其他ID
+            }
+            for_each_counter(hash, [](std::atomic<uint64_t> &word, const unsigned shift)
+            {
+                uint64_t value = word.load(std::memory_order_relaxed);
+                uint64_t counter = value >> shift & kCounterMax;
+                // 饱和的计数器无法知道真实计数，保持不变
+                while (counter != 0 && counter != kCounterMax &&
+                       !word.compare_exchange_weak(value, value - (1ULL << shift), std::memory_order_relaxed))
+                {
+                    counter = value >> shift & kCounterMax;
+                }
+                return true;
+            });
+            if (entries_.load(std::memory_order_relaxed) > 0)
+            {
+                entries_.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+
+        bool contains(const uint64_t hash)
+        {
+            return for_each_counter(hash, [](std::atomic<uint64_t> &word, const unsigned shift)
+            {
+                return (word.load(std::memory_order_relaxed) >> shift & kCounterMax) != 0;
+            });
+        }
+
+        size_t entries() const
+        {
+            return entries_.load(std::memory_order_relaxed);
+        }
+
+        // 按装载量估计误判率(1 - e^(-kn/m))^k
+        double estimated_fp_rate() const
+        {
+            const double k = hash_count_;
+            const double fill = 1.0 - std::exp(-k * static_cast<double>(entries()) /
+                                               static_cast<double>(blocks_.size() * kCountersPerBlock));
+            return std::pow(fill, k);
+        }
+
+    private:
+        struct alignas(64) Block
+        {
+            std::atomic<uint64_t> words_[kCountersPerBlock / 16];
+        };
+
+        // 高位选块，块内每个计数器的位置取二次混合结果的7位；fn返回false时停止
+        template<typename F>
+        bool for_each_counter(const uint64_t hash, F &&fn)
+        {
+            Block &block = blocks_[hash % blocks_.size()];
+            const uint64_t positions = mix(hash ^ 0x9E3779B97F4A7C15ULL);
+            for (uint32_t i = 0; i < hash_count_; ++i)
+            {
+                const unsigned position = positions >> (7 * i) & (kCountersPerBlock - 1);
+                if (!fn(block.words_[position >> 4], (position & 15) * 4))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        std::vector<Block> blocks_;
+        uint32_t hash_count_;
+        std::atomic<size_t> entries_{0};
+    };
+
+    SessionIdFilter::SessionIdFilter(SessionStorage::ptr storage, const SessionFilterConfig config)
+        : storage_(std::move(storage)), config_(config),
+          table_(std::make_shared<Table>(config.capacity_, config.hash_count_))
+    {
+        if (storage_->is_shared() && !config_.bus_)
+        {
+            throw std::invalid_argument("session filter over shared storage needs a bus to learn other nodes' sessions");
+        }
+        SessionIdGenerator::fill(reinterpret_cast<uint8_t *>(&seed_), sizeof(seed_));
+        if (config_.bus_)
+        {
+            subscription_ = config_.bus_->subscribe([this](const std::string &session_id) { add_local(session_id); },
+                                                    [this] { request_rebuild(); });
+        }
+        thread_ = std::thread(&SessionIdFilter::rebuild_loop, this);
+        ZHTTP_LOG_INFO("SessionIdFilter started: capacity={}, hashes={}, rebuild interval={}s",
+                       config_.capacity_, config_.hash_count_, config_.rebuild_interval_.count());
+    }
+
+    SessionIdFilter::~SessionIdFilter()
+    {
+        subscription_.reset();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    uint64_t SessionIdFilter::hash(const std::string &session_id) const
+    {
+        const char *data = session_id.data();
+        const size_t length = session_id.size();
+        uint64_t h = seed_ ^ length * 0x9E3779B97F4A7C15ULL;
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            h = mix(h ^ word);
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, data + i, length - i);
+        return mix(h ^ tail);
+    }
+
+    bool SessionIdFilter::might_contain(const std::string &session_id)
+    {
+        if (!ready_.load(std::memory_order_acquire))
+        {
+            return true;
+        }
+        checks_.fetch_add(1, std::memory_order_relaxed);
+        if (std::atomic_load(&table_)->contains(hash(session_id)))
+        {
+            return true;
+        }
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void SessionIdFilter::add(const std::string &session_id)
+    {
+        add_local(session_id);
+        if (config_.bus_)
+        {
+            config_.bus_->publish(session_id);
+        }
+    }
+
+    void SessionIdFilter::add_local(const std::string &session_id)
+    {
+        const uint64_t h = hash(session_id);
+        std::lock_guard<std::mutex> lock(update_mutex_);
+        table_->add(h);
+        if (staging_)
+        {
+            staging_->add(h);
+        }
+    }
+
+    void SessionIdFilter::remove(const std::string &session_id)
+    {
+        // 重建中的新表不删除：枚举可能没有读到该ID，删除会误删其他ID的计数；留下的误判在下次重建时消除
+        const uint64_t h = hash(session_id);
+        std::lock_guard<std::mutex> lock(update_mutex_);
+        table_->remove(h);
+    }
+
+    void SessionIdFilter::report_false_positive()
+    {
+        if (ready_.load(std::memory_order_relaxed))
+        {
+            false_positives_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool SessionIdFilter::rebuild()
+    {
+        std::lock_guard<std::mutex> rebuild_lock(rebuild_mutex_);
+        const uint64_t resets = resets_.load(std::memory_order_acquire);
+        auto fresh = std::make_shared<Table>(config_.capacity_, config_.hash_count_);
+        {
+            std::lock_guard<std::mutex> lock(update_mutex_);
+            staging_ = fresh; // 此后新增的ID同时写入新表，之前新增的已在存储中，会被枚举到
+        }
+
+        bool enumerated = false;
+        try
+        {
+            enumerated = storage_->for_each_session_id([this, &fresh](const std::string &session_id)
+            {
+                fresh->add(hash(session_id));
+            });
+        }
+        catch (const std::exception &e)
+        {
+            ZHTTP_LOG_ERROR("Failed to rebuild session filter: {}", e.what());
+        }
+
+        std::lock_guard<std::mutex> lock(update_mutex_);
+        staging_.reset();
+        if (!enumerated)
+        {
+            ZHTTP_LOG_WARN("Session storage cannot enumerate ids, session filter stays open");
+            return false;
+        }
+        std::atomic_store(&table_, fresh);
+        // 重建期间订阅中断过，可能漏掉了新建会话的消息，等待紧随其后的下一次重建
+        ready_.store(resets == resets_.load(std::memory_order_acquire), std::memory_order_release);
+        rebuilds_.fetch_add(1, std::memory_order_relaxed);
+        ZHTTP_LOG_INFO("Session filter rebuilt with {} ids", fresh->entries());
+        return true;
+    }
+
+    bool SessionIdFilter::ready() const
+    {
+        return ready_.load(std::memory_order_acquire);
+    }
+
+    SessionIdFilter::Stats SessionIdFilter::stats() const
+    {
+        Stats stats;
+        stats.checks_ = checks_.load(std::memory_order_relaxed);
+        stats.rejected_ = rejected_.load(std::memory_order_relaxed);
+        stats.false_positives_ = false_positives_.load(std::memory_order_relaxed);
+        stats.rebuilds_ = rebuilds_.load(std::memory_order_relaxed);
+        const auto table = std::atomic_load(&table_);
+        stats.entries_ = table->entries();
+        stats.estimated_fp_rate_ = table->estimated_fp_rate();
+        if (const uint64_t absent = stats.rejected_ + stats.false_positives_; absent > 0)
+        {
+            stats.observed_fp_rate_ = static_cast<double>(stats.false_positives_) / static_cast<double>(absent);
+        }
+        return stats;
+    }
+
+    void SessionIdFilter::request_rebuild()
+    {
+        ZHTTP_LOG_WARN("Session filter subscription reset, letting all ids through until rebuilt");
+        resets_.fetch_add(1, std::memory_order_acq_rel);
+        ready_.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rebuild_requested_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void SessionIdFilter::rebuild_loop()
+    {
+        rebuild();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_)
+        {
+            const auto wake = [this] { return stop_ || rebuild_requested_; };
+            if (config_.rebuild_interval_.count() > 0)
+            {
+                cv_.wait_for(lock, config_.rebuild_interval_, wake);
+            }
+            else
+            {
+                cv_.wait(lock, wake);
+            }
+            if (stop_)
+            {
+                break;
+            }
+            rebuild_requested_ = false;
+            lock.unlock();
+            rebuild();
+            lock.lock();
+        }
+    }
+} // namespace zhttp::zsession
@@ -0,0 +1,170 @@
+#include "session/session_id_generator.h"
+#include "log/http_logger.h"
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <sys/random.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace zhttp::zsession
+{
+    namespace
+    {
+        constexpr size_t kKeyBytes = 32;
+        constexpr size_t kIvBytes = 16; // OpenSSL的ChaCha20 IV：32位计数器与96位nonce
+        constexpr size_t kRekeyBytes = kKeyBytes + kIvBytes;
+        constexpr size_t kBufferBytes = 4096;
+
+        constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+        // 从内核取种，getrandom不可用时退回OpenSSL
+        void system_random(uint8_t *out, size_t length)
+        {
+            while (length > 0)
+            {
+                const ssize_t n = ::getrandom(out, length, 0);
+                if (n < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (RAND_bytes(out, static_cast<int>(length)) != 1)
+                    {
+                        throw std::runtime_error("no system randomness available for session ids");
+                    }
+                    return;
+                }
+                out += n;
+                length -= static_cast<size_t>(n);
+            }
+        }
+
+        class KeystreamState
+        {
+        public:
+            KeystreamState() : ctx_(EVP_CIPHER_CTX_new())
+            {
+                if (!ctx_)
+                {
+                    throw std::runtime_error("EVP_CIPHER_CTX_new failed");
+                }
+            }
+
+            ~KeystreamState()
+            {
+                OPENSSL_cleanse(buffer_, sizeof(buffer_));
+                EVP_CIPHER_CTX_free(ctx_);
+            }
+
+            KeystreamState(const KeystreamState &) = delete;
+
+            KeystreamState &operator=(const KeystreamState &) = delete;
+
+            void fill(uint8_t *out, size_t length)
+            {
+                if (pid_ != ::getpid())
+                {
+                    reseed(); // 首次使用或fork之后
+                }
+                while (length > 0)
+                {
+                    if (available_ == 0)
+                    {
+                        refill();
+                    }
+                    const size_t n = std::min(length, available_);
+                    uint8_t *source = buffer_ + sizeof(buffer_) - available_;
+                    std::memcpy(out, source, n);
+                    OPENSSL_cleanse(source, n); // 已发出的字节不留在内存中
+                    out += n;
+                    length -= n;
+                    available_ -= n;
+                }
+            }
+
+        private:
+            void rekey(const uint8_t *key_iv)
+            {
+                if (EVP_EncryptInit_ex(ctx_, EVP_chacha20(), nullptr, key_iv, key_iv + kKeyBytes) != 1)
+                {
+                    throw std::runtime_error("ChaCha20 initialisation failed");
+                }
+            }
+
+            void reseed()
+            {
+                uint8_t seed[kRekeyBytes];
+                system_random(seed, sizeof(seed));
+                rekey(seed);
+                OPENSSL_cleanse(seed, sizeof(seed));
+                available_ = 0;
+                pid_ = ::getpid();
+            }
+
+            // 生成下一块密钥流：开头48字节换成新密钥后擦除，其余作为输出
+            void refill()
+            {
+                static const uint8_t zeros[kRekeyBytes + kBufferBytes] = {};
+                uint8_t block[kRekeyBytes + kBufferBytes];
+                int length = 0;
+                if (EVP_EncryptUpdate(ctx_, block, &length, zeros, sizeof(zeros)) != 1 ||
+                    length != static_cast<int>(sizeof(block)))
+                {
+                    throw std::runtime_error("ChaCha20 keystream generation failed");
+                }
+                rekey(block);
+                std::memcpy(buffer_, block + kRekeyBytes, kBufferBytes);
+                OPENSSL_cleanse(block, sizeof(block));
+                available_ = kBufferBytes;
+            }
+
+        private:
+            EVP_CIPHER_CTX *ctx_;
+            uint8_t buffer_[kBufferBytes]{};
+            size_t available_ = 0;
+            pid_t pid_ = 0;
+        };
+
+        KeystreamState &thread_state()
+        {
+            thread_local KeystreamState state;
+            return state;
+        }
+    } // namespace
+
+    void SessionIdGenerator::fill(uint8_t *out, const size_t length)
+    {
+        thread_state().fill(out, length);
+    }
+
+    void SessionIdGenerator::encode(const uint8_t *bytes, char *out)
+    {
+        // 定长无分支：5组3字节编码为20个字符，最后1字节编码为2个字符
+        for (size_t group = 0; group < 5; ++group)
+        {
+            const uint32_t triple = static_cast<uint32_t>(bytes[group * 3]) << 16 |
+                                    static_cast<uint32_t>(bytes[group * 3 + 1]) << 8 |
+                                    static_cast<uint32_t>(bytes[group * 3 + 2]);
+            out[group * 4] = kAlphabet[triple >> 18 & 0x3F];
+            out[group * 4 + 1] = kAlphabet[triple >> 12 & 0x3F];
+            out[group * 4 + 2] = kAlphabet[triple >> 6 & 0x3F];
+            out[group * 4 + 3] = kAlphabet[triple & 0x3F];
+        }
+        out[20] = kAlphabet[bytes[15] >> 2];
+        out[21] = kAlphabet[(bytes[15] & 0x03) << 4];
+    }
+
+    std::string SessionIdGenerator::generate()
+    {
+        uint8_t bytes[kIdBytes];
+        fill(bytes, sizeof(bytes));
+        std::string id(kIdLength, '\0');
+        encode(bytes, id.data());
+        OPENSSL_cleanse(bytes, sizeof(bytes));
+        return id;
+    }
+} // namespace zhttp::zsession
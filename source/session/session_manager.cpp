@@ -1,11 +1,11 @@
 #include "session/session_manager.h"
 #include "log/http_logger.h"
-#include <sstream>
-#include <iomanip>
 
 namespace zhttp::zsession
 {
-    SessionManager::SessionManager() : session_storage_(std::make_unique<InMemoryStorage>())
+    SessionManager::SessionManager()
+        : session_storage_(std::make_shared<InMemoryStorage>()),
+          refresher_(std::make_unique<SessionRefresher>(session_storage_, refresh_interval_))
     {
         ZHTTP_LOG_INFO("SessionManager initialized with default memory storage");
     }
@@ -23,54 +23,196 @@ namespace zhttp::zsession
         {
             ZHTTP_LOG_DEBUG("Found session ID in request: {}", session_id);
             
-            // 尝试从存储中加载现有会话
-            if (auto session = session_storage_->load(session_id))
+            // 尝试从存储中加载现有会话；只读访问不写存储，过期时间由后台合并写入
+            if (filter_ && !filter_->might_contain(session_id))
+            {
+                ZHTTP_LOG_DEBUG("Session {} rejected by session filter", session_id);
+            }
+            else if (auto session = session_storage_->load(session_id))
             {
                 if (!session->is_expired())
                 {
-                    session->refresh(); // 刷新会话过期时间
-                    session_storage_->store(session); // 更新存储
+                    const auto previous_expiry = session->get_expiry_time();
+                    session->refresh();
+                    if (session_storage_->stores_in_cookie())
+                    {
+                        // load返回的是本次请求独有的对象，回调只持有响应的存活句柄
+                        session->cookie_writer_.write_ = [lifetime = response->lifetime()](const std::string &value)
+                        {
+                            if (const auto alive = lifetime.lock())
+                            {
+                                set_session_id_to_response(*alive, value);
+                            }
+                        };
+                        // Cookie会话无法在服务器端顺延，每个刷新间隔重新下发一次
+                        if (session->get_expiry_time() - previous_expiry >= refresh_interval_)
+                        {
+                            if (auto token = session_storage_->cookie_token(*session))
+                            {
+                                session->cookie_writer_(*token);
+                                refresher_->written(session->get_session_id());
+                                ZHTTP_LOG_DEBUG("Cookie session {} reissued", session->get_session_id());
+                                return session;
+                            }
+                        }
+                        if (session->get_session_id() != session_id)
+                        {
+                            return session; // 来自令牌，服务器端没有可顺延的数据
+                        }
+                    }
+                    refresher_->touch(session->get_session_id(), session->get_expiry_time());
                     ZHTTP_LOG_INFO("Existing session {} loaded and refreshed", session_id);
                     return session;
                 }
                 else
                 {
                     ZHTTP_LOG_WARN("Session {} has expired, will create new session", session_id);
-                    session_storage_->remove(session_id);
+                    // 只有本次调用确实删除了会话才从过滤器删除，同一ID的并发删除只计一次
+                    if (session_storage_->remove(session_id) && filter_)
+                    {
+                        filter_->remove(session_id);
+                    }
+                    refresher_->forget(session_id);
                 }
             }
             else
             {
                 ZHTTP_LOG_DEBUG("Session {} not found in storage", session_id);
+                if (filter_)
+                {
+                    filter_->report_false_positive();
+                }
             }
         }
         
-        // 创建新会话
-        session_id = generate_session_id();
-        auto new_session = std::make_shared<Session>(session_id);
-        session_storage_->store(new_session);
-        set_session_id_to_response(response, session_id);
+        // 延迟创建：此时不分配ID、不下发Cookie、不写存储，首次写入属性时才真正创建
+        auto new_session = std::make_shared<Session>("");
+        new_session->set_materializer(
+                [this, lifetime = response->lifetime(), origin = std::weak_ptr<Session>(new_session)](Session &session)
+                {
+                    materialize(session, origin, lifetime);
+                });
         
-        ZHTTP_LOG_INFO("New session {} created and stored", session_id);
+        ZHTTP_LOG_DEBUG("Lazy session handed out, nothing stored yet");
         return new_session;
     }
 
+    // 为延迟会话分配ID并持久化
+    void SessionManager::materialize(Session &session, const std::weak_ptr<Session> &origin,
+                                     const std::weak_ptr<HttpResponse *> &response)
+    {
+        std::shared_lock<std::shared_mutex> lock(rb_mutex_);
+        
+        const std::string session_id = generate_session_id();
+        session.session_id_ = session_id;
+        auto shared = origin.lock();
+        if (!shared || shared.get() != &session)
+        {
+            shared = std::make_shared<Session>(session); // 调用方复制过会话对象，存储写入时的快照
+        }
+        session_storage_->store(shared);
+        session.clear_dirty();
+        refresher_->written(session_id);
+        if (filter_)
+        {
+            filter_->add(session_id);
+        }
+        if (session_storage_->stores_in_cookie())
+        {
+            session.cookie_writer_.write_ = [response](const std::string &value)
+            {
+                if (const auto alive = response.lock())
+                {
+                    set_session_id_to_response(*alive, value);
+                }
+            };
+        }
+        if (const auto alive = response.lock())
+        {
+            set_session_id_to_response(*alive, session_storage_->cookie_token(session).value_or(session_id));
+        }
+        else
+        {
+            ZHTTP_LOG_WARN("Session {} written after its response was sent, cookie not set", session_id);
+        }
+        
+        ZHTTP_LOG_INFO("New session {} created and stored on first write", session_id);
+    }
+
     // 设置会话存储
     void SessionManager::set_session_storage(SessionStorage::ptr session_storage)
     {
         ZHTTP_LOG_INFO("Setting custom session storage");
         std::unique_lock<std::shared_mutex> lock(rb_mutex_);
+        refresher_.reset(); // 先把待写入的刷新写回旧存储
         session_storage_ = std::move(session_storage);
+        refresher_ = std::make_unique<SessionRefresher>(session_storage_, refresh_interval_);
+        filter_.reset();
+        if (filter_config_)
+        {
+            try
+            {
+                filter_ = std::make_unique<SessionIdFilter>(session_storage_, *filter_config_);
+            }
+            catch (const std::invalid_argument &e)
+            {
+                ZHTTP_LOG_ERROR("Session filter disabled for the new storage: {}", e.what());
+                filter_config_.reset();
+            }
+        }
         ZHTTP_LOG_INFO("Custom session storage updated successfully");
     }
 
+    // 设置滑动过期的最小写入间隔
+    void SessionManager::set_refresh_interval(const std::chrono::seconds interval)
+    {
+        std::unique_lock<std::shared_mutex> lock(rb_mutex_);
+        refresher_.reset();
+        refresh_interval_ = interval;
+        refresher_ = std::make_unique<SessionRefresher>(session_storage_, refresh_interval_);
+        ZHTTP_LOG_INFO("Session refresh interval set to {} seconds", interval.count());
+    }
+
+    // 启用会话ID过滤器
+    void SessionManager::enable_session_filter(const SessionFilterConfig config)
+    {
+        std::unique_lock<std::shared_mutex> lock(rb_mutex_);
+        filter_ = std::make_unique<SessionIdFilter>(session_storage_, config); // 共享存储缺少总线时抛出
+        filter_config_ = config;
+    }
+
+    // 停用会话ID过滤器
+    void SessionManager::disable_session_filter()
+    {
+        std::unique_lock<std::shared_mutex> lock(rb_mutex_);
+        filter_config_.reset();
+        filter_.reset();
+        ZHTTP_LOG_INFO("Session filter disabled");
+    }
+
+    // 过滤器统计
+    std::optional<SessionIdFilter::Stats> SessionManager::session_filter_stats() const
+    {
+        std::shared_lock<std::shared_mutex> lock(rb_mutex_);
+        if (!filter_)
+        {
+            return std::nullopt;
+        }
+        return filter_->stats();
+    }
+
     // 销毁会话
     void SessionManager::destroy_session(const std::string &session_id) const
     {
         ZHTTP_LOG_INFO("Destroying session: {}", session_id);
         
         std::shared_lock<std::shared_mutex> lock(rb_mutex_);
-        session_storage_->remove(session_id);
+        // 只有本次调用确实删除了会话才从过滤器删除，否则会误删其他ID的计数
+        if (session_storage_->remove(session_id) && filter_)
+        {
+            filter_->remove(session_id);
+        }
+        refresher_->forget(session_id);
         
         ZHTTP_LOG_INFO("Session {} destroyed successfully", session_id);
     }
@@ -80,8 +222,30 @@ namespace zhttp::zsession
     {
         ZHTTP_LOG_DEBUG("Updating session: {}", session->get_session_id());
         
+        if (session->is_lazy())
+        {
+            ZHTTP_LOG_DEBUG("Lazy session was never written, nothing to update");
+            return;
+        }
+        
         std::shared_lock<std::shared_mutex> lock(rb_mutex_);
+        if (!session->is_dirty())
+        {
+            if (!session->cookie_writer_)
+            {
+                refresher_->touch(session->get_session_id(), session->get_expiry_time());
+            }
+            ZHTTP_LOG_DEBUG("Session {} unchanged, expiry refresh deferred", session->get_session_id());
+            return;
+        }
         session_storage_->store(session);
+        session->clear_dirty();
+        refresher_->written(session->get_session_id());
+        if (session->cookie_writer_)
+        {
+            // 写入后Cookie中的令牌已过时；会话超出大小上限转存服务器端时改为下发会话ID
+            session->cookie_writer_(session_storage_->cookie_token(*session).value_or(session->get_session_id()));
+        }
         
         ZHTTP_LOG_DEBUG("Session {} updated successfully", session->get_session_id());
     }
@@ -100,19 +264,7 @@ namespace zhttp::zsession
     // 生成随机会话ID
     std::string SessionManager::generate_session_id()
     {
-        ZHTTP_LOG_DEBUG("Generating new session ID");
-        
-        std::uniform_int_distribution<> dis(0, 15);
-        std::stringstream ss;
-        
-        for (int i = 0; i < 32; ++i)
-        {
-            ss << std::hex << dis(rng_);
-        }
-        
-        std::string session_id = ss.str();
-        ZHTTP_LOG_DEBUG("Generated session ID: {}", session_id);
-        return session_id;
+        return SessionIdGenerator::generate();
     }
 
     // 从请求中获取会话ID
@@ -0,0 +1,134 @@
+#include "session/session_refresher.h"
+#include "log/http_logger.h"
+#include <algorithm>
+
+namespace zhttp::zsession
+{
+    SessionRefresher::SessionRefresher(SessionStorage::ptr storage, const std::chrono::seconds interval,
+                                       const std::chrono::milliseconds flush_period)
+        : storage_(std::move(storage)), interval_(interval), flush_period_(flush_period)
+    {
+        thread_ = std::thread(&SessionRefresher::flush_loop, this);
+        ZHTTP_LOG_INFO("SessionRefresher started: interval={}s, flush period={}ms",
+                       interval_.count(), flush_period_.count());
+    }
+
+    SessionRefresher::~SessionRefresher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+        flush();
+    }
+
+    SessionRefresher::Shard &SessionRefresher::shard_for(const std::string &session_id)
+    {
+        return shards_[std::hash<std::string>{}(session_id) % kShardCount];
+    }
+
+    void SessionRefresher::touch(const std::string &session_id, const std::chrono::system_clock::time_point expiry_time)
+    {
+        Shard &shard = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        if (const auto it = shard.written_.find(session_id);
+            it != shard.written_.end() && std::chrono::steady_clock::now() - it->second < interval_)
+        {
+            return; // interval内已写入过
+        }
+        auto &pending = shard.pending_[session_id];
+        pending = std::max(pending, expiry_time);
+    }
+
+    void SessionRefresher::written(const std::string &session_id)
+    {
+        Shard &shard = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        shard.pending_.erase(session_id);
+        shard.written_[session_id] = std::chrono::steady_clock::now();
+    }
+
+    void SessionRefresher::forget(const std::string &session_id)
+    {
+        Shard &shard = shard_for(session_id);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        shard.pending_.erase(session_id);
+        shard.written_.erase(session_id);
+    }
+
+    void SessionRefresher::flush()
+    {
+        std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+        const auto now = std::chrono::steady_clock::now();
+        const bool prune = now - last_prune_ >= interval_;
+        if (prune)
+        {
+            last_prune_ = now;
+        }
+
+        std::vector<ExpiryUpdate> updates;
+        for (auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            for (auto &[session_id, expiry_time] : shard.pending_)
+            {
+                shard.written_[session_id] = now;
+                updates.push_back(ExpiryUpdate{session_id, expiry_time});
+            }
+            shard.pending_.clear();
+
+            // 超过interval的写入记录已不再限制刷新，每个interval清理一次以限制内存
+            for (auto it = shard.written_.begin(); prune && it != shard.written_.end();)
+            {
+                it = now - it->second >= interval_ ? shard.written_.erase(it) : std::next(it);
+            }
+        }
+        if (updates.empty())
+        {
+            return;
+        }
+
+        try
+        {
+            storage_->touch(updates);
+            ZHTTP_LOG_DEBUG("Flushed expiry refresh of {} sessions", updates.size());
+        }
+        catch (const std::exception &e)
+        {
+            // 写入失败的会话在下一个interval可以再次刷新，过期时间足够长时不会丢失会话
+            ZHTTP_LOG_ERROR("Failed to flush expiry refresh of {} sessions: {}", updates.size(), e.what());
+        }
+    }
+
+    size_t SessionRefresher::pending() const
+    {
+        size_t total = 0;
+        for (const auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            total += shard.pending_.size();
+        }
+        return total;
+    }
+
+    void SessionRefresher::flush_loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_)
+        {
+            cv_.wait_for(lock, flush_period_, [this] { return stop_; });
+            if (stop_)
+            {
+                break;
+            }
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+} // namespace zhttp::zsession
@@ -1,5 +1,6 @@
 #include "ssl/ssl_connection.h"
 #include "log/http_logger.h"
+#include <openssl/buffer.h>
 #include <openssl/err.h>
 
 #include <utility>
@@ -16,6 +17,14 @@ namespace zhttp::zssl
         return method;
     }
 
+    // 内存BIO已分配的容量
+    static size_t mem_bio_capacity(BIO *bio)
+    {
+        BUF_MEM *mem = nullptr;
+        BIO_get_mem_ptr(bio, &mem);
+        return mem ? mem->max : 0;
+    }
+
     SslConnection::SslConnection(muduo::net::TcpConnectionPtr conn, SslContext *ctx)
         : ssl_(nullptr), context_(ctx), connection_(std::move(conn)), state_(SslState::HANDSHAKE),
           read_bio_(nullptr),
@@ -133,11 +142,20 @@ namespace zhttp::zssl
 
         // 3. 解密报文，并向回调给上层on_message处理
         on_decrypted();
-        if (message_callback_ && decrypted_buffer_.readableBytes() > 0)
+        if (message_callback_ && decrypted_buffer_ && decrypted_buffer_->readableBytes() > 0)
         {
             ZHTTP_LOG_DEBUG("Calling message callback with {} bytes of decrypted data", 
-                           decrypted_buffer_.readableBytes());
-            message_callback_(connection_, &decrypted_buffer_, receive_time_);
+                           decrypted_buffer_->readableBytes());
+            message_callback_(connection_, decrypted_buffer_.get(), receive_time_);
+        }
+        if (release_buffers_)
+        {
+            // 每次都换新BIO会给每个请求增加分配，只处理被大报文撑大的BIO
+            release_buffers(kMaxBioCapacity);
+        }
+        else
+        {
+            release_decrypted_buffer();
         }
     }
 
@@ -161,10 +179,11 @@ namespace zhttp::zssl
 
             //  解密报文，并向回调给上层on_message处理
             on_decrypted();
-            if (message_callback_ && decrypted_buffer_.readableBytes() > 0)
+            if (message_callback_ && decrypted_buffer_ && decrypted_buffer_->readableBytes() > 0)
             {
-                message_callback_(connection_, &decrypted_buffer_, receive_time_);
+                message_callback_(connection_, decrypted_buffer_.get(), receive_time_);
             }
+            release_decrypted_buffer();
 
             return;
         }
@@ -196,12 +215,18 @@ namespace zhttp::zssl
         {
             if (const int n = BIO_read(write_bio_, buf, std::min(pend, static_cast<int>(sizeof(buf)))); n > 0)
             {
-                write_buffer_.append(buf, n);
-                connection_->send(&write_buffer_);
+                if (!write_buffer_)
+                {
+                    write_buffer_ = BufferPool::local().acquire();
+                }
+                write_buffer_->append(buf, n);
+                connection_->send(write_buffer_.get());
                 total_sent += n;
             }
             else break;
         }
+        // send会取走全部数据，写缓冲区用完即还
+        BufferPool::local().release(std::move(write_buffer_));
         if (total_sent > 0)
         {
             ZHTTP_LOG_DEBUG("Sent {} bytes of encrypted data to: {}", 
@@ -234,7 +259,7 @@ namespace zhttp::zssl
             const int ret = SSL_read(ssl_, plain, sizeof(plain));
             if (ret > 0)
             {
-                decrypted_buffer_.append(plain, ret);
+                get_decrypted_buffer()->append(plain, ret);
                 total_decrypted += ret;
                 continue;
             }
@@ -312,15 +337,19 @@ namespace zhttp::zssl
         auto *conn = static_cast<SslConnection *>(BIO_get_data(bio));
         if (!conn) return -1;
 
-        const size_t readable = conn->read_buffer_.readableBytes();
+        const size_t readable = conn->read_buffer_ ? conn->read_buffer_->readableBytes() : 0;
         if (readable == 0)
         {
             return -1; // 无数据可读
         }
 
         const size_t to_read = std::min(static_cast<size_t>(len), readable);
-        memcpy(data, conn->read_buffer_.peek(), to_read);
-        conn->read_buffer_.retrieve(to_read);
+        memcpy(data, conn->read_buffer_->peek(), to_read);
+        conn->read_buffer_->retrieve(to_read);
+        if (conn->read_buffer_->readableBytes() == 0)
+        {
+            BufferPool::local().release(std::move(conn->read_buffer_));
+        }
         return static_cast<int>(to_read);
     }
 
@@ -346,4 +375,66 @@ namespace zhttp::zssl
     {
         return state_ == SslState::ESTABLISHED;
     }
+
+    muduo::net::Buffer *SslConnection::get_decrypted_buffer()
+    {
+        if (!decrypted_buffer_)
+        {
+            decrypted_buffer_ = BufferPool::local().acquire();
+        }
+        return decrypted_buffer_.get();
+    }
+
+    void SslConnection::release_decrypted_buffer()
+    {
+        if (decrypted_buffer_ && decrypted_buffer_->readableBytes() == 0)
+        {
+            BufferPool::local().release(std::move(decrypted_buffer_));
+        }
+    }
+
+    void SslConnection::shrink()
+    {
+        release_buffers(0);
+    }
+
+    void SslConnection::release_buffers(const size_t min_capacity)
+    {
+        release_decrypted_buffer();
+        if (read_buffer_ && read_buffer_->readableBytes() == 0)
+        {
+            BufferPool::local().release(std::move(read_buffer_));
+        }
+        if (!ssl_ || state_ != SslState::ESTABLISHED)
+        {
+            return;
+        }
+
+        // 内存BIO读空后仍保留历史最大容量，替换为新的空BIO（SSL_set0_*会释放旧BIO）
+        if (BIO_pending(read_bio_) == 0 && mem_bio_capacity(read_bio_) > min_capacity)
+        {
+            if (BIO *fresh = BIO_new(BIO_s_mem()))
+            {
+                SSL_set0_rbio(ssl_, fresh);
+                read_bio_ = fresh;
+            }
+        }
+        if (BIO_pending(write_bio_) == 0 && mem_bio_capacity(write_bio_) > min_capacity)
+        {
+            if (BIO *fresh = BIO_new(BIO_s_mem()))
+            {
+                SSL_set0_wbio(ssl_, fresh);
+                write_bio_ = fresh;
+            }
+        }
+    }
+
+    void SslConnection::enable_release_buffers()
+    {
+        if (ssl_)
+        {
+            SSL_set_mode(ssl_, SSL_MODE_RELEASE_BUFFERS);
+        }
+        release_buffers_ = true;
+    }
 } // namespace zhttp::zssl
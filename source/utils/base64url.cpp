@@ -0,0 +1,79 @@
+#include "utils/base64url.h"
+#include <cstdint>
+
+namespace zhttp::zutils
+{
+    namespace
+    {
+        constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+        // base64url字符到6位值，非法字符为-1
+        constexpr auto kDecodeTable = []
+        {
+            struct Table
+            {
+                int8_t values_[256];
+            } table{};
+            for (int8_t &value : table.values_)
+            {
+                value = -1;
+            }
+            for (int8_t i = 0; i < 64; ++i)
+            {
+                table.values_[static_cast<uint8_t>(kAlphabet[i])] = i;
+            }
+            return table;
+        }();
+    } // namespace
+
+    bool base64url_decode(const std::string_view input, std::string &output)
+    {
+        if (input.size() % 4 == 1)
+        {
+            return false;
+        }
+        output.clear();
+        output.reserve(input.size() * 3 / 4);
+        uint32_t buffer = 0;
+        int bits = 0;
+        for (const char c : input)
+        {
+            const int8_t value = kDecodeTable.values_[static_cast<uint8_t>(c)];
+            if (value < 0)
+            {
+                return false;
+            }
+            buffer = buffer << 6 | static_cast<uint32_t>(value);
+            bits += 6;
+            if (bits >= 8)
+            {
+                bits -= 8;
+                output.push_back(static_cast<char>((buffer >> bits) & 0xff));
+            }
+        }
+        return true;
+    }
+
+    std::string base64url_encode(const std::string_view input)
+    {
+        std::string output;
+        output.reserve((input.size() * 4 + 2) / 3);
+        uint32_t buffer = 0;
+        int bits = 0;
+        for (const char c : input)
+        {
+            buffer = buffer << 8 | static_cast<uint8_t>(c);
+            bits += 8;
+            while (bits >= 6)
+            {
+                bits -= 6;
+                output.push_back(kAlphabet[(buffer >> bits) & 0x3f]);
+            }
+        }
+        if (bits > 0)
+        {
+            output.push_back(kAlphabet[(buffer << (6 - bits)) & 0x3f]);
+        }
+        return output;
+    }
+} // namespace zhttp::zutils
@@ -0,0 +1,161 @@
+#include "utils/epoch.h"
+
+namespace zhttp::zutils
+{
+    namespace
+    {
+        std::atomic<uint64_t> next_domain_id{1};
+
+        // 当前线程在各个域中占用的记录，线程退出时归还，供后续线程复用
+        template<typename Record>
+        struct LocalRecords
+        {
+            std::vector<std::pair<uint64_t, Record *>> records_;
+
+            ~LocalRecords()
+            {
+                for (auto &[id, record] : records_)
+                {
+                    record->in_use_.store(false, std::memory_order_release);
+                }
+            }
+        };
+    }
+
+    EpochDomain::Guard::Guard(EpochDomain &domain) : domain_(domain)
+    {
+        domain_.enter();
+    }
+
+    EpochDomain::Guard::~Guard()
+    {
+        domain_.exit();
+    }
+
+    EpochDomain &EpochDomain::global()
+    {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    EpochDomain::EpochDomain() : id_(next_domain_id.fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    EpochDomain::~EpochDomain()
+    {
+        // 域销毁时不会再有读者
+        for (auto &[epoch, deleter] : retired_)
+        {
+            deleter();
+        }
+    }
+
+    EpochDomain::Record *EpochDomain::local_record()
+    {
+        thread_local LocalRecords<Record> local;
+        for (const auto &[id, record] : local.records_)
+        {
+            if (id == id_)
+            {
+                return record;
+            }
+        }
+
+        // 优先复用已退出线程留下的记录
+        Record *record = nullptr;
+        for (Record *it = records_.load(std::memory_order_acquire); it; it = it->next_)
+        {
+            bool expected = false;
+            if (!it->in_use_.load(std::memory_order_relaxed) &&
+                it->in_use_.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                record = it;
+                break;
+            }
+        }
+        if (!record)
+        {
+            record = new Record();
+            record->in_use_.store(true, std::memory_order_relaxed);
+            Record *head = records_.load(std::memory_order_relaxed);
+            do
+            {
+                record->next_ = head;
+            } while (!records_.compare_exchange_weak(head, record, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+        }
+        local.records_.emplace_back(id_, record);
+        return record;
+    }
+
+    void EpochDomain::enter()
+    {
+        Record *record = local_record();
+        if (record->depth_++ == 0)
+        {
+            // 先登记纪元再读取被保护的指针：之后对指针的acquire读取不会被重排到登记之前，
+            // 需要seq_cst栅栏与retire中的栅栏配对，写者才能看到登记或读者看到新指针
+            record->epoch_.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void EpochDomain::exit()
+    {
+        Record *record = local_record();
+        if (--record->depth_ == 0)
+        {
+            record->epoch_.store(Record::kIdle, std::memory_order_release);
+        }
+    }
+
+    void EpochDomain::retire(std::function<void()> deleter)
+    {
+        // 旧对象已从共享指针上摘下，此后进入的读者都登记在新纪元；栅栏使摘下先于读取读者的纪元
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::lock_guard<std::mutex> lock(retire_mutex_);
+            retired_.emplace_back(epoch, std::move(deleter));
+        }
+        reclaim();
+    }
+
+    size_t EpochDomain::reclaim()
+    {
+        // 扫描前先取当前纪元作为上界：扫描开始后才退休的对象纪元不小于它，
+        // 此时可能有读者在扫描过后才登记并仍持有它，不能在本轮释放
+        uint64_t min_epoch = epoch_.load(std::memory_order_seq_cst);
+        for (Record *it = records_.load(std::memory_order_acquire); it; it = it->next_)
+        {
+            min_epoch = std::min(min_epoch, it->epoch_.load(std::memory_order_seq_cst));
+        }
+
+        std::vector<std::function<void()>> ready;
+        size_t remaining;
+        {
+            std::lock_guard<std::mutex> lock(retire_mutex_);
+            auto keep = retired_.begin();
+            for (auto &item : retired_)
+            {
+                // 读者登记的纪元晚于退休纪元，说明它进入时旧对象已经摘下
+                if (item.first < min_epoch)
+                {
+                    ready.emplace_back(std::move(item.second));
+                }
+                else
+                {
+                    *keep++ = std::move(item);
+                }
+            }
+            retired_.erase(keep, retired_.end());
+            remaining = retired_.size();
+        }
+        for (auto &deleter : ready)
+        {
+            deleter();
+        }
+        return remaining;
+    }
+} // namespace zhttp::zutils
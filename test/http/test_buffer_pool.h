@@ -0,0 +1,62 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <thread>
+#include "http/buffer_pool.h"
+
+namespace zhttp
+{
+    TEST(BufferPoolTest, ReuseReleasedBuffer)
+    {
+        auto &pool = BufferPool::local();
+        const size_t before = pool.cached();
+
+        BufferPool::BufferPtr buffer = pool.acquire();
+        const muduo::net::Buffer *raw = buffer.get();
+        buffer->append("hello", 5);
+        buffer->retrieveAll();
+        pool.release(std::move(buffer));
+        EXPECT_EQ(pool.cached(), before + 1);
+
+        BufferPool::BufferPtr again = pool.acquire();
+        EXPECT_EQ(again.get(), raw);
+        EXPECT_EQ(again->readableBytes(), 0u);
+        EXPECT_EQ(pool.cached(), before);
+    }
+
+    TEST(BufferPoolTest, DropNonEmptyBuffer)
+    {
+        auto &pool = BufferPool::local();
+        const size_t before = pool.cached();
+
+        BufferPool::BufferPtr buffer = pool.acquire();
+        buffer->append("pending", 7);
+        pool.release(std::move(buffer)); // 仍有未读数据，不能回收
+        EXPECT_EQ(pool.cached(), before);
+        pool.release(nullptr);
+        EXPECT_EQ(pool.cached(), before);
+    }
+
+    TEST(BufferPoolTest, ShrinkLargeBuffer)
+    {
+        auto &pool = BufferPool::local();
+        BufferPool::BufferPtr buffer = pool.acquire();
+        const std::string big(256 * 1024, 'x');
+        buffer->append(big.data(), big.size());
+        buffer->retrieveAll();
+        EXPECT_GE(buffer->internalCapacity(), big.size());
+
+        pool.release(std::move(buffer));
+        BufferPool::BufferPtr again = pool.acquire();
+        EXPECT_LT(again->internalCapacity(), big.size());
+    }
+
+    TEST(BufferPoolTest, PoolIsThreadLocal)
+    {
+        const BufferPool *main_pool = &BufferPool::local();
+        const BufferPool *other_pool = nullptr;
+        std::thread t([&] { other_pool = &BufferPool::local(); });
+        t.join();
+        EXPECT_NE(main_pool, other_pool);
+    }
+} // namespace zhttp
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "http/balanced_tcp_server.h"
+
+namespace zhttp
+{
+    TEST(LoopLoadTest, ScoreCombinesConnectionsQueueAndBusy)
+    {
+        LoopLoad load;
+        EXPECT_DOUBLE_EQ(load.score(), 0.0);
+
+        load.add_connection(3);
+        EXPECT_DOUBLE_EQ(load.score(), 3.0);
+
+        load.add_queued_bytes(static_cast<int64_t>(LoopLoad::kQueuedBytesUnit) * 2);
+        EXPECT_DOUBLE_EQ(load.score(), 5.0);
+        load.add_queued_bytes(-static_cast<int64_t>(LoopLoad::kQueuedBytesUnit) * 2);
+        load.add_connection(-3);
+        EXPECT_DOUBLE_EQ(load.score(), 0.0);
+    }
+
+    TEST(LoopLoadTest, BusyRatioDecays)
+    {
+        LoopLoad load;
+        constexpr int64_t window = 100'000'000;
+
+        load.add_busy(window); // 整个窗口都在忙
+        load.sample(window);
+        EXPECT_DOUBLE_EQ(load.busy_ratio(), 0.5);
+        load.add_busy(window * 3); // 超出窗口按满负荷计
+        load.sample(window);
+        EXPECT_DOUBLE_EQ(load.busy_ratio(), 0.75);
+        EXPECT_GT(load.score(), 0.7 * LoopLoad::kBusyWeight);
+
+        // 空闲后逐步回落
+        for (int i = 0; i < 20; ++i)
+        {
+            load.sample(window);
+        }
+        EXPECT_LT(load.busy_ratio(), 0.001);
+    }
+} // namespace zhttp
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "http/timing_wheel.h"
+
+namespace zhttp
+{
+    TEST(TimingWheelTest, ExpireAfterTimeout)
+    {
+        std::vector<TimingWheel::Entry *> expired;
+        TimingWheel wheel(10, [&](TimingWheel::Entry &entry) { expired.push_back(&entry); });
+        TimingWheel::Entry entry({}, &wheel);
+
+        wheel.update(&entry, 3, TimingWheel::TimeoutType::Idle);
+        EXPECT_EQ(wheel.size(), 1u);
+        for (int i = 0; i < 3; ++i)
+        {
+            wheel.tick();
+        }
+        EXPECT_TRUE(expired.empty()); // 不早于超时时间
+        wheel.tick();
+        ASSERT_EQ(expired.size(), 1u);
+        EXPECT_EQ(expired[0], &entry);
+        EXPECT_FALSE(entry.linked_);
+        EXPECT_EQ(wheel.size(), 0u);
+    }
+
+    TEST(TimingWheelTest, UpdatePostponesDeadline)
+    {
+        int expired = 0;
+        TimingWheel wheel(10, [&](TimingWheel::Entry &) { ++expired; });
+        TimingWheel::Entry entry({}, &wheel);
+
+        wheel.update(&entry, 2, TimingWheel::TimeoutType::Body);
+        wheel.tick();
+        wheel.tick();
+        wheel.update(&entry, 2, TimingWheel::TimeoutType::Body); // 有进展，顺延
+        wheel.tick();
+        wheel.tick();
+        EXPECT_EQ(expired, 0);
+        wheel.tick();
+        EXPECT_EQ(expired, 1);
+    }
+
+    TEST(TimingWheelTest, RemoveAndDestroy)
+    {
+        int expired = 0;
+        TimingWheel wheel(4, [&](TimingWheel::Entry &) { ++expired; });
+        TimingWheel::Entry removed({}, &wheel);
+        wheel.update(&removed, 1, TimingWheel::TimeoutType::Idle);
+        wheel.remove(&removed);
+        {
+            TimingWheel::Entry destroyed({}, &wheel);
+            wheel.update(&destroyed, 1, TimingWheel::TimeoutType::Header);
+            EXPECT_EQ(wheel.size(), 1u);
+        }
+        EXPECT_EQ(wheel.size(), 0u);
+
+        for (int i = 0; i < 16; ++i)
+        {
+            wheel.tick();
+        }
+        EXPECT_EQ(expired, 0);
+    }
+
+    TEST(TimingWheelTest, MixedTimeoutsShareWheel)
+    {
+        std::vector<TimingWheel::TimeoutType> expired;
+        TimingWheel wheel(30, [&](TimingWheel::Entry &entry) { expired.push_back(entry.type_); });
+        TimingWheel::Entry header({}, &wheel);
+        TimingWheel::Entry idle({}, &wheel);
+        wheel.update(&header, 5, TimingWheel::TimeoutType::Header);
+        wheel.update(&idle, 30, TimingWheel::TimeoutType::Idle);
+
+        for (int i = 0; i < 6; ++i)
+        {
+            wheel.tick();
+        }
+        ASSERT_EQ(expired.size(), 1u);
+        EXPECT_EQ(expired[0], TimingWheel::TimeoutType::Header);
+
+        for (int i = 0; i < 25; ++i)
+        {
+            wheel.tick();
+        }
+        ASSERT_EQ(expired.size(), 2u);
+        EXPECT_EQ(expired[1], TimingWheel::TimeoutType::Idle);
+    }
+} // namespace zhttp
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "middleware/cors/cors_middle.h"
+#include "middleware/middleware_chain.h"
+#include <muduo/net/Buffer.h>
 #include <gtest/gtest.h>
 
 namespace zhttp::zmiddleware
@@ -143,4 +145,31 @@ namespace zhttp::zmiddleware
         EXPECT_EQ(res.get_header("Access-Control-Allow-Origin"), "*");
     }
 
+    // 测试：洋葱式处理直接写入预检响应，不抛异常也不进入处理器
+    TEST_F(CorsMiddlewareTest, HandlePreflightWithoutThrow)
+    {
+        HttpRequest req;
+        req.set_method(HttpRequest::Method::OPTIONS);
+        req.set_version("HTTP/1.1");
+        req.set_header("Origin", "https://example.com");
+
+        HttpResponse res;
+        MiddlewareContext context(req, res);
+        bool reached = false;
+        const Next::Terminal terminal = [&reached](MiddlewareContext &) { reached = true; };
+        MiddlewareChain chain({std::shared_ptr<Middleware>(middleware, [](Middleware *) {})});
+
+        EXPECT_NO_THROW(chain.run(context, terminal));
+        EXPECT_FALSE(reached);
+        EXPECT_EQ(res.get_status_code(), HttpResponse::StatusCode::NoContent);
+
+        // 预检响应头是预序列化的，检查写出的字节
+        muduo::net::Buffer buf;
+        res.append_buffer(&buf);
+        const std::string wire(buf.peek(), buf.readableBytes());
+        EXPECT_EQ(wire.rfind("HTTP/1.1 204 No Content\r\n", 0), 0u);
+        EXPECT_NE(wire.find("Access-Control-Allow-Origin: https://example.com\r\n"), std::string::npos);
+        EXPECT_NE(wire.find("Access-Control-Max-Age: 600\r\n"), std::string::npos);
+    }
+
 } // namespace zhttp
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "middleware/cors/cors_policy.h"
+#include <gtest/gtest.h>
+#include <muduo/net/Buffer.h>
+
+namespace zhttp::zmiddleware
+{
+    namespace
+    {
+        CorsConfig policy_config(std::vector<std::string> origins)
+        {
+            CorsConfig config;
+            config.allow_origins_ = std::move(origins);
+            config.allow_methods_ = {"GET", "POST"};
+            config.allow_headers_ = {"Content-Type"};
+            config.max_age = 60;
+            return config;
+        }
+
+        std::string serialize(HttpResponse &response)
+        {
+            muduo::net::Buffer buf;
+            response.append_buffer(&buf);
+            return std::string(buf.peek(), buf.readableBytes());
+        }
+    }
+
+    TEST(CorsPolicyTest, ExactAndWildcardOrigins)
+    {
+        const CorsPolicy policy(policy_config({"https://example.com", "*.example.org", "https://*.corp.io"}));
+
+        EXPECT_TRUE(policy.is_origin_allowed("https://example.com"));
+        EXPECT_FALSE(policy.is_origin_allowed("https://example.com.evil.net"));
+        EXPECT_FALSE(policy.is_origin_allowed("http://example.com"));
+
+        EXPECT_TRUE(policy.is_origin_allowed("https://a.example.org"));
+        EXPECT_TRUE(policy.is_origin_allowed("http://a.b.example.org"));
+        EXPECT_FALSE(policy.is_origin_allowed("https://example.org"));   // 通配段不能为空
+        EXPECT_FALSE(policy.is_origin_allowed("https://evilexample.org")); // 必须在点号处分隔
+
+        EXPECT_TRUE(policy.is_origin_allowed("https://api.corp.io"));
+        EXPECT_FALSE(policy.is_origin_allowed("http://api.corp.io"));    // 协议不符
+
+        // 端口不影响通配匹配
+        EXPECT_TRUE(policy.is_origin_allowed("https://a.example.org:8443"));
+        EXPECT_TRUE(policy.is_origin_allowed("https://api.corp.io:443"));
+        EXPECT_FALSE(policy.is_origin_allowed("https://example.org:8443"));
+        EXPECT_FALSE(policy.is_origin_allowed("https://example.com:8443")); // 精确源仍需完全一致
+        EXPECT_EQ(policy.response_origin(), "https://example.com");
+    }
+
+    TEST(CorsPolicyTest, PreflightHeadIsCachedPerExactOrigin)
+    {
+        const CorsPolicy policy(policy_config({"https://example.com", "*.example.org"}));
+
+        const auto head = policy.preflight_head("https://example.com", "HTTP/1.1");
+        ASSERT_NE(head, nullptr);
+        EXPECT_EQ(head, policy.preflight_head("https://example.com", "HTTP/1.1")); // 同一份缓存
+        EXPECT_EQ(*head, "HTTP/1.1 204 No Content\r\n"
+                         "Access-Control-Allow-Origin: https://example.com\r\n"
+                         "Access-Control-Allow-Methods: GET,POST\r\n"
+                         "Access-Control-Allow-Headers: Content-Type\r\n"
+                         "Access-Control-Max-Age: 60\r\n");
+        EXPECT_EQ(policy.preflight_head("https://example.com", "HTTP/1.0")->rfind("HTTP/1.0 204", 0), 0u);
+
+        const auto wildcard = policy.preflight_head("https://x.example.org", "HTTP/1.1");
+        ASSERT_NE(wildcard, nullptr);
+        EXPECT_NE(wildcard->find("Access-Control-Allow-Origin: https://x.example.org\r\n"), std::string::npos);
+
+        EXPECT_EQ(policy.preflight_head("https://evil.com", "HTTP/1.1"), nullptr);
+        EXPECT_EQ(policy.preflight_head("https://example.com", "HTTP/2"), nullptr);
+    }
+
+    TEST(CorsPolicyTest, SerializedHeadKeepsConnectionHeader)
+    {
+        const CorsPolicy policy(policy_config({}));
+        EXPECT_TRUE(policy.is_origin_allowed("https://anything.net"));
+        EXPECT_EQ(policy.response_origin(), "*");
+
+        HttpResponse response;
+        response.set_keep_alive(true);
+        response.set_body("stale");
+        response.set_serialized_head(policy.preflight_head("https://anything.net", "HTTP/1.1"),
+                                     HttpResponse::StatusCode::NoContent);
+        response.set_header("X-Request-Id", "42");
+
+        const std::string wire = serialize(response);
+        EXPECT_EQ(wire.rfind("HTTP/1.1 204 No Content\r\nAccess-Control-Allow-Origin: https://anything.net\r\n", 0),
+                  0u);
+        EXPECT_NE(wire.find("Connection: keep-alive\r\n"), std::string::npos);
+        EXPECT_NE(wire.find("X-Request-Id: 42\r\n"), std::string::npos);
+        EXPECT_EQ(wire.substr(wire.size() - 4), "\r\n\r\n");
+        EXPECT_EQ(response.get_status_code(), HttpResponse::StatusCode::NoContent);
+    }
+} // namespace zhttp::zmiddleware
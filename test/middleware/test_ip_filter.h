@@ -0,0 +1,282 @@
+#pragma once
+
+#include "middleware/ipfilter/ip_filter_middle.h"
+#include "middleware/middleware_chain.h"
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <unistd.h>
+
+namespace zhttp::zmiddleware
+{
+    namespace
+    {
+        IpAddress ip(const std::string_view text)
+        {
+            IpAddress address;
+            EXPECT_TRUE(IpAddress::parse(text, address)) << text;
+            return address;
+        }
+
+        HttpRequest request_from(const std::string &peer, const std::string &forwarded = "")
+        {
+            HttpRequest request;
+            request.set_remote_address(peer);
+            if (!forwarded.empty())
+            {
+                request.set_header("X-Forwarded-For", forwarded);
+            }
+            return request;
+        }
+    }
+
+    TEST(IpTrieTest, ParseAddresses)
+    {
+        IpAddress address;
+        EXPECT_TRUE(IpAddress::parse("192.168.1.1", address));
+        EXPECT_TRUE(address.is_v4());
+        EXPECT_TRUE(IpAddress::parse("2001:db8::1", address));
+        EXPECT_FALSE(address.is_v4());
+        EXPECT_TRUE(IpAddress::parse("::ffff:10.0.0.1", address));
+        EXPECT_TRUE(address.is_v4());
+
+        EXPECT_FALSE(IpAddress::parse("256.1.1.1", address));
+        EXPECT_FALSE(IpAddress::parse("1.2.3", address));
+        EXPECT_FALSE(IpAddress::parse("1::2::3", address));
+        EXPECT_FALSE(IpAddress::parse("", address));
+    }
+
+    TEST(IpTrieTest, LongestPrefixMatch)
+    {
+        IpTrie trie;
+        ASSERT_TRUE(trie.insert("10.0.0.0/8", IpTrie::Action::Deny));
+        ASSERT_TRUE(trie.insert("10.1.0.0/16", IpTrie::Action::Allow));
+        ASSERT_TRUE(trie.insert("10.1.2.3", IpTrie::Action::Deny));
+        ASSERT_TRUE(trie.insert("2001:db8::/32", IpTrie::Action::Deny));
+        EXPECT_FALSE(trie.insert("10.0.0.0/33", IpTrie::Action::Deny));
+        EXPECT_FALSE(trie.insert("not-an-ip", IpTrie::Action::Deny));
+        EXPECT_EQ(trie.size(), 4u);
+
+        EXPECT_EQ(trie.lookup(ip("10.9.9.9")), IpTrie::Action::Deny);
+        EXPECT_EQ(trie.lookup(ip("10.1.9.9")), IpTrie::Action::Allow);
+        EXPECT_EQ(trie.lookup(ip("10.1.2.3")), IpTrie::Action::Deny);
+        EXPECT_EQ(trie.lookup(ip("11.0.0.1")), IpTrie::Action::None);
+        EXPECT_EQ(trie.lookup(ip("2001:db8:1::5")), IpTrie::Action::Deny);
+        EXPECT_EQ(trie.lookup(ip("2001:db9::5")), IpTrie::Action::None);
+        // IPv4规则不会匹配到普通IPv6地址
+        EXPECT_EQ(trie.lookup(ip("a00::1")), IpTrie::Action::None);
+    }
+
+    TEST(IpTrieTest, SplitAndOverride)
+    {
+        IpTrie trie;
+        // 先插入两个兄弟前缀，迫使中间生成无规则的分叉节点
+        trie.insert("192.168.1.0/24", IpTrie::Action::Deny);
+        trie.insert("192.168.2.0/24", IpTrie::Action::Deny);
+        EXPECT_EQ(trie.lookup(ip("192.168.3.1")), IpTrie::Action::None);
+        EXPECT_EQ(trie.lookup(ip("192.168.2.7")), IpTrie::Action::Deny);
+
+        // 在分叉点上插入规则，以及覆盖已有规则
+        trie.insert("192.168.0.0/16", IpTrie::Action::Allow);
+        trie.insert("192.168.1.0/24", IpTrie::Action::Allow);
+        EXPECT_EQ(trie.lookup(ip("192.168.3.1")), IpTrie::Action::Allow);
+        EXPECT_EQ(trie.lookup(ip("192.168.1.1")), IpTrie::Action::Allow);
+        EXPECT_EQ(trie.size(), 3u);
+
+        // 0.0.0.0/0只覆盖IPv4
+        trie.insert("0.0.0.0/0", IpTrie::Action::Deny);
+        EXPECT_EQ(trie.lookup(ip("8.8.8.8")), IpTrie::Action::Deny);
+        EXPECT_EQ(trie.lookup(ip("::1")), IpTrie::Action::None);
+    }
+
+    TEST(IpTrieTest, CompiledIndexMatchesWalk)
+    {
+        std::mt19937 rng(7);
+        IpTrie trie;
+        trie.insert("0.0.0.0/1", IpTrie::Action::Allow);
+        trie.insert("10.0.0.0/8", IpTrie::Action::Deny);
+        for (int i = 0; i < 2000; ++i)
+        {
+            const IpAddress prefix = IpAddress::from_v4(rng());
+            trie.insert(prefix, 96 + 8 + rng() % 25, i % 2 ? IpTrie::Action::Deny : IpTrie::Action::Allow);
+        }
+
+        const IpTrie plain = trie;
+        trie.compile();
+        for (int i = 0; i < 100000; ++i)
+        {
+            const IpAddress address = IpAddress::from_v4(rng());
+            ASSERT_EQ(trie.lookup(address), plain.lookup(address));
+        }
+        EXPECT_EQ(trie.lookup(ip("10.200.0.1")), IpTrie::Action::Deny);
+        EXPECT_EQ(trie.lookup(ip("2001:db8::1")), IpTrie::Action::None);
+
+        // 插入后索引失效，查找退回逐层下降
+        trie.insert("10.200.0.0/16", IpTrie::Action::Allow);
+        EXPECT_EQ(trie.lookup(ip("10.200.0.1")), IpTrie::Action::Allow);
+    }
+
+    TEST(IpFilterTest, AllowDenyAndDefault)
+    {
+        IpFilterConfig config;
+        config.deny_ = {"203.0.113.0/24"};
+        config.allow_ = {"203.0.113.7"};
+        IpFilterMiddleware filter(config);
+        EXPECT_EQ(filter.rule_count(), 2u);
+
+        EXPECT_FALSE(filter.allow_address(ip("203.0.113.1")));
+        EXPECT_TRUE(filter.allow_address(ip("203.0.113.7")));
+        EXPECT_TRUE(filter.allow_address(ip("198.51.100.1")));
+
+        config.deny_by_default_ = true;
+        IpFilterMiddleware whitelist(config);
+        EXPECT_FALSE(whitelist.allow_address(ip("198.51.100.1")));
+        EXPECT_TRUE(whitelist.allow_address(ip("203.0.113.7")));
+    }
+
+    TEST(IpFilterTest, ConnectionCheck)
+    {
+        IpFilterConfig config;
+        config.deny_ = {"127.0.0.0/8", "::1"};
+        IpFilterMiddleware filter(config);
+
+        sockaddr_in v4{};
+        v4.sin_family = AF_INET;
+        ::inet_pton(AF_INET, "127.0.0.1", &v4.sin_addr);
+        EXPECT_FALSE(filter.allow_connection(reinterpret_cast<const sockaddr *>(&v4)));
+        ::inet_pton(AF_INET, "192.0.2.1", &v4.sin_addr);
+        EXPECT_TRUE(filter.allow_connection(reinterpret_cast<const sockaddr *>(&v4)));
+
+        sockaddr_in6 v6{};
+        v6.sin6_family = AF_INET6;
+        ::inet_pton(AF_INET6, "::1", &v6.sin6_addr);
+        EXPECT_FALSE(filter.allow_connection(reinterpret_cast<const sockaddr *>(&v6)));
+        // 双栈套接字上的IPv4映射地址与IPv4规则一致
+        ::inet_pton(AF_INET6, "::ffff:127.0.0.1", &v6.sin6_addr);
+        EXPECT_FALSE(filter.allow_connection(reinterpret_cast<const sockaddr *>(&v6)));
+    }
+
+    TEST(IpFilterTest, RulesFileAndReload)
+    {
+        char path[] = "/tmp/zhttp_ip_rules_XXXXXX";
+        const int fd = ::mkstemp(path);
+        ASSERT_GE(fd, 0);
+        ::close(fd);
+        {
+            std::ofstream out(path);
+            out << "# blocked ranges\n"
+                << "198.51.100.0/24\n"
+                << "deny 2001:db8::/48\n"
+                << "allow 198.51.100.10\r\n"
+                << "bogus line\n";
+        }
+
+        IpTrie trie;
+        EXPECT_EQ(IpFilterMiddleware::load_file(path, trie), 1);
+        EXPECT_EQ(trie.size(), 3u);
+        EXPECT_EQ(IpFilterMiddleware::load_file("/nonexistent/rules", trie), -1);
+
+        IpFilterConfig config;
+        config.rules_file_ = path;
+        IpFilterMiddleware filter(config);
+        EXPECT_FALSE(filter.allow_address(ip("198.51.100.1")));
+        EXPECT_TRUE(filter.allow_address(ip("198.51.100.10")));
+        EXPECT_FALSE(filter.allow_address(ip("2001:db8::1")));
+
+        {
+            std::ofstream out(path);
+            out << "192.0.2.0/24\n";
+        }
+        EXPECT_TRUE(filter.reload());
+        EXPECT_TRUE(filter.allow_address(ip("198.51.100.1")));
+        EXPECT_FALSE(filter.allow_address(ip("192.0.2.5")));
+
+        // 文件消失时保留原规则
+        ::unlink(path);
+        EXPECT_FALSE(filter.reload());
+        EXPECT_FALSE(filter.allow_address(ip("192.0.2.5")));
+    }
+
+    TEST(IpFilterTest, ForwardedForFromTrustedProxy)
+    {
+        IpFilterConfig config;
+        config.deny_ = {"198.51.100.0/24", "10.0.0.0/8"};
+        config.trust_forwarded_for_ = true;
+        config.trusted_proxies_ = {"10.0.0.0/8"};
+        IpFilterMiddleware filter(config);
+
+        // 可信代理的连接放行，按请求判断
+        sockaddr_in proxy{};
+        proxy.sin_family = AF_INET;
+        ::inet_pton(AF_INET, "10.0.0.2", &proxy.sin_addr);
+        EXPECT_TRUE(filter.allow_connection(reinterpret_cast<const sockaddr *>(&proxy)));
+
+        EXPECT_FALSE(filter.allow_request(request_from("10.0.0.2", "198.51.100.9")));
+        EXPECT_TRUE(filter.allow_request(request_from("10.0.0.2", "192.0.2.1")));
+        // 多级代理：跳过右侧的可信代理
+        EXPECT_FALSE(filter.allow_request(request_from("10.0.0.2", "192.0.2.1, 198.51.100.9, 10.0.0.3")));
+        // 客户端伪造的最左侧条目不起作用
+        EXPECT_TRUE(filter.allow_request(request_from("10.0.0.2", "198.51.100.9, 192.0.2.1")));
+        // 非代理对端的XFF被忽略
+        EXPECT_FALSE(filter.allow_request(request_from("198.51.100.9", "192.0.2.1")));
+        // 没有XFF时按代理本身判断
+        EXPECT_FALSE(filter.allow_request(request_from("10.0.0.2")));
+    }
+
+    TEST(IpFilterTest, HandleRejectsWith403)
+    {
+        IpFilterConfig config;
+        config.deny_ = {"198.51.100.0/24"};
+        const auto filter = std::make_shared<IpFilterMiddleware>(config);
+        MiddlewareChain chain({filter});
+
+        HttpRequest request = request_from("198.51.100.9");
+        HttpResponse response;
+        MiddlewareContext context(request, response);
+        bool reached = false;
+        const Next::Terminal terminal = [&reached](MiddlewareContext &) { reached = true; };
+        EXPECT_NO_THROW(chain.run(context, terminal));
+        EXPECT_FALSE(reached);
+        EXPECT_EQ(response.get_status_code(), HttpResponse::StatusCode::Forbidden);
+        EXPECT_THROW(filter->before(request), HttpResponse);
+
+        HttpRequest allowed = request_from("192.0.2.1");
+        EXPECT_NO_THROW(filter->before(allowed));
+
+        // 路由之前的检查不依赖中间件管线
+        HttpResponse rejected;
+        EXPECT_FALSE(filter->filter_request(request, rejected));
+        EXPECT_EQ(rejected.get_status_code(), HttpResponse::StatusCode::Forbidden);
+        HttpResponse passed;
+        passed.set_status_code(HttpResponse::StatusCode::OK);
+        EXPECT_TRUE(filter->filter_request(allowed, passed));
+        EXPECT_EQ(passed.get_status_code(), HttpResponse::StatusCode::OK);
+    }
+
+    TEST(IpFilterTest, SwapRulesWhileReading)
+    {
+        IpFilterMiddleware filter;
+        std::atomic<bool> stop{false};
+        std::thread reader([&]
+        {
+            const IpAddress address = ip("192.0.2.1");
+            while (!stop.load())
+            {
+                filter.allow_address(address);
+            }
+        });
+        for (int i = 0; i < 200; ++i)
+        {
+            auto rules = std::make_unique<IpTrie>();
+            rules->insert("192.0.2.0/24", i % 2 ? IpTrie::Action::Deny : IpTrie::Action::Allow);
+            filter.set_rules(std::move(rules));
+        }
+        stop = true;
+        reader.join();
+        EXPECT_FALSE(filter.allow_address(ip("192.0.2.1")));
+    }
+} // namespace zhttp::zmiddleware
@@ -0,0 +1,317 @@
+#pragma once
+
+#include "middleware/auth/jwt_middle.h"
+#include "middleware/middleware_chain.h"
+#include <gtest/gtest.h>
+#include <openssl/core_names.h>
+#include <openssl/ecdsa.h>
+#include <openssl/evp.h>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <unistd.h>
+
+namespace zhttp::zmiddleware
+{
+    namespace
+    {
+        // 测试用密钥：生成密钥对，导出JWK并签发令牌
+        struct TestKey
+        {
+            std::shared_ptr<EVP_PKEY> key_;
+            std::string kid_;
+            bool ec_;
+
+            static TestKey rsa(std::string kid)
+            {
+                return TestKey{std::shared_ptr<EVP_PKEY>(EVP_PKEY_Q_keygen(nullptr, nullptr, "RSA", size_t{2048}),
+                                                         EVP_PKEY_free), std::move(kid), false};
+            }
+
+            static TestKey ec(std::string kid)
+            {
+                return TestKey{std::shared_ptr<EVP_PKEY>(EVP_PKEY_Q_keygen(nullptr, nullptr, "EC", "P-256"),
+                                                         EVP_PKEY_free), std::move(kid), true};
+            }
+
+            static std::string bn_param(EVP_PKEY *key, const char *name)
+            {
+                BIGNUM *bn = nullptr;
+                EVP_PKEY_get_bn_param(key, name, &bn);
+                std::string bytes(BN_num_bytes(bn), '\0');
+                BN_bn2bin(bn, reinterpret_cast<unsigned char *>(bytes.data()));
+                BN_free(bn);
+                return bytes;
+            }
+
+            nlohmann::json jwk() const
+            {
+                nlohmann::json jwk{{"kid", kid_}, {"use", "sig"}};
+                if (ec_)
+                {
+                    unsigned char point[65];
+                    size_t length = 0;
+                    EVP_PKEY_get_octet_string_param(key_.get(), OSSL_PKEY_PARAM_PUB_KEY, point, sizeof(point), &length);
+                    jwk["kty"] = "EC";
+                    jwk["crv"] = "P-256";
+                    jwk["x"] = jwt::base64url_encode(std::string_view(reinterpret_cast<char *>(point) + 1, 32));
+                    jwk["y"] = jwt::base64url_encode(std::string_view(reinterpret_cast<char *>(point) + 33, 32));
+                }
+                else
+                {
+                    jwk["kty"] = "RSA";
+                    jwk["n"] = jwt::base64url_encode(bn_param(key_.get(), OSSL_PKEY_PARAM_RSA_N));
+                    jwk["e"] = jwt::base64url_encode(bn_param(key_.get(), OSSL_PKEY_PARAM_RSA_E));
+                }
+                return jwk;
+            }
+
+            std::string sign(const nlohmann::json &payload, const std::string &alg = "") const
+            {
+                const nlohmann::json header{{"alg", alg.empty() ? (ec_ ? "ES256" : "RS256") : alg},
+                                            {"typ", "JWT"}, {"kid", kid_}};
+                const std::string input = jwt::base64url_encode(header.dump()) + "." +
+                                          jwt::base64url_encode(payload.dump());
+
+                EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+                size_t length = 0;
+                EVP_DigestSignInit(ctx, nullptr, EVP_sha256(), nullptr, key_.get());
+                EVP_DigestSign(ctx, nullptr, &length, reinterpret_cast<const unsigned char *>(input.data()),
+                               input.size());
+                std::string signature(length, '\0');
+                EVP_DigestSign(ctx, reinterpret_cast<unsigned char *>(signature.data()), &length,
+                               reinterpret_cast<const unsigned char *>(input.data()), input.size());
+                EVP_MD_CTX_free(ctx);
+                signature.resize(length);
+
+                if (ec_)
+                {
+                    // DER转为JWS要求的定长r||s
+                    const auto *der = reinterpret_cast<const unsigned char *>(signature.data());
+                    ECDSA_SIG *sig = d2i_ECDSA_SIG(nullptr, &der, static_cast<long>(signature.size()));
+                    std::string raw(64, '\0');
+                    BN_bn2binpad(ECDSA_SIG_get0_r(sig), reinterpret_cast<unsigned char *>(raw.data()), 32);
+                    BN_bn2binpad(ECDSA_SIG_get0_s(sig), reinterpret_cast<unsigned char *>(raw.data()) + 32, 32);
+                    ECDSA_SIG_free(sig);
+                    signature = raw;
+                }
+                return input + "." + jwt::base64url_encode(signature);
+            }
+        };
+
+        std::string jwks_of(std::initializer_list<const TestKey *> keys)
+        {
+            nlohmann::json doc{{"keys", nlohmann::json::array()}};
+            for (const TestKey *key : keys)
+            {
+                doc["keys"].push_back(key->jwk());
+            }
+            return doc.dump();
+        }
+
+        const TestKey &rsa_key()
+        {
+            static const TestKey key = TestKey::rsa("rsa-1");
+            return key;
+        }
+
+        const TestKey &ec_key()
+        {
+            static const TestKey key = TestKey::ec("ec-1");
+            return key;
+        }
+
+        nlohmann::json claims_for(const std::string &subject, const int64_t ttl = 3600)
+        {
+            const int64_t now = std::time(nullptr);
+            return {{"sub", subject}, {"iss", "zhttp"}, {"aud", {"api", "web"}}, {"iat", now}, {"exp", now + ttl}};
+        }
+    }
+
+    TEST(JwtTest, Base64Url)
+    {
+        const std::string data("\xfb\xff\x00ab?", 6);
+        const std::string encoded = jwt::base64url_encode(data);
+        EXPECT_EQ(encoded.find_first_of("+/="), std::string::npos);
+        std::string decoded;
+        ASSERT_TRUE(jwt::base64url_decode(encoded, decoded));
+        EXPECT_EQ(decoded, data);
+        EXPECT_FALSE(jwt::base64url_decode("ab+c", decoded));
+        EXPECT_FALSE(jwt::base64url_decode("abcde", decoded));
+    }
+
+    TEST(JwtTest, VerifyRs256AndEs256)
+    {
+        const auto keys = JwkSet::parse(jwks_of({&rsa_key(), &ec_key()}));
+        ASSERT_TRUE(keys);
+        ASSERT_EQ(keys->size(), 2u);
+
+        const JwtVerifier verifier(JwtVerifier::Options{"zhttp", "api", 0, true});
+        const int64_t now = std::time(nullptr);
+        for (const TestKey *key : {&rsa_key(), &ec_key()})
+        {
+            std::shared_ptr<const JwtClaims> claims;
+            ASSERT_EQ(verifier.verify(key->sign(claims_for("alice")), *keys, now, claims), JwtStatus::Ok);
+            EXPECT_EQ(claims->subject_, "alice");
+            EXPECT_EQ(claims->key_id_, key->kid_);
+            EXPECT_EQ(claims->get_string("iss"), "zhttp");
+        }
+    }
+
+    TEST(JwtTest, RejectsInvalidTokens)
+    {
+        const auto keys = JwkSet::parse(jwks_of({&rsa_key(), &ec_key()}));
+        const JwtVerifier verifier(JwtVerifier::Options{"zhttp", "api", 0, true});
+        const int64_t now = std::time(nullptr);
+        std::shared_ptr<const JwtClaims> claims;
+
+        const std::string token = rsa_key().sign(claims_for("alice"));
+        std::string tampered = token;
+        tampered[token.find('.') + 5] ^= 1; // 改动载荷
+        EXPECT_EQ(verifier.verify(tampered, *keys, now, claims), JwtStatus::BadSignature);
+        EXPECT_EQ(verifier.verify("abc.def", *keys, now, claims), JwtStatus::Malformed);
+        EXPECT_EQ(verifier.verify("a.b.c.d", *keys, now, claims), JwtStatus::Malformed);
+
+        // alg=none与算法混淆都被拒绝
+        const std::string none = jwt::base64url_encode(R"({"alg":"none"})") + "." +
+                                 jwt::base64url_encode(claims_for("eve").dump()) + ".";
+        EXPECT_EQ(verifier.verify(none, *keys, now, claims), JwtStatus::UnsupportedAlgorithm);
+        TestKey confused = rsa_key();
+        EXPECT_EQ(verifier.verify(confused.sign(claims_for("eve"), "ES256"), *keys, now, claims),
+                  JwtStatus::UnknownKey);
+
+        const TestKey stranger = TestKey::ec("ec-1");
+        EXPECT_EQ(verifier.verify(stranger.sign(claims_for("eve")), *keys, now, claims), JwtStatus::BadSignature);
+
+        EXPECT_EQ(verifier.verify(rsa_key().sign(claims_for("alice", -10)), *keys, now, claims), JwtStatus::Expired);
+        auto future = claims_for("alice");
+        future["nbf"] = now + 600;
+        EXPECT_EQ(verifier.verify(rsa_key().sign(future), *keys, now, claims), JwtStatus::NotYetValid);
+        auto other_issuer = claims_for("alice");
+        other_issuer["iss"] = "other";
+        EXPECT_EQ(verifier.verify(rsa_key().sign(other_issuer), *keys, now, claims), JwtStatus::BadIssuer);
+        auto other_audience = claims_for("alice");
+        other_audience["aud"] = "admin";
+        EXPECT_EQ(verifier.verify(rsa_key().sign(other_audience), *keys, now, claims), JwtStatus::BadAudience);
+        auto no_exp = claims_for("alice");
+        no_exp.erase("exp");
+        EXPECT_EQ(verifier.verify(rsa_key().sign(no_exp), *keys, now, claims), JwtStatus::Malformed);
+
+        // 超出范围的时间声明被拒绝，不参与可能溢出的运算
+        for (const nlohmann::json &exp : {nlohmann::json(std::numeric_limits<int64_t>::max()),
+                                          nlohmann::json(std::numeric_limits<uint64_t>::max()),
+                                          nlohmann::json(1e300), nlohmann::json(-1e300)})
+        {
+            auto huge = claims_for("alice");
+            huge["exp"] = exp;
+            EXPECT_EQ(verifier.verify(rsa_key().sign(huge), *keys, now, claims), JwtStatus::Malformed) << exp;
+        }
+        EXPECT_THROW(JwtVerifier(JwtVerifier::Options{"zhttp", "api", -1, true}), std::invalid_argument);
+        EXPECT_THROW(JwtVerifier(JwtVerifier::Options{"zhttp", "api", std::numeric_limits<int64_t>::max(), true}),
+                     std::invalid_argument);
+    }
+
+    TEST(JwtTest, JwksSkipsUnsupportedKeys)
+    {
+        nlohmann::json doc = nlohmann::json::parse(jwks_of({&rsa_key()}));
+        doc["keys"].push_back({{"kty", "oct"}, {"k", "c2VjcmV0"}});
+        doc["keys"].push_back({{"kty", "RSA"}, {"kid", "enc"}, {"use", "enc"}});
+        doc["keys"].push_back({{"kty", "RSA"}, {"kid", "short"}, {"n", "AQAB"}, {"e", "AQAB"}});
+        size_t skipped = 0;
+        const auto keys = JwkSet::parse(doc.dump(), &skipped);
+        ASSERT_TRUE(keys);
+        EXPECT_EQ(keys->size(), 1u);
+        EXPECT_EQ(skipped, 3u);
+        EXPECT_FALSE(JwkSet::parse("not json"));
+    }
+
+    TEST(JwtMiddlewareTest, CachesVerifiedTokensAndExposesClaims)
+    {
+        const auto middleware = std::make_shared<JwtAuthMiddleware>();
+        middleware->set_keys(JwkSet::parse(jwks_of({&ec_key()})));
+        MiddlewareChain chain({middleware});
+
+        const std::string token = ec_key().sign(claims_for("bob"));
+        std::string seen;
+        const Next::Terminal terminal = [&seen](MiddlewareContext &context)
+        {
+            const JwtClaims *claims = JwtAuthMiddleware::claims(context.request());
+            seen = claims ? claims->subject_ : "";
+        };
+
+        for (int i = 0; i < 3; ++i)
+        {
+            HttpRequest request;
+            request.set_header("Authorization", "Bearer " + token);
+            HttpResponse response;
+            MiddlewareContext context(request, response);
+            chain.run(context, terminal);
+            EXPECT_EQ(seen, "bob");
+            ASSERT_NE(context.get<std::shared_ptr<const JwtClaims>>(JwtAuthMiddleware::kClaimsKey), nullptr);
+        }
+        EXPECT_EQ(middleware->cached_tokens(), 1u);
+
+        // 替换密钥后缓存失效，旧密钥签发的令牌被拒绝
+        middleware->set_keys(JwkSet::parse(jwks_of({&rsa_key()})));
+        EXPECT_EQ(middleware->cached_tokens(), 0u);
+        std::shared_ptr<const JwtClaims> claims;
+        EXPECT_EQ(middleware->verify(token, claims), JwtStatus::UnknownKey);
+    }
+
+    TEST(JwtMiddlewareTest, RejectsWith401)
+    {
+        const auto middleware = std::make_shared<JwtAuthMiddleware>();
+        middleware->set_keys(JwkSet::parse(jwks_of({&rsa_key()})));
+
+        HttpRequest missing;
+        HttpResponse response;
+        MiddlewareContext context(missing, response);
+        bool reached = false;
+        middleware->process(context, [&reached] { reached = true; });
+        EXPECT_EQ(response.get_status_code(), HttpResponse::StatusCode::Unauthorized);
+        EXPECT_EQ(response.get_header("WWW-Authenticate"), "Bearer");
+        EXPECT_FALSE(reached);
+
+        HttpRequest bad;
+        bad.set_header("Authorization", "Bearer " + rsa_key().sign(claims_for("alice", -100)));
+        EXPECT_THROW(middleware->before(bad), HttpResponse);
+
+        HttpRequest good;
+        good.set_header("Authorization", "bearer " + rsa_key().sign(claims_for("alice")));
+        EXPECT_NO_THROW(middleware->before(good));
+        ASSERT_NE(JwtAuthMiddleware::claims(good), nullptr);
+        EXPECT_EQ(JwtAuthMiddleware::claims(good)->subject_, "alice");
+
+        JwtConfig config;
+        config.optional_ = true;
+        JwtAuthMiddleware optional(config);
+        HttpRequest anonymous;
+        EXPECT_NO_THROW(optional.before(anonymous));
+        EXPECT_EQ(JwtAuthMiddleware::claims(anonymous), nullptr);
+    }
+
+    TEST(JwtMiddlewareTest, ReloadsJwksFile)
+    {
+        char path[] = "/tmp/zhttp_jwks_XXXXXX";
+        const int fd = ::mkstemp(path);
+        ASSERT_GE(fd, 0);
+        ::close(fd);
+        std::ofstream(path) << jwks_of({&rsa_key()});
+
+        JwtConfig config;
+        config.jwks_file_ = path;
+        config.reload_interval_ = 0;
+        JwtAuthMiddleware middleware(config);
+        EXPECT_EQ(middleware.key_count(), 1u);
+
+        std::ofstream(path) << jwks_of({&rsa_key(), &ec_key()});
+        EXPECT_TRUE(middleware.reload());
+        EXPECT_EQ(middleware.key_count(), 2u);
+
+        // 内容损坏时保留原密钥
+        std::ofstream(path) << "{";
+        EXPECT_FALSE(middleware.reload());
+        EXPECT_EQ(middleware.key_count(), 2u);
+        ::unlink(path);
+    }
+} // namespace zhttp::zmiddleware
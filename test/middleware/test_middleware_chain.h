@@ -115,4 +115,67 @@ namespace zhttp::zmiddleware
         EXPECT_NO_THROW(chain.process_before(req));
         EXPECT_NO_THROW(chain.process_after(res));
     }
+
+    // 短路并保存请求状态的洋葱式中间件
+    class GateMiddleware : public Middleware
+    {
+    public:
+        void handle(MiddlewareContext &context, const Next &next) override
+        {
+            if (context.request().get_header("X-Token") != "ok")
+            {
+                context.response().set_status_code(HttpResponse::StatusCode::Unauthorized);
+                return;
+            }
+            context.set<std::string>("user", "alice");
+            next();
+            context.response().set_header("X-Gate", "passed");
+        }
+
+        void before(HttpRequest &) override {}
+
+        void after(HttpResponse &) override {}
+    };
+
+    TEST(MiddlewareChainTest, OnionOrderWithAdapters)
+    {
+        TrackingMiddleware::call_order.clear();
+        MiddlewareChain chain({std::make_shared<TrackingMiddleware>(1), std::make_shared<TrackingMiddleware>(2)});
+
+        HttpRequest req;
+        HttpResponse res;
+        MiddlewareContext context(req, res);
+        chain.run(context, [](MiddlewareContext &) { TrackingMiddleware::call_order.push_back(0); });
+
+        EXPECT_EQ(TrackingMiddleware::call_order, (std::vector<int>{1, 2, 0, -2, -1}));
+    }
+
+    TEST(MiddlewareChainTest, ShortCircuitWithoutThrow)
+    {
+        TrackingMiddleware::call_order.clear();
+        MiddlewareChain chain({std::make_shared<TrackingMiddleware>(1), std::make_shared<GateMiddleware>()});
+
+        HttpRequest req;
+        HttpResponse res;
+        bool handled = false;
+        const Next::Terminal terminal = [&handled](MiddlewareContext &context)
+        {
+            handled = context.get<std::string>("user") && *context.get<std::string>("user") == "alice";
+        };
+
+        MiddlewareContext rejected(req, res);
+        EXPECT_NO_THROW(chain.run(rejected, terminal));
+        EXPECT_FALSE(handled);
+        EXPECT_EQ(res.get_status_code(), HttpResponse::StatusCode::Unauthorized);
+        // 外层中间件仍能看到短路响应
+        EXPECT_EQ(TrackingMiddleware::call_order, (std::vector<int>{1, -1}));
+
+        req.set_header("X-Token", "ok");
+        HttpResponse accepted_res;
+        MiddlewareContext accepted(req, accepted_res);
+        chain.run(accepted, terminal);
+        EXPECT_TRUE(handled);
+        EXPECT_EQ(accepted_res.get_header("X-Gate"), "passed");
+        EXPECT_EQ(accepted.get<int>("user"), nullptr);
+    }
 } // namespace zhttp::zmiddleware
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "middleware/pipeline.h"
+#include "middleware/middleware_chain.h"
+#include "middleware/cors/cors_middle.h"
+
+namespace zhttp::zmiddleware
+{
+    namespace
+    {
+        std::vector<std::string> pipeline_trace;
+
+        // before/after式中间件
+        template<int N>
+        struct TraceHooks
+        {
+            void before(HttpRequest &) { pipeline_trace.push_back("b" + std::to_string(N)); }
+
+            void after(HttpResponse &) { pipeline_trace.push_back("a" + std::to_string(N)); }
+        };
+
+        // process式中间件，X-Block请求头存在时短路
+        struct TraceGate
+        {
+            template<typename NextFn>
+            void process(MiddlewareContext &context, NextFn &&next)
+            {
+                pipeline_trace.emplace_back("gate");
+                if (!context.request().get_header("X-Block").empty())
+                {
+                    context.response().set_status_code(HttpResponse::StatusCode::Forbidden);
+                    return;
+                }
+                context.set<int>("depth", 2);
+                next();
+            }
+        };
+    }
+
+    TEST(PipelineTest, OnionOrderAndShortCircuit)
+    {
+        Pipeline<TraceHooks<1>, TraceGate, TraceHooks<2>> pipeline;
+        static_assert(decltype(pipeline)::size() == 3);
+
+        HttpRequest req;
+        HttpResponse res;
+        MiddlewareContext context(req, res);
+        pipeline_trace.clear();
+        pipeline.run(context, [](MiddlewareContext &ctx)
+        {
+            pipeline_trace.push_back("handler" + std::to_string(*ctx.get<int>("depth")));
+        });
+        EXPECT_EQ(pipeline_trace, (std::vector<std::string>{"b1", "gate", "b2", "handler2", "a2", "a1"}));
+
+        req.set_header("X-Block", "1");
+        HttpResponse blocked;
+        MiddlewareContext blocked_context(req, blocked);
+        pipeline_trace.clear();
+        pipeline.run(blocked_context, [](MiddlewareContext &) { pipeline_trace.emplace_back("handler"); });
+        EXPECT_EQ(pipeline_trace, (std::vector<std::string>{"b1", "gate", "a1"}));
+        EXPECT_EQ(blocked.get_status_code(), HttpResponse::StatusCode::Forbidden);
+    }
+
+    TEST(PipelineTest, StaticMiddlewareInsideRuntimeChain)
+    {
+        auto group = std::make_shared<StaticMiddleware<TraceHooks<1>, CorsMiddleware>>();
+        MiddlewareChain chain({group, std::make_shared<StaticMiddleware<TraceHooks<2>>>()});
+
+        // 跨域预检在静态管线中短路，外层的after仍然执行
+        HttpRequest req;
+        req.set_method(HttpRequest::Method::OPTIONS);
+        req.set_version("HTTP/1.1");
+        req.set_header("Origin", "https://example.com");
+        HttpResponse res;
+        MiddlewareContext context(req, res);
+        pipeline_trace.clear();
+        chain.run(context, [](MiddlewareContext &) { pipeline_trace.emplace_back("handler"); });
+        EXPECT_EQ(pipeline_trace, (std::vector<std::string>{"b1", "a1"}));
+        EXPECT_EQ(res.get_status_code(), HttpResponse::StatusCode::NoContent);
+
+        // before/after接口按顺序与逆序转发
+        pipeline_trace.clear();
+        HttpRequest get;
+        chain.process_before(get);
+        chain.process_after(res);
+        EXPECT_EQ(pipeline_trace, (std::vector<std::string>{"b1", "b2", "a2", "a1"}));
+
+        // 只有process的中间件无法拆成两个阶段：Pipeline::before/after编译期拒绝，包装后调用时报错
+        static_assert(!detail::all_before_after<TraceHooks<1>, TraceGate>);
+        StaticMiddleware<TraceHooks<1>, TraceGate> gated;
+        EXPECT_THROW(gated.before(get), std::logic_error);
+        EXPECT_THROW(gated.after(res), std::logic_error);
+    }
+} // namespace zhttp::zmiddleware
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "middleware/ratelimit/rate_limit_middle.h"
+#include <gtest/gtest.h>
+
+namespace zhttp::zmiddleware
+{
+    // 调用before并捕获短路响应
+    inline bool rate_limited(RateLimitMiddleware &middleware, HttpRequest &request, HttpResponse &out_response)
+    {
+        try
+        {
+            middleware.before(request);
+        } catch (const HttpResponse &resp)
+        {
+            out_response = resp;
+            return true;
+        }
+        return false;
+    }
+
+    TEST(TokenBucketTableTest, BurstThenRefill)
+    {
+        TokenBucketTable table(10.0, 3, 4); // 每秒10个令牌，容量3
+        const int64_t now = TokenBucketTable::now_ms();
+
+        EXPECT_TRUE(table.try_acquire("k", now));
+        EXPECT_TRUE(table.try_acquire("k", now));
+        EXPECT_TRUE(table.try_acquire("k", now));
+        EXPECT_FALSE(table.try_acquire("k", now));
+
+        // 100ms 补充一个令牌
+        EXPECT_TRUE(table.try_acquire("k", now + 100));
+        EXPECT_FALSE(table.try_acquire("k", now + 100));
+    }
+
+    TEST(TokenBucketTableTest, KeysAreIndependent)
+    {
+        TokenBucketTable table(1.0, 1, 4);
+        const int64_t now = TokenBucketTable::now_ms();
+
+        EXPECT_TRUE(table.try_acquire("a", now));
+        EXPECT_FALSE(table.try_acquire("a", now));
+        EXPECT_TRUE(table.try_acquire("b", now));
+        EXPECT_EQ(table.size(), 2u);
+    }
+
+    TEST(TokenBucketTableTest, EvictIdleKeys)
+    {
+        TokenBucketTable table(10.0, 2, 4); // 0.2s 即可填满
+        const int64_t now = TokenBucketTable::now_ms();
+
+        table.try_acquire("idle", now);
+        table.try_acquire("busy", now + 5000);
+
+        EXPECT_EQ(table.evict_idle(now + 5000, 1000), 1u);
+        EXPECT_EQ(table.size(), 1u);
+        // 被淘汰的键再次出现时是满桶
+        EXPECT_TRUE(table.try_acquire("idle", now + 5000));
+        EXPECT_TRUE(table.try_acquire("idle", now + 5000));
+        EXPECT_FALSE(table.try_acquire("idle", now + 5000));
+    }
+
+    TEST(RateLimitMiddlewareTest, RejectsWith429ByIp)
+    {
+        RateLimitConfig config;
+        config.rate_ = 0.001;
+        config.burst_ = 2;
+        RateLimitMiddleware middleware(config);
+
+        HttpRequest req;
+        req.set_version("HTTP/1.1");
+        req.set_remote_address("10.0.0.1");
+        HttpResponse resp;
+
+        EXPECT_FALSE(rate_limited(middleware, req, resp));
+        EXPECT_FALSE(rate_limited(middleware, req, resp));
+        ASSERT_TRUE(rate_limited(middleware, req, resp));
+        EXPECT_EQ(resp.get_status_code(), HttpResponse::StatusCode::TooManyRequests);
+        EXPECT_FALSE(resp.get_header("Retry-After").empty());
+
+        HttpRequest other;
+        other.set_remote_address("10.0.0.2");
+        EXPECT_FALSE(rate_limited(middleware, other, resp));
+        EXPECT_EQ(middleware.tracked_keys(), 2u);
+    }
+
+    TEST(RateLimitMiddlewareTest, KeyByHeaderFallsBackToIp)
+    {
+        RateLimitConfig config;
+        config.key_type_ = RateLimitKeyType::HEADER;
+        config.key_header_ = "X-Api-Key";
+        config.rate_ = 0.001;
+        config.burst_ = 1;
+        RateLimitMiddleware middleware(config);
+        HttpResponse resp;
+
+        HttpRequest a;
+        a.set_remote_address("10.0.0.1");
+        a.set_header("X-Api-Key", "key-a");
+        HttpRequest b;
+        b.set_remote_address("10.0.0.1");
+        b.set_header("X-Api-Key", "key-b");
+        HttpRequest no_key;
+        no_key.set_remote_address("10.0.0.1");
+
+        EXPECT_FALSE(rate_limited(middleware, a, resp));
+        EXPECT_TRUE(rate_limited(middleware, a, resp));
+        EXPECT_FALSE(rate_limited(middleware, b, resp)); // 同IP不同键
+        EXPECT_FALSE(rate_limited(middleware, no_key, resp));
+        EXPECT_TRUE(rate_limited(middleware, no_key, resp));
+    }
+} // namespace zhttp::zmiddleware
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "router/radix_tree.h"
+#include "router/router.h"
+
+namespace zhttp::zrouter
+{
+    namespace
+    {
+        RouteTarget body_target(const std::string &body)
+        {
+            return RouteTarget{nullptr, [body](const HttpRequest &, HttpResponse *resp) { resp->set_body(body); }};
+        }
+
+        std::string find_body(const RadixTree &tree, HttpRequest &req)
+        {
+            const RouteTarget *target = tree.find(req);
+            if (!target)
+            {
+                return "<none>";
+            }
+            HttpResponse resp;
+            (*target)(req, &resp);
+            return resp.get_body();
+        }
+
+        HttpRequest make_request(const HttpRequest::Method method, const std::string &path)
+        {
+            HttpRequest req;
+            req.set_method(method);
+            req.set_path(path);
+            return req;
+        }
+    }
+
+    TEST(RadixTreeTest, NamedParameters)
+    {
+        RadixTree tree;
+        tree.insert("/users/:id/posts/:post_id", HttpRequest::Method::GET, body_target("post"));
+
+        HttpRequest req = make_request(HttpRequest::Method::GET, "/users/42/posts/hello");
+        EXPECT_EQ(find_body(tree, req), "post");
+        EXPECT_EQ(req.get_path_parameter("id"), "42");
+        EXPECT_EQ(req.get_path_parameter("post_id"), "hello");
+        EXPECT_EQ(req.get_path_parameters("param2"), "hello"); // 按位置兼容
+
+        HttpRequest miss = make_request(HttpRequest::Method::GET, "/users/42/posts");
+        EXPECT_EQ(find_body(tree, miss), "<none>");
+        EXPECT_TRUE(miss.get_path_parameter_list().empty());
+    }
+
+    TEST(RadixTreeTest, StaticOverParamWithBacktracking)
+    {
+        RadixTree tree;
+        tree.insert("/users/new", HttpRequest::Method::GET, body_target("new"));
+        tree.insert("/users/:id", HttpRequest::Method::GET, body_target("user"));
+        tree.insert("/users/:id/edit", HttpRequest::Method::GET, body_target("edit"));
+
+        HttpRequest new_req = make_request(HttpRequest::Method::GET, "/users/new");
+        EXPECT_EQ(find_body(tree, new_req), "new");
+        EXPECT_TRUE(new_req.get_path_parameter_list().empty());
+
+        HttpRequest newer = make_request(HttpRequest::Method::GET, "/users/newer");
+        EXPECT_EQ(find_body(tree, newer), "user");
+        EXPECT_EQ(newer.get_path_parameter("id"), "newer");
+
+        // 静态分支"new"之后没有"/edit"，回溯到参数分支
+        HttpRequest edit = make_request(HttpRequest::Method::GET, "/users/new/edit");
+        EXPECT_EQ(find_body(tree, edit), "edit");
+        EXPECT_EQ(edit.get_path_parameter("id"), "new");
+    }
+
+    TEST(RadixTreeTest, WildcardAndMethods)
+    {
+        RadixTree tree;
+        tree.insert("/static/*filepath", HttpRequest::Method::GET, body_target("file"));
+        tree.insert("/static/index", HttpRequest::Method::GET, body_target("index"));
+        tree.insert("/static/*filepath", HttpRequest::Method::DELETE, body_target("delete"));
+        EXPECT_EQ(tree.size(), 3u);
+
+        HttpRequest file = make_request(HttpRequest::Method::GET, "/static/css/site/main");
+        EXPECT_EQ(find_body(tree, file), "file");
+        EXPECT_EQ(file.get_path_parameter("filepath"), "css/site/main");
+
+        HttpRequest index = make_request(HttpRequest::Method::GET, "/static/index");
+        EXPECT_EQ(find_body(tree, index), "index");
+
+        HttpRequest del = make_request(HttpRequest::Method::DELETE, "/static/index");
+        EXPECT_EQ(find_body(tree, del), "delete");
+
+        HttpRequest post = make_request(HttpRequest::Method::POST, "/static/index");
+        EXPECT_EQ(find_body(tree, post), "<none>");
+    }
+
+    TEST(RadixTreeTest, PrefixSplitting)
+    {
+        RadixTree tree;
+        tree.insert("/search", HttpRequest::Method::GET, body_target("search"));
+        tree.insert("/support", HttpRequest::Method::GET, body_target("support"));
+        tree.insert("/se", HttpRequest::Method::GET, body_target("se"));
+
+        for (const auto &path : {"/search", "/support", "/se"})
+        {
+            HttpRequest req = make_request(HttpRequest::Method::GET, path);
+            EXPECT_EQ(find_body(tree, req), std::string(path).substr(1));
+        }
+        HttpRequest miss = make_request(HttpRequest::Method::GET, "/sea");
+        EXPECT_EQ(find_body(tree, miss), "<none>");
+    }
+
+    TEST(RadixTreeTest, PatternValidation)
+    {
+        EXPECT_TRUE(RadixTree::is_tree_pattern("/users/:id"));
+        EXPECT_TRUE(RadixTree::is_tree_pattern("/files/*path"));
+        EXPECT_FALSE(RadixTree::is_tree_pattern("/v[0-9]+/items"));
+        EXPECT_FALSE(RadixTree::is_tree_pattern("/files/*path/more"));
+        EXPECT_FALSE(RadixTree::is_tree_pattern("/a:b"));
+
+        RadixTree tree;
+        tree.insert("/users/:id", HttpRequest::Method::GET, body_target("a"));
+        EXPECT_THROW(tree.insert("/users/:name/x", HttpRequest::Method::GET, body_target("b")),
+                     std::invalid_argument);
+    }
+
+    TEST(RadixTreeTest, RouterUsesTreeAndRegexFallback)
+    {
+        Router router;
+        router.register_regex_callback("/items/:id", HttpRequest::Method::GET,
+                                       [](const HttpRequest &req, HttpResponse *resp)
+                                       {
+                                           resp->set_body("item:" + req.get_path_parameters("id"));
+                                       });
+        router.register_regex_callback("/v[0-9]+/items", HttpRequest::Method::GET,
+                                       [](const HttpRequest &, HttpResponse *resp) { resp->set_body("versioned"); });
+
+        HttpRequest item = make_request(HttpRequest::Method::GET, "/items/7");
+        HttpResponse item_resp;
+        EXPECT_TRUE(router.dispatch(item, &item_resp));
+        EXPECT_EQ(item_resp.get_body(), "item:7");
+        EXPECT_EQ(item.get_path_parameter("id"), "7");
+
+        HttpRequest versioned = make_request(HttpRequest::Method::GET, "/v2/items");
+        HttpResponse versioned_resp;
+        EXPECT_TRUE(router.route(versioned, &versioned_resp));
+        EXPECT_EQ(versioned_resp.get_body(), "versioned");
+    }
+} // namespace zhttp::zrouter
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <regex>
+#include "router/regex_set.h"
+#include "router/router.h"
+
+namespace zhttp::zrouter
+{
+    namespace
+    {
+        const std::vector<std::string> kRegexPatterns = {
+            R"(^/v[0-9]+/items$)",
+            R"(^/v([0-9]+)/items/([^/]+)$)",
+            R"(^/static/.*\.(css|js)$)",
+            R"(^/files/([a-z]+)\.(png|jpe?g)$)",
+            R"(^/a(b|bc)*c$)",
+            R"(^/(?:x|y){2,3}/z$)",
+            R"(^/lazy/(.*?)(\d*)$)",
+            R"(^/w/\w+-\d{2}$)",
+            R"(^/neg/[^a-c]+$)",
+        };
+
+        const std::vector<std::string> kRegexTexts = {
+            "/v1/items", "/v22/items", "/v/items", "/v3/items/abc", "/v3/items/a/b",
+            "/static/app.css", "/static/js/app.js", "/static/app.cssx", "/files/cat.png",
+            "/files/cat.jpeg", "/files/cat.jpg", "/files/Cat.png", "/abcbcc", "/ac", "/abbbc",
+            "/xy/z", "/xyx/z", "/xyxy/z", "/lazy/abc123", "/lazy/", "/w/foo_bar-12", "/w/foo-123",
+            "/neg/xyz", "/neg/xaz", "",
+        };
+    }
+
+    TEST(RegexSetTest, MatchesAgreeWithStdRegex)
+    {
+        RegexSet set;
+        std::vector<std::regex> regexes;
+        for (const auto &pattern : kRegexPatterns)
+        {
+            set.add(pattern);
+            regexes.emplace_back(pattern);
+        }
+
+        std::vector<uint32_t> matches;
+        for (const auto &text : kRegexTexts)
+        {
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < regexes.size(); ++i)
+            {
+                if (std::regex_match(text, regexes[i])) expected.push_back(i);
+            }
+            set.match(text, matches);
+            EXPECT_EQ(matches, expected) << text;
+        }
+        EXPECT_GT(set.dfa_states(), 0u);
+    }
+
+    TEST(RegexSetTest, CapturesAgreeWithStdRegex)
+    {
+        RegexSet set;
+        for (const auto &pattern : kRegexPatterns)
+        {
+            set.add(pattern);
+        }
+
+        std::vector<RegexSet::Group> groups;
+        for (uint32_t i = 0; i < kRegexPatterns.size(); ++i)
+        {
+            const std::regex regex(kRegexPatterns[i]);
+            for (const auto &text : kRegexTexts)
+            {
+                std::smatch match;
+                const bool expected = std::regex_match(text, match, regex);
+                ASSERT_EQ(set.captures(i, text, groups), expected) << kRegexPatterns[i] << " " << text;
+                if (!expected) continue;
+                ASSERT_EQ(groups.size() + 1, match.size());
+                for (size_t g = 1; g < match.size(); ++g)
+                {
+                    if (!match[g].matched)
+                    {
+                        EXPECT_EQ(groups[g - 1].first, std::string_view::npos);
+                        continue;
+                    }
+                    EXPECT_EQ(groups[g - 1].first, static_cast<size_t>(match.position(g))) << kRegexPatterns[i] << " " << text;
+                    EXPECT_EQ(groups[g - 1].second, static_cast<size_t>(match.length(g))) << kRegexPatterns[i] << " " << text;
+                }
+            }
+        }
+    }
+
+    TEST(RegexSetTest, RejectsUnsupportedSyntax)
+    {
+        RegexSet set;
+        EXPECT_THROW(set.add(R"(^/(a)\1$)"), std::invalid_argument);
+        EXPECT_THROW(set.add(R"(^/(?=a)a$)"), std::invalid_argument);
+        EXPECT_THROW(set.add(R"(^/a^b$)"), std::invalid_argument);
+        EXPECT_EQ(set.size(), 0u);
+    }
+
+    TEST(RegexSetTest, RouterUsesRegexSet)
+    {
+        Router router;
+        router.register_regex_callback(R"(/v[0-9]+/users/:id)", HttpRequest::Method::GET,
+                                       [](const HttpRequest &req, HttpResponse *resp)
+                                       {
+                                           resp->set_body("user:" + req.get_path_parameters("param1"));
+                                       });
+        router.register_regex_callback(R"(/(a)\1)", HttpRequest::Method::GET,
+                                       [](const HttpRequest &, HttpResponse *resp) { resp->set_body("backref"); });
+
+        HttpRequest req;
+        req.set_method(HttpRequest::Method::GET);
+        req.set_path("/v2/users/42");
+        HttpResponse resp;
+        EXPECT_TRUE(router.route(req, &resp));
+        EXPECT_EQ(resp.get_body(), "user:42");
+
+        // 集合不支持的语法退回std::regex
+        req.set_path("/aa");
+        EXPECT_TRUE(router.route(req, &resp));
+        EXPECT_EQ(resp.get_body(), "backref");
+
+        req.set_method(HttpRequest::Method::POST);
+        EXPECT_FALSE(router.route(req, &resp));
+    }
+} // namespace zhttp::zrouter
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "router/route_group.h"
+
+namespace zhttp::zrouter
+{
+    namespace
+    {
+        // 记录执行顺序的中间件
+        class RecordingMiddleware : public zmiddleware::Middleware
+        {
+        public:
+            RecordingMiddleware(std::string name, std::vector<std::string> *trace)
+                    : name_(std::move(name)), trace_(trace)
+            {
+            }
+
+            void before(HttpRequest &) override { trace_->push_back(name_ + ".before"); }
+
+            void after(HttpResponse &) override { trace_->push_back(name_ + ".after"); }
+
+        private:
+            std::string name_;
+            std::vector<std::string> *trace_;
+        };
+
+        bool group_dispatch(Router &router, const HttpRequest::Method method, const std::string &path,
+                            std::vector<std::string> &trace)
+        {
+            HttpRequest req;
+            req.set_method(method);
+            req.set_path(path);
+            HttpResponse resp;
+            trace.clear();
+            return router.dispatch(req, &resp);
+        }
+    }
+
+    TEST(RouteGroupTest, MiddlewareScopedToPrefix)
+    {
+        std::vector<std::string> trace;
+        auto global = std::make_shared<RecordingMiddleware>("global", &trace);
+        auto auth = std::make_shared<RecordingMiddleware>("auth", &trace);
+        auto admin = std::make_shared<RecordingMiddleware>("admin", &trace);
+
+        Router router;
+        const auto callback = [&trace](const HttpRequest &, HttpResponse *) { trace.emplace_back("handler"); };
+        router.register_callback("/health", HttpRequest::Method::GET, callback);
+
+        RouteGroup api(&router, "/api/", {auth});
+        api.Get("/users", callback);
+        api.add_regex_route(HttpRequest::Method::GET, "/users/:id", callback);
+        api.group("/admin", {admin}).Post("/reset", callback);
+        router.use("", {global});
+
+        EXPECT_TRUE(group_dispatch(router, HttpRequest::Method::GET, "/health", trace));
+        EXPECT_EQ(trace, (std::vector<std::string>{"global.before", "handler", "global.after"}));
+
+        EXPECT_TRUE(group_dispatch(router, HttpRequest::Method::GET, "/api/users/7", trace));
+        EXPECT_EQ(trace, (std::vector<std::string>{"global.before", "auth.before", "handler",
+                                                   "auth.after", "global.after"}));
+
+        EXPECT_TRUE(group_dispatch(router, HttpRequest::Method::POST, "/api/admin/reset", trace));
+        EXPECT_EQ(trace, (std::vector<std::string>{"global.before", "auth.before", "admin.before", "handler",
+                                                   "admin.after", "auth.after", "global.after"}));
+
+        // 未命中的请求不经过任何中间件
+        EXPECT_FALSE(group_dispatch(router, HttpRequest::Method::GET, "/api/missing", trace));
+        EXPECT_TRUE(trace.empty());
+    }
+
+    TEST(RouteGroupTest, PrefixMatchesWholeSegments)
+    {
+        std::vector<std::string> trace;
+        Router router;
+        const auto callback = [&trace](const HttpRequest &, HttpResponse *) { trace.emplace_back("handler"); };
+        RouteGroup(&router, "/api", {std::make_shared<RecordingMiddleware>("api", &trace)});
+        router.register_callback("/apiary", HttpRequest::Method::GET, callback);
+        router.register_callback("/api", HttpRequest::Method::GET, callback);
+
+        EXPECT_TRUE(group_dispatch(router, HttpRequest::Method::GET, "/apiary", trace));
+        EXPECT_EQ(trace, (std::vector<std::string>{"handler"}));
+        EXPECT_TRUE(group_dispatch(router, HttpRequest::Method::GET, "/api", trace));
+        EXPECT_EQ(trace.size(), 3u);
+    }
+
+    TEST(RouteGroupTest, OptionsUsesScopeOfOriginalPath)
+    {
+        std::vector<std::string> trace;
+        Router router;
+        router.register_callback("/options/method", HttpRequest::Method::OPTIONS,
+                                 [&trace](const HttpRequest &req, HttpResponse *)
+                                 {
+                                     trace.push_back("options:" + req.get_path());
+                                 });
+        RouteGroup(&router, "/api", {std::make_shared<RecordingMiddleware>("cors", &trace)});
+
+        HttpRequest req;
+        req.set_method(HttpRequest::Method::OPTIONS);
+        req.set_path("/api/users");
+        HttpResponse resp;
+        EXPECT_TRUE(router.dispatch_options(req, &resp, "/options/method"));
+        EXPECT_EQ(trace, (std::vector<std::string>{"cors.before", "options:/options/method", "cors.after"}));
+
+        trace.clear();
+        req.set_path("/static/app.js");
+        EXPECT_TRUE(router.dispatch_options(req, &resp, "/options/method"));
+        EXPECT_EQ(trace, (std::vector<std::string>{"options:/options/method"}));
+    }
+
+    TEST(RouteGroupTest, OptionsUsesScopeOfParameterisedGroup)
+    {
+        // 预检路径是具体值，作用域前缀是模式
+        std::vector<std::string> trace;
+        Router router;
+        router.register_callback("/options/method", HttpRequest::Method::OPTIONS,
+                                 [&trace](const HttpRequest &, HttpResponse *)
+                                 {
+                                     trace.push_back("options");
+                                 });
+        RouteGroup(&router, "/tenants/:tenant", {std::make_shared<RecordingMiddleware>("cors", &trace)})
+                .add_regex_route(HttpRequest::Method::POST, "/orders", [](const HttpRequest &, HttpResponse *) {});
+
+        HttpRequest req;
+        req.set_method(HttpRequest::Method::OPTIONS);
+        req.set_path("/tenants/acme/orders");
+        HttpResponse resp;
+        EXPECT_TRUE(router.dispatch_options(req, &resp, "/options/method"));
+        EXPECT_EQ(trace, (std::vector<std::string>{"cors.before", "options", "cors.after"}));
+    }
+} // namespace zhttp::zrouter
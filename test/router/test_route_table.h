@@ -0,0 +1,165 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "router/router.h"
+
+namespace zhttp::zrouter
+{
+    namespace
+    {
+        std::string route_body(Router &router, const HttpRequest::Method method, const std::string &path)
+        {
+            HttpRequest req;
+            req.set_method(method);
+            req.set_path(path);
+            HttpResponse resp;
+            return router.route(req, &resp) ? resp.get_body() : "<none>";
+        }
+
+        Router::HandlerCallback reply(const std::string &body)
+        {
+            return [body](const HttpRequest &, HttpResponse *resp) { resp->set_body(body); };
+        }
+    }
+
+    TEST(RouteTableTest, ExactRoutesAndOverride)
+    {
+        Router router;
+        for (int i = 0; i < 100; ++i)
+        {
+            router.register_callback("/r" + std::to_string(i), HttpRequest::Method::GET,
+                                     reply("v" + std::to_string(i)));
+        }
+        router.register_callback("/r7", HttpRequest::Method::GET, reply("new"));
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/r42"), "v42");
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/r7"), "new");
+        EXPECT_EQ(route_body(router, HttpRequest::Method::POST, "/r42"), "<none>");
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/r100"), "<none>");
+    }
+
+    TEST(RouteTableTest, RemoveAndConflictAfterFreeze)
+    {
+        Router router;
+        router.register_callback("/a", HttpRequest::Method::GET, reply("a"));
+        router.register_regex_callback("/users/:id", HttpRequest::Method::GET, reply("user"));
+        router.freeze();
+
+        // 运行期注册立即生效
+        router.register_callback("/b", HttpRequest::Method::GET, reply("b"));
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/b"), "b");
+
+        EXPECT_EQ(router.remove_route("/users/:id", HttpRequest::Method::GET), 1u);
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/users/1"), "<none>");
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/a"), "a");
+        EXPECT_EQ(router.remove_route("/missing", HttpRequest::Method::GET), 0u);
+
+        // 冲突的模式被拒绝，已有路由不受影响
+        router.register_regex_callback("/items/:id", HttpRequest::Method::GET, reply("item"));
+        EXPECT_THROW(router.register_regex_callback("/items/:name", HttpRequest::Method::GET, reply("x")),
+                     std::invalid_argument);
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/items/3"), "item");
+        router.register_callback("/c", HttpRequest::Method::GET, reply("c"));
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/c"), "c");
+    }
+
+    TEST(RouteTableTest, RegexRoutesKeepRegistrationOrder)
+    {
+        // 先注册的std::regex路由优先于后注册的正则集合路由，反之亦然
+        Router router;
+        router.register_regex_callback(R"(/(?=a)a/([^/]+))", HttpRequest::Method::GET, reply("fallback-a"));
+        router.register_regex_callback(R"(/a/([^/]+))", HttpRequest::Method::GET, reply("set-a"));
+        router.register_regex_callback(R"(/b/([^/]+))", HttpRequest::Method::GET, reply("set-b"));
+        router.register_regex_callback(R"(/(?=b)b/([^/]+))", HttpRequest::Method::GET, reply("fallback-b"));
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/a/1"), "fallback-a");
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/b/1"), "set-b");
+
+        // 处理器仍优先于回调函数
+        class Reply final : public RouterHandler
+        {
+        public:
+            void handle_request(const HttpRequest &, HttpResponse *resp) override { resp->set_body("handler-b"); }
+        };
+        router.register_regex_handler(R"(/(?=b)b/(\d+))", HttpRequest::Method::GET, std::make_shared<Reply>());
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/b/1"), "handler-b");
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/b/x"), "set-b");
+    }
+
+    TEST(RouteTableTest, FindRouteByMethodAndPath)
+    {
+        const auto target = [](const std::string &body)
+        {
+            RouteTarget route;
+            route.callback_ = reply(body);
+            return route;
+        };
+        const RouteTable table({
+                {RouteDefinition::Kind::Exact, "/health", HttpRequest::Method::GET, target("exact")},
+                {RouteDefinition::Kind::Dynamic, "/users/:id", HttpRequest::Method::GET, target("tree")},
+                {RouteDefinition::Kind::Dynamic, R"(/files/(\d+))", HttpRequest::Method::PUT, target("set")},
+                {RouteDefinition::Kind::Dynamic, R"(/(?=x)x/([^/]+))", HttpRequest::Method::GET, target("fallback")}});
+
+        // 与按请求查找命中同一条路由，但不需要构造请求
+        const auto body = [&table](const HttpRequest::Method method, const std::string &path) -> std::string
+        {
+            const RouteTarget *route = table.find_route(method, path);
+            if (!route)
+            {
+                return "<none>";
+            }
+            HttpResponse resp;
+            (*route)(HttpRequest(), &resp);
+            return resp.get_body();
+        };
+        EXPECT_EQ(body(HttpRequest::Method::GET, "/health"), "exact");
+        EXPECT_EQ(body(HttpRequest::Method::GET, "/users/7"), "tree");
+        EXPECT_EQ(body(HttpRequest::Method::PUT, "/files/12"), "set");
+        EXPECT_EQ(body(HttpRequest::Method::GET, "/x/y"), "fallback");
+        EXPECT_EQ(body(HttpRequest::Method::POST, "/users/7"), "<none>");
+        EXPECT_EQ(body(HttpRequest::Method::PUT, "/files/ab"), "<none>");
+    }
+
+    TEST(RouteTableTest, ConcurrentRouteDuringUpdates)
+    {
+        Router router;
+        router.register_callback("/stable", HttpRequest::Method::GET, reply("stable"));
+        router.freeze();
+
+        std::atomic<bool> stop{false};
+        std::atomic<int> misses{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t)
+        {
+            readers.emplace_back([&]
+            {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    if (route_body(router, HttpRequest::Method::GET, "/stable") != "stable")
+                    {
+                        ++misses;
+                    }
+                }
+            });
+        }
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const std::string path = "/hot/" + std::to_string(i);
+            router.register_callback(path, HttpRequest::Method::GET, reply(path));
+            EXPECT_EQ(route_body(router, HttpRequest::Method::GET, path), path);
+            if (i % 2 == 0)
+            {
+                router.remove_route(path, HttpRequest::Method::GET);
+            }
+        }
+        stop = true;
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+        EXPECT_EQ(misses.load(), 0);
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/hot/199"), "/hot/199");
+        EXPECT_EQ(route_body(router, HttpRequest::Method::GET, "/hot/198"), "<none>");
+    }
+} // namespace zhttp::zrouter
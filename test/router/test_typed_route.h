@@ -0,0 +1,107 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include "router/route_group.h"
+
+namespace zhttp::zrouter
+{
+    namespace typed_patterns
+    {
+        static constexpr char kUserPost[] = "/users/{id:u64}/posts/{slug}";
+        static constexpr char kOffset[] = "/offset/{delta:i32}";
+        static constexpr char kFiles[] = "/files/{*rest}";
+        static constexpr char kPost[] = "/posts/{post:u32}";
+    }
+
+    // 模式在编译期解析
+    static_assert(typed::TypedPattern<typed_patterns::kUserPost>::kTree == "/users/:id/posts/:slug");
+    static_assert(typed::TypedPattern<typed_patterns::kUserPost>::kInfo.count_ == 2);
+    static_assert(typed::TypedPattern<typed_patterns::kFiles>::kTree == "/files/*rest");
+    static_assert(!typed::detail::parse("/users/{id:u65}", nullptr).valid_);
+    static_assert(!typed::detail::parse("/users/x{id}", nullptr).valid_);
+    static_assert(!typed::detail::parse("/users/{*rest}/tail", nullptr).valid_);
+    static_assert(!typed::detail::parse("/users/{id", nullptr).valid_);
+
+    namespace
+    {
+        HttpResponse typed_route(Router &router, const std::string &path)
+        {
+            HttpRequest req;
+            req.set_method(HttpRequest::Method::GET);
+            req.set_path(path);
+            HttpResponse resp;
+            resp.set_status_code(HttpResponse::StatusCode::OK);
+            if (!router.dispatch(req, &resp))
+            {
+                resp.set_body("<none>");
+            }
+            return resp;
+        }
+    }
+
+    TEST(TypedRouteTest, DecodesTypedParameters)
+    {
+        Router router;
+        router.register_typed<typed_patterns::kUserPost>(
+                HttpRequest::Method::GET,
+                [](const HttpRequest &, HttpResponse *resp, const uint64_t id, const std::string_view slug)
+                {
+                    resp->set_body(std::to_string(id + 1) + ":" + std::string(slug));
+                });
+        router.register_typed<typed_patterns::kOffset>(
+                HttpRequest::Method::GET,
+                [](const HttpRequest &, HttpResponse *resp, const int32_t delta)
+                {
+                    resp->set_body(std::to_string(delta * 2));
+                });
+
+        EXPECT_EQ(typed_route(router, "/users/41/posts/hello").get_body(), "42:hello");
+        EXPECT_EQ(typed_route(router, "/offset/-21").get_body(), "-42");
+        EXPECT_EQ(typed_route(router, "/users/41/posts").get_body(), "<none>");
+    }
+
+    TEST(TypedRouteTest, RejectsUndecodableParameters)
+    {
+        Router router;
+        router.register_typed<typed_patterns::kUserPost>(
+                HttpRequest::Method::GET,
+                [](const HttpRequest &, HttpResponse *resp, uint64_t, std::string_view)
+                {
+                    resp->set_body("called");
+                });
+
+        for (const char *path : {"/users/abc/posts/x", "/users/-1/posts/x", "/users/12x/posts/x",
+                                 "/users/99999999999999999999/posts/x"})
+        {
+            const HttpResponse resp = typed_route(router, path);
+            EXPECT_EQ(resp.get_status_code(), HttpResponse::StatusCode::NotFound) << path;
+            EXPECT_NE(resp.get_body(), "called") << path;
+        }
+    }
+
+    TEST(TypedRouteTest, WildcardAndRequestAccess)
+    {
+        Router router;
+        router.register_typed<typed_patterns::kFiles>(
+                HttpRequest::Method::GET,
+                [](const HttpRequest &req, HttpResponse *resp, const std::string_view rest)
+                {
+                    resp->set_body(std::string(rest) + "|" + std::string(req.get_path_parameter("rest")));
+                });
+        EXPECT_EQ(typed_route(router, "/files/a/b.txt").get_body(), "a/b.txt|a/b.txt");
+    }
+
+    TEST(TypedRouteTest, SkipsGroupPrefixParameters)
+    {
+        // 分组前缀中的参数不参与类型化解码
+        Router router;
+        RouteGroup tenant(&router, "/tenants/:tenant", {});
+        tenant.Get<typed_patterns::kPost>(
+                [](const HttpRequest &req, HttpResponse *resp, const uint32_t post)
+                {
+                    resp->set_body(std::string(req.get_path_parameter("tenant")) + ":" + std::to_string(post + 1));
+                });
+        EXPECT_EQ(typed_route(router, "/tenants/acme/posts/41").get_body(), "acme:42");
+        EXPECT_EQ(typed_route(router, "/tenants/7/posts/x").get_status_code(), HttpResponse::StatusCode::NotFound);
+    }
+} // namespace zhttp::zrouter
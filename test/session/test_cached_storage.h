@@ -0,0 +1,211 @@
+#pragma once
+#include "session/cached_storage.h"
+#include "session/memory_storage.h"
+#include <thread>
+#include <gtest/gtest.h>
+
+namespace zhttp::zsession
+{
+    // 模拟远端存储：保存副本并记录访问次数
+    class CountingStorage final : public SessionStorage
+    {
+    public:
+        void store(const std::shared_ptr<Session> &session) override
+        {
+            ++stores_;
+            storage_.store(std::make_shared<Session>(*session));
+        }
+
+        std::shared_ptr<Session> load(const std::string &session_id) override
+        {
+            ++loads_;
+            auto session = storage_.load(session_id);
+            return session ? std::make_shared<Session>(*session) : nullptr;
+        }
+
+        bool remove(const std::string &session_id) override { return storage_.remove(session_id); }
+
+        void clear_expired() override { storage_.clear_expired(); }
+
+        std::atomic<int> loads_{0};
+        std::atomic<int> stores_{0};
+
+    private:
+        InMemoryStorage storage_{4};
+    };
+
+    TEST(CachedStorageTest, HitAvoidsBackend)
+    {
+        auto backend = std::make_shared<CountingStorage>();
+        CachedSessionStorage storage(backend);
+
+        auto session = std::make_shared<Session>("near1");
+        session->set_attribute("k", "v");
+        storage.store(session);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            auto loaded = storage.load("near1");
+            ASSERT_NE(loaded, nullptr);
+            EXPECT_EQ(loaded->get_attribute("k"), "v");
+        }
+        EXPECT_EQ(backend->loads_, 0);
+        EXPECT_EQ(storage.stats().hits_, 10u);
+
+        // 返回的是独立副本，调用方修改不影响缓存
+        storage.load("near1")->set_attribute("k", "changed");
+        EXPECT_EQ(storage.load("near1")->get_attribute("k"), "v");
+    }
+
+    // 只预取部分属性的远端存储，其余属性经loader读取
+    class PartialStorage final : public SessionStorage
+    {
+    public:
+        class Loader final : public AttributeLoader
+        {
+        public:
+            explicit Loader(std::atomic<int> *reads) : reads_(reads) {}
+
+            std::optional<std::string> load(const std::string &key) override
+            {
+                ++*reads_;
+                return key == "cart" ? std::optional<std::string>("remote") : std::nullopt;
+            }
+
+            std::unordered_map<std::string, std::string> load_all() override
+            {
+                ++*reads_;
+                return {{"cart", "remote"}};
+            }
+
+        private:
+            std::atomic<int> *reads_;
+        };
+
+        void store(const std::shared_ptr<Session> &) override {}
+
+        std::shared_ptr<Session> load(const std::string &session_id) override
+        {
+            auto session = std::make_shared<Session>(session_id);
+            session->set_attribute("user", "alice");
+            session->set_attribute_loader(std::make_shared<Loader>(&reads_));
+            session->clear_dirty();
+            return session;
+        }
+
+        bool remove(const std::string &) override { return false; }
+
+        void clear_expired() override {}
+
+        std::atomic<int> reads_{0};
+    };
+
+    TEST(CachedStorageTest, CachesWholePartialSessions)
+    {
+        // 缓存的副本是完整的，命中缓存后读取属性不再访问后端
+        auto backend = std::make_shared<PartialStorage>();
+        CachedSessionStorage storage(backend);
+
+        EXPECT_EQ(storage.load("partial1")->get_attribute("user"), "alice");
+        const int reads = backend->reads_;
+        for (int i = 0; i < 5; ++i)
+        {
+            auto loaded = storage.load("partial1");
+            EXPECT_FALSE(loaded->is_partial());
+            EXPECT_EQ(loaded->get_attribute("cart"), "remote");
+        }
+        EXPECT_EQ(backend->reads_, reads);
+    }
+
+    TEST(CachedStorageTest, MissFillsCache)
+    {
+        auto backend = std::make_shared<CountingStorage>();
+        backend->store(std::make_shared<Session>("near2"));
+        CachedSessionStorage storage(backend);
+
+        ASSERT_NE(storage.load("near2"), nullptr);
+        ASSERT_NE(storage.load("near2"), nullptr);
+        EXPECT_EQ(backend->loads_, 1);
+        EXPECT_EQ(storage.stats().misses_, 1u);
+        EXPECT_EQ(storage.load("absent"), nullptr);
+    }
+
+    TEST(CachedStorageTest, CrossNodeInvalidation)
+    {
+        auto backend = std::make_shared<CountingStorage>();
+        auto hub = std::make_shared<LocalInvalidationHub>();
+        CachedSessionStorage node_a(backend, hub->endpoint());
+        CachedSessionStorage node_b(backend, hub->endpoint());
+
+        auto session = std::make_shared<Session>("near3");
+        session->set_attribute("k", "v1");
+        node_a.store(session);
+        EXPECT_EQ(node_b.load("near3")->get_attribute("k"), "v1");
+
+        session->set_attribute("k", "v2");
+        node_a.store(session);
+        EXPECT_EQ(node_b.stats().invalidations_, 2u); // 两次写入各发布一次
+        EXPECT_EQ(node_b.load("near3")->get_attribute("k"), "v2");
+
+        node_b.remove("near3");
+        EXPECT_EQ(node_a.load("near3"), nullptr);
+    }
+
+    TEST(CachedStorageTest, ResetDropsEverything)
+    {
+        auto backend = std::make_shared<CountingStorage>();
+        auto hub = std::make_shared<LocalInvalidationHub>();
+        CachedSessionStorage storage(backend, hub->endpoint());
+        for (int i = 0; i < 8; ++i)
+        {
+            storage.store(std::make_shared<Session>("reset" + std::to_string(i)));
+        }
+        EXPECT_EQ(storage.size(), 8u);
+        hub->reset();
+        EXPECT_EQ(storage.size(), 0u);
+    }
+
+    TEST(CachedStorageTest, LocalCopyExpires)
+    {
+        auto backend = std::make_shared<CountingStorage>();
+        CachedSessionStorage storage(backend, nullptr, NearCacheConfig{100, 50, 1});
+        storage.store(std::make_shared<Session>("near4"));
+
+        ASSERT_NE(storage.load("near4"), nullptr);
+        EXPECT_EQ(backend->loads_, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(80));
+        ASSERT_NE(storage.load("near4"), nullptr);
+        EXPECT_EQ(backend->loads_, 1);
+    }
+
+    TEST(CachedStorageTest, CapacityBound)
+    {
+        auto backend = std::make_shared<CountingStorage>();
+        CachedSessionStorage storage(backend, nullptr, NearCacheConfig{16, 60000, 1});
+        for (int i = 0; i < 100; ++i)
+        {
+            storage.store(std::make_shared<Session>("cap" + std::to_string(i)));
+        }
+        EXPECT_EQ(storage.size(), 16u);
+
+        // 最早写入的已被淘汰，从后端重新加载
+        ASSERT_NE(storage.load("cap0"), nullptr);
+        EXPECT_EQ(backend->loads_, 1);
+        ASSERT_NE(storage.load("cap99"), nullptr);
+        EXPECT_EQ(backend->loads_, 1);
+    }
+
+    TEST(CachedStorageTest, LoadAndRefresh)
+    {
+        auto backend = std::make_shared<CountingStorage>();
+        backend->store(std::make_shared<Session>("near5"));
+        CachedSessionStorage storage(backend);
+
+        // 未命中交给后端，命中时本地刷新并写穿
+        ASSERT_NE(storage.load_and_refresh("near5"), nullptr);
+        EXPECT_EQ(backend->loads_, 1);
+        ASSERT_NE(storage.load_and_refresh("near5"), nullptr);
+        EXPECT_EQ(backend->loads_, 1);
+        EXPECT_EQ(backend->stores_, 3);
+    }
+} // namespace zhttp::zsession
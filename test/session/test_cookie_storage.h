@@ -0,0 +1,164 @@
+#pragma once
+#include "session/cookie_storage.h"
+#include "session/session_manager.h"
+#include <gtest/gtest.h>
+
+namespace zhttp::zsession
+{
+    namespace
+    {
+        std::string cookie_of(const HttpResponse &response)
+        {
+            const std::string header = response.get_header("Set-Cookie");
+            const size_t begin = header.find('=') + 1;
+            return header.substr(begin, header.find(';') - begin);
+        }
+    } // namespace
+
+    TEST(CookieStorageTest, SealAndOpen)
+    {
+        CookieSessionStorage storage({CookieSessionStorage::generate_key(1)});
+        auto session = std::make_shared<Session>("cookie1");
+        session->set_attribute("user", "alice");
+        session->set_attribute("role", "admin");
+
+        const auto token = storage.cookie_token(*session);
+        ASSERT_TRUE(token.has_value());
+        EXPECT_TRUE(CookieSessionStorage::is_token(*token));
+        EXPECT_EQ(token->find_first_of(";, \""), std::string::npos); // 可直接作为Cookie值
+
+        const auto loaded = storage.load(*token);
+        ASSERT_NE(loaded, nullptr);
+        EXPECT_EQ(loaded->get_session_id(), "cookie1");
+        EXPECT_EQ(loaded->get_attribute("user"), "alice");
+        EXPECT_EQ(loaded->get_attribute("role"), "admin");
+        EXPECT_FALSE(loaded->is_dirty());
+        EXPECT_LE(std::chrono::abs(loaded->get_expiry_time() - session->get_expiry_time()), std::chrono::seconds(1));
+
+        // 同一会话每次加密使用不同的nonce
+        EXPECT_NE(*storage.cookie_token(*session), *token);
+    }
+
+    TEST(CookieStorageTest, RejectsTamperedAndExpiredTokens)
+    {
+        CookieSessionStorage storage({CookieSessionStorage::generate_key(1)});
+        auto session = std::make_shared<Session>("cookie2");
+        session->set_attribute("user", "bob");
+        std::string token = *storage.cookie_token(*session);
+
+        std::string tampered = token;
+        tampered[tampered.size() / 2] = tampered[tampered.size() / 2] == 'A' ? 'B' : 'A';
+        EXPECT_EQ(storage.load(tampered), nullptr);
+        EXPECT_EQ(storage.load(token.substr(0, token.size() - 4)), nullptr);
+        EXPECT_EQ(storage.load("z1.!!!"), nullptr);
+
+        CookieSessionStorage other({CookieSessionStorage::generate_key(1)});
+        EXPECT_EQ(other.load(token), nullptr); // 密钥编号相同但密钥不同
+
+        session->set_expiry_time(std::chrono::system_clock::now() - std::chrono::seconds(10));
+        EXPECT_EQ(storage.load(*storage.cookie_token(*session)), nullptr);
+
+        EXPECT_THROW(CookieSessionStorage({CookieKey{1, "short"}}), std::invalid_argument);
+        EXPECT_THROW(CookieSessionStorage(std::vector<CookieKey>{}), std::invalid_argument);
+    }
+
+    TEST(CookieStorageTest, KeyRotation)
+    {
+        CookieSessionStorage storage({CookieSessionStorage::generate_key(1)});
+        auto session = std::make_shared<Session>("cookie3");
+        session->set_attribute("user", "carol");
+        const std::string old_token = *storage.cookie_token(*session);
+
+        storage.rotate(CookieSessionStorage::generate_key(2));
+        const std::string new_token = *storage.cookie_token(*session);
+        EXPECT_NE(storage.load(old_token), nullptr); // 旧密钥仍可解密
+        EXPECT_NE(storage.load(new_token), nullptr);
+
+        EXPECT_THROW(storage.retire(2), std::invalid_argument);
+        storage.retire(1);
+        EXPECT_EQ(storage.load(old_token), nullptr);
+        EXPECT_EQ(storage.load(new_token)->get_attribute("user"), "carol");
+    }
+
+    TEST(CookieStorageTest, OversizedSessionsFallBack)
+    {
+        auto fallback = std::make_shared<InMemoryStorage>(4);
+        CookieSessionStorage storage({CookieSessionStorage::generate_key(1)}, fallback, 200);
+
+        auto small = std::make_shared<Session>("small");
+        small->set_attribute("user", "dave");
+        storage.store(small);
+        EXPECT_TRUE(storage.cookie_token(*small).has_value());
+        EXPECT_EQ(fallback->size(), 0u);
+
+        auto large = std::make_shared<Session>("large");
+        large->set_attribute("cart", std::string(500, 'x'));
+        storage.store(large);
+        EXPECT_FALSE(storage.cookie_token(*large).has_value());
+        EXPECT_EQ(fallback->size(), 1u);
+
+        const auto loaded = storage.load("large");
+        ASSERT_NE(loaded, nullptr);
+        EXPECT_NE(loaded, large); // 不与fallback共享对象
+        EXPECT_EQ(loaded->get_attribute("cart").size(), 500u);
+
+        storage.remove("large");
+        EXPECT_EQ(fallback->size(), 0u);
+    }
+
+    TEST(CookieStorageTest, ManagerIssuesCookieTokens)
+    {
+        auto fallback = std::make_shared<InMemoryStorage>(4);
+        auto storage = std::make_shared<CookieSessionStorage>(
+                std::vector<CookieKey>{CookieSessionStorage::generate_key(1)}, fallback, 300);
+        auto &mgr = SessionManager::get_instance();
+        mgr.set_session_storage(storage);
+
+        HttpRequest req;
+        HttpResponse resp;
+        auto session = mgr.get_session(req, &resp);
+        session->set_attribute("user", "erin");
+        const std::string token = cookie_of(resp);
+        EXPECT_TRUE(CookieSessionStorage::is_token(token));
+        EXPECT_EQ(fallback->size(), 0u);
+
+        // 携带令牌的请求不访问服务器端存储；写入后重新下发令牌
+        HttpRequest req2;
+        req2.set_header("Cookie", "session_id=" + token);
+        HttpResponse resp2;
+        auto loaded = mgr.get_session(req2, &resp2);
+        EXPECT_EQ(loaded->get_session_id(), session->get_session_id());
+        EXPECT_EQ(loaded->get_attribute("user"), "erin");
+        loaded->set_attribute("theme", "dark");
+        mgr.update_session(loaded);
+        const std::string token2 = cookie_of(resp2);
+        ASSERT_TRUE(CookieSessionStorage::is_token(token2));
+        EXPECT_EQ(storage->load(token2)->get_attribute("theme"), "dark");
+
+        // 超出上限后转存服务器端，Cookie改为会话ID
+        HttpRequest req3;
+        req3.set_header("Cookie", "session_id=" + token2);
+        HttpResponse resp3;
+        auto grown = mgr.get_session(req3, &resp3);
+        grown->set_attribute("cart", std::string(400, 'x'));
+        mgr.update_session(grown);
+        EXPECT_EQ(cookie_of(resp3), session->get_session_id());
+        EXPECT_EQ(fallback->size(), 1u);
+
+        // 服务器端存的是副本：调用方之后的改动不会带进去，存储持有的对象也没有本次请求的回调
+        grown->set_attribute("cart", "changed");
+        const auto held = fallback->load(session->get_session_id());
+        EXPECT_EQ(held->get_attribute("cart").size(), 400u);
+        resp3 = HttpResponse();
+        held->set_attribute("note", "later");
+        mgr.update_session(held);
+        EXPECT_EQ(cookie_of(resp3), "");
+
+        HttpRequest req4;
+        req4.set_header("Cookie", "session_id=" + session->get_session_id());
+        HttpResponse resp4;
+        EXPECT_EQ(mgr.get_session(req4, &resp4)->get_attribute("cart").size(), 400u);
+
+        mgr.set_session_storage(std::make_shared<InMemoryStorage>());
+    }
+} // namespace zhttp::zsession
@@ -69,4 +69,100 @@ namespace zhttp::zsession
         auto loaded = storage->load(session_id);
         EXPECT_EQ(loaded, nullptr);
     }
+
+    TEST_F(DbSessionStorageTest, SingleRoundTripPerOperation)
+    {
+        storage->load_and_refresh(session_id); // 预先加载脚本
+
+        uint64_t before = zdb::RedisConnection::round_trips();
+        storage->store(session);
+        EXPECT_EQ(zdb::RedisConnection::round_trips() - before, 1u);
+
+        before = zdb::RedisConnection::round_trips();
+        ASSERT_NE(storage->load(session_id), nullptr);
+        EXPECT_EQ(zdb::RedisConnection::round_trips() - before, 1u);
+
+        before = zdb::RedisConnection::round_trips();
+        ASSERT_NE(storage->load_and_refresh(session_id), nullptr);
+        EXPECT_EQ(zdb::RedisConnection::round_trips() - before, 1u);
+    }
+
+    TEST_F(DbSessionStorageTest, LoadAndRefreshExtendsExpiry)
+    {
+        session->set_expiry_time(std::chrono::system_clock::now() + std::chrono::seconds(5));
+        storage->store(session);
+
+        auto refreshed = storage->load_and_refresh(session_id);
+        ASSERT_NE(refreshed, nullptr);
+        EXPECT_EQ(refreshed->get_attribute("user"), "alice");
+        EXPECT_GT(refreshed->get_expiry_time(), std::chrono::system_clock::now() + std::chrono::seconds(60));
+
+        // 服务器端的过期字段同样已顺延
+        auto loaded = storage->load(session_id);
+        ASSERT_NE(loaded, nullptr);
+        EXPECT_EQ(std::chrono::duration_cast<std::chrono::seconds>(loaded->get_expiry_time().time_since_epoch()),
+                  std::chrono::duration_cast<std::chrono::seconds>(refreshed->get_expiry_time().time_since_epoch()));
+    }
+
+    TEST_F(DbSessionStorageTest, LoadAndRefreshMissingOrExpired)
+    {
+        EXPECT_EQ(storage->load_and_refresh("gtest_missing_session"), nullptr);
+
+        session->set_expiry_time(std::chrono::system_clock::now() + std::chrono::seconds(1));
+        storage->store(session);
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+        EXPECT_EQ(storage->load_and_refresh(session_id), nullptr);
+    }
+
+    TEST_F(DbSessionStorageTest, FieldLayoutLoadsOnDemand)
+    {
+        DbSessionStorage fields(RedisSessionLayout::Fields, {"user"});
+        fields.store(session);
+
+        uint64_t before = zdb::RedisConnection::round_trips();
+        auto loaded = fields.load(session_id);
+        ASSERT_NE(loaded, nullptr);
+        EXPECT_TRUE(loaded->is_partial());
+        EXPECT_EQ(loaded->get_attribute("user"), "alice"); // 预取
+        EXPECT_EQ(zdb::RedisConnection::round_trips() - before, 1u);
+        EXPECT_EQ(loaded->get_attribute("role"), "admin"); // 按需读取
+        EXPECT_EQ(zdb::RedisConnection::round_trips() - before, 2u);
+    }
+
+    TEST_F(DbSessionStorageTest, FieldLayoutWritesChangedFields)
+    {
+        DbSessionStorage fields(RedisSessionLayout::Fields, {"user"});
+        fields.store(session);
+
+        auto loaded = fields.load(session_id);
+        ASSERT_NE(loaded, nullptr);
+        loaded->set_attribute("flag", "1");
+        loaded->remove_attribute("role");
+        fields.store(loaded);
+
+        const auto raw = zdb::RedisConnectionPool::get_instance().get_connection()->hgetall("session:" + session_id);
+        EXPECT_EQ(raw.count("attr:user"), 1u); // 未改动的字段保持不变
+        EXPECT_EQ(raw.count("attr:role"), 0u);
+        EXPECT_EQ(raw.at("attr:flag"), "1");
+
+        auto reloaded = fields.load(session_id);
+        ASSERT_NE(reloaded, nullptr);
+        EXPECT_EQ(reloaded->get_attributes_json(), (nlohmann::json{{"user", "alice"}, {"flag", "1"}}));
+    }
+
+    TEST_F(DbSessionStorageTest, FieldLayoutMigratesBlobSessions)
+    {
+        storage->store(session); // Blob布局写入
+
+        DbSessionStorage fields(RedisSessionLayout::Fields);
+        auto loaded = fields.load(session_id);
+        ASSERT_NE(loaded, nullptr);
+        EXPECT_EQ(loaded->get_attribute("role"), "admin");
+        EXPECT_TRUE(loaded->is_dirty());
+        fields.store(loaded);
+
+        const auto raw = zdb::RedisConnectionPool::get_instance().get_connection()->hgetall("session:" + session_id);
+        EXPECT_EQ(raw.count("attributes"), 0u);
+        EXPECT_EQ(raw.at("attr:role"), "admin");
+    }
 } // namespace zhttp::zsession
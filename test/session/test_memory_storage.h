@@ -1,6 +1,9 @@
 #pragma once
 #include "session/memory_storage.h"
+#include <algorithm>
+#include <random>
 #include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 
 namespace zhttp::zsession
@@ -35,4 +38,175 @@ namespace zhttp::zsession
         storage.clear_expired();
         EXPECT_EQ(storage.load("sid3"), nullptr);
     }
+
+    TEST(MemoryStorageTest, LoadAndRefresh)
+    {
+        InMemoryStorage storage;
+        auto session = std::make_shared<Session>("sid4", 60);
+        session->set_expiry_time(std::chrono::system_clock::now() + std::chrono::seconds(1));
+        storage.store(session);
+
+        auto loaded = storage.load_and_refresh("sid4");
+        ASSERT_NE(loaded, nullptr);
+        EXPECT_GT(loaded->get_expiry_time(), std::chrono::system_clock::now() + std::chrono::seconds(30));
+        EXPECT_EQ(storage.load_and_refresh("missing"), nullptr);
+    }
+
+    TEST(ExpiryWheelTest, FiresAtExpiryAcrossLevels)
+    {
+        constexpr int64_t start = 1000000;
+        ExpiryWheel wheel(start);
+        // 覆盖各层与超出范围的到期时间
+        const std::vector<int64_t> delays = {1, 5, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 300000, 20000000};
+        std::vector<ExpiryWheel::Node> nodes(delays.size());
+        for (size_t i = 0; i < delays.size(); ++i)
+        {
+            wheel.schedule(&nodes[i], start + delays[i]);
+        }
+        EXPECT_EQ(wheel.size(), delays.size());
+
+        std::vector<int64_t> fired(delays.size(), 0);
+        const auto on_expire = [&](ExpiryWheel::Node *node)
+        {
+            const size_t i = node - nodes.data();
+            if (node->expiry_ > wheel.now())
+            {
+                wheel.schedule(node, node->expiry_); // 超出范围的节点提前到点，复核后重新调度
+                return;
+            }
+            fired[i] = wheel.now();
+        };
+        // 分多次不规则地推进
+        int64_t now = start;
+        std::mt19937 rng(3);
+        while (now < start + 20000001)
+        {
+            now = std::min<int64_t>(now + 1 + rng() % 5000, start + 20000001);
+            wheel.advance(now, on_expire);
+            for (size_t i = 0; i < delays.size(); ++i)
+            {
+                if (fired[i] == 0)
+                {
+                    ASSERT_GT(start + delays[i], now) << "missed delay " << delays[i];
+                }
+            }
+        }
+        for (size_t i = 0; i < delays.size(); ++i)
+        {
+            EXPECT_GE(fired[i], start + delays[i]) << delays[i];
+        }
+        EXPECT_EQ(wheel.size(), 0u);
+    }
+
+    TEST(ExpiryWheelTest, RescheduleAndRemove)
+    {
+        ExpiryWheel wheel(0);
+        ExpiryWheel::Node a, b, c;
+        wheel.schedule(&a, 10);
+        wheel.schedule(&b, 10);
+        wheel.schedule(&c, 100);
+        wheel.schedule(&a, 5000); // 刷新
+        wheel.remove(&b);
+        EXPECT_EQ(wheel.size(), 2u);
+
+        std::vector<ExpiryWheel::Node *> fired;
+        wheel.advance(200, [&fired](ExpiryWheel::Node *node) { fired.push_back(node); });
+        ASSERT_EQ(fired.size(), 1u);
+        EXPECT_EQ(fired[0], &c);
+
+        // 到期时间早于当前时间的节点在下一次推进时触发
+        wheel.schedule(&b, 150);
+        fired.clear();
+        wheel.advance(200, [&fired](ExpiryWheel::Node *node) { fired.push_back(node); });
+        ASSERT_EQ(fired.size(), 1u);
+        EXPECT_EQ(fired[0], &b);
+
+        fired.clear();
+        wheel.advance(5000, [&fired](ExpiryWheel::Node *node) { fired.push_back(node); });
+        ASSERT_EQ(fired.size(), 1u);
+        EXPECT_EQ(fired[0], &a);
+    }
+
+    TEST(MemoryStorageTest, ClearExpiredKeepsRefreshedSessions)
+    {
+        InMemoryStorage storage(4);
+        auto expired = std::make_shared<Session>("old", 1);
+        auto refreshed = std::make_shared<Session>("refreshed", 1);
+        storage.store(expired);
+        storage.store(refreshed);
+        storage.store(std::make_shared<Session>("live"));
+        expired->set_expiry_time(std::chrono::system_clock::now() - std::chrono::seconds(5));
+        storage.store(expired);
+
+        // 延长过期时间后重新存储，时间轮改按新的过期时间调度
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        refreshed->set_expiry_time(std::chrono::system_clock::now() + std::chrono::seconds(60));
+        storage.store(refreshed);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+        storage.clear_expired();
+        EXPECT_EQ(storage.size(), 2u);
+        EXPECT_EQ(storage.load("old"), nullptr);
+        EXPECT_NE(storage.load("refreshed"), nullptr);
+        EXPECT_NE(storage.load("live"), nullptr);
+    }
+
+    TEST(MemoryStorageTest, StoresAndLoadsCopies)
+    {
+        InMemoryStorage storage(4);
+        auto session = std::make_shared<Session>("sid_copy");
+        session->set_attribute("k", "v");
+        storage.store(session);
+
+        // 存储之后的修改不影响已存储的会话
+        session->set_attribute("k", "changed");
+        auto loaded = storage.load("sid_copy");
+        ASSERT_NE(loaded, nullptr);
+        EXPECT_NE(loaded, session);
+        EXPECT_EQ(loaded->get_attribute("k"), "v");
+
+        // 每次加载得到独立对象，修改需要store后才可见
+        loaded->set_attribute("k", "mine");
+        EXPECT_NE(storage.load("sid_copy"), loaded);
+        EXPECT_EQ(storage.load("sid_copy")->get_attribute("k"), "v");
+        storage.store(loaded);
+        EXPECT_EQ(storage.load("sid_copy")->get_attribute("k"), "mine");
+    }
+
+    TEST(MemoryStorageTest, ConcurrentAccess)
+    {
+        InMemoryStorage storage(8);
+        constexpr int threads = 4;
+        constexpr int per_thread = 2000;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&storage, t]
+            {
+                for (int i = 0; i < per_thread; ++i)
+                {
+                    const std::string id = std::to_string(t) + "-" + std::to_string(i);
+                    storage.store(std::make_shared<Session>(id));
+                    EXPECT_NE(storage.load(id), nullptr);
+                    if (i % 2)
+                    {
+                        storage.remove(id);
+                    }
+                }
+            });
+        }
+        std::thread cleaner([&storage]
+        {
+            for (int i = 0; i < 50; ++i)
+            {
+                storage.clear_expired();
+            }
+        });
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        cleaner.join();
+        EXPECT_EQ(storage.size(), static_cast<size_t>(threads * per_thread / 2));
+    }
 } // namespace zhttp::zsession
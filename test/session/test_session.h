@@ -6,6 +6,33 @@ namespace zhttp
 {
     namespace zsession
     {
+        // 模拟存储中的其余属性，记录读取次数
+        class FakeAttributeLoader final : public AttributeLoader
+        {
+        public:
+            explicit FakeAttributeLoader(std::unordered_map<std::string, std::string> remote)
+                : remote_(std::move(remote))
+            {
+            }
+
+            std::optional<std::string> load(const std::string &key) override
+            {
+                ++loads_;
+                const auto it = remote_.find(key);
+                return it == remote_.end() ? std::nullopt : std::optional<std::string>(it->second);
+            }
+
+            std::unordered_map<std::string, std::string> load_all() override
+            {
+                ++load_alls_;
+                return remote_;
+            }
+
+            std::unordered_map<std::string, std::string> remote_;
+            int loads_ = 0;
+            int load_alls_ = 0;
+        };
+
         TEST(SessionTest, AttributeSetAndGet)
         {
             Session s("sid123");
@@ -40,5 +67,77 @@ namespace zhttp
             Session s("mysid");
             EXPECT_EQ(s.get_session_id(), "mysid");
         }
+
+        TEST(SessionTest, PartialLoadOnDemand)
+        {
+            auto loader = std::make_shared<FakeAttributeLoader>(
+                    std::unordered_map<std::string, std::string>{{"user_id", "7"}, {"cart", "big"}, {"flag", "1"}});
+            Session s("partial");
+            s.set_attribute("user_id", "7"); // 预取的属性
+            s.set_attribute_loader(loader);
+            s.clear_dirty();
+
+            EXPECT_EQ(s.get_attribute("user_id"), "7");
+            EXPECT_EQ(loader->loads_, 0);
+            EXPECT_EQ(s.get_attribute("cart"), "big");
+            EXPECT_EQ(s.get_attribute("cart"), "big");
+            EXPECT_EQ(s.get_attribute("missing"), "");
+            EXPECT_EQ(s.get_attribute("missing"), "");
+            EXPECT_EQ(loader->loads_, 2); // 每个属性至多读取一次
+
+            // 删除未加载的属性同样记为改动，且不会再被读回
+            s.remove_attribute("flag");
+            EXPECT_EQ(s.get_dirty_keys(), (std::unordered_set<std::string>{"flag"}));
+            EXPECT_FALSE(s.has_attribute("flag"));
+            EXPECT_EQ(loader->loads_, 2);
+
+            // 需要全部属性时一次取回，本地的改动优先
+            s.set_attribute("cart", "small");
+            EXPECT_EQ(s.get_attributes_json(), (nlohmann::json{{"user_id", "7"}, {"cart", "small"}}));
+            EXPECT_EQ(loader->load_alls_, 1);
+            EXPECT_FALSE(s.is_partial());
+        }
+
+        TEST(SessionTest, PartialLoadThroughConstReference)
+        {
+            auto loader = std::make_shared<FakeAttributeLoader>(
+                    std::unordered_map<std::string, std::string>{{"user_id", "7"}, {"cart", "big"}});
+            Session s("partial_const");
+            s.set_attribute_loader(loader);
+            s.clear_dirty();
+
+            // 只读接口保持const，按需加载对持有const引用的调用方透明
+            const Session &view = s;
+            EXPECT_EQ(view.get_attribute("cart"), "big");
+            EXPECT_TRUE(view.has_attribute("user_id"));
+            EXPECT_EQ(loader->loads_, 2);
+            EXPECT_EQ(view.get_attributes_json(), (nlohmann::json{{"user_id", "7"}, {"cart", "big"}}));
+            EXPECT_FALSE(view.is_partial());
+            EXPECT_FALSE(view.is_dirty());
+        }
+
+        TEST(SessionTest, DirtyTracking)
+        {
+            Session s("dirty");
+            EXPECT_TRUE(s.is_dirty()); // 新建的会话尚未持久化
+            s.set_attribute("a", "1");
+            s.set_attribute("b", "2");
+            s.clear_dirty();
+            EXPECT_FALSE(s.is_dirty());
+
+            s.set_attribute("a", "1"); // 值未变化
+            s.remove_attribute("missing");
+            s.refresh();
+            EXPECT_FALSE(s.is_dirty());
+
+            s.set_attribute("a", "3");
+            s.remove_attribute("b");
+            EXPECT_TRUE(s.is_dirty());
+            EXPECT_EQ(s.get_dirty_keys(), (std::unordered_set<std::string>{"a", "b"}));
+
+            s.clear_dirty();
+            s.clear_attributes();
+            EXPECT_EQ(s.get_dirty_keys(), (std::unordered_set<std::string>{"a"}));
+        }
     } // namespace zsession
 } // namespace zhttp
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+#include "session/session_codec.h"
+#include <gtest/gtest.h>
+
+namespace zhttp::zsession
+{
+    TEST(SessionCodecTest, RoundTrip)
+    {
+        Session session("codec1");
+        session.set_attribute("user", "alice");
+        session.set_attribute("empty", "");
+        session.set_attribute(std::string("bin\0key", 7), std::string("\0\xFF\x80", 3));
+        session.set_attribute("long", std::string(1000, 'x')); // 多字节长度前缀
+
+        const std::string encoded = SessionCodec::encode(session);
+        EXPECT_TRUE(SessionCodec::is_binary(encoded));
+
+        Session decoded("codec1");
+        ASSERT_TRUE(SessionCodec::decode(encoded, decoded));
+        EXPECT_EQ(decoded.get_attributes_json(), session.get_attributes_json());
+        EXPECT_EQ(decoded.get_attribute(std::string("bin\0key", 7)), std::string("\0\xFF\x80", 3));
+        EXPECT_EQ(decoded.get_attribute("long").size(), 1000u);
+    }
+
+    TEST(SessionCodecTest, ReadsLegacyJson)
+    {
+        Session session("codec2");
+        session.set_attribute("user", "bob");
+        session.set_attribute("role", "admin");
+
+        Session decoded("codec2");
+        ASSERT_TRUE(SessionCodec::decode(session.get_attributes_json().dump(), decoded));
+        EXPECT_EQ(decoded.get_attribute("user"), "bob");
+        EXPECT_EQ(decoded.get_attribute("role"), "admin");
+        EXPECT_FALSE(SessionCodec::decode(R"({"n": 1})", decoded)); // 属性值只能是字符串
+        EXPECT_FALSE(SessionCodec::decode("not json", decoded));
+    }
+
+    TEST(SessionCodecTest, RejectsCorruptData)
+    {
+        Session session("codec3");
+        session.set_attribute("user", "carol");
+        const std::string encoded = SessionCodec::encode(session);
+
+        Session decoded("codec3");
+        decoded.set_attribute("keep", "me");
+        for (size_t length = 3; length < encoded.size(); ++length)
+        {
+            EXPECT_FALSE(SessionCodec::decode(encoded.substr(0, length), decoded)) << length;
+        }
+        EXPECT_FALSE(SessionCodec::decode(encoded + "x", decoded));
+
+        std::string future = encoded;
+        future[2] = static_cast<char>(SessionCodec::kVersion + 1);
+        EXPECT_FALSE(SessionCodec::decode(future, decoded));
+
+        std::string huge = encoded.substr(0, 3) + "\xFF\xFF\xFF\xFF\x0F";
+        EXPECT_FALSE(SessionCodec::decode(huge, decoded));
+
+        // 失败时原有属性保持不变
+        EXPECT_EQ(decoded.get_attribute("keep"), "me");
+    }
+} // namespace zhttp::zsession
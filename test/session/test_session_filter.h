@@ -0,0 +1,252 @@
+#pragma once
+#include "session/session_manager.h"
+#include "session/session_filter.h"
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace zhttp::zsession
+{
+    namespace
+    {
+        // 不支持枚举的存储
+        class OpaqueStorage final : public SessionStorage
+        {
+        public:
+            void store(const std::shared_ptr<Session> &session) override { storage_.store(session); }
+
+            std::shared_ptr<Session> load(const std::string &session_id) override { return storage_.load(session_id); }
+
+            bool remove(const std::string &session_id) override { return storage_.remove(session_id); }
+
+            void clear_expired() override { storage_.clear_expired(); }
+
+        private:
+            InMemoryStorage storage_{4};
+        };
+
+        // 模拟多个节点共享的存储
+        class SharedStorage final : public SessionStorage
+        {
+        public:
+            void store(const std::shared_ptr<Session> &session) override { storage_.store(session); }
+
+            std::shared_ptr<Session> load(const std::string &session_id) override { return storage_.load(session_id); }
+
+            bool remove(const std::string &session_id) override { return storage_.remove(session_id); }
+
+            void clear_expired() override { storage_.clear_expired(); }
+
+            bool is_shared() const override { return true; }
+
+            bool for_each_session_id(const std::function<void(const std::string &)> &fn) override
+            {
+                return storage_.for_each_session_id(fn);
+            }
+
+        private:
+            InMemoryStorage storage_{4};
+        };
+
+        bool wait_ready(const SessionIdFilter &filter)
+        {
+            for (int i = 0; i < 200 && !filter.ready(); ++i)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            return filter.ready();
+        }
+
+        SessionFilterConfig filter_config(const size_t capacity)
+        {
+            SessionFilterConfig config;
+            config.capacity_ = capacity;
+            config.rebuild_interval_ = std::chrono::seconds(0);
+            return config;
+        }
+    } // namespace
+
+    TEST(SessionFilterTest, RejectsUnknownIds)
+    {
+        auto storage = std::make_shared<InMemoryStorage>(4);
+        std::vector<std::string> live;
+        for (int i = 0; i < 10000; ++i)
+        {
+            live.push_back(SessionIdGenerator::generate());
+            storage->store(std::make_shared<Session>(live.back()));
+        }
+
+        SessionIdFilter filter(storage, filter_config(10000));
+        ASSERT_TRUE(wait_ready(filter));
+        for (const auto &id : live)
+        {
+            ASSERT_TRUE(filter.might_contain(id)); // 不能漏判
+        }
+
+        size_t passed = 0;
+        for (int i = 0; i < 10000; ++i)
+        {
+            if (filter.might_contain(SessionIdGenerator::generate()))
+            {
+                ++passed;
+                filter.report_false_positive();
+            }
+        }
+        EXPECT_LT(passed, 300u); // 每个ID 10个计数器，误判率约1%
+
+        const auto stats = filter.stats();
+        EXPECT_EQ(stats.entries_, 10000u);
+        EXPECT_EQ(stats.checks_, 20000u);
+        EXPECT_EQ(stats.rejected_ + stats.false_positives_, 10000u);
+        EXPECT_NEAR(stats.observed_fp_rate_, passed / 10000.0, 1e-9);
+        EXPECT_GT(stats.estimated_fp_rate_, 0.0);
+        EXPECT_LT(stats.estimated_fp_rate_, 0.03);
+    }
+
+    TEST(SessionFilterTest, AddRemoveAndRebuild)
+    {
+        auto storage = std::make_shared<InMemoryStorage>(4);
+        SessionIdFilter filter(storage, filter_config(1000));
+        ASSERT_TRUE(wait_ready(filter));
+
+        auto session = std::make_shared<Session>("filter1");
+        storage->store(session);
+        EXPECT_FALSE(filter.might_contain("filter1"));
+        filter.add("filter1");
+        EXPECT_TRUE(filter.might_contain("filter1"));
+        filter.remove("filter1");
+        EXPECT_FALSE(filter.might_contain("filter1"));
+
+        // 存储内部的增删在重建后生效
+        EXPECT_TRUE(filter.rebuild());
+        EXPECT_TRUE(filter.might_contain("filter1"));
+        storage->remove("filter1");
+        EXPECT_TRUE(filter.rebuild());
+        EXPECT_FALSE(filter.might_contain("filter1"));
+        EXPECT_EQ(filter.stats().rebuilds_, 3u);
+    }
+
+    TEST(SessionFilterTest, RepeatedDestroyKeepsOtherIds)
+    {
+        auto storage = std::make_shared<InMemoryStorage>(4);
+        auto &mgr = SessionManager::get_instance();
+        mgr.set_session_storage(storage);
+        mgr.enable_session_filter(filter_config(16)); // 表很小，ID之间大量共用计数器
+        for (int i = 0; i < 200 && mgr.session_filter_stats()->rebuilds_ == 0; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        std::vector<std::string> ids;
+        for (int i = 0; i < 32; ++i)
+        {
+            HttpRequest req;
+            HttpResponse resp;
+            auto session = mgr.get_session(req, &resp);
+            session->set_attribute("n", std::to_string(i));
+            ids.push_back(session->get_session_id());
+        }
+
+        // 同一ID删除多次只减少一次计数，不存在的ID不减少计数
+        for (int i = 0; i < 16; ++i)
+        {
+            mgr.destroy_session(ids[i]);
+            mgr.destroy_session(ids[i]);
+            mgr.destroy_session(SessionIdGenerator::generate());
+        }
+        for (int i = 16; i < 32; ++i)
+        {
+            HttpRequest req;
+            req.set_header("Cookie", "session_id=" + ids[i]);
+            HttpResponse resp;
+            EXPECT_EQ(mgr.get_session(req, &resp)->get_attribute("n"), std::to_string(i));
+        }
+
+        mgr.disable_session_filter();
+        mgr.set_session_storage(std::make_shared<InMemoryStorage>());
+    }
+
+    TEST(SessionFilterTest, SharesNewSessionsAcrossNodes)
+    {
+        // 两个节点共享同一个存储，新建的会话经总线同步
+        auto storage = std::make_shared<SharedStorage>();
+        auto hub = std::make_shared<LocalInvalidationHub>();
+        SessionFilterConfig config = filter_config(1000);
+        EXPECT_THROW(SessionIdFilter(storage, config), std::invalid_argument);
+
+        config.bus_ = hub->endpoint();
+        SessionIdFilter node_a(storage, config);
+        config.bus_ = hub->endpoint();
+        SessionIdFilter node_b(storage, config);
+        ASSERT_TRUE(wait_ready(node_a));
+        ASSERT_TRUE(wait_ready(node_b));
+
+        storage->store(std::make_shared<Session>("shared1"));
+        node_a.add("shared1");
+        EXPECT_TRUE(node_a.might_contain("shared1"));
+        EXPECT_TRUE(node_b.might_contain("shared1"));
+
+        // 订阅中断后立即重建
+        const uint64_t rebuilds = node_b.stats().rebuilds_;
+        hub->reset();
+        for (int i = 0; i < 200 && node_b.stats().rebuilds_ == rebuilds; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        EXPECT_GT(node_b.stats().rebuilds_, rebuilds);
+        ASSERT_TRUE(wait_ready(node_b));
+        EXPECT_FALSE(node_b.might_contain("unknown"));
+        EXPECT_TRUE(node_b.might_contain("shared1"));
+    }
+
+    TEST(SessionFilterTest, StaysOpenWithoutEnumeration)
+    {
+        SessionIdFilter filter(std::make_shared<OpaqueStorage>(), filter_config(1000));
+        EXPECT_FALSE(filter.rebuild());
+        EXPECT_FALSE(filter.ready());
+        EXPECT_TRUE(filter.might_contain("anything"));
+        EXPECT_EQ(filter.stats().checks_, 0u);
+    }
+
+    TEST(SessionFilterTest, ManagerSkipsStorageForUnknownIds)
+    {
+        auto storage = std::make_shared<InMemoryStorage>(4);
+        auto &mgr = SessionManager::get_instance();
+        mgr.set_session_storage(storage);
+        mgr.enable_session_filter(filter_config(1000));
+        for (int i = 0; i < 200 && mgr.session_filter_stats()->rebuilds_ == 0; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        HttpRequest req;
+        HttpResponse resp;
+        auto session = mgr.get_session(req, &resp);
+        session->set_attribute("user", "alice"); // 创建时加入过滤器
+        const std::string sid = session->get_session_id();
+
+        HttpRequest valid;
+        valid.set_header("Cookie", "session_id=" + sid);
+        HttpResponse valid_resp;
+        EXPECT_EQ(mgr.get_session(valid, &valid_resp)->get_attribute("user"), "alice");
+
+        HttpRequest forged;
+        forged.set_header("Cookie", "session_id=" + SessionIdGenerator::generate());
+        HttpResponse forged_resp;
+        EXPECT_TRUE(mgr.get_session(forged, &forged_resp)->is_lazy());
+
+        auto stats = mgr.session_filter_stats();
+        ASSERT_TRUE(stats.has_value());
+        EXPECT_EQ(stats->checks_, 2u);
+        EXPECT_EQ(stats->rejected_, 1u);
+
+        // 销毁后同一ID不再访问存储
+        mgr.destroy_session(sid);
+        HttpResponse stale_resp;
+        EXPECT_TRUE(mgr.get_session(valid, &stale_resp)->is_lazy());
+        EXPECT_EQ(mgr.session_filter_stats()->rejected_, 2u);
+
+        mgr.disable_session_filter();
+        EXPECT_FALSE(mgr.session_filter_stats().has_value());
+        mgr.set_session_storage(std::make_shared<InMemoryStorage>());
+    }
+} // namespace zhttp::zsession
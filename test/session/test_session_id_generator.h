@@ -0,0 +1,70 @@
+#pragma once
+#include "session/session_id_generator.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cctype>
+#include <thread>
+#include <unordered_set>
+#include <mutex>
+
+namespace zhttp::zsession
+{
+    TEST(SessionIdGeneratorTest, LengthAndAlphabet)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            const std::string id = SessionIdGenerator::generate();
+            ASSERT_EQ(id.size(), SessionIdGenerator::kIdLength);
+            for (const char c : id)
+            {
+                ASSERT_TRUE(std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_') << id;
+            }
+        }
+    }
+
+    TEST(SessionIdGeneratorTest, EncodesBase64Url)
+    {
+        uint8_t bytes[SessionIdGenerator::kIdBytes];
+        for (size_t i = 0; i < sizeof(bytes); ++i)
+        {
+            bytes[i] = static_cast<uint8_t>(i);
+        }
+        std::string out(SessionIdGenerator::kIdLength, '\0');
+        SessionIdGenerator::encode(bytes, out.data());
+        EXPECT_EQ(out, "AAECAwQFBgcICQoLDA0ODw");
+
+        std::fill(std::begin(bytes), std::end(bytes), 0xFF);
+        bytes[0] = 0xFB;
+        SessionIdGenerator::encode(bytes, out.data());
+        EXPECT_EQ(out, "-____________________w");
+    }
+
+    TEST(SessionIdGeneratorTest, UniqueAcrossThreads)
+    {
+        constexpr int kThreads = 8;
+        constexpr int kPerThread = 20000;
+        std::unordered_set<std::string> ids;
+        std::mutex mutex;
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            threads.emplace_back([&]
+            {
+                std::vector<std::string> local;
+                local.reserve(kPerThread);
+                for (int i = 0; i < kPerThread; ++i)
+                {
+                    local.push_back(SessionIdGenerator::generate());
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                ids.insert(local.begin(), local.end());
+            });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(ids.size(), static_cast<size_t>(kThreads * kPerThread));
+    }
+} // namespace zhttp::zsession
@@ -11,16 +11,92 @@ namespace zhttp::zsession
         HttpResponse resp;
         auto &mgr = SessionManager::get_instance();
         auto session = mgr.get_session(req, &resp);
-        EXPECT_NE(session, nullptr);
+        ASSERT_NE(session, nullptr);
+        EXPECT_TRUE(session->is_lazy());
+        session->set_attribute("user", "alice"); // 首次写入时才创建
         EXPECT_FALSE(session->get_session_id().empty());
     }
 
+    TEST(SessionManagerTest, LazySessionNotPersistedUntilWritten)
+    {
+        auto storage = std::make_shared<InMemoryStorage>(4);
+        auto &mgr = SessionManager::get_instance();
+        mgr.set_session_storage(storage);
+
+        // 只读请求：没有ID、没有Cookie、没有存储
+        HttpRequest req;
+        HttpResponse resp;
+        auto session = mgr.get_session(req, &resp);
+        EXPECT_TRUE(session->get_session_id().empty());
+        EXPECT_EQ(session->get_attribute("user"), "");
+        mgr.update_session(session);
+        EXPECT_EQ(storage->size(), 0u);
+        EXPECT_EQ(resp.get_header("Set-Cookie"), "");
+
+        // 首次写入：分配ID、下发Cookie并持久化
+        session->set_attribute("user", "alice");
+        EXPECT_FALSE(session->is_lazy());
+        EXPECT_EQ(storage->size(), 1u);
+        EXPECT_EQ(resp.get_header("Set-Cookie").rfind("session_id=" + session->get_session_id(), 0), 0u);
+        EXPECT_EQ(storage->load(session->get_session_id())->get_attribute("user"), "alice");
+
+        mgr.set_session_storage(std::make_shared<InMemoryStorage>());
+    }
+
+    TEST(SessionManagerTest, CopiedLazySessionMaterializesItself)
+    {
+        auto storage = std::make_shared<InMemoryStorage>(4);
+        auto &mgr = SessionManager::get_instance();
+        mgr.set_session_storage(storage);
+
+        HttpRequest req;
+        HttpResponse resp;
+        auto session = mgr.get_session(req, &resp);
+        Session copy = *session;
+        copy.set_attribute("user", "alice");
+
+        // 写入的副本获得ID并被存储，原对象仍是延迟会话
+        EXPECT_FALSE(copy.is_lazy());
+        ASSERT_FALSE(copy.get_session_id().empty());
+        EXPECT_TRUE(session->is_lazy());
+        EXPECT_EQ(resp.get_header("Set-Cookie").rfind("session_id=" + copy.get_session_id(), 0), 0u);
+        EXPECT_EQ(storage->load(copy.get_session_id())->get_attribute("user"), "alice");
+
+        // 之后的更新写到同一个ID下
+        copy.set_attribute("role", "admin");
+        mgr.update_session(std::make_shared<Session>(copy));
+        EXPECT_EQ(storage->size(), 1u);
+        EXPECT_EQ(storage->load(copy.get_session_id())->get_attribute("role"), "admin");
+
+        mgr.set_session_storage(std::make_shared<InMemoryStorage>());
+    }
+
+    TEST(SessionManagerTest, LazySessionWrittenAfterResponse)
+    {
+        auto storage = std::make_shared<InMemoryStorage>(4);
+        auto &mgr = SessionManager::get_instance();
+        mgr.set_session_storage(storage);
+
+        std::shared_ptr<Session> session;
+        {
+            HttpRequest req;
+            HttpResponse resp;
+            session = mgr.get_session(req, &resp);
+        }
+        session->set_attribute("user", "bob"); // 响应已销毁，不能再写入Cookie
+        EXPECT_FALSE(session->get_session_id().empty());
+        EXPECT_EQ(storage->size(), 1u);
+
+        mgr.set_session_storage(std::make_shared<InMemoryStorage>());
+    }
+
     TEST(SessionManagerTest, SessionReuseWithCookie)
     {
         HttpRequest req;
         HttpResponse resp;
         auto &mgr = SessionManager::get_instance();
         auto session1 = mgr.get_session(req, &resp);
+        session1->set_attribute("user", "alice");
         std::string sid = session1->get_session_id();
 
         HttpRequest req2;
@@ -36,6 +112,7 @@ namespace zhttp::zsession
         HttpResponse resp;
         auto &mgr = SessionManager::get_instance();
         auto session = mgr.get_session(req, &resp);
+        session->set_attribute("user", "alice");
         std::string sid = session->get_session_id();
         mgr.destroy_session(sid);
 
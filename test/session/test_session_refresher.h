@@ -0,0 +1,117 @@
+#pragma once
+#include "session/session_manager.h"
+#include "session/session_refresher.h"
+#include <atomic>
+#include <gtest/gtest.h>
+
+namespace zhttp::zsession
+{
+    // 记录写入次数的内存存储
+    class RecordingStorage final : public SessionStorage
+    {
+    public:
+        void store(const std::shared_ptr<Session> &session) override
+        {
+            ++stores_;
+            storage_.store(session);
+        }
+
+        std::shared_ptr<Session> load(const std::string &session_id) override { return storage_.load(session_id); }
+
+        bool remove(const std::string &session_id) override { return storage_.remove(session_id); }
+
+        void clear_expired() override { storage_.clear_expired(); }
+
+        void touch(const std::vector<ExpiryUpdate> &updates) override
+        {
+            ++touch_batches_;
+            touched_ += static_cast<int>(updates.size());
+            SessionStorage::touch(updates);
+        }
+
+        std::atomic<int> stores_{0};
+        std::atomic<int> touch_batches_{0};
+        std::atomic<int> touched_{0};
+
+    private:
+        InMemoryStorage storage_{4};
+    };
+
+    TEST(SessionRefresherTest, CoalescesTouchesIntoBatches)
+    {
+        auto storage = std::make_shared<RecordingStorage>();
+        SessionRefresher refresher(storage, std::chrono::seconds(60), std::chrono::hours(1));
+        const auto expiry = std::chrono::system_clock::now() + std::chrono::hours(2);
+        for (int i = 0; i < 100; ++i)
+        {
+            storage->store(std::make_shared<Session>("refresh" + std::to_string(i % 10)));
+            refresher.touch("refresh" + std::to_string(i % 10), expiry);
+        }
+        EXPECT_EQ(refresher.pending(), 10u);
+
+        refresher.flush();
+        EXPECT_EQ(storage->touch_batches_, 1);
+        EXPECT_EQ(storage->touched_, 10);
+        EXPECT_EQ(storage->load("refresh3")->get_expiry_time(), expiry);
+
+        // interval内再次访问不再写入
+        refresher.touch("refresh3", expiry + std::chrono::seconds(5));
+        EXPECT_EQ(refresher.pending(), 0u);
+    }
+
+    TEST(SessionRefresherTest, WrittenAndForget)
+    {
+        auto storage = std::make_shared<RecordingStorage>();
+        SessionRefresher refresher(storage, std::chrono::seconds(60), std::chrono::hours(1));
+        const auto expiry = std::chrono::system_clock::now() + std::chrono::hours(2);
+
+        refresher.touch("written", expiry);
+        refresher.written("written"); // 完整写入已包含过期时间
+        refresher.touch("written", expiry);
+        refresher.touch("removed", expiry);
+        refresher.forget("removed");
+        EXPECT_EQ(refresher.pending(), 0u);
+    }
+
+    TEST(SessionRefresherTest, BackgroundFlush)
+    {
+        auto storage = std::make_shared<RecordingStorage>();
+        storage->store(std::make_shared<Session>("background"));
+        SessionRefresher refresher(storage, std::chrono::seconds(60), std::chrono::milliseconds(20));
+        refresher.touch("background", std::chrono::system_clock::now() + std::chrono::hours(2));
+
+        for (int i = 0; i < 100 && storage->touched_ == 0; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        EXPECT_EQ(storage->touched_, 1);
+    }
+
+    TEST(SessionRefresherTest, ReadOnlyRequestsDoNotStore)
+    {
+        auto storage = std::make_shared<RecordingStorage>();
+        auto &mgr = SessionManager::get_instance();
+        mgr.set_session_storage(storage);
+
+        HttpRequest req;
+        HttpResponse resp;
+        const auto session = mgr.get_session(req, &resp);
+        session->set_attribute("user", "alice");
+        mgr.update_session(session);
+        EXPECT_EQ(storage->stores_, 1); // 首次写入属性时创建
+
+        HttpRequest req2;
+        req2.set_header("Cookie", "session_id=" + session->get_session_id());
+        for (int i = 0; i < 50; ++i)
+        {
+            HttpResponse resp2;
+            const auto loaded = mgr.get_session(req2, &resp2);
+            EXPECT_EQ(loaded->get_attribute("user"), "alice");
+            mgr.update_session(loaded);
+        }
+        EXPECT_EQ(storage->stores_, 1);
+
+        mgr.set_session_storage(std::make_shared<InMemoryStorage>()); // 写回待刷新的过期时间并恢复默认存储
+        EXPECT_LE(storage->touched_, 1);
+    }
+} // namespace zhttp::zsession
@@ -1,16 +1,37 @@
 #include"http/test_http_request.h"
 #include"http/test_http_context.h"
 #include "http/test_http_response.h"
+#include "http/test_timing_wheel.h"
+#include "http/test_buffer_pool.h"
+#include "http/test_loop_load.h"
 
 #include "router/test_router.h"
+#include "router/test_radix_tree.h"
+#include "router/test_regex_set.h"
+#include "router/test_route_table.h"
+#include "router/test_typed_route.h"
+#include "router/test_route_group.h"
+
+#include "utils/test_epoch.h"
 
 #include "session/test_session.h"
+#include "session/test_session_codec.h"
+#include "session/test_session_id_generator.h"
 #include "session/test_memory_storage.h"
 #include "session/test_session_manager.h"
 #include "session/test_db_storage.h"
+#include "session/test_cached_storage.h"
+#include "session/test_cookie_storage.h"
+#include "session/test_session_refresher.h"
+#include "session/test_session_filter.h"
 
 #include "middleware/test_middleware_chain.h"
+#include "middleware/test_pipeline.h"
 #include "middleware/test_cors_middle.h"
+#include "middleware/test_cors_policy.h"
+#include "middleware/test_rate_limit_middle.h"
+#include "middleware/test_ip_filter.h"
+#include "middleware/test_jwt_middle.h"
 
 #include "db_pool/test_mysql_connection.h"
 #include "db_pool/test_mysql_pool.h"
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "utils/epoch.h"
+
+namespace zhttp::zutils
+{
+    TEST(EpochDomainTest, ReclaimWaitsForReaders)
+    {
+        EpochDomain domain;
+        std::atomic<int> freed{0};
+        {
+            const auto guard = domain.pin();
+            domain.retire([&freed] { ++freed; });
+            EXPECT_EQ(domain.reclaim(), 1u);
+            EXPECT_EQ(freed.load(), 0);
+        }
+        EXPECT_EQ(domain.reclaim(), 0u);
+        EXPECT_EQ(freed.load(), 1);
+
+        // 读者在退休之后进入，不阻碍回收
+        domain.retire([&freed] { ++freed; });
+        const auto guard = domain.pin();
+        EXPECT_EQ(domain.reclaim(), 0u);
+        EXPECT_EQ(freed.load(), 2);
+    }
+    TEST(EpochDomainTest, ConcurrentReclaimNeverFreesPinnedObject)
+    {
+        // 释放函数只做标记而不真正释放，读者在临界区内看到标记即说明提前回收
+        struct Node
+        {
+            std::atomic<bool> dead_{false};
+        };
+
+        EpochDomain domain;
+        constexpr int kSwaps = 20000;
+        std::vector<std::unique_ptr<Node>> nodes;
+        nodes.reserve(kSwaps + 1);
+        for (int i = 0; i <= kSwaps; ++i)
+        {
+            nodes.push_back(std::make_unique<Node>());
+        }
+
+        std::atomic<Node *> current{nodes[0].get()};
+        std::atomic<bool> stop{false};
+        std::atomic<int> violations{0};
+
+        std::vector<std::thread> threads;
+        for (int r = 0; r < 3; ++r)
+        {
+            threads.emplace_back([&]
+            {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    const auto guard = domain.pin();
+                    Node *node = current.load(std::memory_order_acquire);
+                    for (int spin = 0; spin < 64; ++spin)
+                    {
+                        if (node->dead_.load(std::memory_order_acquire))
+                        {
+                            ++violations;
+                            break;
+                        }
+                    }
+                }
+            });
+        }
+        threads.emplace_back([&]
+        {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                domain.reclaim();
+            }
+        });
+
+        for (int i = 1; i <= kSwaps; ++i)
+        {
+            Node *old = current.exchange(nodes[i].get(), std::memory_order_acq_rel);
+            domain.retire([old] { old->dead_.store(true, std::memory_order_release); });
+        }
+        stop.store(true);
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        EXPECT_EQ(violations.load(), 0);
+        EXPECT_EQ(domain.reclaim(), 0u);
+    }
+} // namespace zhttp::zutils